@@ -21,6 +21,17 @@ tests {
     tests.file = tests/FortFirewallTests.pro
 }
 
+# Benchmarks
+bench {
+    SUBDIRS += \
+        bench
+
+    bench.depends = ui
+    bench.file = tests/FortFirewallBench.pro
+
+    tests: bench.depends += tests
+}
+
 # Driver Payload
 driver_payload {
     SUBDIRS += \
@@ -2,8 +2,14 @@ include($$PWD/Driver-include.pri)
 
 SOURCES += \
     $$PWD/common/fortconf.c \
+    $$PWD/common/fortflowtab.c \
     $$PWD/common/fortlog.c \
+    $$PWD/common/fortmetrics.c \
     $$PWD/common/fortprov.c \
+    $$PWD/common/fortpsenum.c \
+    $$PWD/common/fortpsmap.c \
+    $$PWD/common/fortsvctab.c \
+    $$PWD/common/forttrc.c \
     $$PWD/common/fort_wildmatch.c
 
 HEADERS += \
@@ -11,7 +17,13 @@ HEADERS += \
     $$PWD/common/common_types.h \
     $$PWD/common/fortconf.h \
     $$PWD/common/fortdef.h \
+    $$PWD/common/fortflowtab.h \
     $$PWD/common/fortioctl.h \
     $$PWD/common/fortlog.h \
+    $$PWD/common/fortmetrics.h \
     $$PWD/common/fortprov.h \
+    $$PWD/common/fortpsenum.h \
+    $$PWD/common/fortpsmap.h \
+    $$PWD/common/fortsvctab.h \
+    $$PWD/common/forttrc.h \
     $$PWD/common/fort_wildmatch.h
@@ -133,6 +133,73 @@ FORT_API BOOL fort_conf_ip_inlist(
     }
 }
 
+static BOOL fort_conf_port_find(const UINT16 *portarr, UINT16 port, UINT32 count, BOOL is_range)
+{
+    if (count == 0)
+        return FALSE;
+
+    int low = 0;
+    int high = count - 1;
+
+    do {
+        const int mid = (low + high) / 2;
+        const UINT16 mid_port = portarr[mid];
+
+        if (port < mid_port)
+            high = mid - 1;
+        else if (port > mid_port)
+            low = mid + 1;
+        else
+            return TRUE;
+    } while (low <= high);
+
+    if (!is_range)
+        return FALSE;
+
+    return high >= 0 && port >= portarr[high] && port <= portarr[count + high];
+}
+
+FORT_API BOOL fort_conf_port_inlist(UINT16 port, const PFORT_CONF_PORT_LIST port_list)
+{
+    const UINT16 *ports = port_list->port;
+
+    return fort_conf_port_find(ports, port, port_list->port_n, /*is_range=*/FALSE)
+            || fort_conf_port_find(
+                    &ports[port_list->port_n], port, port_list->pair_n, /*is_range=*/TRUE);
+}
+
+#define fort_conf_port_bit_test(bits, index) (((bits)[(index) / 8] & (1 << ((index) % 8))) != 0)
+
+FORT_API BOOL fort_conf_port_inbitmap(UINT16 port, const UINT8 *port_bitmap)
+{
+    return fort_conf_port_bit_test(port_bitmap, port);
+}
+
+FORT_API BOOL fort_conf_port_inblocks(UINT16 port, const PFORT_CONF_PORT_BLOCKS port_blocks)
+{
+    const UINT8 block = port_blocks->block[port / FORT_CONF_PORT_BLOCK_PORTS];
+
+    if (block < FORT_CONF_PORT_BLOCK_LEAF)
+        return block == FORT_CONF_PORT_BLOCK_ALL;
+
+    const UINT8 *leaf_bits = &port_blocks->leaf_bits[(block - FORT_CONF_PORT_BLOCK_LEAF)
+            * FORT_CONF_PORT_LEAF_SIZE];
+
+    return fort_conf_port_bit_test(leaf_bits, port % FORT_CONF_PORT_BLOCK_PORTS);
+}
+
+FORT_API BOOL fort_conf_port_included(UINT16 port, const char *port_data, UINT8 port_encoding)
+{
+    switch (port_encoding) {
+    case FORT_CONF_PORT_ENCODING_BITMAP:
+        return fort_conf_port_inbitmap(port, (const UINT8 *) port_data);
+    case FORT_CONF_PORT_ENCODING_BLOCKS:
+        return fort_conf_port_inblocks(port, (const PFORT_CONF_PORT_BLOCKS) port_data);
+    default:
+        return fort_conf_port_inlist(port, (const PFORT_CONF_PORT_LIST) port_data);
+    }
+}
+
 FORT_API PFORT_CONF_ADDR_GROUP fort_conf_addr_group_ref(const PFORT_CONF conf, int addr_group_index)
 {
     const UINT32 *addr_group_offsets = (const UINT32 *) (conf->data + conf->addr_groups_off);
@@ -355,7 +422,11 @@ FORT_API UINT16 fort_conf_app_period_bits(const PFORT_CONF conf, FORT_TIME time,
     UINT16 period_bits = (UINT16) conf->flags.group_bits;
     int n = 0;
 
-    for (int i = 0; i < FORT_CONF_GROUP_MAX; ++i) {
+    /* Periods of the app groups only */
+    const UINT32 groups_n = (conf->wild_apps_off - conf->app_periods_off) / sizeof(FORT_PERIOD);
+    const int periods_max = (groups_n < FORT_CONF_GROUP_MAX) ? groups_n : FORT_CONF_GROUP_MAX;
+
+    for (int i = 0; i < periods_max; ++i) {
         const UINT16 bit = (1 << i);
         const FORT_PERIOD period = *app_periods++;
 
@@ -394,3 +465,490 @@ FORT_API void fort_conf_app_perms_mask_init(PFORT_CONF conf, UINT32 group_bits)
     conf->app_perms_block_mask = (perms_mask & 0xAAAAAAAA);
     conf->app_perms_allow_mask = (perms_mask & 0x55555555);
 }
+
+FORT_API UINT32 fort_conf_generation_bump(UINT32 volatile *conf_generation)
+{
+    UINT32 generation;
+
+    /* Zero marks "not cached", skip it on wrap around */
+    while ((generation = (UINT32) InterlockedIncrement((LONG volatile *) conf_generation)) == 0) {
+    }
+
+    return generation;
+}
+
+FORT_API BOOL fort_conf_app_verdict_get(
+        const PFORT_APP_VERDICT verdict, UINT32 conf_generation, PFORT_APP_DATA app_data)
+{
+    if (conf_generation == 0 || verdict->conf_generation != conf_generation)
+        return FALSE;
+
+    *app_data = verdict->app_data;
+
+    return TRUE;
+}
+
+FORT_API void fort_conf_app_verdict_set(
+        PFORT_APP_VERDICT verdict, UINT32 conf_generation, FORT_APP_DATA app_data)
+{
+    /* Invalidate the verdict for the concurrent readers while it's changing */
+    InterlockedExchange((LONG volatile *) &verdict->conf_generation, 0);
+
+    verdict->app_data = app_data;
+
+    WriteRelease((LONG volatile *) &verdict->conf_generation, (LONG) conf_generation);
+}
+
+FORT_API void fort_conf_app_verdict_copy(PFORT_APP_VERDICT dst, const PFORT_APP_VERDICT src)
+{
+    const UINT32 conf_generation = ReadAcquire((LONG const volatile *) &src->conf_generation);
+
+    dst->app_data = src->app_data;
+
+    MemoryBarrier();
+
+    /* Drop the verdict, if it was changed while copying */
+    dst->conf_generation =
+            (ReadNoFence((LONG const volatile *) &src->conf_generation) == (LONG) conf_generation)
+            ? conf_generation
+            : 0;
+}
+
+static BOOL fort_conf_addr4_list_verify(const char *data, UINT32 size, UINT32 *list_size)
+{
+    if (size < FORT_CONF_ADDR4_LIST_OFF)
+        return FALSE;
+
+    const PFORT_CONF_ADDR4_LIST addr_list = (const PFORT_CONF_ADDR4_LIST) data;
+
+    if (addr_list->ip_n > FORT_CONF_IP_MAX || addr_list->pair_n > FORT_CONF_IP_MAX)
+        return FALSE;
+
+    *list_size = FORT_CONF_ADDR4_LIST_SIZE(addr_list->ip_n, addr_list->pair_n);
+
+    return *list_size <= size;
+}
+
+static BOOL fort_conf_addr6_list_verify(const char *data, UINT32 size, UINT32 *list_size)
+{
+    if (size < FORT_CONF_ADDR6_LIST_OFF)
+        return FALSE;
+
+    const PFORT_CONF_ADDR6_LIST addr_list = (const PFORT_CONF_ADDR6_LIST) data;
+
+    if (addr_list->ip_n > FORT_CONF_IP_MAX || addr_list->pair_n > FORT_CONF_IP_MAX)
+        return FALSE;
+
+    *list_size = FORT_CONF_ADDR6_LIST_SIZE(addr_list->ip_n, addr_list->pair_n);
+
+    return *list_size <= size;
+}
+
+static BOOL fort_conf_addr_list_verify(const char *data, UINT32 size, UINT32 *list_size)
+{
+    UINT32 addr4_size;
+    if (!fort_conf_addr4_list_verify(data, size, &addr4_size))
+        return FALSE;
+
+    /* The IPv6 list follows the IPv4 one */
+    UINT32 addr6_size;
+    if (!fort_conf_addr6_list_verify(data + addr4_size, size - addr4_size, &addr6_size))
+        return FALSE;
+
+    *list_size = addr4_size + addr6_size;
+
+    return TRUE;
+}
+
+static BOOL fort_conf_addr_group_verify(const char *data, UINT32 size)
+{
+    if (size < FORT_CONF_ADDR_GROUP_OFF)
+        return FALSE;
+
+    const PFORT_CONF_ADDR_GROUP addr_group = (const PFORT_CONF_ADDR_GROUP) data;
+
+    const UINT32 lists_size = size - FORT_CONF_ADDR_GROUP_OFF;
+    UINT32 list_size;
+
+    /* Include list */
+    if (!fort_conf_addr_list_verify(addr_group->data, lists_size, &list_size))
+        return FALSE;
+
+    /* Exclude list */
+    const UINT32 exclude_off = addr_group->exclude_off;
+
+    return exclude_off <= lists_size
+            && fort_conf_addr_list_verify(
+                    addr_group->data + exclude_off, lists_size - exclude_off, &list_size);
+}
+
+static BOOL fort_conf_addr_groups_verify(const char *data, UINT32 size)
+{
+    const UINT32 *addr_group_offsets = (const UINT32 *) data;
+
+    if (size < sizeof(UINT32))
+        return FALSE;
+
+    /* The offsets' table precedes the groups */
+    const UINT32 table_size = addr_group_offsets[0];
+    const UINT32 groups_n = table_size / sizeof(UINT32);
+
+    if (table_size % sizeof(UINT32) != 0 || table_size > size)
+        return FALSE;
+
+    /* Internet and Allowed Internet addresses are required */
+    if (groups_n < 2)
+        return FALSE;
+
+    for (UINT32 i = 0; i < groups_n; ++i) {
+        const UINT32 group_off = addr_group_offsets[i];
+        const UINT32 group_end = (i + 1 < groups_n) ? addr_group_offsets[i + 1] : size;
+
+        if (group_off < table_size || group_off > group_end || group_end > size)
+            return FALSE;
+
+        if (!fort_conf_addr_group_verify(data + group_off, group_end - group_off))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOL fort_conf_app_entry_verify(const char *data, UINT32 size, UINT32 *entry_size)
+{
+    if (size < FORT_CONF_APP_ENTRY_PATH_OFF)
+        return FALSE;
+
+    const PFORT_APP_ENTRY app_entry = (const PFORT_APP_ENTRY) data;
+    const UINT16 path_len = app_entry->path_len;
+
+    if (path_len > FORT_CONF_APP_PATH_MAX_SIZE || (path_len % sizeof(WCHAR)) != 0)
+        return FALSE;
+
+    if (app_entry->app_data.flags.group_index >= FORT_CONF_GROUP_MAX)
+        return FALSE;
+
+    *entry_size = FORT_CONF_APP_ENTRY_SIZE(path_len);
+    if (*entry_size > size)
+        return FALSE;
+
+    /* The wildcard matching needs the terminating zero */
+    return app_entry->path[path_len / sizeof(WCHAR)] == L'\0';
+}
+
+static BOOL fort_conf_apps_verify(const char *data, UINT32 size, UINT16 apps_n)
+{
+    while (apps_n-- != 0) {
+        UINT32 entry_size;
+        if (!fort_conf_app_entry_verify(data, size, &entry_size))
+            return FALSE;
+
+        data += entry_size;
+        size -= entry_size;
+    }
+
+    return TRUE;
+}
+
+static BOOL fort_conf_prefix_apps_verify(const char *data, UINT32 size, UINT16 apps_n)
+{
+    if (apps_n == 0)
+        return TRUE;
+
+    const UINT32 *app_offsets = (const UINT32 *) data;
+
+    const UINT32 table_size = FORT_CONF_STR_HEADER_SIZE(apps_n);
+    if (table_size > size)
+        return FALSE;
+
+    const char *app_entries = data + table_size;
+    const UINT32 entries_size = size - table_size;
+
+    for (UINT32 i = 0; i < apps_n; ++i) {
+        const UINT32 app_off = app_offsets[i];
+        const UINT32 app_end = app_offsets[i + 1];
+
+        if (app_off > app_end || app_end > entries_size)
+            return FALSE;
+
+        UINT32 entry_size;
+        if (!fort_conf_app_entry_verify(app_entries + app_off, app_end - app_off, &entry_size))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOL fort_conf_periods_verify(const char *data, UINT32 size, UINT8 periods_n)
+{
+    if (size % sizeof(FORT_PERIOD) != 0)
+        return FALSE;
+
+    const PFORT_PERIOD periods = (const PFORT_PERIOD) data;
+    const UINT32 groups_n = size / sizeof(FORT_PERIOD);
+
+    if (groups_n > FORT_CONF_GROUP_MAX)
+        return FALSE;
+
+    UINT32 active_n = 0;
+    for (UINT32 i = 0; i < groups_n; ++i) {
+        if (periods[i].v != 0) {
+            ++active_n;
+        }
+    }
+
+    return periods_n <= active_n;
+}
+
+FORT_API BOOL fort_conf_verify(const PFORT_CONF conf, UINT32 len)
+{
+    if (len < FORT_CONF_DATA_OFF)
+        return FALSE;
+
+    const UINT32 data_len = len - FORT_CONF_DATA_OFF;
+    const char *data = conf->data;
+
+    /* The sections are in order */
+    if (conf->addr_groups_off > conf->app_periods_off
+            || conf->app_periods_off > conf->wild_apps_off
+            || conf->wild_apps_off > conf->prefix_apps_off
+            || conf->prefix_apps_off > conf->exe_apps_off || conf->exe_apps_off > data_len)
+        return FALSE;
+
+    return fort_conf_addr_groups_verify(data + conf->addr_groups_off,
+                   conf->app_periods_off - conf->addr_groups_off)
+            && fort_conf_periods_verify(data + conf->app_periods_off,
+                    conf->wild_apps_off - conf->app_periods_off, conf->app_periods_n)
+            && fort_conf_apps_verify(data + conf->wild_apps_off,
+                    conf->prefix_apps_off - conf->wild_apps_off, conf->wild_apps_n)
+            && fort_conf_prefix_apps_verify(data + conf->prefix_apps_off,
+                    conf->exe_apps_off - conf->prefix_apps_off, conf->prefix_apps_n)
+            && fort_conf_apps_verify(
+                    data + conf->exe_apps_off, data_len - conf->exe_apps_off, conf->exe_apps_n);
+}
+
+FORT_API BOOL fort_conf_app_entries_verify(const PFORT_APP_ENTRIES app_entries, UINT32 len)
+{
+    if (len < FORT_APP_ENTRIES_DATA_OFF)
+        return FALSE;
+
+    return fort_conf_apps_verify(
+            app_entries->data, len - FORT_APP_ENTRIES_DATA_OFF, app_entries->apps_n);
+}
+
+FORT_API BOOL fort_conf_app_verify(const PFORT_APP_ENTRY app_entry, UINT32 len)
+{
+    UINT32 entry_size;
+
+    return fort_conf_app_entry_verify((const char *) app_entry, len, &entry_size);
+}
+
+FORT_API BOOL fort_conf_zones_verify(const PFORT_CONF_ZONES zones, UINT32 len)
+{
+    if (len < FORT_CONF_ZONES_DATA_OFF)
+        return FALSE;
+
+    const UINT32 data_len = len - FORT_CONF_ZONES_DATA_OFF;
+
+    for (int zone_index = 0; zone_index < FORT_CONF_ZONE_MAX; ++zone_index) {
+        if ((zones->mask & (1u << zone_index)) == 0)
+            continue;
+
+        const UINT32 addr_off = zones->addr_off[zone_index];
+
+        UINT32 list_size;
+        if (addr_off > data_len
+                || !fort_conf_addr_list_verify(
+                        zones->data + addr_off, data_len - addr_off, &list_size))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static BOOL fort_conf_port_blocks_verify(const char *data, UINT32 size, UINT32 *list_size)
+{
+    if (size < FORT_CONF_PORT_BLOCKS_OFF)
+        return FALSE;
+
+    const PFORT_CONF_PORT_BLOCKS port_blocks = (const PFORT_CONF_PORT_BLOCKS) data;
+    const UINT8 leaf_n = port_blocks->leaf_n;
+
+    if (leaf_n > FORT_CONF_PORT_LEAF_MAX)
+        return FALSE;
+
+    for (int i = 0; i < FORT_CONF_PORT_BLOCK_COUNT; ++i) {
+        if (port_blocks->block[i] >= FORT_CONF_PORT_BLOCK_LEAF + leaf_n)
+            return FALSE;
+    }
+
+    *list_size = FORT_CONF_PORT_BLOCKS_SIZE(leaf_n);
+
+    return *list_size <= size;
+}
+
+static BOOL fort_conf_port_list_verify(
+        const char *data, UINT32 size, UINT8 port_encoding, UINT32 *list_size)
+{
+    switch (port_encoding) {
+    case FORT_CONF_PORT_ENCODING_LIST: {
+        if (size < FORT_CONF_PORT_LIST_OFF)
+            return FALSE;
+
+        const PFORT_CONF_PORT_LIST port_list = (const PFORT_CONF_PORT_LIST) data;
+
+        *list_size = FORT_CONF_PORT_LIST_SIZE(port_list->port_n, port_list->pair_n);
+    } break;
+    case FORT_CONF_PORT_ENCODING_BITMAP: {
+        *list_size = FORT_CONF_PORT_BITMAP_SIZE;
+    } break;
+    case FORT_CONF_PORT_ENCODING_BLOCKS:
+        return fort_conf_port_blocks_verify(data, size, list_size);
+    default:
+        return FALSE;
+    }
+
+    return *list_size <= size;
+}
+
+static BOOL fort_conf_rule_filter_verify(
+        const PFORT_CONF_RULE_EXPR expr, const char *data, UINT32 size, UINT32 *filter_size)
+{
+    const UINT8 flags = expr->flags;
+
+    /* Empty filter */
+    if (flags == 0)
+        return FALSE;
+
+    UINT32 list_size;
+
+    *filter_size = 0;
+
+    if ((flags & FORT_RULE_FLAG_ADDRESS) != 0) {
+        if (!(expr->has_ip6_list ? fort_conf_addr_list_verify(data, size, &list_size)
+                                 : fort_conf_addr4_list_verify(data, size, &list_size)))
+            return FALSE;
+
+        *filter_size += list_size;
+    }
+
+    if ((flags & FORT_RULE_FLAG_PORT) != 0) {
+        if (!fort_conf_port_list_verify(data + *filter_size, size - *filter_size,
+                    expr->port_encoding, &list_size))
+            return FALSE;
+
+        *filter_size += list_size;
+    }
+
+    return TRUE;
+}
+
+static BOOL fort_conf_rule_expr_verify(const char *data, UINT32 size)
+{
+    int depth = 0;
+
+    for (;;) {
+        if (size < sizeof(FORT_CONF_RULE_EXPR))
+            return FALSE;
+
+        const PFORT_CONF_RULE_EXPR expr = (const PFORT_CONF_RULE_EXPR) data;
+
+        data += sizeof(FORT_CONF_RULE_EXPR);
+        size -= sizeof(FORT_CONF_RULE_EXPR);
+
+        if (expr->expr_end) {
+            /* The last one closes the top group */
+            if (depth-- == 0)
+                return TRUE;
+        } else if (expr->expr_begin) {
+            if (++depth > FORT_CONF_RULE_DEPTH_MAX)
+                return FALSE;
+        } else {
+            UINT32 filter_size;
+            if (!fort_conf_rule_filter_verify(expr, data, size, &filter_size))
+                return FALSE;
+
+            data += filter_size;
+            size -= filter_size;
+        }
+    }
+}
+
+static BOOL fort_conf_rule_verify(
+        const char *data, UINT32 size, UINT16 max_rule_id, UINT16 rule_id)
+{
+    if (size < sizeof(FORT_CONF_RULE))
+        return FALSE;
+
+    const PFORT_CONF_RULE rule = (const PFORT_CONF_RULE) data;
+
+    if (rule->set_count > FORT_CONF_RULE_SET_MAX)
+        return FALSE;
+
+    const UINT32 rule_size = FORT_CONF_RULE_SIZE(rule);
+    if (rule_size > size)
+        return FALSE;
+
+    /* Sub-rules' ids follow the rule's header and zones */
+    const UINT16 *rule_set = (const UINT16 *) (data + rule_size) - rule->set_count;
+
+    for (int i = 0; i < rule->set_count; ++i) {
+        const UINT16 set_rule_id = rule_set[i];
+
+        if (set_rule_id == 0 || set_rule_id > max_rule_id || set_rule_id == rule_id)
+            return FALSE;
+    }
+
+    return !rule->has_expr || fort_conf_rule_expr_verify(data + rule_size, size - rule_size);
+}
+
+FORT_API BOOL fort_conf_rules_verify(const PFORT_CONF_RULES rules, UINT32 len)
+{
+    if (len < FORT_CONF_RULES_DATA_OFF)
+        return FALSE;
+
+    const UINT16 max_rule_id = rules->max_rule_id;
+    if (max_rule_id > FORT_CONF_RULE_MAX)
+        return FALSE;
+
+    const UINT32 data_len = len - FORT_CONF_RULES_DATA_OFF;
+    const UINT32 offsets_size = FORT_CONF_RULES_OFFSETS_SIZE(max_rule_id);
+    if (offsets_size > data_len)
+        return FALSE;
+
+    const UINT32 *rule_offsets = (const UINT32 *) rules->data;
+    const char *rules_data = rules->data + offsets_size;
+    const UINT32 rules_size = data_len - offsets_size;
+
+    for (UINT16 rule_id = 1; rule_id <= max_rule_id; ++rule_id) {
+        const UINT32 rule_off = rule_offsets[rule_id];
+
+        if (rule_off == FORT_CONF_RULE_OFF_NONE)
+            continue; /* the rule id is missing */
+
+        if (rule_off > rules_size
+                || !fort_conf_rule_verify(
+                        rules_data + rule_off, rules_size - rule_off, max_rule_id, rule_id))
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+FORT_API PFORT_CONF_RULE fort_conf_rule_ref(const PFORT_CONF_RULES rules, UINT16 rule_id)
+{
+    const UINT16 max_rule_id = rules->max_rule_id;
+
+    if (rule_id == 0 || rule_id > max_rule_id)
+        return NULL;
+
+    const UINT32 *rule_offsets = (const UINT32 *) rules->data;
+    const UINT32 rule_off = rule_offsets[rule_id];
+
+    if (rule_off == FORT_CONF_RULE_OFF_NONE)
+        return NULL;
+
+    const char *rules_data = rules->data + FORT_CONF_RULES_OFFSETS_SIZE(max_rule_id);
+
+    return (PFORT_CONF_RULE) (rules_data + rule_off);
+}
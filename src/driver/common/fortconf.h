@@ -56,9 +56,12 @@ typedef struct fort_service_info
     WCHAR name[2];
 } FORT_SERVICE_INFO, *PFORT_SERVICE_INFO;
 
+#define FORT_SERVICE_INFO_LIST_DELTA 0x0001 /* update of previous list, zero pid removes */
+
 typedef struct fort_service_info_list
 {
     UINT16 services_n;
+    UINT16 flags;
 
     FORT_SERVICE_INFO data[1];
 } FORT_SERVICE_INFO_LIST, *PFORT_SERVICE_INFO_LIST;
@@ -79,6 +82,29 @@ typedef struct fort_conf_port_list
     UINT16 port[1];
 } FORT_CONF_PORT_LIST, *PFORT_CONF_PORT_LIST;
 
+#define FORT_CONF_PORT_ENCODING_LIST   0 /* FORT_CONF_PORT_LIST */
+#define FORT_CONF_PORT_ENCODING_BITMAP 1 /* 65536-bit bitmap */
+#define FORT_CONF_PORT_ENCODING_BLOCKS 2 /* FORT_CONF_PORT_BLOCKS */
+
+#define FORT_CONF_PORT_BITMAP_SIZE  (65536 / 8)
+#define FORT_CONF_PORT_BLOCK_COUNT  256
+#define FORT_CONF_PORT_BLOCK_PORTS  (65536 / FORT_CONF_PORT_BLOCK_COUNT)
+#define FORT_CONF_PORT_LEAF_SIZE    (FORT_CONF_PORT_BLOCK_PORTS / 8)
+#define FORT_CONF_PORT_BLOCK_NONE   0
+#define FORT_CONF_PORT_BLOCK_ALL    1
+#define FORT_CONF_PORT_BLOCK_LEAF   2 /* code of the first leaf */
+#define FORT_CONF_PORT_LEAF_MAX     (256 - FORT_CONF_PORT_BLOCK_LEAF)
+
+/* Two-level bitmap: only partially included blocks of ports have their leaf bitmaps */
+typedef struct fort_conf_port_blocks
+{
+    UINT8 leaf_n;
+
+    UINT8 block[FORT_CONF_PORT_BLOCK_COUNT]; /* FORT_CONF_PORT_BLOCK_* or leaf's code */
+
+    UINT8 leaf_bits[1];
+} FORT_CONF_PORT_BLOCKS, *PFORT_CONF_PORT_BLOCKS;
+
 typedef struct fort_conf_addr4_list
 {
     UINT32 ip_n;
@@ -124,6 +150,7 @@ typedef struct fort_conf_rule_expr
     UINT8 expr_local : 1; // Local Address/Port
 
     UINT8 has_ip6_list : 1;
+    UINT8 port_encoding : 2; /* FORT_CONF_PORT_ENCODING_* */
 
     UINT8 flags;
 } FORT_CONF_RULE_EXPR, *PFORT_CONF_RULE_EXPR;
@@ -161,10 +188,22 @@ typedef struct fort_conf_rule_flag
 
 #define FORT_CONF_RULES_DATA_OFF                  offsetof(FORT_CONF_RULES, data)
 #define FORT_CONF_RULES_OFFSETS_SIZE(max_rule_id) ((max_rule_id + 1) * sizeof(UINT32))
+#define FORT_CONF_RULE_OFF_NONE                   ((UINT32) -1) /* offset of the missing rule id */
 #define FORT_CONF_RULE_SIZE(rule)                                                                  \
     (sizeof(FORT_CONF_RULE) + ((rule)->has_zones ? sizeof(FORT_CONF_RULE_ZONES) : 0)               \
             + (rule)->set_count * sizeof(UINT16))
 
+/*
+ * Rule's expression follows the sub-rules' ids as a sequence of FORT_CONF_RULE_EXPR records:
+ * - "expr_begin" opens a nested group of filters,
+ * - "expr_end" closes the group, the last one closes the top group of the rule,
+ * - other records are filters followed by their data:
+ *   FORT_CONF_ADDR4_LIST [+ FORT_CONF_ADDR6_LIST] if FORT_RULE_FLAG_ADDRESS,
+ *   port list of "port_encoding" if FORT_RULE_FLAG_PORT.
+ * "expr_or" starts an alternative in the group, else the record is AND-ed to the previous one.
+ */
+#define FORT_CONF_RULE_EXPR_OFF(rule) FORT_CONF_RULE_SIZE(rule)
+
 typedef struct fort_conf_zones
 {
     UINT32 mask;
@@ -255,6 +294,13 @@ typedef struct fort_app_data
     UINT16 reject_zones;
 } FORT_APP_DATA, *PFORT_APP_DATA;
 
+typedef struct fort_app_verdict
+{
+    UINT32 conf_generation; /* 0: not cached */
+
+    FORT_APP_DATA app_data;
+} FORT_APP_VERDICT, *PFORT_APP_VERDICT;
+
 typedef struct fort_app_entry
 {
     FORT_APP_DATA app_data;
@@ -268,6 +314,15 @@ typedef struct fort_app_entry
 #define FORT_CONF_APP_ENTRY_SIZE(path_len)                                                         \
     (FORT_CONF_APP_ENTRY_PATH_OFF + (path_len) + sizeof(WCHAR)) /* include terminating zero */
 
+typedef struct fort_app_entries
+{
+    UINT16 apps_n;
+
+    char data[4]; /* packed FORT_APP_ENTRY records */
+} FORT_APP_ENTRIES, *PFORT_APP_ENTRIES;
+
+#define FORT_APP_ENTRIES_DATA_OFF offsetof(FORT_APP_ENTRIES, data)
+
 typedef struct fort_speed_limit
 {
     UINT16 plr; /* packet loss rate in 1/100% (0-10000, i.e. 10% packet loss = 1000) */
@@ -324,15 +379,25 @@ typedef struct fort_conf_io
 {
     FORT_CONF_GROUP conf_group;
 
+    UINT32 flows_capacity; /* initial capacity of the flow table */
+
     FORT_CONF conf;
 } FORT_CONF_IO, *PFORT_CONF_IO;
 
-#define FORT_CONF_DATA_OFF       offsetof(FORT_CONF, data)
-#define FORT_CONF_IO_CONF_OFF    offsetof(FORT_CONF_IO, conf)
-#define FORT_CONF_ADDR4_LIST_OFF offsetof(FORT_CONF_ADDR4_LIST, ip)
-#define FORT_CONF_ADDR6_LIST_OFF offsetof(FORT_CONF_ADDR6_LIST, ip)
-#define FORT_CONF_ADDR_GROUP_OFF offsetof(FORT_CONF_ADDR_GROUP, data)
-#define FORT_CONF_ZONES_DATA_OFF offsetof(FORT_CONF_ZONES, data)
+#define FORT_CONF_DATA_OFF        offsetof(FORT_CONF, data)
+#define FORT_CONF_IO_CONF_OFF     offsetof(FORT_CONF_IO, conf)
+#define FORT_CONF_PORT_LIST_OFF   offsetof(FORT_CONF_PORT_LIST, port)
+#define FORT_CONF_PORT_BLOCKS_OFF offsetof(FORT_CONF_PORT_BLOCKS, leaf_bits)
+#define FORT_CONF_ADDR4_LIST_OFF  offsetof(FORT_CONF_ADDR4_LIST, ip)
+#define FORT_CONF_ADDR6_LIST_OFF  offsetof(FORT_CONF_ADDR6_LIST, ip)
+#define FORT_CONF_ADDR_GROUP_OFF  offsetof(FORT_CONF_ADDR_GROUP, data)
+#define FORT_CONF_ZONES_DATA_OFF  offsetof(FORT_CONF_ZONES, data)
+
+#define FORT_CONF_PORT_LIST_SIZE(port_n, pair_n)                                                   \
+    (FORT_CONF_PORT_LIST_OFF + ((port_n) + (pair_n) * 2) * sizeof(UINT16))
+
+#define FORT_CONF_PORT_BLOCKS_SIZE(leaf_n)                                                         \
+    (FORT_CONF_PORT_BLOCKS_OFF + (leaf_n) * FORT_CONF_PORT_LEAF_SIZE)
 
 #define FORT_CONF_ADDR4_LIST_SIZE(ip_n, pair_n)                                                    \
     (FORT_CONF_ADDR4_LIST_OFF + FORT_CONF_IP4_ARR_SIZE(ip_n) + FORT_CONF_IP4_RANGE_SIZE(pair_n))
@@ -358,6 +423,14 @@ FORT_API BOOL is_time_in_period(FORT_TIME time, FORT_PERIOD period);
 FORT_API BOOL fort_conf_ip_inlist(
         const UINT32 *ip, const PFORT_CONF_ADDR4_LIST addr_list, BOOL isIPv6);
 
+FORT_API BOOL fort_conf_port_inlist(UINT16 port, const PFORT_CONF_PORT_LIST port_list);
+
+FORT_API BOOL fort_conf_port_inbitmap(UINT16 port, const UINT8 *port_bitmap);
+
+FORT_API BOOL fort_conf_port_inblocks(UINT16 port, const PFORT_CONF_PORT_BLOCKS port_blocks);
+
+FORT_API BOOL fort_conf_port_included(UINT16 port, const char *port_data, UINT8 port_encoding);
+
 FORT_API PFORT_CONF_ADDR_GROUP fort_conf_addr_group_ref(
         const PFORT_CONF conf, int addr_group_index);
 
@@ -393,6 +466,30 @@ FORT_API UINT16 fort_conf_app_period_bits(const PFORT_CONF conf, FORT_TIME time,
 
 FORT_API void fort_conf_app_perms_mask_init(PFORT_CONF conf, UINT32 group_bits);
 
+FORT_API UINT32 fort_conf_generation_bump(UINT32 volatile *conf_generation);
+
+FORT_API BOOL fort_conf_app_verdict_get(
+        const PFORT_APP_VERDICT verdict, UINT32 conf_generation, PFORT_APP_DATA app_data);
+
+FORT_API void fort_conf_app_verdict_set(
+        PFORT_APP_VERDICT verdict, UINT32 conf_generation, FORT_APP_DATA app_data);
+
+FORT_API void fort_conf_app_verdict_copy(PFORT_APP_VERDICT dst, const PFORT_APP_VERDICT src);
+
+/* Check all offsets, counts and lengths before the conf is used */
+FORT_API BOOL fort_conf_verify(const PFORT_CONF conf, UINT32 len);
+
+FORT_API BOOL fort_conf_rules_verify(const PFORT_CONF_RULES rules, UINT32 len);
+
+/* Returns NULL for the missing rule id */
+FORT_API PFORT_CONF_RULE fort_conf_rule_ref(const PFORT_CONF_RULES rules, UINT16 rule_id);
+
+FORT_API BOOL fort_conf_app_entries_verify(const PFORT_APP_ENTRIES app_entries, UINT32 len);
+
+FORT_API BOOL fort_conf_app_verify(const PFORT_APP_ENTRY app_entry, UINT32 len);
+
+FORT_API BOOL fort_conf_zones_verify(const PFORT_CONF_ZONES zones, UINT32 len);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -0,0 +1,177 @@
+/* Fort Firewall Flows Table */
+
+#include "fortflowtab.h"
+
+#define fort_flowtab_segment_buckets(segment_index)                                                \
+    (FORT_FLOWTAB_BUCKETS_MIN << ((segment_index) - 1))
+
+static PFORT_FLOWTAB_NODE *fort_flowtab_slot(PFORT_FLOWTAB tab, UINT32 index)
+{
+    if (index < FORT_FLOWTAB_BUCKETS_MIN)
+        return &tab->buckets_min[index];
+
+    ULONG bit;
+    _BitScanReverse(&bit, index);
+
+    const int segment_index = bit - FORT_FLOWTAB_BUCKETS_BIT + 1;
+
+    return &tab->segments[segment_index][index - (1u << bit)];
+}
+
+static UINT32 fort_flowtab_index(const PFORT_FLOWTAB tab, UINT32 hash)
+{
+    const UINT32 low_mask = (1u << tab->bucket_bit) - 1;
+
+    const UINT32 index = hash & low_mask;
+
+    /* The bucket is already split in the current level */
+    return (index < tab->split) ? (hash & ((low_mask << 1) | 1)) : index;
+}
+
+static UINT32 fort_flowtab_allocated_count(const PFORT_FLOWTAB tab)
+{
+    return FORT_FLOWTAB_BUCKETS_MIN << (tab->segments_n - 1);
+}
+
+static BOOL fort_flowtab_split(PFORT_FLOWTAB tab)
+{
+    const UINT32 low_max = 1u << tab->bucket_bit;
+    const UINT32 new_index = low_max + tab->split;
+
+    if (new_index >= fort_flowtab_allocated_count(tab))
+        return FALSE; /* the segment is not provided yet */
+
+    PFORT_FLOWTAB_NODE *old_bucket = fort_flowtab_slot(tab, tab->split);
+    PFORT_FLOWTAB_NODE *new_bucket = fort_flowtab_slot(tab, new_index);
+
+    PFORT_FLOWTAB_NODE node = *old_bucket;
+
+    *old_bucket = NULL;
+    *new_bucket = NULL; /* the segment is not zeroed */
+
+    while (node != NULL) {
+        PFORT_FLOWTAB_NODE next = node->next;
+        PFORT_FLOWTAB_NODE *bucket = (node->hash & low_max) != 0 ? new_bucket : old_bucket;
+
+        node->next = *bucket;
+        *bucket = node;
+
+        node = next;
+    }
+
+    if (++tab->split == low_max) {
+        ++tab->bucket_bit;
+        tab->split = 0;
+    }
+
+    return TRUE;
+}
+
+FORT_API void fort_flowtab_init(PFORT_FLOWTAB tab)
+{
+    RtlZeroMemory(tab, sizeof(FORT_FLOWTAB));
+
+    tab->bucket_bit = FORT_FLOWTAB_BUCKETS_BIT;
+
+    tab->segments[0] = tab->buckets_min;
+    tab->segments_n = 1;
+}
+
+FORT_API UINT32 fort_flowtab_count(const PFORT_FLOWTAB tab)
+{
+    return tab->count;
+}
+
+FORT_API UINT32 fort_flowtab_buckets_count(const PFORT_FLOWTAB tab)
+{
+    return (1u << tab->bucket_bit) + tab->split;
+}
+
+FORT_API PFORT_FLOWTAB_NODE fort_flowtab_bucket(PFORT_FLOWTAB tab, UINT32 hash)
+{
+    return *fort_flowtab_slot(tab, fort_flowtab_index(tab, hash));
+}
+
+FORT_API void fort_flowtab_insert(PFORT_FLOWTAB tab, PFORT_FLOWTAB_NODE node, UINT32 hash)
+{
+    PFORT_FLOWTAB_NODE *bucket = fort_flowtab_slot(tab, fort_flowtab_index(tab, hash));
+
+    node->hash = hash;
+    node->next = *bucket;
+    *bucket = node;
+
+    ++tab->count;
+
+    /* Split at most two buckets to catch up after a late segment */
+    for (int i = 0; i < 2 && tab->count > fort_flowtab_buckets_count(tab); ++i) {
+        if (!fort_flowtab_split(tab))
+            break;
+    }
+}
+
+FORT_API void fort_flowtab_remove(PFORT_FLOWTAB tab, PFORT_FLOWTAB_NODE node)
+{
+    PFORT_FLOWTAB_NODE *link = fort_flowtab_slot(tab, fort_flowtab_index(tab, node->hash));
+
+    while (*link != node) {
+        link = &(*link)->next;
+    }
+
+    *link = node->next;
+
+    --tab->count;
+}
+
+FORT_API void fort_flowtab_foreach_arg(
+        PFORT_FLOWTAB tab, FORT_FLOWTAB_FOREACH_FUNC func, PVOID arg)
+{
+    const UINT32 buckets_count = fort_flowtab_buckets_count(tab);
+
+    for (UINT32 i = 0; i < buckets_count; ++i) {
+        PFORT_FLOWTAB_NODE node = *fort_flowtab_slot(tab, i);
+
+        while (node != NULL) {
+            PFORT_FLOWTAB_NODE next = node->next; /* the node may be removed */
+
+            func(arg, node);
+
+            node = next;
+        }
+    }
+}
+
+FORT_API UINT32 fort_flowtab_reserve_size(const PFORT_FLOWTAB tab, UINT32 capacity)
+{
+    if (tab->segments_n >= FORT_FLOWTAB_SEGMENTS_MAX)
+        return 0;
+
+    const UINT32 allocated_count = fort_flowtab_allocated_count(tab);
+
+    if (allocated_count >= capacity)
+        return 0;
+
+    /* The next segment doubles the allocated buckets */
+    return allocated_count * sizeof(PFORT_FLOWTAB_NODE);
+}
+
+FORT_API BOOL fort_flowtab_segment_add(PFORT_FLOWTAB tab, PVOID segment, UINT32 size)
+{
+    if (tab->segments_n >= FORT_FLOWTAB_SEGMENTS_MAX
+            || size != fort_flowtab_segment_buckets(tab->segments_n) * sizeof(PFORT_FLOWTAB_NODE))
+        return FALSE;
+
+    tab->segments[tab->segments_n++] = segment;
+
+    return TRUE;
+}
+
+FORT_API PVOID fort_flowtab_segment_pop(PFORT_FLOWTAB tab)
+{
+    if (tab->segments_n <= 1)
+        return NULL;
+
+    PVOID segment = tab->segments[--tab->segments_n];
+    tab->segments[tab->segments_n] = NULL;
+
+    return segment;
+}
@@ -0,0 +1,74 @@
+#ifndef FORTFLOWTAB_H
+#define FORTFLOWTAB_H
+
+#include "common.h"
+
+#define FORT_FLOWTAB_BUCKETS_BIT  6 /* buckets of the embedded segment */
+#define FORT_FLOWTAB_BUCKETS_MIN  (1u << FORT_FLOWTAB_BUCKETS_BIT)
+#define FORT_FLOWTAB_SEGMENTS_MAX (31 - FORT_FLOWTAB_BUCKETS_BIT + 1) /* up to 2^31 buckets */
+
+/*
+ * Flow Id -> Node table with linear hashing.
+ *
+ * The table grows by splitting one bucket per insert, so no operation
+ * rehashes the whole table. The bucket segments are provided by the caller,
+ * segment i > 0 holds FORT_FLOWTAB_BUCKETS_MIN << (i - 1) buckets and needn't
+ * be zeroed. Segments are kept until the table is done, the table doesn't shrink.
+ *
+ * The caller must serialize all operations.
+ */
+
+typedef struct fort_flowtab_node
+{
+    struct fort_flowtab_node *next; /* bucket's chain */
+
+    UINT32 hash;
+} FORT_FLOWTAB_NODE, *PFORT_FLOWTAB_NODE;
+
+typedef void (*FORT_FLOWTAB_FOREACH_FUNC)(PVOID arg, PVOID node);
+
+typedef struct fort_flowtab
+{
+    UINT32 count;
+
+    UCHAR bucket_bit; /* of the current level */
+    UCHAR segments_n;
+
+    UINT32 split; /* next bucket to split in the current level */
+
+    PFORT_FLOWTAB_NODE *segments[FORT_FLOWTAB_SEGMENTS_MAX];
+
+    PFORT_FLOWTAB_NODE buckets_min[FORT_FLOWTAB_BUCKETS_MIN];
+} FORT_FLOWTAB, *PFORT_FLOWTAB;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API void fort_flowtab_init(PFORT_FLOWTAB tab);
+
+FORT_API UINT32 fort_flowtab_count(const PFORT_FLOWTAB tab);
+
+FORT_API UINT32 fort_flowtab_buckets_count(const PFORT_FLOWTAB tab);
+
+FORT_API PFORT_FLOWTAB_NODE fort_flowtab_bucket(PFORT_FLOWTAB tab, UINT32 hash);
+
+FORT_API void fort_flowtab_insert(PFORT_FLOWTAB tab, PFORT_FLOWTAB_NODE node, UINT32 hash);
+
+FORT_API void fort_flowtab_remove(PFORT_FLOWTAB tab, PFORT_FLOWTAB_NODE node);
+
+FORT_API void fort_flowtab_foreach_arg(
+        PFORT_FLOWTAB tab, FORT_FLOWTAB_FOREACH_FUNC func, PVOID arg);
+
+FORT_API UINT32 fort_flowtab_reserve_size(const PFORT_FLOWTAB tab, UINT32 capacity);
+
+FORT_API BOOL fort_flowtab_segment_add(PFORT_FLOWTAB tab, PVOID segment, UINT32 size);
+
+/* Returns the provided segments to free them, when the table is done */
+FORT_API PVOID fort_flowtab_segment_pop(PFORT_FLOWTAB tab);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTFLOWTAB_H
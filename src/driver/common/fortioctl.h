@@ -168,6 +168,10 @@ DEFINE_GUID(FORT_GUID_EMPTY, 0x00000000, 0x0000, 0x0000, 0x00, 0x00, 0x00, 0x00,
 #define FORT_NT_DEVICE_NAME  L"\\Device\\fortfw"
 #define FORT_DOS_DEVICE_NAME L"\\DosDevices\\fortfw"
 
+/* Read-only statistics file of the device: it may be opened along with the main client */
+#define FORT_DEVICE_STATS_NAME      FORT_DEVICE_NAME "\\stats"
+#define FORT_DEVICE_STATS_FILE_NAME L"\\stats"
+
 #define FORT_DEVICE_TYPE 0xD000
 #define FORT_IOCTL_BASE  0xD00
 
@@ -185,6 +189,11 @@ DEFINE_GUID(FORT_GUID_EMPTY, 0x00000000, 0x0000, 0x0000, 0x00, 0x00, 0x00, 0x00,
 #define FORT_IOCTL_INDEX_DELAPP      6
 #define FORT_IOCTL_INDEX_SETZONES    7
 #define FORT_IOCTL_INDEX_SETZONEFLAG 8
+#define FORT_IOCTL_INDEX_GETSTATS    9
+#define FORT_IOCTL_INDEX_GETTRACE    10
+#define FORT_IOCTL_INDEX_SETRULES    11
+#define FORT_IOCTL_INDEX_SETRULEFLAG 12
+#define FORT_IOCTL_INDEX_ADDAPPS     13
 
 #define FORT_IOCTL_VALIDATE    FORT_CTL_CODE(FORT_IOCTL_INDEX_VALIDATE, FILE_WRITE_DATA)
 #define FORT_IOCTL_SETSERVICES FORT_CTL_CODE(FORT_IOCTL_INDEX_SETSERVICES, FILE_WRITE_DATA)
@@ -195,5 +204,10 @@ DEFINE_GUID(FORT_GUID_EMPTY, 0x00000000, 0x0000, 0x0000, 0x00, 0x00, 0x00, 0x00,
 #define FORT_IOCTL_DELAPP      FORT_CTL_CODE(FORT_IOCTL_INDEX_DELAPP, FILE_WRITE_DATA)
 #define FORT_IOCTL_SETZONES    FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONES, FILE_WRITE_DATA)
 #define FORT_IOCTL_SETZONEFLAG FORT_CTL_CODE(FORT_IOCTL_INDEX_SETZONEFLAG, FILE_WRITE_DATA)
+#define FORT_IOCTL_GETSTATS    FORT_CTL_CODE(FORT_IOCTL_INDEX_GETSTATS, FILE_READ_DATA)
+#define FORT_IOCTL_GETTRACE    FORT_CTL_CODE(FORT_IOCTL_INDEX_GETTRACE, FILE_READ_DATA)
+#define FORT_IOCTL_SETRULES    FORT_CTL_CODE(FORT_IOCTL_INDEX_SETRULES, FILE_WRITE_DATA)
+#define FORT_IOCTL_SETRULEFLAG FORT_CTL_CODE(FORT_IOCTL_INDEX_SETRULEFLAG, FILE_WRITE_DATA)
+#define FORT_IOCTL_ADDAPPS     FORT_CTL_CODE(FORT_IOCTL_INDEX_ADDAPPS, FILE_WRITE_DATA)
 
 #endif // FORTIOCTL_H
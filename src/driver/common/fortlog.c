@@ -90,6 +90,31 @@ void fort_log_blocked_ip_header_read(const char *p, BOOL *isIPv6, BOOL *inbound,
     RtlCopyMemory(remote_ip, up, ip_size);
 }
 
+FORT_API void fort_log_blocked_ip_sum_header_write(
+        char *p, UINT32 hit_count, INT64 first_time, INT64 last_time)
+{
+    UINT32 *up = (UINT32 *) p;
+
+    *up++ = fort_log_flag_type(FORT_LOG_TYPE_BLOCKED_IP_SUM);
+    *up++ = hit_count;
+
+    INT64 *tp = (INT64 *) up;
+    *tp++ = first_time;
+    *tp = last_time;
+}
+
+FORT_API void fort_log_blocked_ip_sum_header_read(
+        const char *p, UINT32 *hit_count, INT64 *first_time, INT64 *last_time)
+{
+    const UINT32 *up = (const UINT32 *) p + 1;
+
+    *hit_count = *up++;
+
+    const INT64 *tp = (const INT64 *) up;
+    *first_time = *tp++;
+    *last_time = *tp;
+}
+
 FORT_API void fort_log_proc_new_header_write(char *p, UINT32 pid, UINT32 path_len)
 {
     UINT32 *up = (UINT32 *) p;
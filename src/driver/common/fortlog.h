@@ -38,6 +38,14 @@
 
 #define FORT_LOG_BLOCKED_IP_SIZE_MAX FORT_LOG_BLOCKED_IP_SIZE(FORT_LOG_PATH_MAX, /*isIPv6=*/TRUE)
 
+#define FORT_LOG_BLOCKED_IP_SUM_HEADER_SIZE (2 * sizeof(UINT32) + 2 * sizeof(INT64))
+
+#define FORT_LOG_BLOCKED_IP_SUM_SIZE(path_len, isIPv6)                                             \
+    (FORT_LOG_BLOCKED_IP_SUM_HEADER_SIZE + FORT_LOG_BLOCKED_IP_SIZE((path_len), (isIPv6)))
+
+#define FORT_LOG_BLOCKED_IP_SUM_SIZE_MAX                                                           \
+    FORT_LOG_BLOCKED_IP_SUM_SIZE(FORT_LOG_PATH_MAX, /*isIPv6=*/TRUE)
+
 #define FORT_LOG_PROC_NEW_HEADER_SIZE (2 * sizeof(UINT32))
 
 #define FORT_LOG_PROC_NEW_SIZE(path_len)                                                           \
@@ -55,7 +63,7 @@
 
 #define FORT_LOG_TIME_SIZE (sizeof(UINT32) + sizeof(INT64))
 
-#define FORT_LOG_SIZE_MAX FORT_LOG_BLOCKED_SIZE_MAX
+#define FORT_LOG_SIZE_MAX FORT_LOG_BLOCKED_IP_SUM_SIZE_MAX
 
 #if defined(__cplusplus)
 extern "C" {
@@ -82,6 +90,12 @@ FORT_API void fort_log_blocked_ip_header_read(const char *p, BOOL *isIPv6, BOOL
         BOOL *inherited, UCHAR *block_reason, UCHAR *ip_proto, UINT16 *local_port,
         UINT16 *remote_port, UINT32 *local_ip, UINT32 *remote_ip, UINT32 *pid, UINT32 *path_len);
 
+FORT_API void fort_log_blocked_ip_sum_header_write(
+        char *p, UINT32 hit_count, INT64 first_time, INT64 last_time);
+
+FORT_API void fort_log_blocked_ip_sum_header_read(
+        const char *p, UINT32 *hit_count, INT64 *first_time, INT64 *last_time);
+
 FORT_API void fort_log_proc_new_header_write(char *p, UINT32 pid, UINT32 path_len);
 
 FORT_API void fort_log_proc_new_write(char *p, UINT32 pid, UINT32 path_len, const char *path);
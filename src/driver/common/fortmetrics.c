@@ -0,0 +1,139 @@
+/* Fort Firewall Driver Metrics */
+
+#include "fortmetrics.h"
+
+#define fort_metrics_slot(metrics, slot) (&(metrics)->slots[(slot) % (metrics)->slots_n])
+
+FORT_API void fort_metrics_init(
+        PFORT_METRICS metrics, PFORT_METRICS_SLOT slots, UINT16 slots_n, INT64 ticks_freq)
+{
+    metrics->slots_n = (slots != NULL) ? slots_n : 0;
+    metrics->ticks_freq = ticks_freq;
+    metrics->slots = slots;
+
+    if (metrics->slots_n != 0) {
+        RtlZeroMemory(slots, slots_n * sizeof(FORT_METRICS_SLOT));
+    }
+}
+
+FORT_API void fort_metrics_inc(PFORT_METRICS metrics, UINT32 slot, UINT16 counter)
+{
+    if (metrics->slots_n == 0)
+        return;
+
+    PFORT_METRICS_SLOT metrics_slot = fort_metrics_slot(metrics, slot);
+
+    /* The slot's thread could be preempted at PASSIVE_LEVEL */
+    InterlockedIncrement64((LONG64 volatile *) &metrics_slot->counters[counter]);
+}
+
+FORT_API UINT64 fort_metrics_ticks_to_ns(const PFORT_METRICS metrics, INT64 ticks)
+{
+    const INT64 freq = metrics->ticks_freq;
+
+    if (ticks <= 0 || freq <= 0)
+        return 0;
+
+    /* Avoid the overflow of ticks * 10^9 */
+    return (UINT64) (ticks / freq) * 1000000000ULL
+            + (UINT64) (ticks % freq) * 1000000000ULL / (UINT64) freq;
+}
+
+FORT_API void fort_metrics_latency_add(
+        PFORT_METRICS metrics, UINT32 slot, UINT16 hist_index, INT64 ticks)
+{
+    if (metrics->slots_n == 0)
+        return;
+
+    PFORT_METRICS_SLOT metrics_slot = fort_metrics_slot(metrics, slot);
+    PFORT_METRICS_HIST hist = &metrics_slot->hists[hist_index];
+
+    const UINT64 ns = fort_metrics_ticks_to_ns(metrics, ticks);
+    const UINT16 bucket = fort_metrics_hist_bucket(ns);
+
+    InterlockedIncrement((LONG volatile *) &hist->buckets[bucket]);
+    InterlockedAdd64((LONG64 volatile *) &hist->sum_ns, (LONG64) ns);
+}
+
+static void fort_metrics_hist_sum(PFORT_METRICS_HIST sum, const PFORT_METRICS_HIST hist)
+{
+    sum->sum_ns += hist->sum_ns;
+
+    for (int i = 0; i < FORT_METRICS_HIST_BUCKETS; ++i) {
+        sum->buckets[i] += hist->buckets[i];
+    }
+}
+
+FORT_API void fort_metrics_snapshot(const PFORT_METRICS metrics, PFORT_DRIVER_METRICS out)
+{
+    RtlZeroMemory(out, sizeof(FORT_DRIVER_METRICS));
+
+    out->version = FORT_METRICS_VERSION;
+    out->size = sizeof(FORT_DRIVER_METRICS);
+    out->slots_n = metrics->slots_n;
+
+    for (UINT16 slot = 0; slot < metrics->slots_n; ++slot) {
+        const PFORT_METRICS_SLOT metrics_slot = &metrics->slots[slot];
+
+        for (int i = 0; i < FORT_METRICS_COUNTER_COUNT; ++i) {
+            out->counters[i] += metrics_slot->counters[i];
+        }
+
+        for (int i = 0; i < FORT_METRICS_HIST_COUNT; ++i) {
+            fort_metrics_hist_sum(&out->hists[i], &metrics_slot->hists[i]);
+        }
+    }
+}
+
+FORT_API UINT16 fort_metrics_hist_bucket(UINT64 ns)
+{
+    if (ns >= (1ULL << (FORT_METRICS_HIST_BUCKETS - 1)))
+        return FORT_METRICS_HIST_BUCKETS - 1;
+
+    ULONG index;
+    return _BitScanReverse(&index, (ULONG) ns) ? (UINT16) index : 0;
+}
+
+FORT_API UINT64 fort_metrics_hist_bucket_max(UINT16 bucket)
+{
+    return (2ULL << bucket) - 1;
+}
+
+FORT_API void fort_metrics_hist_add(PFORT_METRICS_HIST hist, UINT64 ns)
+{
+    ++hist->buckets[fort_metrics_hist_bucket(ns)];
+
+    hist->sum_ns += ns;
+}
+
+FORT_API UINT64 fort_metrics_hist_count(const PFORT_METRICS_HIST hist)
+{
+    UINT64 count = 0;
+
+    for (int i = 0; i < FORT_METRICS_HIST_BUCKETS; ++i) {
+        count += hist->buckets[i];
+    }
+
+    return count;
+}
+
+FORT_API UINT64 fort_metrics_hist_percentile(const PFORT_METRICS_HIST hist, UINT16 percent)
+{
+    const UINT64 count = fort_metrics_hist_count(hist);
+    if (count == 0)
+        return 0;
+
+    /* Rank of the percentile's sample, rounded up */
+    const UINT64 rank = (count * percent + 99) / 100;
+
+    UINT64 seen = 0;
+
+    for (UINT16 i = 0; i < FORT_METRICS_HIST_BUCKETS; ++i) {
+        seen += hist->buckets[i];
+
+        if (seen >= rank && seen != 0)
+            return fort_metrics_hist_bucket_max(i);
+    }
+
+    return fort_metrics_hist_bucket_max(FORT_METRICS_HIST_BUCKETS - 1);
+}
@@ -0,0 +1,93 @@
+#ifndef FORTMETRICS_H
+#define FORTMETRICS_H
+
+#include "common.h"
+
+#define FORT_METRICS_VERSION 2
+
+/* Counters */
+#define FORT_METRICS_CLASSIFY      0 /* ALE classify calls */
+#define FORT_METRICS_PERMIT        1
+#define FORT_METRICS_BLOCK         2
+#define FORT_METRICS_LOG_OVERFLOW  3 /* log buffer allocation failures */
+#define FORT_METRICS_PENDING_DROP  4
+#define FORT_METRICS_SHAPER_DROP   5
+#define FORT_METRICS_FLOW_CLASSIFY 6
+#define FORT_METRICS_COUNTER_COUNT 7
+
+/* Latency histograms */
+#define FORT_METRICS_HIST_ALE_CLASSIFY  0
+#define FORT_METRICS_HIST_FLOW_CLASSIFY 1
+#define FORT_METRICS_HIST_COUNT         2
+
+/* Bucket i counts latencies in [2^i, 2^(i+1)) nanoseconds, the last one counts greater */
+#define FORT_METRICS_HIST_BUCKETS 32
+
+typedef struct fort_metrics_hist
+{
+    UINT64 sum_ns;
+    UINT32 buckets[FORT_METRICS_HIST_BUCKETS];
+} FORT_METRICS_HIST, *PFORT_METRICS_HIST;
+
+typedef struct DECLSPEC_CACHEALIGN fort_metrics_slot
+{
+    UINT64 counters[FORT_METRICS_COUNTER_COUNT];
+    FORT_METRICS_HIST hists[FORT_METRICS_HIST_COUNT];
+} FORT_METRICS_SLOT, *PFORT_METRICS_SLOT;
+
+typedef struct fort_metrics
+{
+    UINT16 slots_n;
+
+    INT64 ticks_freq; /* per second */
+
+    PFORT_METRICS_SLOT slots;
+} FORT_METRICS, *PFORT_METRICS;
+
+/* Snapshot of FORT_IOCTL_GETSTATS */
+typedef struct fort_driver_metrics
+{
+    UINT16 version;
+    UINT16 size;
+
+    UINT16 slots_n; /* summed per-CPU slots */
+    UINT16 reserved;
+
+    UINT32 flows_n; /* flow table size */
+    UINT32 flow_buckets_n; /* flow table buckets */
+
+    UINT64 counters[FORT_METRICS_COUNTER_COUNT];
+    FORT_METRICS_HIST hists[FORT_METRICS_HIST_COUNT];
+} FORT_DRIVER_METRICS, *PFORT_DRIVER_METRICS;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API void fort_metrics_init(
+        PFORT_METRICS metrics, PFORT_METRICS_SLOT slots, UINT16 slots_n, INT64 ticks_freq);
+
+FORT_API void fort_metrics_inc(PFORT_METRICS metrics, UINT32 slot, UINT16 counter);
+
+FORT_API UINT64 fort_metrics_ticks_to_ns(const PFORT_METRICS metrics, INT64 ticks);
+
+FORT_API void fort_metrics_latency_add(
+        PFORT_METRICS metrics, UINT32 slot, UINT16 hist_index, INT64 ticks);
+
+FORT_API void fort_metrics_snapshot(const PFORT_METRICS metrics, PFORT_DRIVER_METRICS out);
+
+FORT_API UINT16 fort_metrics_hist_bucket(UINT64 ns);
+
+FORT_API UINT64 fort_metrics_hist_bucket_max(UINT16 bucket);
+
+FORT_API void fort_metrics_hist_add(PFORT_METRICS_HIST hist, UINT64 ns);
+
+FORT_API UINT64 fort_metrics_hist_count(const PFORT_METRICS_HIST hist);
+
+FORT_API UINT64 fort_metrics_hist_percentile(const PFORT_METRICS_HIST hist, UINT16 percent);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTMETRICS_H
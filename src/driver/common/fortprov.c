@@ -12,6 +12,23 @@
 #define FORT_PROV_PACKET_FILTERS_COUNT  4
 #define FORT_PROV_REAUTH_FILTERS_COUNT  4
 
+static_assert(FORT_PROV_ITEM_BOOT_FILTERS == FORT_PROV_ITEM_CALLOUTS + FORT_PROV_CALLOUTS_COUNT,
+        "Invalid FORT_PROV_ITEM_BOOT_FILTERS");
+static_assert(FORT_PROV_ITEM_COUNT
+                == FORT_PROV_ITEM_CALLOUT_FILTERS + FORT_PROV_CALLOUT_FILTERS_COUNT,
+        "Invalid FORT_PROV_ITEM_COUNT");
+
+/* Items with the boot-time variant */
+#define FORT_PROV_VARIANT_ITEMS                                                                    \
+    (FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER) | FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER)     \
+            | FORT_PROV_ITEMS_MASK(                                                                \
+                    FORT_PROV_ITEM_CALLOUT_FILTERS, FORT_PROV_CALLOUT_FILTERS_COUNT))
+
+/* Items used by the flow & reauth filters */
+#define FORT_PROV_FLOW_DEP_ITEMS                                                                   \
+    (FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER)                                                   \
+            | FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_CALLOUTS, FORT_PROV_CALLOUTS_COUNT))
+
 static struct
 {
     FORT_PROV_BOOT_CONF boot_conf;
@@ -42,8 +59,7 @@ static void fort_prov_init_callout(
     cout->calloutKey = key;
     cout->displayData.name = (PWCHAR) name;
     cout->displayData.description = (PWCHAR) descr;
-    cout->providerKey = (GUID *) &FORT_GUID_PROVIDER;
-    cout->applicableLayer = layer;
+    cout->applicableLayer = layer; /* no providerKey to keep them on the provider's update */
 }
 
 static void fort_prov_init_callouts(void)
@@ -319,7 +335,6 @@ static void fort_prov_init_sublayer(void)
     sublayer->subLayerKey = FORT_GUID_SUBLAYER;
     sublayer->displayData.name = (PWCHAR) L"FortSublayer";
     sublayer->displayData.description = (PWCHAR) L"Fort Firewall Sublayer";
-    sublayer->providerKey = (GUID *) &FORT_GUID_PROVIDER;
 
     FWPM_SUBLAYER0 *boot_sublayer = &g_provGlobal.boot_sublayer;
     *boot_sublayer = *sublayer;
@@ -375,17 +390,6 @@ FORT_API DWORD fort_prov_trans_close(HANDLE engine, DWORD status)
     return status;
 }
 
-static DWORD fort_prov_add_callouts(HANDLE engine, const FWPM_CALLOUT0 *callouts, int count)
-{
-    for (int i = 0; i < count; ++i) {
-        const DWORD status = FwpmCalloutAdd0(engine, &callouts[i], NULL, NULL);
-        if (status)
-            return status;
-    }
-
-    return 0;
-}
-
 static DWORD fort_prov_add_filters(HANDLE engine, const FWPM_FILTER0 *filters, int count)
 {
     for (int i = 0; i < count; ++i) {
@@ -485,63 +489,169 @@ FORT_API void fort_prov_trans_unregister(void)
     }
 }
 
-static DWORD fort_prov_register_filters(HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf)
+FORT_API UINT32 fort_prov_item_deps(int item)
 {
+    /* Provider, sublayer & callouts don't refer to other objects.
+     * Boot-time filters are out of the sublayer. */
+    if (item < FORT_PROV_ITEM_PERSIST_FILTERS)
+        return 0;
+
+    if (item < FORT_PROV_ITEM_CALLOUT_FILTERS)
+        return FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER);
+
+    /* Callout filters use the callouts of the same order */
+    const int callout_item = FORT_PROV_ITEM_CALLOUTS + (item - FORT_PROV_ITEM_CALLOUT_FILTERS);
+
+    return FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER) | FORT_PROV_ITEM_BIT(callout_item);
+}
+
+FORT_API void fort_prov_state_build(const FORT_PROV_BOOT_CONF boot_conf, PFORT_PROV_STATE state)
+{
+    UINT32 items = FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER)
+            | FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER)
+            | FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_CALLOUTS, FORT_PROV_CALLOUTS_COUNT)
+            | FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_CALLOUT_FILTERS, FORT_PROV_CALLOUT_FILTERS_COUNT);
+
     if (boot_conf.boot_filter) {
-        DWORD status;
+        items |= FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_BOOT_FILTERS, FORT_PROV_BOOT_FILTERS_COUNT)
+                | FORT_PROV_ITEMS_MASK(
+                        FORT_PROV_ITEM_PERSIST_FILTERS, FORT_PROV_PERSIST_FILTERS_COUNT);
+    }
 
-        if ((status = fort_prov_add_filters(
-                     engine, g_provGlobal.boot_filters, FORT_PROV_BOOT_FILTERS_COUNT)))
-            return status;
+    state->items = items;
+    state->boot_items = boot_conf.boot_filter ? (items & FORT_PROV_VARIANT_ITEMS) : 0;
+    state->provider_data = boot_conf.v;
+}
 
-        if ((status = fort_prov_add_filters(
-                     engine, g_provGlobal.persist_filters, FORT_PROV_PERSIST_FILTERS_COUNT)))
-            return status;
+FORT_API void fort_prov_state_diff(
+        const PFORT_PROV_STATE old_state, const PFORT_PROV_STATE new_state, PFORT_PROV_DIFF diff)
+{
+    const UINT32 kept_items = old_state->items & new_state->items;
+
+    UINT32 changed_items = (old_state->items ^ new_state->items)
+            | (kept_items & (old_state->boot_items ^ new_state->boot_items));
+
+    /* WFP can't update the provider's data in place, nothing refers to the provider */
+    if (old_state->provider_data != new_state->provider_data) {
+        changed_items |= (kept_items & FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER));
+    }
+
+    /* Re-create the dependents of changed items, the dependencies go first */
+    for (int item = 0; item < FORT_PROV_ITEM_COUNT; ++item) {
+        const UINT32 item_bit = FORT_PROV_ITEM_BIT(item);
+
+        if ((kept_items & item_bit) != 0 && (fort_prov_item_deps(item) & changed_items) != 0) {
+            changed_items |= item_bit;
+        }
     }
 
-    return fort_prov_add_filters(engine,
-            (boot_conf.boot_filter ? g_provGlobal.callout_boot_filters
-                                   : g_provGlobal.callout_filters),
-            FORT_PROV_CALLOUT_FILTERS_COUNT);
+    diff->remove_items = (changed_items & old_state->items);
+    diff->add_items = (changed_items & new_state->items);
+    diff->boot_items = new_state->boot_items;
 }
 
-static DWORD fort_prov_register_provider(HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf)
+FORT_API BOOL fort_prov_diff_flows_removed(const PFORT_PROV_DIFF diff)
 {
-    g_provGlobal.boot_conf = boot_conf;
+    return (diff->remove_items & FORT_PROV_FLOW_DEP_ITEMS) != 0;
+}
 
-    FWPM_PROVIDER0 *provider =
-            boot_conf.boot_filter ? &g_provGlobal.boot_provider : &g_provGlobal.provider;
+static const FWPM_FILTER0 *fort_prov_item_filter(int item, BOOL boot)
+{
+    if (item < FORT_PROV_ITEM_PERSIST_FILTERS)
+        return &g_provGlobal.boot_filters[item - FORT_PROV_ITEM_BOOT_FILTERS];
+
+    if (item < FORT_PROV_ITEM_CALLOUT_FILTERS)
+        return &g_provGlobal.persist_filters[item - FORT_PROV_ITEM_PERSIST_FILTERS];
+
+    const int index = item - FORT_PROV_ITEM_CALLOUT_FILTERS;
 
-    return FwpmProviderAdd0(engine, provider, NULL);
+    return boot ? &g_provGlobal.callout_boot_filters[index] : &g_provGlobal.callout_filters[index];
 }
 
-static DWORD fort_prov_register_sublayer(HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf)
+static DWORD fort_prov_item_add(HANDLE engine, int item, BOOL boot)
 {
-    FWPM_SUBLAYER0 *sublayer =
-            boot_conf.boot_filter ? &g_provGlobal.boot_sublayer : &g_provGlobal.sublayer;
+    if (item == FORT_PROV_ITEM_PROVIDER) {
+        const FWPM_PROVIDER0 *provider =
+                boot ? &g_provGlobal.boot_provider : &g_provGlobal.provider;
+
+        return FwpmProviderAdd0(engine, provider, NULL);
+    }
 
-    return FwpmSubLayerAdd0(engine, sublayer, NULL);
+    if (item == FORT_PROV_ITEM_SUBLAYER) {
+        const FWPM_SUBLAYER0 *sublayer =
+                boot ? &g_provGlobal.boot_sublayer : &g_provGlobal.sublayer;
+
+        return FwpmSubLayerAdd0(engine, sublayer, NULL);
+    }
+
+    if (item < FORT_PROV_ITEM_BOOT_FILTERS) {
+        const FWPM_CALLOUT0 *callout = &g_provGlobal.callouts[item - FORT_PROV_ITEM_CALLOUTS];
+
+        return FwpmCalloutAdd0(engine, callout, NULL, NULL);
+    }
+
+    return FwpmFilterAdd0(engine, fort_prov_item_filter(item, boot), NULL, NULL);
 }
 
-FORT_API DWORD fort_prov_register(HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf)
+static void fort_prov_item_delete(HANDLE engine, int item)
 {
-    DWORD status;
+    if (item == FORT_PROV_ITEM_PROVIDER) {
+        FwpmProviderDeleteByKey0(engine, (GUID *) &FORT_GUID_PROVIDER);
+    } else if (item == FORT_PROV_ITEM_SUBLAYER) {
+        FwpmSubLayerDeleteByKey0(engine, (GUID *) &FORT_GUID_SUBLAYER);
+    } else if (item < FORT_PROV_ITEM_BOOT_FILTERS) {
+        const FWPM_CALLOUT0 *callout = &g_provGlobal.callouts[item - FORT_PROV_ITEM_CALLOUTS];
+
+        FwpmCalloutDeleteByKey0(engine, (GUID *) &callout->calloutKey);
+    } else {
+        const FWPM_FILTER0 *filter = fort_prov_item_filter(item, /*boot=*/FALSE);
+
+        FwpmFilterDeleteByKey0(engine, (GUID *) &filter->filterKey);
+    }
+}
+
+static DWORD fort_prov_diff_apply(
+        HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf, const PFORT_PROV_DIFF diff)
+{
+    /* Delete the dependents first */
+    for (int item = FORT_PROV_ITEM_COUNT - 1; item >= 0; --item) {
+        if ((diff->remove_items & FORT_PROV_ITEM_BIT(item)) != 0) {
+            fort_prov_item_delete(engine, item);
+        }
+    }
 
-    if ((status = fort_prov_register_provider(engine, boot_conf)))
-        return status;
+    g_provGlobal.boot_conf = boot_conf;
 
-    if ((status = fort_prov_register_sublayer(engine, boot_conf)))
-        return status;
+    /* Add the dependencies first */
+    for (int item = 0; item < FORT_PROV_ITEM_COUNT; ++item) {
+        const UINT32 item_bit = FORT_PROV_ITEM_BIT(item);
 
-    if ((status = fort_prov_add_callouts(engine, g_provGlobal.callouts, FORT_PROV_CALLOUTS_COUNT)))
-        return status;
+        if ((diff->add_items & item_bit) == 0)
+            continue;
 
-    if ((status = fort_prov_register_filters(engine, boot_conf)))
-        return status;
+        const BOOL boot = (diff->boot_items & item_bit) != 0;
+
+        const DWORD status = fort_prov_item_add(engine, item, boot);
+        if (status)
+            return status;
+    }
 
     return 0;
 }
 
+FORT_API DWORD fort_prov_register(HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf)
+{
+    FORT_PROV_STATE old_state = { 0 }; /* nothing is installed */
+
+    FORT_PROV_STATE state;
+    fort_prov_state_build(boot_conf, &state);
+
+    FORT_PROV_DIFF diff;
+    fort_prov_state_diff(&old_state, &state, &diff);
+
+    return fort_prov_diff_apply(engine, boot_conf, &diff);
+}
+
 FORT_API DWORD fort_prov_trans_register(const FORT_PROV_BOOT_CONF boot_conf)
 {
     HANDLE engine;
@@ -576,6 +686,40 @@ FORT_API BOOL fort_prov_get_boot_conf(HANDLE engine, PFORT_PROV_BOOT_CONF boot_c
     return FALSE;
 }
 
+FORT_API DWORD fort_prov_update(
+        HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf, BOOL *flows_removed)
+{
+    FORT_PROV_BOOT_CONF old_boot_conf;
+
+    /* Re-create all on unknown installed state */
+    if (!fort_prov_get_boot_conf(engine, &old_boot_conf)) {
+        *flows_removed = TRUE;
+
+        fort_prov_unregister(engine);
+
+        return fort_prov_register(engine, boot_conf);
+    }
+
+    FORT_PROV_STATE old_state;
+    fort_prov_state_build(old_boot_conf, &old_state);
+
+    FORT_PROV_STATE state;
+    fort_prov_state_build(boot_conf, &state);
+
+    FORT_PROV_DIFF diff;
+    fort_prov_state_diff(&old_state, &state, &diff);
+
+    *flows_removed = fort_prov_diff_flows_removed(&diff);
+
+    /* The flow & reauth filters use the sublayer and callouts */
+    if (*flows_removed) {
+        fort_prov_flow_unregister(engine);
+        fort_prov_unregister_reauth_filters(engine);
+    }
+
+    return fort_prov_diff_apply(engine, boot_conf, &diff);
+}
+
 FORT_API DWORD fort_prov_flow_register(HANDLE engine, BOOL filter_packets)
 {
     DWORD status;
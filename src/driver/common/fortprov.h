@@ -16,6 +16,32 @@ typedef struct fort_prov_boot_conf
     };
 } FORT_PROV_BOOT_CONF, *PFORT_PROV_BOOT_CONF;
 
+/* Provider's objects, the order of items must follow their dependencies */
+#define FORT_PROV_ITEM_PROVIDER        0
+#define FORT_PROV_ITEM_SUBLAYER        1
+#define FORT_PROV_ITEM_CALLOUTS        2 /* 12 callouts */
+#define FORT_PROV_ITEM_BOOT_FILTERS    14 /* 4 boot-time filters */
+#define FORT_PROV_ITEM_PERSIST_FILTERS 18 /* 4 persistent filters */
+#define FORT_PROV_ITEM_CALLOUT_FILTERS 22 /* 4 callout filters */
+#define FORT_PROV_ITEM_COUNT           26
+
+#define FORT_PROV_ITEM_BIT(item)          (1u << (item))
+#define FORT_PROV_ITEMS_MASK(item, count) (((1u << (count)) - 1) << (item))
+
+typedef struct fort_prov_state
+{
+    UINT32 items; /* installed items */
+    UINT32 boot_items; /* items of the boot-time (persistent) variant */
+    UINT32 provider_data; /* boot conf */
+} FORT_PROV_STATE, *PFORT_PROV_STATE;
+
+typedef struct fort_prov_diff
+{
+    UINT32 remove_items;
+    UINT32 add_items;
+    UINT32 boot_items; /* variants of the added items */
+} FORT_PROV_DIFF, *PFORT_PROV_DIFF;
+
 #define fort_prov_open(engine)         FwpmEngineOpen0(NULL, RPC_C_AUTHN_WINNT, NULL, NULL, (engine))
 #define fort_prov_close(engine)        FwpmEngineClose0(engine)
 #define fort_prov_trans_begin(engine)  FwpmTransactionBegin0((engine), 0)
@@ -44,6 +70,18 @@ FORT_API DWORD fort_prov_trans_register(const FORT_PROV_BOOT_CONF boot_conf);
 
 FORT_API BOOL fort_prov_get_boot_conf(HANDLE engine, PFORT_PROV_BOOT_CONF boot_conf);
 
+FORT_API UINT32 fort_prov_item_deps(int item);
+
+FORT_API void fort_prov_state_build(const FORT_PROV_BOOT_CONF boot_conf, PFORT_PROV_STATE state);
+
+FORT_API void fort_prov_state_diff(
+        const PFORT_PROV_STATE old_state, const PFORT_PROV_STATE new_state, PFORT_PROV_DIFF diff);
+
+FORT_API BOOL fort_prov_diff_flows_removed(const PFORT_PROV_DIFF diff);
+
+FORT_API DWORD fort_prov_update(
+        HANDLE engine, const FORT_PROV_BOOT_CONF boot_conf, BOOL *flows_removed);
+
 FORT_API DWORD fort_prov_flow_register(HANDLE engine, BOOL filter_packets);
 
 FORT_API void fort_prov_reauth(HANDLE engine);
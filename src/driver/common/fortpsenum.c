@@ -0,0 +1,180 @@
+/* Fort Firewall Processes Enumeration */
+
+#include "fortpsenum.h"
+
+#define FORT_PSENUM_OFFSET_END ((ULONG) -1)
+
+FORT_API void fort_psenum_init(PFORT_PSENUM psenum, PVOID buffer, ULONG buffer_size)
+{
+    RtlZeroMemory(psenum, sizeof(FORT_PSENUM));
+
+    psenum->buffer = buffer;
+    psenum->buffer_size = buffer_size;
+
+    if (buffer == NULL || buffer_size < sizeof(FORT_SYSTEM_PROCESS)) {
+        psenum->offset = FORT_PSENUM_OFFSET_END;
+        psenum->done = TRUE;
+    }
+}
+
+FORT_API BOOL fort_psenum_is_done(const PFORT_PSENUM psenum)
+{
+    return psenum->done;
+}
+
+static PFORT_SYSTEM_PROCESS fort_psenum_entry_at(const PFORT_PSENUM psenum, ULONG offset)
+{
+    if (offset == FORT_PSENUM_OFFSET_END || offset > psenum->buffer_size
+            || psenum->buffer_size - offset < sizeof(FORT_SYSTEM_PROCESS))
+        return NULL; /* out of buffer */
+
+    return (PFORT_SYSTEM_PROCESS) (psenum->buffer + offset);
+}
+
+static ULONG fort_psenum_next_offset(ULONG offset, const PFORT_SYSTEM_PROCESS process)
+{
+    const ULONG next_offset = process->NextEntryOffset;
+
+    if (next_offset == 0 || offset + next_offset < offset)
+        return FORT_PSENUM_OFFSET_END; /* last entry or overflow */
+
+    return offset + next_offset;
+}
+
+inline static void fort_psenum_entry_fill(
+        PFORT_PSENUM_ENTRY entry, const PFORT_SYSTEM_PROCESS process)
+{
+    entry->process_id = (UINT32) process->ProcessId;
+    entry->parent_process_id = (UINT32) process->ParentProcessId;
+}
+
+FORT_API UINT32 fort_psenum_count(const PFORT_PSENUM psenum)
+{
+    UINT32 count = 0;
+    ULONG offset = psenum->offset;
+
+    for (;;) {
+        const PFORT_SYSTEM_PROCESS process = fort_psenum_entry_at(psenum, offset);
+        if (process == NULL)
+            break;
+
+        ++count;
+
+        offset = fort_psenum_next_offset(offset, process);
+    }
+
+    return count;
+}
+
+static void fort_psenum_pids_sort(PFORT_PSENUM_PID pids, UINT32 pids_n)
+{
+    /* Shell sort: no recursion and no allocations */
+    for (UINT32 gap = pids_n / 2; gap != 0; gap /= 2) {
+        for (UINT32 i = gap; i < pids_n; ++i) {
+            const FORT_PSENUM_PID pid = pids[i];
+
+            UINT32 j = i;
+            for (; j >= gap && pids[j - gap].process_id > pid.process_id; j -= gap) {
+                pids[j] = pids[j - gap];
+            }
+
+            pids[j] = pid;
+        }
+    }
+}
+
+FORT_API void fort_psenum_index(PFORT_PSENUM psenum, PFORT_PSENUM_PID pids, UINT32 pids_n)
+{
+    UINT32 count = 0;
+    ULONG offset = psenum->offset;
+
+    while (count < pids_n) {
+        const PFORT_SYSTEM_PROCESS process = fort_psenum_entry_at(psenum, offset);
+        if (process == NULL)
+            break;
+
+        PFORT_PSENUM_PID pid = &pids[count++];
+        pid->process_id = (UINT32) process->ProcessId;
+        pid->offset = offset;
+
+        offset = fort_psenum_next_offset(offset, process);
+    }
+
+    fort_psenum_pids_sort(pids, count);
+
+    psenum->pids = pids;
+    psenum->pids_n = count;
+}
+
+FORT_API UINT16 fort_psenum_next_batch(
+        PFORT_PSENUM psenum, PFORT_PSENUM_ENTRY entries, UINT16 max_count)
+{
+    UINT16 count = 0;
+    ULONG offset = psenum->offset;
+
+    while (count < max_count) {
+        const PFORT_SYSTEM_PROCESS process = fort_psenum_entry_at(psenum, offset);
+        if (process == NULL) {
+            offset = FORT_PSENUM_OFFSET_END;
+            break;
+        }
+
+        fort_psenum_entry_fill(&entries[count++], process);
+
+        offset = fort_psenum_next_offset(offset, process);
+    }
+
+    psenum->offset = offset;
+
+    if (count != 0) {
+        ++psenum->batches_n;
+        psenum->procs_n += count;
+    }
+
+    if (offset == FORT_PSENUM_OFFSET_END) {
+        psenum->done = TRUE;
+    }
+
+    return count;
+}
+
+static PFORT_PSENUM_PID fort_psenum_pid_find(const PFORT_PSENUM psenum, UINT32 process_id)
+{
+    UINT32 low = 0;
+    UINT32 high = psenum->pids_n;
+
+    while (low < high) {
+        const UINT32 mid = low + (high - low) / 2;
+        const PFORT_PSENUM_PID pid = &psenum->pids[mid];
+
+        if (pid->process_id == process_id)
+            return pid;
+
+        if (pid->process_id < process_id) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return NULL;
+}
+
+FORT_API BOOL fort_psenum_find_pending(
+        const PFORT_PSENUM psenum, UINT32 process_id, PFORT_PSENUM_ENTRY entry)
+{
+    if (psenum->done)
+        return FALSE;
+
+    const PFORT_PSENUM_PID pid = fort_psenum_pid_find(psenum, process_id);
+
+    /* The entries before the current offset are enumerated already */
+    if (pid == NULL || pid->offset < psenum->offset)
+        return FALSE;
+
+    const PFORT_SYSTEM_PROCESS process = fort_psenum_entry_at(psenum, pid->offset);
+
+    fort_psenum_entry_fill(entry, process);
+
+    return TRUE;
+}
@@ -0,0 +1,80 @@
+#ifndef FORTPSENUM_H
+#define FORTPSENUM_H
+
+#include "common.h"
+
+#define FORT_PSENUM_BATCH_SIZE 64
+
+/* Layout of SYSTEM_PROCESS_INFORMATION */
+typedef struct fort_system_process
+{
+    ULONG NextEntryOffset;
+    ULONG NumberOfThreads;
+    ULONG Reserved1[6];
+    LARGE_INTEGER CreateTime;
+    LARGE_INTEGER UserTime;
+    LARGE_INTEGER KernelTime;
+    struct
+    {
+        USHORT Length;
+        USHORT MaximumLength;
+        PWSTR Buffer;
+    } ImageName;
+    LONG BasePriority;
+    SIZE_T ProcessId;
+    SIZE_T ParentProcessId;
+    ULONG HandleCount;
+    ULONG SessionId;
+} FORT_SYSTEM_PROCESS, *PFORT_SYSTEM_PROCESS;
+
+typedef struct fort_psenum_entry
+{
+    UINT32 process_id;
+    UINT32 parent_process_id;
+} FORT_PSENUM_ENTRY, *PFORT_PSENUM_ENTRY;
+
+typedef struct fort_psenum_pid
+{
+    UINT32 process_id;
+    ULONG offset; /* of the entry */
+} FORT_PSENUM_PID, *PFORT_PSENUM_PID;
+
+typedef struct fort_psenum
+{
+    PUCHAR buffer;
+    ULONG buffer_size;
+
+    PFORT_PSENUM_PID pids; /* sorted by process id for the pending lookups */
+    UINT32 pids_n;
+
+    ULONG offset; /* of the next not enumerated entry */
+
+    UCHAR volatile done;
+
+    UINT32 batches_n; /* enumerated batches */
+    UINT32 procs_n; /* enumerated processes */
+} FORT_PSENUM, *PFORT_PSENUM;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API void fort_psenum_init(PFORT_PSENUM psenum, PVOID buffer, ULONG buffer_size);
+
+FORT_API BOOL fort_psenum_is_done(const PFORT_PSENUM psenum);
+
+FORT_API UINT32 fort_psenum_count(const PFORT_PSENUM psenum);
+
+FORT_API void fort_psenum_index(PFORT_PSENUM psenum, PFORT_PSENUM_PID pids, UINT32 pids_n);
+
+FORT_API UINT16 fort_psenum_next_batch(
+        PFORT_PSENUM psenum, PFORT_PSENUM_ENTRY entries, UINT16 max_count);
+
+FORT_API BOOL fort_psenum_find_pending(
+        const PFORT_PSENUM psenum, UINT32 process_id, PFORT_PSENUM_ENTRY entry);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTPSENUM_H
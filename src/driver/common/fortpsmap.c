@@ -0,0 +1,135 @@
+/* Fort Firewall Process Map */
+
+#include "fortpsmap.h"
+
+#define fort_psmap_bucket(map, hash) (&(map)->buckets[(hash) & (map)->buckets_mask])
+
+#define fort_psmap_read_next(link)                                                                 \
+    ((PFORT_PSMAP_NODE) ReadPointerAcquire((PVOID const volatile *) (link)))
+
+FORT_API UINT32 fort_psmap_hash(UINT32 pid)
+{
+    /* Thomas Wang's integer hash, as tommy_inthash_u32() */
+    pid -= pid << 6;
+    pid ^= pid >> 17;
+    pid -= pid << 9;
+    pid ^= pid << 4;
+    pid -= pid << 3;
+    pid ^= pid << 10;
+    pid ^= pid >> 15;
+
+    return pid;
+}
+
+FORT_API void fort_psmap_init(
+        PFORT_PSMAP map, PFORT_PSMAP_NODE volatile *buckets, UINT32 buckets_count)
+{
+    RtlZeroMemory(map, sizeof(FORT_PSMAP));
+    RtlZeroMemory((PVOID) buckets, buckets_count * sizeof(PFORT_PSMAP_NODE));
+
+    map->buckets_mask = buckets_count - 1;
+    map->buckets = buckets;
+}
+
+FORT_API UINT32 fort_psmap_read_begin(PFORT_PSMAP map, UINT32 slot)
+{
+    slot &= (FORT_PSMAP_READER_SLOTS - 1);
+
+    PFORT_PSMAP_READERS readers = &map->readers[slot];
+
+    for (;;) {
+        const LONG epoch = ReadAcquire(&map->epoch);
+        const UINT32 parity = epoch & 1;
+
+        InterlockedIncrement(&readers->count[parity]);
+
+        /* The epoch could be advanced before the reader was counted */
+        if (ReadAcquire(&map->epoch) == epoch)
+            return (slot << 1) | parity;
+
+        InterlockedDecrement(&readers->count[parity]);
+    }
+}
+
+FORT_API void fort_psmap_read_end(PFORT_PSMAP map, UINT32 read_token)
+{
+    PFORT_PSMAP_READERS readers = &map->readers[read_token >> 1];
+
+    InterlockedDecrement(&readers->count[read_token & 1]);
+}
+
+FORT_API PFORT_PSMAP_NODE fort_psmap_find(PFORT_PSMAP map, UINT32 pid, UINT32 hash)
+{
+    PFORT_PSMAP_NODE node = fort_psmap_read_next(fort_psmap_bucket(map, hash));
+
+    while (node != NULL) {
+        if (node->pid == pid)
+            return node;
+
+        node = fort_psmap_read_next(&node->next);
+    }
+
+    return NULL;
+}
+
+FORT_API void fort_psmap_insert(PFORT_PSMAP map, PFORT_PSMAP_NODE node, UINT32 pid, UINT32 hash)
+{
+    PFORT_PSMAP_NODE volatile *bucket = fort_psmap_bucket(map, hash);
+
+    node->hash = hash;
+    node->pid = pid;
+    node->next = *bucket;
+    node->retired_next = NULL;
+
+    /* Publish the initialized node */
+    WritePointerRelease((PVOID volatile *) bucket, node);
+
+    ++map->count;
+}
+
+FORT_API void fort_psmap_remove(PFORT_PSMAP map, PFORT_PSMAP_NODE node)
+{
+    PFORT_PSMAP_NODE volatile *link = fort_psmap_bucket(map, node->hash);
+
+    while (*link != node) {
+        link = &(*link)->next;
+    }
+
+    /* Keep the node's next link: the current readers may walk through it */
+    WritePointerRelease((PVOID volatile *) link, node->next);
+
+    const UINT32 parity = map->epoch & 1;
+
+    node->retired_next = map->retired[parity];
+    map->retired[parity] = node;
+
+    --map->count;
+}
+
+static LONG fort_psmap_readers_count(PFORT_PSMAP map, UINT32 parity)
+{
+    LONG count = 0;
+
+    for (int i = 0; i < FORT_PSMAP_READER_SLOTS; ++i) {
+        count += ReadAcquire(&map->readers[i].count[parity]);
+    }
+
+    return count;
+}
+
+FORT_API PFORT_PSMAP_NODE fort_psmap_reclaim(PFORT_PSMAP map)
+{
+    const LONG epoch = map->epoch;
+    const UINT32 old_parity = (epoch + 1) & 1; /* parity of the previous epoch */
+
+    /* The readers of the previous epoch could still see nodes retired in it */
+    if (fort_psmap_readers_count(map, old_parity) != 0)
+        return NULL;
+
+    PFORT_PSMAP_NODE nodes = map->retired[old_parity];
+    map->retired[old_parity] = NULL;
+
+    InterlockedExchange(&map->epoch, (LONG) ((ULONG) epoch + 1));
+
+    return nodes;
+}
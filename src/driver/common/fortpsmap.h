@@ -0,0 +1,70 @@
+#ifndef FORTPSMAP_H
+#define FORTPSMAP_H
+
+#include "common.h"
+
+#define FORT_PSMAP_BUCKET_COUNT 1024 /* must be power of 2 */
+#define FORT_PSMAP_READER_SLOTS 32 /* must be power of 2 */
+
+/*
+ * Process Id -> Node map with lock-free lookups.
+ *
+ * Writers (insert/remove/reclaim) must be serialized by the caller.
+ * Readers enter an epoch, removed nodes are kept intact until all readers
+ * of the epoch of their removal are gone, then fort_psmap_reclaim() returns them.
+ */
+
+typedef struct fort_psmap_node
+{
+    struct fort_psmap_node *volatile next; /* bucket's chain */
+    struct fort_psmap_node *retired_next; /* retired list */
+
+    UINT32 hash;
+    UINT32 pid;
+} FORT_PSMAP_NODE, *PFORT_PSMAP_NODE;
+
+typedef struct DECLSPEC_CACHEALIGN fort_psmap_readers
+{
+    LONG volatile count[2]; /* by epoch's parity */
+} FORT_PSMAP_READERS, *PFORT_PSMAP_READERS;
+
+typedef struct fort_psmap
+{
+    LONG volatile epoch;
+
+    UINT32 count;
+
+    UINT32 buckets_mask;
+    PFORT_PSMAP_NODE volatile *buckets;
+
+    PFORT_PSMAP_NODE retired[2]; /* by epoch's parity */
+
+    FORT_PSMAP_READERS readers[FORT_PSMAP_READER_SLOTS];
+} FORT_PSMAP, *PFORT_PSMAP;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API UINT32 fort_psmap_hash(UINT32 pid);
+
+FORT_API void fort_psmap_init(
+        PFORT_PSMAP map, PFORT_PSMAP_NODE volatile *buckets, UINT32 buckets_count);
+
+FORT_API UINT32 fort_psmap_read_begin(PFORT_PSMAP map, UINT32 slot);
+
+FORT_API void fort_psmap_read_end(PFORT_PSMAP map, UINT32 read_token);
+
+FORT_API PFORT_PSMAP_NODE fort_psmap_find(PFORT_PSMAP map, UINT32 pid, UINT32 hash);
+
+FORT_API void fort_psmap_insert(PFORT_PSMAP map, PFORT_PSMAP_NODE node, UINT32 pid, UINT32 hash);
+
+FORT_API void fort_psmap_remove(PFORT_PSMAP map, PFORT_PSMAP_NODE node);
+
+FORT_API PFORT_PSMAP_NODE fort_psmap_reclaim(PFORT_PSMAP map);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTPSMAP_H
@@ -0,0 +1,371 @@
+/* Fort Firewall Services Table */
+
+#include "fortsvctab.h"
+
+#define FORT_SVCTAB_INDEX_MIN 16
+
+#define FORT_SVCTAB_COMPACT_RATIO 4 /* compact, when removed > live / ratio */
+
+#define fort_svctab_lower(c) (((c) >= L'A' && (c) <= L'Z') ? ((c) + (L'a' - L'A')) : (c))
+
+#define fort_svctab_index_next(tab, slot) (((slot) + 1) & (tab)->index_mask)
+
+typedef void (*FORT_SVCTAB_SERVICE_FUNC)(PVOID ctx, UINT32 process_id, PCWCH name, UINT16 name_len);
+
+FORT_API UINT32 fort_svctab_pid_hash(UINT32 process_id)
+{
+    /* Process Ids are multiples of 4 */
+    return process_id >> 2;
+}
+
+FORT_API UINT32 fort_svctab_name_hash(PCWCH name, UINT16 name_len)
+{
+    /* FNV-1a of lower-cased characters */
+    UINT32 hash = 2166136261U;
+
+    for (UINT16 i = 0; i < name_len / sizeof(WCHAR); ++i) {
+        hash ^= (UINT16) fort_svctab_lower(name[i]);
+        hash *= 16777619U;
+    }
+
+    return hash;
+}
+
+static UINT32 fort_svctab_index_size(UINT16 count_max)
+{
+    UINT32 size = FORT_SVCTAB_INDEX_MIN;
+
+    /* Keep the load factor not greater than 1/2 */
+    while (size < (UINT32) count_max * 2) {
+        size <<= 1;
+    }
+
+    return size;
+}
+
+static ULONG fort_svctab_size(UINT16 count_max, UINT32 names_max)
+{
+    const UINT32 index_size = fort_svctab_index_size(count_max);
+
+    return FORT_ALIGN_SIZE(sizeof(FORT_SVCTAB), sizeof(PVOID))
+            + FORT_ALIGN_SIZE(count_max * sizeof(FORT_SVCTAB_ENTRY), sizeof(PVOID))
+            + 2 * index_size * sizeof(UINT16) + names_max;
+}
+
+static PFORT_SVCTAB fort_svctab_init(PVOID buffer, UINT16 count_max, UINT32 names_max)
+{
+    const UINT32 index_size = fort_svctab_index_size(count_max);
+
+    PFORT_SVCTAB tab = buffer;
+    PCHAR data = (PCHAR) buffer + FORT_ALIGN_SIZE(sizeof(FORT_SVCTAB), sizeof(PVOID));
+
+    RtlZeroMemory(tab, fort_svctab_size(count_max, names_max));
+
+    tab->count_max = count_max;
+    tab->index_mask = index_size - 1;
+    tab->names_max = names_max;
+
+    tab->entries = (PFORT_SVCTAB_ENTRY) data;
+    data += FORT_ALIGN_SIZE(count_max * sizeof(FORT_SVCTAB_ENTRY), sizeof(PVOID));
+
+    tab->pid_index = (UINT16 *) data;
+    data += index_size * sizeof(UINT16);
+
+    tab->name_index = (UINT16 *) data;
+    data += index_size * sizeof(UINT16);
+
+    tab->names = data;
+
+    return tab;
+}
+
+static BOOL fort_svctab_name_equal(PCWCH name, PCWCH tab_name, UINT16 name_len)
+{
+    for (UINT16 i = 0; i < name_len / sizeof(WCHAR); ++i) {
+        if (fort_svctab_lower(name[i]) != tab_name[i])
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+static PFORT_SVCTAB_ENTRY fort_svctab_find_name_hash(
+        const PFORT_SVCTAB tab, PCWCH name, UINT16 name_len, UINT32 name_hash)
+{
+    UINT32 slot = name_hash & tab->index_mask;
+
+    for (;;) {
+        const UINT16 index = tab->name_index[slot];
+        if (index == 0)
+            break;
+
+        const PFORT_SVCTAB_ENTRY entry = &tab->entries[index - 1];
+
+        if (entry->name_hash == name_hash && entry->name_len == name_len
+                && fort_svctab_name_equal(name, fort_svctab_entry_name(tab, entry), name_len))
+            return entry;
+
+        slot = fort_svctab_index_next(tab, slot);
+    }
+
+    return NULL;
+}
+
+static void fort_svctab_index_add(const PFORT_SVCTAB tab, UINT16 *index, UINT32 hash, UINT16 value)
+{
+    UINT32 slot = hash & tab->index_mask;
+
+    while (index[slot] != 0) {
+        slot = fort_svctab_index_next(tab, slot);
+    }
+
+    index[slot] = value;
+}
+
+/* The first added name wins */
+static void fort_svctab_add(PFORT_SVCTAB tab, UINT32 process_id, PCWCH name, UINT16 name_len)
+{
+    if (name_len == 0 || tab->count >= tab->count_max
+            || tab->names_size + name_len > tab->names_max)
+        return;
+
+    const UINT32 name_hash = fort_svctab_name_hash(name, name_len);
+
+    if (fort_svctab_find_name_hash(tab, name, name_len, name_hash) != NULL)
+        return;
+
+    const UINT16 index = tab->count++;
+
+    PFORT_SVCTAB_ENTRY entry = &tab->entries[index];
+    entry->process_id = process_id;
+    entry->name_hash = name_hash;
+    entry->name_off = tab->names_size;
+    entry->name_len = name_len;
+
+    PWCH tab_name = fort_svctab_entry_name(tab, entry);
+    for (UINT16 i = 0; i < name_len / sizeof(WCHAR); ++i) {
+        tab_name[i] = fort_svctab_lower(name[i]);
+    }
+
+    tab->names_size += name_len;
+
+    fort_svctab_index_add(tab, tab->name_index, name_hash, index + 1);
+
+    if (process_id != 0) {
+        fort_svctab_index_add(tab, tab->pid_index, fort_svctab_pid_hash(process_id), index + 1);
+    }
+}
+
+static BOOL fort_svctab_list_walk(const PFORT_SERVICE_INFO_LIST services, ULONG data_len,
+        FORT_SVCTAB_SERVICE_FUNC func, PVOID ctx)
+{
+    PCHAR data = (PCHAR) services->data;
+    const PCHAR end_data = data + data_len;
+
+    UINT16 n = services->services_n;
+    while (n-- > 0) {
+        const PFORT_SERVICE_INFO service = (PFORT_SERVICE_INFO) data;
+
+        if (data + FORT_SERVICE_INFO_NAME_OFF > end_data)
+            return FALSE;
+
+        const UINT16 name_len = service->name_len;
+
+        if (name_len > FORT_SERVICE_INFO_NAME_MAX_SIZE
+                || data + FORT_SERVICE_INFO_NAME_OFF + name_len > end_data)
+            return FALSE;
+
+        func(ctx, service->process_id, service->name, name_len);
+
+        data += FORT_SERVICE_INFO_NAME_OFF + FORT_CONF_STR_DATA_SIZE(name_len);
+    }
+
+    return TRUE;
+}
+
+typedef struct fort_svctab_list_stat
+{
+    UINT32 count;
+    UINT32 names_size;
+} FORT_SVCTAB_LIST_STAT, *PFORT_SVCTAB_LIST_STAT;
+
+static void fort_svctab_list_stat_add(PVOID ctx, UINT32 process_id, PCWCH name, UINT16 name_len)
+{
+    UNUSED(process_id);
+    UNUSED(name);
+
+    PFORT_SVCTAB_LIST_STAT stat = ctx;
+
+    ++stat->count;
+    stat->names_size += name_len;
+}
+
+static void fort_svctab_list_add(PVOID ctx, UINT32 process_id, PCWCH name, UINT16 name_len)
+{
+    fort_svctab_add((PFORT_SVCTAB) ctx, process_id, name, name_len);
+}
+
+inline static BOOL fort_svctab_is_delta(
+        const PFORT_SVCTAB old_tab, const PFORT_SERVICE_INFO_LIST services)
+{
+    return old_tab != NULL && (services->flags & FORT_SERVICE_INFO_LIST_DELTA) != 0;
+}
+
+static BOOL fort_svctab_build_stat(const PFORT_SVCTAB old_tab,
+        const PFORT_SERVICE_INFO_LIST services, ULONG data_len, PFORT_SVCTAB_LIST_STAT stat)
+{
+    stat->count = 0;
+    stat->names_size = 0;
+
+    if (!fort_svctab_list_walk(services, data_len, &fort_svctab_list_stat_add, stat))
+        return FALSE;
+
+    if (fort_svctab_is_delta(old_tab, services)) {
+        for (UINT16 i = 0; i < old_tab->count; ++i) {
+            const PFORT_SVCTAB_ENTRY entry = &old_tab->entries[i];
+
+            if (entry->process_id == 0)
+                continue; /* removed */
+
+            ++stat->count;
+            stat->names_size += entry->name_len;
+        }
+    }
+
+    return stat->count <= 0xFFFF;
+}
+
+FORT_API ULONG fort_svctab_build_size(
+        const PFORT_SVCTAB old_tab, const PFORT_SERVICE_INFO_LIST services, ULONG data_len)
+{
+    FORT_SVCTAB_LIST_STAT stat;
+    if (!fort_svctab_build_stat(old_tab, services, data_len, &stat))
+        return 0;
+
+    return fort_svctab_size((UINT16) stat.count, stat.names_size);
+}
+
+FORT_API PFORT_SVCTAB fort_svctab_build(PVOID buffer, const PFORT_SVCTAB old_tab,
+        const PFORT_SERVICE_INFO_LIST services, ULONG data_len)
+{
+    FORT_SVCTAB_LIST_STAT stat;
+    if (!fort_svctab_build_stat(old_tab, services, data_len, &stat))
+        return NULL;
+
+    PFORT_SVCTAB tab = fort_svctab_init(buffer, (UINT16) stat.count, stat.names_size);
+
+    /* The list's services replace the old ones */
+    fort_svctab_list_walk(services, data_len, &fort_svctab_list_add, tab);
+
+    if (fort_svctab_is_delta(old_tab, services)) {
+        for (UINT16 i = 0; i < old_tab->count; ++i) {
+            const PFORT_SVCTAB_ENTRY entry = &old_tab->entries[i];
+
+            if (entry->process_id == 0)
+                continue; /* removed */
+
+            fort_svctab_add(tab, entry->process_id, fort_svctab_entry_name(old_tab, entry),
+                    entry->name_len);
+        }
+    }
+
+    return tab;
+}
+
+FORT_API PFORT_SVCTAB_ENTRY fort_svctab_find_pid(const PFORT_SVCTAB tab, UINT32 process_id)
+{
+    if (process_id == 0)
+        return NULL;
+
+    UINT32 slot = fort_svctab_pid_hash(process_id) & tab->index_mask;
+
+    for (;;) {
+        const UINT16 index = tab->pid_index[slot];
+        if (index == 0)
+            break;
+
+        const PFORT_SVCTAB_ENTRY entry = &tab->entries[index - 1];
+
+        if (entry->process_id == process_id)
+            return entry;
+
+        slot = fort_svctab_index_next(tab, slot);
+    }
+
+    return NULL;
+}
+
+FORT_API PFORT_SVCTAB_ENTRY fort_svctab_find_name(
+        const PFORT_SVCTAB tab, PCWCH name, UINT16 name_len)
+{
+    const UINT32 name_hash = fort_svctab_name_hash(name, name_len);
+
+    return fort_svctab_find_name_hash(tab, name, name_len, name_hash);
+}
+
+FORT_API PWCH fort_svctab_entry_name(const PFORT_SVCTAB tab, const PFORT_SVCTAB_ENTRY entry)
+{
+    return (PWCH) (tab->names + entry->name_off);
+}
+
+static void fort_svctab_compact(PFORT_SVCTAB tab)
+{
+    const UINT32 index_size = tab->index_mask + 1;
+
+    RtlZeroMemory(tab->pid_index, index_size * sizeof(UINT16));
+    RtlZeroMemory(tab->name_index, index_size * sizeof(UINT16));
+
+    UINT16 count = 0;
+    UINT32 names_size = 0;
+
+    /* Move the live entries and their names down in place */
+    for (UINT16 i = 0; i < tab->count; ++i) {
+        const FORT_SVCTAB_ENTRY old_entry = tab->entries[i];
+
+        if (old_entry.process_id == 0)
+            continue; /* removed */
+
+        const UINT16 index = count++;
+
+        PFORT_SVCTAB_ENTRY entry = &tab->entries[index];
+        *entry = old_entry;
+        entry->name_off = names_size;
+
+        RtlMoveMemory(tab->names + names_size, tab->names + old_entry.name_off,
+                old_entry.name_len);
+
+        names_size += old_entry.name_len;
+
+        fort_svctab_index_add(tab, tab->name_index, entry->name_hash, index + 1);
+        fort_svctab_index_add(
+                tab, tab->pid_index, fort_svctab_pid_hash(entry->process_id), index + 1);
+    }
+
+    tab->count = count;
+    tab->names_size = names_size;
+    tab->removed_count = 0;
+}
+
+FORT_API BOOL fort_svctab_remove_pid(PFORT_SVCTAB tab, UINT32 process_id)
+{
+    BOOL removed = FALSE;
+
+    /* A shared process hosts several services */
+    PFORT_SVCTAB_ENTRY entry;
+    while ((entry = fort_svctab_find_pid(tab, process_id)) != NULL) {
+        /* Keep the pid index's slot occupied to not break the probing chains */
+        entry->process_id = 0;
+
+        ++tab->removed_count;
+
+        removed = TRUE;
+    }
+
+    if (removed
+            && tab->removed_count * FORT_SVCTAB_COMPACT_RATIO
+                    > tab->count - tab->removed_count) {
+        fort_svctab_compact(tab);
+    }
+
+    return removed;
+}
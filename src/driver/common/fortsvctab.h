@@ -0,0 +1,73 @@
+#ifndef FORTSVCTAB_H
+#define FORTSVCTAB_H
+
+#include "common.h"
+
+#include "fortconf.h"
+
+/*
+ * Service Name <-> Process Id table.
+ *
+ * Built at once from the FORT_SERVICE_INFO_LIST (merged with the previous table
+ * for FORT_SERVICE_INFO_LIST_DELTA lists) and indexed by process id and by name
+ * with linear probing.
+ * Entries with zero process id are known as removed services.
+ * Entries of exited processes are compacted, when there are too many of them.
+ */
+
+typedef struct fort_svctab_entry
+{
+    UINT32 process_id;
+    UINT32 name_hash;
+    UINT32 name_off; /* in names buffer */
+    UINT16 name_len; /* in bytes */
+} FORT_SVCTAB_ENTRY, *PFORT_SVCTAB_ENTRY;
+
+typedef struct fort_svctab
+{
+    UINT16 count;
+    UINT16 count_max;
+
+    UINT16 removed_count; /* entries of exited processes */
+
+    UINT32 index_mask; /* index size - 1 */
+
+    UINT32 names_size;
+    UINT32 names_max;
+
+    PFORT_SVCTAB_ENTRY entries;
+
+    UINT16 *pid_index; /* entry index + 1 */
+    UINT16 *name_index; /* entry index + 1 */
+
+    PCHAR names; /* lower-case */
+} FORT_SVCTAB, *PFORT_SVCTAB;
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API UINT32 fort_svctab_pid_hash(UINT32 process_id);
+
+FORT_API UINT32 fort_svctab_name_hash(PCWCH name, UINT16 name_len);
+
+FORT_API ULONG fort_svctab_build_size(
+        const PFORT_SVCTAB old_tab, const PFORT_SERVICE_INFO_LIST services, ULONG data_len);
+
+FORT_API PFORT_SVCTAB fort_svctab_build(PVOID buffer, const PFORT_SVCTAB old_tab,
+        const PFORT_SERVICE_INFO_LIST services, ULONG data_len);
+
+FORT_API PFORT_SVCTAB_ENTRY fort_svctab_find_pid(const PFORT_SVCTAB tab, UINT32 process_id);
+
+FORT_API PFORT_SVCTAB_ENTRY fort_svctab_find_name(
+        const PFORT_SVCTAB tab, PCWCH name, UINT16 name_len);
+
+FORT_API PWCH fort_svctab_entry_name(const PFORT_SVCTAB tab, const PFORT_SVCTAB_ENTRY entry);
+
+FORT_API BOOL fort_svctab_remove_pid(PFORT_SVCTAB tab, UINT32 process_id);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTSVCTAB_H
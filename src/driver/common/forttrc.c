@@ -0,0 +1,135 @@
+/* Fort Firewall Binary Trace Ring */
+
+#include "forttrc.h"
+
+FORT_API void fort_trc_ring_init(
+        PFORT_TRC_RING ring, PFORT_TRC_RECORD records, UINT32 count, INT64 ticks_freq)
+{
+    RtlZeroMemory(ring, sizeof(FORT_TRC_RING));
+
+    ring->ticks_freq = ticks_freq;
+
+    /* The count must be power of 2 */
+    if (records == NULL || count == 0 || (count & (count - 1)) != 0)
+        return;
+
+    RtlZeroMemory(records, FORT_TRC_RECORDS_SIZE(count));
+
+    ring->mask = count - 1;
+    ring->records = records;
+}
+
+FORT_API void fort_trc_ring_write(PFORT_TRC_RING ring, UINT16 event_id, UINT16 cpu,
+        INT64 timestamp, UINT32 d0, UINT32 d1, UINT32 d2)
+{
+    if (ring->records == NULL)
+        return;
+
+    const INT64 seq = InterlockedIncrement64(&ring->head) - 1;
+
+    PFORT_TRC_RECORD rec = &ring->records[seq & ring->mask];
+
+    /* Invalidate the overwritten record for the reader */
+    InterlockedExchange64(&rec->seq, 0);
+
+    rec->timestamp = timestamp;
+    rec->event_id = event_id;
+    rec->cpu = cpu;
+    rec->data[0] = d0;
+    rec->data[1] = d1;
+    rec->data[2] = d2;
+
+    /* Commit the record */
+    InterlockedExchange64(&rec->seq, seq + 1);
+}
+
+static BOOL fort_trc_ring_read_record(
+        PFORT_TRC_RING ring, INT64 seq, PFORT_TRC_RECORD out, BOOL *overwritten)
+{
+    const PFORT_TRC_RECORD rec = &ring->records[seq & ring->mask];
+
+    const INT64 rec_seq = ReadAcquire64(&rec->seq);
+
+    if (rec_seq == seq + 1) {
+        RtlCopyMemory(out, rec, sizeof(FORT_TRC_RECORD));
+
+        /* The writer could overwrite the record while it was copied */
+        MemoryBarrier();
+
+        if (ReadAcquire64(&rec->seq) == rec_seq) {
+            out->seq = seq;
+            return TRUE;
+        }
+    }
+
+    /* Not committed yet or already overwritten */
+    const INT64 head = ReadAcquire64(&ring->head);
+
+    *overwritten = (head - seq > (INT64) ring->mask + 1);
+
+    return FALSE;
+}
+
+static UINT32 fort_trc_ring_read_records(
+        PFORT_TRC_RING ring, PFORT_TRC_RECORD out, UINT32 max_count)
+{
+    const INT64 capacity = (INT64) ring->mask + 1;
+    const INT64 head = ReadAcquire64(&ring->head);
+
+    INT64 tail = ring->tail;
+
+    /* Skip the overwritten records */
+    if (head - tail > capacity) {
+        ring->lost += (UINT32) (head - capacity - tail);
+        tail = head - capacity;
+    }
+
+    UINT32 count = 0;
+
+    while (tail < head && count < max_count) {
+        BOOL overwritten = FALSE;
+
+        if (fort_trc_ring_read_record(ring, tail, &out[count], &overwritten)) {
+            ++count;
+        } else if (overwritten) {
+            ++ring->lost;
+        } else {
+            break; /* the writer is in progress */
+        }
+
+        ++tail;
+    }
+
+    ring->tail = tail;
+
+    return count;
+}
+
+FORT_API UINT32 fort_trc_ring_read(PFORT_TRC_RING ring, PVOID out, UINT32 out_len)
+{
+    if (out_len < FORT_TRC_RECORDS_OFF)
+        return 0;
+
+    PFORT_TRC_HEADER header = out;
+    RtlZeroMemory(header, sizeof(FORT_TRC_HEADER));
+
+    header->version = FORT_TRC_VERSION;
+    header->record_size = sizeof(FORT_TRC_RECORD);
+    header->ticks_freq = ring->ticks_freq;
+
+    /* Only one reader at a time */
+    if (ring->records == NULL || InterlockedCompareExchange(&ring->reading, 1, 0) != 0)
+        return FORT_TRC_RECORDS_OFF;
+
+    const UINT32 max_count = (out_len - FORT_TRC_RECORDS_OFF) / sizeof(FORT_TRC_RECORD);
+
+    header->count = fort_trc_ring_read_records(
+            ring, (PFORT_TRC_RECORD) ((PCHAR) out + FORT_TRC_RECORDS_OFF), max_count);
+
+    header->lost = ring->lost;
+    ring->lost = 0;
+
+    InterlockedExchange(&ring->reading, 0);
+
+    return FORT_TRC_RECORDS_OFF + FORT_TRC_RECORDS_SIZE(header->count);
+}
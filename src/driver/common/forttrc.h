@@ -0,0 +1,87 @@
+#ifndef FORTTRC_H
+#define FORTTRC_H
+
+#include "common.h"
+
+#define FORT_TRC_VERSION 1
+
+/* Trace events */
+#define FORT_TRC_CONF_APPLY     1 /* data: conf size, status */
+#define FORT_TRC_REAUTH         2 /* data: status */
+#define FORT_TRC_FLOW_ASSOCIATE 3 /* data: flow id low, flow id high, process id */
+#define FORT_TRC_FLOW_DELETE    4 /* data: flow id low, flow id high */
+#define FORT_TRC_SHAPER_ENQUEUE 5 /* data: queue index, data length, queued bytes */
+#define FORT_TRC_SHAPER_DEQUEUE 6 /* data: queue index, packets count, queued bytes */
+#define FORT_TRC_BUFFER_FLUSH   7 /* data: size */
+#define FORT_TRC_EVENT_MAX      FORT_TRC_BUFFER_FLUSH
+
+#define FORT_TRC_DATA_COUNT 3
+
+#define FORT_TRC_RING_RECORDS 4096 /* must be power of 2 */
+
+/*
+ * Fixed-size ring of binary trace records.
+ *
+ * Writers are lock-free and could run concurrently at any IRQL <= DISPATCH_LEVEL.
+ * The oldest records are overwritten when the ring is full and counted as lost on read.
+ */
+
+typedef struct fort_trc_record
+{
+    INT64 volatile seq; /* in ring: sequence number + 1 when committed, 0 while writing */
+    INT64 timestamp; /* performance counter ticks */
+
+    UINT16 event_id;
+    UINT16 cpu;
+
+    UINT32 data[FORT_TRC_DATA_COUNT];
+} FORT_TRC_RECORD, *PFORT_TRC_RECORD;
+
+/* Header of FORT_IOCTL_GETTRACE output, followed by the records */
+typedef struct fort_trc_header
+{
+    UINT16 version;
+    UINT16 record_size;
+
+    UINT32 count;
+    UINT32 lost; /* records overwritten since the last read */
+    UINT32 reserved;
+
+    INT64 ticks_freq; /* per second */
+} FORT_TRC_HEADER, *PFORT_TRC_HEADER;
+
+typedef struct fort_trc_ring
+{
+    INT64 volatile head; /* next sequence number to write */
+    INT64 tail; /* next sequence number to read */
+
+    UINT32 mask;
+    UINT32 lost;
+
+    LONG volatile reading;
+
+    INT64 ticks_freq;
+
+    PFORT_TRC_RECORD records;
+} FORT_TRC_RING, *PFORT_TRC_RING;
+
+#define FORT_TRC_RECORDS_OFF sizeof(FORT_TRC_HEADER)
+#define FORT_TRC_RECORDS_SIZE(n) ((n) * sizeof(FORT_TRC_RECORD))
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+FORT_API void fort_trc_ring_init(
+        PFORT_TRC_RING ring, PFORT_TRC_RECORD records, UINT32 count, INT64 ticks_freq);
+
+FORT_API void fort_trc_ring_write(PFORT_TRC_RING ring, UINT16 event_id, UINT16 cpu,
+        INT64 timestamp, UINT32 d0, UINT32 d1, UINT32 d2);
+
+FORT_API UINT32 fort_trc_ring_read(PFORT_TRC_RING ring, PVOID out, UINT32 out_len);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
+
+#endif // FORTTRC_H
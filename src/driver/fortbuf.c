@@ -9,6 +9,8 @@
 
 #define FORT_BUFFER_POOL_TAG 'BwfF'
 
+#define FORT_BUFFER_IP_SUM_MASK (FORT_BUFFER_IP_SUM_COUNT - 1)
+
 static PFORT_BUFFER_DATA fort_buffer_data_new(PFORT_BUFFER buf)
 {
     PFORT_BUFFER_DATA data = buf->data_free;
@@ -83,6 +85,10 @@ FORT_API void fort_buffer_close(PFORT_BUFFER buf)
 {
     fort_buffer_data_del(buf->data_head);
     fort_buffer_data_del(buf->data_free);
+
+    if (buf->ip_sums != NULL) {
+        fort_mem_free(buf->ip_sums, FORT_BUFFER_POOL_TAG);
+    }
 }
 
 FORT_API void fort_buffer_clear(PFORT_BUFFER buf)
@@ -95,6 +101,7 @@ FORT_API void fort_buffer_clear(PFORT_BUFFER buf)
     buf->data_head = NULL;
     buf->data_tail = NULL;
     buf->data_free = NULL;
+    buf->ip_sums = NULL;
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
@@ -130,6 +137,7 @@ inline static NTSTATUS fort_buffer_prepare_new(PFORT_BUFFER buf, UINT32 len, PCH
     if (data == NULL) {
         LOG("Buffer OOM: len=%d\n", len);
         TRACE(FORT_BUFFER_OOM, STATUS_INSUFFICIENT_RESOURCES, len, 0);
+        fort_device_metrics_inc(FORT_METRICS_LOG_OVERFLOW);
         return STATUS_INSUFFICIENT_RESOURCES;
     }
 
@@ -180,10 +188,144 @@ FORT_API NTSTATUS fort_buffer_blocked_write(PFORT_BUFFER buf, BOOL blocked, UINT
     return status;
 }
 
+static INT64 fort_buffer_unix_time(void)
+{
+    LARGE_INTEGER system_time;
+    KeQuerySystemTime(&system_time);
+
+    return fort_system_to_unix_time(system_time.QuadPart);
+}
+
+static tommy_key_t fort_buffer_ip_sum_hash(BOOL isIPv6, BOOL inbound, UCHAR block_reason,
+        UCHAR ip_proto, UINT16 remote_port, const UINT32 *remote_ip, UINT32 pid)
+{
+    const UINT32 opt = remote_port | ((UINT32) ip_proto << 16) | ((UINT32) block_reason << 24);
+
+    tommy_key_t hash = tommy_inthash_u32(pid) ^ tommy_inthash_u32(opt);
+    hash = tommy_hash_u32(hash, remote_ip, FORT_IP_ADDR_SIZE(isIPv6));
+
+    return hash ^ (isIPv6 ? 1 : 0) ^ (inbound ? 2 : 0);
+}
+
+inline static BOOL fort_buffer_ip_sum_equal(PFORT_BUFFER_IP_SUM sum, tommy_key_t hash,
+        BOOL isIPv6, BOOL inbound, UCHAR block_reason, UCHAR ip_proto, UINT16 remote_port,
+        const UINT32 *remote_ip, UINT32 pid)
+{
+    return sum->hash == hash && sum->pid == pid && sum->remote_port == remote_port
+            && sum->ip_proto == ip_proto && sum->block_reason == block_reason
+            && sum->isIPv6 == (UCHAR) isIPv6 && sum->inbound == (UCHAR) inbound
+            && RtlEqualMemory(&sum->remote_ip, remote_ip, FORT_IP_ADDR_SIZE(isIPv6));
+}
+
+static PFORT_BUFFER_IP_SUMS fort_buffer_ip_sums_get(PFORT_BUFFER buf)
+{
+    PFORT_BUFFER_IP_SUMS ip_sums = buf->ip_sums;
+
+    if (ip_sums == NULL) {
+        ip_sums = fort_mem_alloc(sizeof(FORT_BUFFER_IP_SUMS), FORT_BUFFER_POOL_TAG);
+        if (ip_sums == NULL)
+            return NULL;
+
+        RtlZeroMemory(ip_sums, sizeof(FORT_BUFFER_IP_SUMS));
+
+        buf->ip_sums = ip_sums;
+    }
+
+    return ip_sums;
+}
+
+/* Returns the offset of the path in the paths of the summaries or -1, when they're full */
+static int fort_buffer_ip_sum_path_add(
+        PFORT_BUFFER_IP_SUMS ip_sums, UINT32 pid, UINT32 path_len, const PVOID path)
+{
+    if (path_len == 0)
+        return 0;
+
+    /* Share the path of the same process */
+    for (int i = 0; i < FORT_BUFFER_IP_SUM_COUNT; ++i) {
+        PFORT_BUFFER_IP_SUM sum = &ip_sums->slots[i];
+
+        if (sum->used && sum->pid == pid && sum->path_len == path_len
+                && RtlEqualMemory(ip_sums->paths + sum->path_off, path, path_len))
+            return sum->path_off;
+    }
+
+    const UINT32 path_off = ip_sums->paths_top;
+    if (path_len > FORT_BUFFER_IP_SUM_PATHS_SIZE - path_off)
+        return -1;
+
+    RtlCopyMemory(ip_sums->paths + path_off, path, path_len);
+
+    ip_sums->paths_top += (UINT16) path_len;
+
+    return path_off;
+}
+
+/* Returns TRUE, when the blocked IP is counted to be logged on timer tick */
+static BOOL fort_buffer_ip_sum_add(PFORT_BUFFER buf, BOOL isIPv6, BOOL inbound, BOOL inherited,
+        UCHAR block_reason, UCHAR ip_proto, UINT16 local_port, UINT16 remote_port,
+        const UINT32 *local_ip, const UINT32 *remote_ip, UINT32 pid, UINT32 path_len,
+        const PVOID path)
+{
+    PFORT_BUFFER_IP_SUMS ip_sums = fort_buffer_ip_sums_get(buf);
+    if (ip_sums == NULL)
+        return FALSE;
+
+    const tommy_key_t hash = fort_buffer_ip_sum_hash(
+            isIPv6, inbound, block_reason, ip_proto, remote_port, remote_ip, pid);
+
+    /* Linear probing */
+    PFORT_BUFFER_IP_SUM sum = NULL;
+    for (UINT32 i = 0; i < FORT_BUFFER_IP_SUM_COUNT; ++i) {
+        sum = &ip_sums->slots[(hash + i) & FORT_BUFFER_IP_SUM_MASK];
+
+        if (!sum->used)
+            break;
+
+        if (fort_buffer_ip_sum_equal(sum, hash, isIPv6, inbound, block_reason, ip_proto,
+                    remote_port, remote_ip, pid)) {
+            ++sum->hit_count;
+            sum->last_time = fort_buffer_unix_time();
+            return TRUE;
+        }
+    }
+
+    if (sum->used)
+        return FALSE; /* table is full: log as is */
+
+    const int path_off = fort_buffer_ip_sum_path_add(ip_sums, pid, path_len, path);
+    if (path_off < 0)
+        return FALSE; /* paths are full: log as is */
+
+    const int ip_size = FORT_IP_ADDR_SIZE(isIPv6);
+
+    sum->hash = hash;
+    sum->hit_count = 1;
+    sum->first_time = sum->last_time = fort_buffer_unix_time();
+    sum->pid = pid;
+    sum->used = TRUE;
+    sum->isIPv6 = (UCHAR) isIPv6;
+    sum->inbound = (UCHAR) inbound;
+    sum->inherited = (UCHAR) inherited;
+    sum->block_reason = block_reason;
+    sum->ip_proto = ip_proto;
+    sum->local_port = local_port;
+    sum->remote_port = remote_port;
+    sum->path_len = (UINT16) path_len;
+    sum->path_off = (UINT16) path_off;
+
+    RtlCopyMemory(&sum->local_ip, local_ip, ip_size);
+    RtlCopyMemory(&sum->remote_ip, remote_ip, ip_size);
+
+    ++ip_sums->used_count;
+
+    return TRUE;
+}
+
 NTSTATUS fort_buffer_blocked_ip_write(PFORT_BUFFER buf, BOOL isIPv6, BOOL inbound, BOOL inherited,
         UCHAR block_reason, UCHAR ip_proto, UINT16 local_port, UINT16 remote_port,
         const UINT32 *local_ip, const UINT32 *remote_ip, UINT32 pid, UINT32 path_len,
-        const PVOID path, PIRP *irp, ULONG_PTR *info)
+        const PVOID path, BOOL summarize, PIRP *irp, ULONG_PTR *info)
 {
     FORT_CHECK_STACK(FORT_BUFFER_BLOCKED_IP_WRITE);
 
@@ -197,7 +339,13 @@ NTSTATUS fort_buffer_blocked_ip_write(PFORT_BUFFER buf, BOOL isIPv6, BOOL inboun
 
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&buf->lock, &lock_queue);
-    {
+
+    /* Count the blocked IP, it'll be logged on timer tick */
+    if (summarize
+            && fort_buffer_ip_sum_add(buf, isIPv6, inbound, inherited, block_reason, ip_proto,
+                    local_port, remote_port, local_ip, remote_ip, pid, path_len, path)) {
+        status = STATUS_SUCCESS;
+    } else {
         PCHAR out;
         status = fort_buffer_prepare(buf, len, &out, irp, info);
 
@@ -206,11 +354,51 @@ NTSTATUS fort_buffer_blocked_ip_write(PFORT_BUFFER buf, BOOL isIPv6, BOOL inboun
                     local_port, remote_port, local_ip, remote_ip, pid, path_len, path);
         }
     }
+
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 
     return status;
 }
 
+static void fort_buffer_ip_sum_write(PFORT_BUFFER buf, PFORT_BUFFER_IP_SUMS ip_sums,
+        PFORT_BUFFER_IP_SUM sum, PIRP *irp, ULONG_PTR *info)
+{
+    const BOOL isIPv6 = sum->isIPv6;
+    const UINT32 len = FORT_LOG_BLOCKED_IP_SUM_SIZE(sum->path_len, isIPv6);
+
+    PCHAR out;
+    if (!NT_SUCCESS(fort_buffer_prepare(buf, len, &out, irp, info)))
+        return;
+
+    fort_log_blocked_ip_sum_header_write(out, sum->hit_count, sum->first_time, sum->last_time);
+    out += FORT_LOG_BLOCKED_IP_SUM_HEADER_SIZE;
+
+    fort_log_blocked_ip_write(out, isIPv6, sum->inbound, sum->inherited, sum->block_reason,
+            sum->ip_proto, sum->local_port, sum->remote_port, &sum->local_ip.v4,
+            &sum->remote_ip.v4, sum->pid, sum->path_len, ip_sums->paths + sum->path_off);
+}
+
+FORT_API void fort_buffer_blocked_ip_sums_flush(PFORT_BUFFER buf, PIRP *irp, ULONG_PTR *info)
+{
+    PFORT_BUFFER_IP_SUMS ip_sums = buf->ip_sums;
+
+    if (ip_sums == NULL || ip_sums->used_count == 0)
+        return;
+
+    for (int i = 0; i < FORT_BUFFER_IP_SUM_COUNT; ++i) {
+        PFORT_BUFFER_IP_SUM sum = &ip_sums->slots[i];
+
+        if (sum->used) {
+            fort_buffer_ip_sum_write(buf, ip_sums, sum, irp, info);
+        }
+
+        sum->used = FALSE;
+    }
+
+    ip_sums->used_count = 0;
+    ip_sums->paths_top = 0;
+}
+
 FORT_API NTSTATUS fort_buffer_proc_new_write(
         PFORT_BUFFER buf, UINT32 pid, UINT32 path_len, const PVOID path, PIRP *irp, ULONG_PTR *info)
 {
@@ -369,6 +557,8 @@ FORT_API void fort_buffer_flush_pending(PFORT_BUFFER buf, PIRP *irp, ULONG_PTR *
     if (out_top != 0) {
         *info = out_top;
 
+        TRACE_RING(FORT_TRC_BUFFER_FLUSH, out_top, 0, 0);
+
         buf->out_top = 0;
         buf->out_len = 0;
 
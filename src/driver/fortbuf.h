@@ -5,6 +5,50 @@
 
 #include "common/fortlog.h"
 
+#include "forttds.h"
+
+#define FORT_BUFFER_IP_SUM_COUNT 64 /* must be power of 2 */
+#define FORT_BUFFER_IP_SUM_PATHS_SIZE (8 * 1024)
+
+typedef struct fort_buffer_ip_sum
+{
+    tommy_key_t hash;
+
+    UINT32 hit_count; /* including the first hit */
+
+    INT64 first_time;
+    INT64 last_time;
+
+    UINT32 pid;
+
+    UCHAR used : 1;
+    UCHAR isIPv6 : 1;
+    UCHAR inbound : 1;
+    UCHAR inherited : 1;
+
+    UCHAR block_reason;
+    UCHAR ip_proto;
+
+    UINT16 local_port;
+    UINT16 remote_port;
+
+    UINT16 path_len;
+    UINT16 path_off; /* offset in the paths of the summaries */
+
+    ip_addr_t local_ip;
+    ip_addr_t remote_ip;
+} FORT_BUFFER_IP_SUM, *PFORT_BUFFER_IP_SUM;
+
+typedef struct fort_buffer_ip_sums
+{
+    UINT16 used_count;
+    UINT16 paths_top;
+
+    FORT_BUFFER_IP_SUM slots[FORT_BUFFER_IP_SUM_COUNT];
+
+    CHAR paths[FORT_BUFFER_IP_SUM_PATHS_SIZE]; /* shared by the summaries of a process */
+} FORT_BUFFER_IP_SUMS, *PFORT_BUFFER_IP_SUMS;
+
 typedef struct fort_buffer_data
 {
     struct fort_buffer_data *next;
@@ -19,6 +63,8 @@ typedef struct fort_buffer
     PFORT_BUFFER_DATA data_tail; /* last is current */
     PFORT_BUFFER_DATA data_free;
 
+    PFORT_BUFFER_IP_SUMS ip_sums; /* blocked IP-s aggregated per timer tick */
+
     PIRP irp; /* pending */
     PCHAR out;
     ULONG out_len;
@@ -46,7 +92,9 @@ FORT_API NTSTATUS fort_buffer_blocked_write(PFORT_BUFFER buf, BOOL blocked, UINT
 FORT_API NTSTATUS fort_buffer_blocked_ip_write(PFORT_BUFFER buf, BOOL isIPv6, BOOL inbound,
         BOOL inherited, UCHAR block_reason, UCHAR ip_proto, UINT16 local_port, UINT16 remote_port,
         const UINT32 *local_ip, const UINT32 *remote_ip, UINT32 pid, UINT32 path_len,
-        const PVOID path, PIRP *irp, ULONG_PTR *info);
+        const PVOID path, BOOL summarize, PIRP *irp, ULONG_PTR *info);
+
+FORT_API void fort_buffer_blocked_ip_sums_flush(PFORT_BUFFER buf, PIRP *irp, ULONG_PTR *info);
 
 FORT_API NTSTATUS fort_buffer_proc_new_write(PFORT_BUFFER buf, UINT32 pid, UINT32 path_len,
         const PVOID path, PIRP *irp, ULONG_PTR *info);
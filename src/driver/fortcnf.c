@@ -3,6 +3,9 @@
 #include "fortcnf.h"
 
 #define FORT_ZONES_POOL_TAG 'ZwfF'
+#define FORT_RULES_POOL_TAG 'RwfF'
+
+#define FORT_CONF_EXE_ENTRIES_CHUNK 64 /* entries added per hold of the conf lock */
 
 /* Synchronize with tommy_hashdyn_node! */
 typedef struct fort_conf_exe_node
@@ -58,6 +61,16 @@ FORT_API UCHAR fort_device_flag(PFORT_DEVICE_CONF device_conf, UCHAR flag)
     return fort_device_flags(device_conf) & flag;
 }
 
+FORT_API UINT32 fort_device_conf_generation(PFORT_DEVICE_CONF device_conf)
+{
+    return device_conf->conf_generation;
+}
+
+FORT_API void fort_device_conf_generation_bump(PFORT_DEVICE_CONF device_conf)
+{
+    fort_conf_generation_bump(&device_conf->conf_generation);
+}
+
 static PFORT_CONF_EXE_NODE fort_conf_ref_exe_find_node(
         PFORT_CONF_REF conf_ref, const PVOID path, UINT32 path_len, tommy_key_t path_hash)
 {
@@ -197,6 +210,37 @@ FORT_API NTSTATUS fort_conf_ref_exe_add_entry(
     }
 }
 
+FORT_API NTSTATUS fort_conf_ref_exe_add_entries(
+        PFORT_CONF_REF conf_ref, const PFORT_APP_ENTRIES app_entries)
+{
+    const char *data = app_entries->data;
+    int count = app_entries->apps_n;
+
+    NTSTATUS status = STATUS_SUCCESS;
+
+    /* Let the lookups run between the chunks */
+    while (count > 0 && NT_SUCCESS(status)) {
+        const int chunk_count = min(count, FORT_CONF_EXE_ENTRIES_CHUNK);
+        count -= chunk_count;
+
+        KIRQL oldIrql = ExAcquireSpinLockExclusive(&conf_ref->conf_lock);
+
+        for (int i = 0; i < chunk_count; ++i) {
+            const PFORT_APP_ENTRY entry = (const PFORT_APP_ENTRY) data;
+
+            status = fort_conf_ref_exe_add_entry(conf_ref, entry, /*locked=*/TRUE);
+            if (!NT_SUCCESS(status))
+                break;
+
+            data += FORT_CONF_APP_ENTRY_SIZE(entry->path_len);
+        }
+
+        ExReleaseSpinLockExclusive(&conf_ref->conf_lock, oldIrql);
+    }
+
+    return status;
+}
+
 static void fort_conf_ref_exe_fill(PFORT_CONF_REF conf_ref, const PFORT_CONF conf)
 {
     const char *app_entries = (const char *) (conf->data + conf->exe_apps_off);
@@ -365,6 +409,8 @@ FORT_API FORT_CONF_FLAGS fort_conf_ref_set(PFORT_DEVICE_CONF device_conf, PFORT_
 
         device_conf->conf_flags = conf_flags;
 
+        fort_device_conf_generation_bump(device_conf);
+
         if (old_conf_ref != NULL) {
             fort_conf_ref_put_locked(device_conf, old_conf_ref);
         }
@@ -397,6 +443,8 @@ FORT_API FORT_CONF_FLAGS fort_conf_ref_flags_set(
                     device_conf, FORT_DEVICE_BOOT_FILTER_LOCALS, conf_flags->filter_locals);
 
             device_conf->conf_flags = *conf_flags;
+
+            fort_device_conf_generation_bump(device_conf);
         } else {
             const UCHAR flags = fort_device_flag(device_conf, FORT_DEVICE_BOOT_MASK);
 
@@ -507,3 +555,43 @@ FORT_API BOOL fort_conf_zones_ip_included(
 
     return res;
 }
+
+FORT_API PFORT_CONF_RULES fort_conf_rules_new(PFORT_CONF_RULES rules, ULONG len)
+{
+    PFORT_CONF_RULES conf_rules = fort_mem_alloc(len, FORT_RULES_POOL_TAG);
+    if (conf_rules != NULL) {
+        RtlCopyMemory(conf_rules, rules, len);
+    }
+    return conf_rules;
+}
+
+static void fort_conf_rules_free(PFORT_CONF_RULES rules)
+{
+    if (rules != NULL) {
+        fort_mem_free(rules, FORT_RULES_POOL_TAG);
+    }
+}
+
+FORT_API void fort_conf_rules_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_RULES rules)
+{
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->rules_lock);
+    {
+        fort_conf_rules_free(device_conf->rules);
+        device_conf->rules = rules;
+    }
+    ExReleaseSpinLockExclusive(&device_conf->rules_lock, oldIrql);
+}
+
+FORT_API void fort_conf_rule_flag_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_RULE_FLAG rule_flag)
+{
+    KIRQL oldIrql = ExAcquireSpinLockExclusive(&device_conf->rules_lock);
+    PFORT_CONF_RULES rules = device_conf->rules;
+    if (rules != NULL) {
+        PFORT_CONF_RULE rule = fort_conf_rule_ref(rules, rule_flag->rule_id);
+
+        if (rule != NULL) {
+            rule->enabled = rule_flag->enabled;
+        }
+    }
+    ExReleaseSpinLockExclusive(&device_conf->rules_lock, oldIrql);
+}
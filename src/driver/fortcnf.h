@@ -39,8 +39,13 @@ typedef struct fort_device_conf
     PFORT_CONF_REF volatile ref;
     KSPIN_LOCK ref_lock;
 
+    UINT32 volatile conf_generation; /* changes on every apps' verdict change */
+
     PFORT_CONF_ZONES zones;
     EX_SPIN_LOCK zones_lock;
+
+    PFORT_CONF_RULES rules;
+    EX_SPIN_LOCK rules_lock;
 } FORT_DEVICE_CONF, *PFORT_DEVICE_CONF;
 
 #if defined(__cplusplus)
@@ -53,6 +58,10 @@ FORT_API UCHAR fort_device_flag_set(PFORT_DEVICE_CONF device_conf, UCHAR flag, B
 
 FORT_API UCHAR fort_device_flag(PFORT_DEVICE_CONF device_conf, UCHAR flag);
 
+FORT_API UINT32 fort_device_conf_generation(PFORT_DEVICE_CONF device_conf);
+
+FORT_API void fort_device_conf_generation_bump(PFORT_DEVICE_CONF device_conf);
+
 FORT_API FORT_APP_DATA fort_conf_exe_find(
         const PFORT_CONF conf, PVOID context, const PVOID path, UINT32 path_len);
 
@@ -62,6 +71,9 @@ FORT_API NTSTATUS fort_conf_ref_exe_add_path(
 FORT_API NTSTATUS fort_conf_ref_exe_add_entry(
         PFORT_CONF_REF conf_ref, const PFORT_APP_ENTRY entry, BOOL locked);
 
+FORT_API NTSTATUS fort_conf_ref_exe_add_entries(
+        PFORT_CONF_REF conf_ref, const PFORT_APP_ENTRIES app_entries);
+
 FORT_API void fort_conf_ref_exe_del_entry(PFORT_CONF_REF conf_ref, const PFORT_APP_ENTRY entry);
 
 FORT_API PFORT_CONF_REF fort_conf_ref_new(const PFORT_CONF conf, ULONG len);
@@ -88,6 +100,13 @@ FORT_API void fort_conf_zone_flag_set(
 FORT_API BOOL fort_conf_zones_ip_included(
         PFORT_DEVICE_CONF device_conf, UINT32 zones_mask, const UINT32 *remote_ip, BOOL isIPv6);
 
+FORT_API PFORT_CONF_RULES fort_conf_rules_new(PFORT_CONF_RULES rules, ULONG len);
+
+FORT_API void fort_conf_rules_set(PFORT_DEVICE_CONF device_conf, PFORT_CONF_RULES rules);
+
+FORT_API void fort_conf_rule_flag_set(
+        PFORT_DEVICE_CONF device_conf, PFORT_CONF_RULE_FLAG rule_flag);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -64,6 +64,11 @@ static FORT_APP_DATA fort_callout_ale_conf_app_data(
 
     fort_callout_ale_set_app_flags(cx, app_data);
 
+    if (cx->cache_verdict) {
+        fort_pstree_set_app_verdict(&fort_device()->ps_tree, cx->process_id, cx->path,
+                cx->conf_generation, app_data);
+    }
+
     return app_data;
 }
 
@@ -83,6 +88,8 @@ inline static BOOL fort_callout_ale_associate_flow(
     const NTSTATUS status = fort_flow_associate(&fort_device()->stat, flow_id, cx->process_id,
             group_index, ca->isIPv6, is_tcp, ca->inbound, cx->is_reauth, &log_stat);
 
+    TRACE_RING(FORT_TRC_FLOW_ASSOCIATE, flow_id, flow_id >> 32, cx->process_id);
+
     if (!NT_SUCCESS(status)) {
         if (status != FORT_STATUS_FLOW_BLOCK) {
             LOG("Classify v4: Flow assoc. error: %x\n", status);
@@ -93,6 +100,10 @@ inline static BOOL fort_callout_ale_associate_flow(
         return TRUE; /* block (Error) */
     }
 
+    if ((fort_stat_flags(&fort_device()->stat) & FORT_STAT_FLOWS_RESERVE) != 0) {
+        fort_worker_queue(&fort_device()->worker, FORT_WORKER_FLOWS);
+    }
+
     if (!log_stat) {
         fort_buffer_proc_new_write(&fort_device()->buffer, cx->process_id, cx->real_path->Length,
                 cx->real_path->Buffer, &cx->irp, &cx->info);
@@ -128,6 +139,8 @@ inline static void fort_callout_ale_log_app_path(PFORT_CALLOUT_ALE_EXTRA cx,
     if (!NT_SUCCESS(fort_conf_ref_exe_add_path(conf_ref, &app_entry, cx->path->Buffer)))
         return;
 
+    fort_device_conf_generation_bump(&fort_device()->conf);
+
     fort_callout_ale_set_app_flags(cx, app_data);
 
     fort_buffer_blocked_write(&fort_device()->buffer, cx->blocked, cx->process_id,
@@ -170,9 +183,13 @@ inline static void fort_callout_ale_log_blocked_ip(PCFORT_CALLOUT_ARG ca,
     const IPPROTO ip_proto =
             (IPPROTO) ca->inFixedValues->incomingValue[ca->fi->ipProto].value.uint8;
 
+    /* Repeated blocks are counted until the log timer's tick */
+    const BOOL summarize = fort_timer_is_running(&fort_device()->log_timer);
+
     fort_buffer_blocked_ip_write(&fort_device()->buffer, ca->isIPv6, ca->inbound, cx->inherited,
             cx->block_reason, ip_proto, local_port, remote_port, local_ip, cx->remote_ip,
-            cx->process_id, cx->real_path->Length, cx->real_path->Buffer, &cx->irp, &cx->info);
+            cx->process_id, cx->real_path->Length, cx->real_path->Buffer, summarize, &cx->irp,
+            &cx->info);
 }
 
 inline static BOOL fort_callout_ale_add_pending(
@@ -351,6 +368,32 @@ inline static void fort_callout_ale_classify_action(PCFORT_CALLOUT_ARG ca,
     }
 }
 
+inline static void fort_callout_ale_check_verdict(
+        PFORT_CALLOUT_ALE_EXTRA cx, const PFORT_APP_VERDICT verdict)
+{
+    FORT_APP_DATA app_data;
+
+    if (fort_conf_app_verdict_get(verdict, cx->conf_generation, &app_data)) {
+        fort_callout_ale_set_app_flags(cx, app_data);
+    } else {
+        cx->cache_verdict = TRUE;
+    }
+}
+
+inline static BOOL fort_callout_ale_get_proc_name(UINT32 process_id, PUNICODE_STRING path,
+        BOOL *isSvcHost, BOOL *inherited, PFORT_APP_VERDICT verdict)
+{
+    PFORT_PSTREE ps_tree = &fort_device()->ps_tree;
+
+    if (fort_pstree_get_proc_name(ps_tree, process_id, path, isSvcHost, inherited, verdict))
+        return TRUE;
+
+    /* The process is not enumerated yet on startup: use the real path till it's resolved */
+    fort_pstree_enum_request_proc(ps_tree, process_id);
+
+    return FALSE;
+}
+
 inline static void fort_callout_ale_check_conf(
         PCFORT_CALLOUT_ARG ca, PFORT_CALLOUT_ALE_EXTRA cx, PFORT_CONF_REF conf_ref)
 {
@@ -367,17 +410,21 @@ inline static void fort_callout_ale_check_conf(
     BOOL isSvcHost = FALSE;
     BOOL inherited = FALSE;
     UNICODE_STRING path;
-    if (!fort_pstree_get_proc_name(
-                &fort_device()->ps_tree, process_id, &path, &isSvcHost, &inherited)) {
+    FORT_APP_VERDICT verdict;
+    if (!fort_callout_ale_get_proc_name(process_id, &path, &isSvcHost, &inherited, &verdict)) {
         path = real_path;
-    } else if (!inherited) {
-        /* TODO: Check "ServiceTag" on Windows 10+ */
+    } else {
+        fort_callout_ale_check_verdict(cx, &verdict);
+
+        if (!inherited) {
+            /* TODO: Check "ServiceTag" on Windows 10+ */
 #if 0 // !defined(FORT_WIN7_COMPAT)
-        PVOID subProcessTag = ca->inMetaValues->subProcessTag;
-        if (subProcessTag && isSvcHost) { }
+            PVOID subProcessTag = ca->inMetaValues->subProcessTag;
+            if (subProcessTag && isSvcHost) { }
 #endif
 
-        real_path = path;
+            real_path = path;
+        }
     }
 
     cx->process_id = process_id;
@@ -399,6 +446,9 @@ inline static void fort_callout_ale_check_conf(
 inline static void fort_callout_ale_by_conf(
         PCFORT_CALLOUT_ARG ca, PFORT_CALLOUT_ALE_EXTRA cx, PFORT_DEVICE_CONF device_conf)
 {
+    /* Take the generation before the conf: a verdict cached for it may only get stale */
+    cx->conf_generation = fort_device_conf_generation(device_conf);
+
     PFORT_CONF_REF conf_ref = fort_conf_ref_take(device_conf);
 
     if (conf_ref == NULL) {
@@ -412,8 +462,14 @@ inline static void fort_callout_ale_by_conf(
 
     cx->irp = NULL;
 
+    /* The process names are used until the end of the check */
+    PFORT_PSTREE ps_tree = &fort_device()->ps_tree;
+    const UINT32 ps_read_token = fort_pstree_read_begin(ps_tree);
+
     fort_callout_ale_check_conf(ca, cx, conf_ref);
 
+    fort_pstree_read_end(ps_tree, ps_read_token);
+
     fort_conf_ref_put(device_conf, conf_ref);
 
     if (cx->irp != NULL) {
@@ -432,6 +488,20 @@ inline static BOOL fort_callout_ale_is_local_address(PFORT_CALLOUT_ARG ca,
             || fort_addr_is_local_broadcast(cx->remote_ip, ca->isIPv6));
 }
 
+inline static void fort_callout_ale_classify_metrics(const FWPS_CLASSIFY_OUT0 *classifyOut)
+{
+    fort_device_metrics_inc(FORT_METRICS_CLASSIFY);
+
+    switch (classifyOut->actionType) {
+    case FWP_ACTION_PERMIT: {
+        fort_device_metrics_inc(FORT_METRICS_PERMIT);
+    } break;
+    case FWP_ACTION_BLOCK: {
+        fort_device_metrics_inc(FORT_METRICS_BLOCK);
+    } break;
+    }
+}
+
 static void fort_callout_ale_classify(PFORT_CALLOUT_ARG ca)
 {
     FORT_CHECK_STACK(FORT_CALLOUT_ALE_CLASSIFY);
@@ -479,7 +549,13 @@ inline static void fort_callout_ale_classify_v(const FWPS_INCOMING_VALUES0 *inFi
         .isIPv6 = isIPv6,
     };
 
+    const LARGE_INTEGER begin = KeQueryPerformanceCounter(NULL);
+
     fort_callout_ale_classify(&ca);
+
+    fort_device_metrics_latency(FORT_METRICS_HIST_ALE_CLASSIFY, begin);
+
+    fort_callout_ale_classify_metrics(classifyOut);
 }
 
 static void NTAPI fort_callout_connect_v4(const FWPS_INCOMING_VALUES0 *inFixedValues,
@@ -564,7 +640,13 @@ inline static void fort_callout_flow_classify(PCFORT_CALLOUT_ARG ca, UINT32 data
 {
     const UINT32 headerSize = ca->inbound ? ca->inMetaValues->transportHeaderSize : 0;
 
+    const LARGE_INTEGER begin = KeQueryPerformanceCounter(NULL);
+
     fort_flow_classify(&fort_device()->stat, ca->flowContext, headerSize + dataSize, ca->inbound);
+
+    fort_device_metrics_latency(FORT_METRICS_HIST_FLOW_CLASSIFY, begin);
+
+    fort_device_metrics_inc(FORT_METRICS_FLOW_CLASSIFY);
 }
 
 static void NTAPI fort_callout_stream_classify(const FWPS_INCOMING_VALUES0 *inFixedValues,
@@ -662,9 +744,13 @@ static void NTAPI fort_callout_flow_delete(UINT16 layerId, UINT32 calloutId, UIN
 
     FORT_CHECK_STACK(FORT_CALLOUT_FLOW_DELETE);
 
+    const UINT64 flow_id = ((PFORT_FLOW) flowContext)->flow_id;
+
     fort_shaper_drop_flow_packets(&fort_device()->shaper, flowContext);
 
     fort_flow_delete(&fort_device()->stat, flowContext);
+
+    TRACE_RING(FORT_TRC_FLOW_DELETE, flow_id, flow_id >> 32, 0);
 }
 
 inline static BOOL fort_callout_transport_shape(PFORT_CALLOUT_ARG ca)
@@ -918,11 +1004,12 @@ inline static NTSTATUS fort_callout_force_reauth_prov_recreate(HANDLE engine,
         .filter_locals = conf_flags.filter_locals,
     };
 
-    fort_prov_unregister(engine);
+    /* Re-create only the changed provider's objects */
+    BOOL flows_removed = FALSE;
 
-    const NTSTATUS status = fort_prov_register(engine, boot_conf);
+    const NTSTATUS status = fort_prov_update(engine, boot_conf, &flows_removed);
     if (status == 0) {
-        *prov_recreated = TRUE;
+        *prov_recreated = flows_removed;
     }
 
     return status;
@@ -993,6 +1080,8 @@ FORT_API NTSTATUS fort_callout_force_reauth(const FORT_CONF_FLAGS old_conf_flags
     /* Reauth provider filters */
     status = fort_callout_force_reauth_prov(old_conf_flags, conf_flags);
 
+    TRACE_RING(FORT_TRC_REAUTH, status, 0, 0);
+
     if (!NT_SUCCESS(status)) {
         LOG("Callout Reauth: Error: %x\n", status);
         TRACE(FORT_CALLOUT_CALLOUT_REAUTH_ERROR, status, 0, 0);
@@ -1069,6 +1158,9 @@ FORT_API void fort_callout_timer(void)
     /* Get current Unix time */
     fort_callout_update_system_time(stat, buf, &irp, &info);
 
+    /* Flush blocked IP-s counters */
+    fort_buffer_blocked_ip_sums_flush(buf, &irp, &info);
+
     /* Flush traffic statistics */
     fort_callout_flush_stat_traf(stat, buf, &irp, &info);
 
@@ -46,10 +46,12 @@ typedef struct fort_callout_ale_extra
     UCHAR drop_blocked : 1;
     UCHAR blocked : 1;
     UCHAR ignore : 1;
+    UCHAR cache_verdict : 1;
     INT8 block_reason;
 
     FORT_APP_DATA app_data;
 
+    UINT32 conf_generation;
     UINT32 process_id;
 
     const UINT32 *remote_ip;
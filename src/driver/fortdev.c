@@ -11,6 +11,13 @@
 #include "forttrace.h"
 #include "fortutl.h"
 
+#define FORT_DEVICE_POOL_TAG 'DwfF'
+
+#define FORT_DEVICE_METRICS_SLOTS_MAX 64
+
+/* Marks the file objects of the statistics readers */
+#define FORT_DEVICE_STATS_CONTEXT ((PVOID) 1)
+
 static PFORT_DEVICE g_device = NULL;
 
 typedef struct fort_device_control_arg
@@ -57,6 +64,23 @@ static void fort_device_reauth_queue(void)
     fort_worker_queue(&fort_device()->worker, FORT_WORKER_REAUTH);
 }
 
+static void fort_device_pstree_enum_queue(void)
+{
+    fort_worker_queue(&fort_device()->worker, FORT_WORKER_PSTREE);
+}
+
+static void fort_device_flows_reserve(void)
+{
+    fort_stat_flows_reserve_ahead(&fort_device()->stat);
+}
+
+static void fort_device_pstree_enum(void)
+{
+    if (fort_pstree_enum_processes_batch(&fort_device()->ps_tree)) {
+        fort_device_pstree_enum_queue();
+    }
+}
+
 static void fort_app_period_timer(void)
 {
     if (fort_conf_ref_period_update(&fort_device()->conf, /*force=*/FALSE, /*periods_n=*/NULL)) {
@@ -71,6 +95,21 @@ FORT_API void fort_device_on_system_time(void)
     }
 }
 
+static BOOL fort_device_file_is_stats(PFILE_OBJECT file_object)
+{
+    return file_object != NULL && file_object->FsContext2 == FORT_DEVICE_STATS_CONTEXT;
+}
+
+static BOOL fort_device_file_name_is_stats(PFILE_OBJECT file_object)
+{
+    const USHORT name_len = sizeof(FORT_DEVICE_STATS_FILE_NAME) - sizeof(WCHAR);
+
+    if (file_object == NULL || file_object->FileName.Length != name_len)
+        return FALSE;
+
+    return RtlEqualMemory(file_object->FileName.Buffer, FORT_DEVICE_STATS_FILE_NAME, name_len);
+}
+
 FORT_API NTSTATUS fort_device_create(PDEVICE_OBJECT device, PIRP irp)
 {
     UNUSED(device);
@@ -79,6 +118,20 @@ FORT_API NTSTATUS fort_device_create(PDEVICE_OBJECT device, PIRP irp)
 
     NTSTATUS status = STATUS_SUCCESS;
 
+    /* Statistics reader: doesn't take the device */
+    {
+        const PIO_STACK_LOCATION irp_stack = IoGetCurrentIrpStackLocation(irp);
+        PFILE_OBJECT file_object = irp_stack->FileObject;
+
+        if (fort_device_file_name_is_stats(file_object)) {
+            file_object->FsContext2 = FORT_DEVICE_STATS_CONTEXT;
+
+            fort_request_complete(irp, status);
+
+            return status;
+        }
+    }
+
     /* Device opened */
     const UCHAR flags = fort_device_flag_set(&fort_device()->conf, FORT_DEVICE_IS_OPENED, TRUE);
     if ((flags & FORT_DEVICE_IS_OPENED) != 0) {
@@ -112,6 +165,13 @@ FORT_API NTSTATUS fort_device_cleanup(PDEVICE_OBJECT device, PIRP irp)
 
     FORT_CHECK_STACK(FORT_DEVICE_CLEANUP);
 
+    /* Statistics reader closed */
+    if (fort_device_file_is_stats(IoGetCurrentIrpStackLocation(irp)->FileObject)) {
+        fort_request_complete(irp, STATUS_SUCCESS);
+
+        return STATUS_SUCCESS;
+    }
+
     /* Device closed */
     fort_device_flag_set(
             &fort_device()->conf, (FORT_DEVICE_IS_OPENED | FORT_DEVICE_IS_VALIDATED), FALSE);
@@ -122,6 +182,7 @@ FORT_API NTSTATUS fort_device_cleanup(PDEVICE_OBJECT device, PIRP irp)
         FORT_CONF_FLAGS conf_flags = fort_device()->conf.conf_flags;
 
         fort_conf_zones_set(&fort_device()->conf, NULL);
+        fort_conf_rules_set(&fort_device()->conf, NULL);
 
         fort_stat_conf_flags_update(&fort_device()->stat, &conf_flags);
 
@@ -159,7 +220,7 @@ static NTSTATUS fort_device_control_setservices(PFORT_DEVICE_CONTROL_ARG dca)
     const PFORT_SERVICE_INFO_LIST services = dca->buffer;
     const ULONG len = dca->in_len;
 
-    if (len > sizeof(FORT_SERVICE_INFO_LIST)) {
+    if (len > FORT_SERVICE_INFO_LIST_DATA_OFF) {
         fort_pstree_update_services(&fort_device()->ps_tree, services,
                 /*data_len=*/len - FORT_SERVICE_INFO_LIST_DATA_OFF);
 
@@ -180,9 +241,9 @@ inline static NTSTATUS fort_device_control_setconf_ref(
     fort_stat_conf_update(&fort_device()->stat, conf_io);
     fort_shaper_conf_update(&fort_device()->shaper, conf_io);
 
-    /* Enumerate processes */
-    if (was_null_conf) {
-        fort_pstree_enum_processes(&fort_device()->ps_tree);
+    /* Enumerate processes by batches in worker */
+    if (was_null_conf && fort_pstree_enum_processes(&fort_device()->ps_tree)) {
+        fort_device_pstree_enum_queue();
     }
 
     return fort_device_reauth_force(old_conf_flags);
@@ -195,13 +256,23 @@ static NTSTATUS fort_device_control_setconf(PFORT_DEVICE_CONTROL_ARG dca)
 
     if (len > sizeof(FORT_CONF_IO)) {
         const PFORT_CONF conf = &conf_io->conf;
-        PFORT_CONF_REF conf_ref = fort_conf_ref_new(conf, len - FORT_CONF_IO_CONF_OFF);
+        const ULONG conf_len = len - FORT_CONF_IO_CONF_OFF;
+
+        /* Reject the malformed conf before the swap */
+        if (!fort_conf_verify(conf, conf_len))
+            return FORT_STATUS_USER_ERROR;
+
+        PFORT_CONF_REF conf_ref = fort_conf_ref_new(conf, conf_len);
 
         if (conf_ref == NULL) {
             return STATUS_INSUFFICIENT_RESOURCES;
         }
 
-        return fort_device_control_setconf_ref(conf_io, conf_ref);
+        const NTSTATUS status = fort_device_control_setconf_ref(conf_io, conf_ref);
+
+        TRACE_RING(FORT_TRC_CONF_APPLY, len, status, 0);
+
+        return status;
     }
 
     return STATUS_UNSUCCESSFUL;
@@ -268,6 +339,9 @@ static NTSTATUS fort_device_control_app(PFORT_DEVICE_CONTROL_ARG dca, BOOL is_ad
     if (len < sizeof(FORT_APP_ENTRY) || len < FORT_CONF_APP_ENTRY_SIZE(app_entry->path_len))
         return STATUS_UNSUCCESSFUL;
 
+    if (!fort_conf_app_verify(app_entry, len))
+        return FORT_STATUS_USER_ERROR;
+
     PFORT_CONF_REF conf_ref = fort_conf_ref_take(&fort_device()->conf);
 
     if (conf_ref == NULL)
@@ -278,6 +352,8 @@ static NTSTATUS fort_device_control_app(PFORT_DEVICE_CONTROL_ARG dca, BOOL is_ad
     fort_conf_ref_put(&fort_device()->conf, conf_ref);
 
     if (NT_SUCCESS(status)) {
+        fort_device_conf_generation_bump(&fort_device()->conf);
+
         fort_device_reauth_queue();
     }
 
@@ -294,12 +370,43 @@ static NTSTATUS fort_device_control_delapp(PFORT_DEVICE_CONTROL_ARG dca)
     return fort_device_control_app(dca, /*is_adding=*/FALSE);
 }
 
+static NTSTATUS fort_device_control_addapps(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    const PFORT_APP_ENTRIES app_entries = dca->buffer;
+    const ULONG len = dca->in_len;
+
+    if (len < FORT_APP_ENTRIES_DATA_OFF)
+        return STATUS_UNSUCCESSFUL;
+
+    if (!fort_conf_app_entries_verify(app_entries, len))
+        return FORT_STATUS_USER_ERROR;
+
+    PFORT_CONF_REF conf_ref = fort_conf_ref_take(&fort_device()->conf);
+
+    if (conf_ref == NULL)
+        return STATUS_INSUFFICIENT_RESOURCES;
+
+    const NTSTATUS status = fort_conf_ref_exe_add_entries(conf_ref, app_entries);
+
+    fort_conf_ref_put(&fort_device()->conf, conf_ref);
+
+    /* Some entries may be added on error too: reauth once for the whole batch */
+    fort_device_conf_generation_bump(&fort_device()->conf);
+
+    fort_device_reauth_queue();
+
+    return status;
+}
+
 static NTSTATUS fort_device_control_setzones(PFORT_DEVICE_CONTROL_ARG dca)
 {
     const PFORT_CONF_ZONES zones = dca->buffer;
     const ULONG len = dca->in_len;
 
     if (len >= FORT_CONF_ZONES_DATA_OFF) {
+        if (!fort_conf_zones_verify(zones, len))
+            return FORT_STATUS_USER_ERROR;
+
         PFORT_CONF_ZONES conf_zones = fort_conf_zones_new(zones, len);
 
         if (conf_zones == NULL) {
@@ -307,6 +414,8 @@ static NTSTATUS fort_device_control_setzones(PFORT_DEVICE_CONTROL_ARG dca)
         } else {
             fort_conf_zones_set(&fort_device()->conf, conf_zones);
 
+            fort_device_conf_generation_bump(&fort_device()->conf);
+
             fort_device_reauth_queue();
 
             return STATUS_SUCCESS;
@@ -324,6 +433,8 @@ static NTSTATUS fort_device_control_setzoneflag(PFORT_DEVICE_CONTROL_ARG dca)
     if (len == sizeof(FORT_CONF_ZONE_FLAG)) {
         fort_conf_zone_flag_set(&fort_device()->conf, zone_flag);
 
+        fort_device_conf_generation_bump(&fort_device()->conf);
+
         fort_device_reauth_queue();
 
         return STATUS_SUCCESS;
@@ -332,7 +443,75 @@ static NTSTATUS fort_device_control_setzoneflag(PFORT_DEVICE_CONTROL_ARG dca)
     return STATUS_UNSUCCESSFUL;
 }
 
-static_assert(FORT_CTL_INDEX_FROM_CODE(FORT_IOCTL_SETZONEFLAG) == FORT_IOCTL_INDEX_SETZONEFLAG,
+static NTSTATUS fort_device_control_setrules(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    const PFORT_CONF_RULES rules = dca->buffer;
+    const ULONG len = dca->in_len;
+
+    if (len >= FORT_CONF_RULES_DATA_OFF) {
+        if (!fort_conf_rules_verify(rules, len))
+            return FORT_STATUS_USER_ERROR;
+
+        PFORT_CONF_RULES conf_rules = fort_conf_rules_new(rules, len);
+
+        if (conf_rules == NULL) {
+            return STATUS_INSUFFICIENT_RESOURCES;
+        } else {
+            /* The classify path doesn't match the rules yet: no reauth */
+            fort_conf_rules_set(&fort_device()->conf, conf_rules);
+
+            return STATUS_SUCCESS;
+        }
+    }
+
+    return STATUS_UNSUCCESSFUL;
+}
+
+static NTSTATUS fort_device_control_setruleflag(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    const PFORT_CONF_RULE_FLAG rule_flag = dca->buffer;
+    const ULONG len = dca->in_len;
+
+    if (len == sizeof(FORT_CONF_RULE_FLAG)) {
+        fort_conf_rule_flag_set(&fort_device()->conf, rule_flag);
+
+        return STATUS_SUCCESS;
+    }
+
+    return STATUS_UNSUCCESSFUL;
+}
+
+static NTSTATUS fort_device_control_getstats(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    PFORT_DRIVER_METRICS out = dca->buffer;
+    const ULONG out_len = dca->out_len;
+
+    if (out_len < sizeof(FORT_DRIVER_METRICS))
+        return STATUS_BUFFER_TOO_SMALL;
+
+    fort_metrics_snapshot(&fort_device()->metrics, out);
+
+    out->flows_n = fort_stat_flows_count(&fort_device()->stat, &out->flow_buckets_n);
+
+    *dca->info = sizeof(FORT_DRIVER_METRICS);
+
+    return STATUS_SUCCESS;
+}
+
+static NTSTATUS fort_device_control_gettrace(PFORT_DEVICE_CONTROL_ARG dca)
+{
+    PVOID out = dca->buffer;
+    const ULONG out_len = dca->out_len;
+
+    if (out_len < sizeof(FORT_TRC_HEADER))
+        return STATUS_BUFFER_TOO_SMALL;
+
+    *dca->info = fort_trc_ring_read(&fort_device()->trace_ring, out, out_len);
+
+    return STATUS_SUCCESS;
+}
+
+static_assert(FORT_CTL_INDEX_FROM_CODE(FORT_IOCTL_ADDAPPS) == FORT_IOCTL_INDEX_ADDAPPS,
         "Invalid FORT_CTL_INDEX_FROM_CODE()");
 
 typedef NTSTATUS(FORT_DEVICE_CONTROL_PROCESS_FUNC)(PFORT_DEVICE_CONTROL_ARG dca);
@@ -348,6 +527,11 @@ static PFORT_DEVICE_CONTROL_PROCESS_FUNC fortDeviceControlProcess_funcList[] = {
     &fort_device_control_delapp,
     &fort_device_control_setzones,
     &fort_device_control_setzoneflag,
+    &fort_device_control_getstats,
+    &fort_device_control_gettrace,
+    &fort_device_control_setrules,
+    &fort_device_control_setruleflag,
+    &fort_device_control_addapps,
 };
 
 static NTSTATUS fort_device_control_process(
@@ -356,10 +540,15 @@ static NTSTATUS fort_device_control_process(
     const UCHAR control_index =
             FORT_CTL_INDEX_FROM_CODE(irp_stack->Parameters.DeviceIoControl.IoControlCode);
 
-    if (control_index > FORT_IOCTL_INDEX_SETZONEFLAG)
+    if (control_index > FORT_IOCTL_INDEX_ADDAPPS)
         return STATUS_INVALID_PARAMETER;
 
-    if (control_index != FORT_IOCTL_INDEX_VALIDATE
+    if (fort_device_file_is_stats(irp_stack->FileObject)) {
+        /* Statistics reader may only read the metrics and the trace */
+        if (control_index != FORT_IOCTL_INDEX_GETSTATS
+                && control_index != FORT_IOCTL_INDEX_GETTRACE)
+            return STATUS_INVALID_DEVICE_REQUEST;
+    } else if (control_index != FORT_IOCTL_INDEX_VALIDATE
             && fort_device_flag(&fort_device()->conf, FORT_DEVICE_IS_VALIDATED) == 0)
         return STATUS_INVALID_DEVICE_REQUEST;
 
@@ -444,6 +633,45 @@ static NTSTATUS fort_device_register_provider(void)
     return fort_prov_trans_close(engine, status);
 }
 
+static void fort_device_metrics_open(PFORT_METRICS metrics)
+{
+    const ULONG cpu_count = KeQueryActiveProcessorCountEx(ALL_PROCESSOR_GROUPS);
+    const UINT16 slots_n = (UINT16) min(cpu_count, FORT_DEVICE_METRICS_SLOTS_MAX);
+
+    LARGE_INTEGER ticks_freq;
+    KeQueryPerformanceCounter(&ticks_freq);
+
+    /* Works without the metrics on allocation failure */
+    PFORT_METRICS_SLOT slots =
+            fort_mem_alloc(slots_n * sizeof(FORT_METRICS_SLOT), FORT_DEVICE_POOL_TAG);
+
+    fort_metrics_init(metrics, slots, slots_n, ticks_freq.QuadPart);
+}
+
+static void fort_device_metrics_close(PFORT_METRICS metrics)
+{
+    PFORT_METRICS_SLOT slots = metrics->slots;
+
+    fort_metrics_init(metrics, NULL, 0, 0);
+
+    if (slots != NULL) {
+        fort_mem_free(slots, FORT_DEVICE_POOL_TAG);
+    }
+}
+
+FORT_API void fort_device_metrics_inc(UINT16 counter)
+{
+    fort_metrics_inc(&fort_device()->metrics, KeGetCurrentProcessorNumberEx(NULL), counter);
+}
+
+FORT_API void fort_device_metrics_latency(UINT16 hist_index, LARGE_INTEGER begin)
+{
+    const LARGE_INTEGER end = KeQueryPerformanceCounter(NULL);
+
+    fort_metrics_latency_add(&fort_device()->metrics, KeGetCurrentProcessorNumberEx(NULL),
+            hist_index, end.QuadPart - begin.QuadPart);
+}
+
 FORT_API NTSTATUS fort_device_load(PVOID device_param)
 {
     FORT_CHECK_STACK(FORT_DEVICE_LOAD);
@@ -455,7 +683,11 @@ FORT_API NTSTATUS fort_device_load(PVOID device_param)
     ExInitializeRundownProtection(&fort_device()->reauth_rundown);
 
     fort_worker_func_set(&fort_device()->worker, FORT_WORKER_REAUTH, &fort_device_reauth);
+    fort_worker_func_set(&fort_device()->worker, FORT_WORKER_PSTREE, &fort_device_pstree_enum);
+    fort_worker_func_set(&fort_device()->worker, FORT_WORKER_FLOWS, &fort_device_flows_reserve);
 
+    fort_device_metrics_open(&fort_device()->metrics);
+    fort_trace_ring_open(&fort_device()->trace_ring);
     fort_device_conf_open(&fort_device()->conf);
     fort_buffer_open(&fort_device()->buffer);
     fort_stat_open(&fort_device()->stat);
@@ -506,7 +738,8 @@ FORT_API void fort_device_unload(void)
     fort_timer_close(&fort_device()->app_timer);
     fort_timer_close(&fort_device()->log_timer);
 
-    /* Stop worker threads */
+    /* Stop processes enumeration & worker threads */
+    fort_pstree_enum_processes_cancel(&fort_device()->ps_tree);
     fort_worker_unregister(&fort_device()->worker);
 
     /* Stop process monitor */
@@ -527,4 +760,7 @@ FORT_API void fort_device_unload(void)
     if (fort_device_flag(&fort_device()->conf, FORT_DEVICE_BOOT_FILTER) == 0) {
         fort_prov_trans_unregister();
     }
+
+    fort_trace_ring_close(&fort_device()->trace_ring);
+    fort_device_metrics_close(&fort_device()->metrics);
 }
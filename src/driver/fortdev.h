@@ -3,6 +3,9 @@
 
 #include "fortdrv.h"
 
+#include "common/fortmetrics.h"
+#include "common/forttrc.h"
+
 #include "fortbuf.h"
 #include "fortcnf.h"
 #include "fortpkt.h"
@@ -32,6 +35,8 @@ typedef struct fort_device
     FORT_TIMER log_timer;
     FORT_TIMER app_timer;
     FORT_WORKER worker;
+    FORT_METRICS metrics;
+    FORT_TRC_RING trace_ring;
 } FORT_DEVICE, *PFORT_DEVICE;
 
 #if defined(__cplusplus)
@@ -44,6 +49,10 @@ FORT_API void fort_device_set(PFORT_DEVICE device);
 
 FORT_API void fort_device_on_system_time(void);
 
+FORT_API void fort_device_metrics_inc(UINT16 counter);
+
+FORT_API void fort_device_metrics_latency(UINT16 hist_index, LARGE_INTEGER begin);
+
 FORT_API NTSTATUS fort_device_create(PDEVICE_OBJECT device, PIRP irp);
 
 FORT_API NTSTATUS fort_device_close(PDEVICE_OBJECT device, PIRP irp);
@@ -36,7 +36,7 @@ static NTSTATUS fort_driver_create_device(PDRIVER_OBJECT driver, PUNICODE_STRING
     /* TODO: Use IoCreateDeviceSecure() with custom SDDL for Service SID */
     PDEVICE_OBJECT device_obj;
     status = IoCreateDevice(driver, sizeof(FORT_DEVICE), &device_name, FORT_DEVICE_TYPE, 0,
-            /*exclusive=*/TRUE, &device_obj);
+            /*exclusive=*/FALSE, &device_obj); /* the statistics file is opened along */
     if (!NT_SUCCESS(status)) {
         LOG("Create Device: Error: %x\n", status);
         return status;
@@ -9,8 +9,14 @@
 */
 
 #include "common/fortconf.c"
+#include "common/fortflowtab.c"
 #include "common/fortlog.c"
+#include "common/fortmetrics.c"
 #include "common/fortprov.c"
+#include "common/fortpsenum.c"
+#include "common/fortpsmap.c"
+#include "common/fortsvctab.c"
+#include "common/forttrc.c"
 #include "common/fort_wildmatch.c"
 
 #include "loader/fortmm_imp.c"
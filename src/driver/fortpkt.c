@@ -652,10 +652,22 @@ inline static BOOL fort_shaper_queue_is_empty(PFORT_PACKET_QUEUE queue)
             && fort_shaper_packet_list_is_empty(&queue->latency_list);
 }
 
+inline static UINT32 fort_shaper_packet_chain_count(PFORT_FLOW_PACKET pkt)
+{
+    UINT32 count = 0;
+
+    for (; pkt != NULL; pkt = pkt->next) {
+        ++count;
+    }
+
+    return count;
+}
+
 static BOOL fort_shaper_queue_process(
-        PFORT_SHAPER shaper, PFORT_PACKET_QUEUE queue, const LARGE_INTEGER now)
+        PFORT_SHAPER shaper, PFORT_PACKET_QUEUE queue, int queue_index, const LARGE_INTEGER now)
 {
     PFORT_FLOW_PACKET pkt_chain = NULL;
+    UINT64 queued_bytes = 0;
     BOOL is_active = FALSE;
 
     KLOCK_QUEUE_HANDLE lock_queue;
@@ -667,12 +679,16 @@ static BOOL fort_shaper_queue_process(
 
         pkt_chain = fort_shaper_queue_process_latency(shaper, queue, now);
 
+        queued_bytes = queue->queued_bytes;
         is_active = !fort_shaper_queue_is_empty(queue);
     }
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 
     if (pkt_chain != NULL) {
+        TRACE_RING(FORT_TRC_SHAPER_DEQUEUE, queue_index, fort_shaper_packet_chain_count(pkt_chain),
+                queued_bytes);
+
         fort_shaper_packet_foreach(shaper, pkt_chain, &fort_shaper_packet_inject);
     }
 
@@ -753,7 +769,7 @@ inline static ULONG fort_shaper_thread_process_queues(
         if (queue == NULL)
             continue;
 
-        if (fort_shaper_queue_process(shaper, queue, now)) {
+        if (fort_shaper_queue_process(shaper, queue, i, now)) {
             new_active_io_bits |= (1 << i);
         }
     }
@@ -916,19 +932,23 @@ void fort_shaper_conf_flags_update(PFORT_SHAPER shaper, const PFORT_CONF_FLAGS c
     fort_shaper_flush(shaper, flush_io_bits, /*drop=*/FALSE);
 }
 
-static void fort_shaper_packet_queue_add_packet(
+static UINT64 fort_shaper_packet_queue_add_packet(
         PFORT_SHAPER shaper, PFORT_PACKET_QUEUE queue, PFORT_FLOW_PACKET pkt, UINT32 queue_bit)
 {
+    UINT64 queued_bytes;
+
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&queue->lock, &lock_queue);
     {
-        queue->queued_bytes += pkt->data_length;
+        queued_bytes = (queue->queued_bytes += pkt->data_length);
 
         fort_shaper_packet_list_add_chain(&queue->bandwidth_list, pkt, pkt);
 
         fort_shaper_io_bits_set(&shaper->active_io_bits, queue_bit, TRUE);
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    return queued_bytes;
 }
 
 inline static BOOL fort_shaper_packet_queue_check_plr(PFORT_PACKET_QUEUE queue)
@@ -987,6 +1007,7 @@ inline static NTSTATUS fort_shaper_packet_queue(
 
     /* Check the Queue for new Packet */
     if (!fort_shaper_packet_queue_check_packet(queue, data_length)) {
+        fort_device_metrics_inc(FORT_METRICS_SHAPER_DROP);
         return STATUS_SUCCESS; /* drop the packet */
     }
 
@@ -1007,7 +1028,10 @@ inline static NTSTATUS fort_shaper_packet_queue(
     pkt->data_length = data_length;
 
     /* Add the Packet to Queue */
-    fort_shaper_packet_queue_add_packet(shaper, queue, pkt, queue_bit);
+    const UINT64 queued_bytes =
+            fort_shaper_packet_queue_add_packet(shaper, queue, pkt, queue_bit);
+
+    TRACE_RING(FORT_TRC_SHAPER_ENQUEUE, queue_index, data_length, queued_bytes);
 
     /* Packets in transport layer must be re-injected in DCP/thread due to locking */
     fort_shaper_thread_set_event(shaper);
@@ -1278,13 +1302,17 @@ FORT_API BOOL fort_pending_add_packet(
         return FALSE;
 
     /* Check the Process's Limits */
-    if (!fort_pending_proc_check_limits(pending, cx->process_id))
+    if (!fort_pending_proc_check_limits(pending, cx->process_id)) {
+        fort_device_metrics_inc(FORT_METRICS_PENDING_DROP);
         return FALSE;
+    }
 
     /* Create the Packet */
     PFORT_PENDING_PACKET pkt = fort_pending_packet_new();
-    if (pkt == NULL)
+    if (pkt == NULL) {
+        fort_device_metrics_inc(FORT_METRICS_PENDING_DROP);
         return FALSE;
+    }
 
     RtlZeroMemory(pkt, sizeof(FORT_PENDING_PACKET));
 
@@ -1298,6 +1326,7 @@ FORT_API BOOL fort_pending_add_packet(
 
     if (!NT_SUCCESS(status)) {
         fort_pending_packet_free(pkt);
+        fort_device_metrics_inc(FORT_METRICS_PENDING_DROP);
         return FALSE;
     }
 
@@ -36,36 +36,16 @@ typedef struct fort_psname
 #define FORT_PSNODE_KILL_CHILD     0x0010
 #define FORT_PSNODE_IS_SVCHOST     0x0020
 
-/* Synchronize with tommy_hashdyn_node! */
 typedef struct fort_psnode
 {
-    struct fort_psnode *next;
-    struct fort_psnode *prev;
+    FORT_PSMAP_NODE map_node; /* must be first */
 
-    PFORT_PSNAME ps_name; /* tommy_hashdyn_node::data */
-
-    tommy_key_t pid_hash; /* tommy_hashdyn_node::index */
-
-    UINT32 process_id;
+    PFORT_PSNAME volatile ps_name;
 
     UINT16 volatile flags;
-} FORT_PSNODE, *PFORT_PSNODE;
 
-typedef struct _SYSTEM_PROCESSES
-{
-    ULONG NextEntryOffset;
-    ULONG NumberOfThreads;
-    ULONG Reserved1[6];
-    LARGE_INTEGER CreateTime;
-    LARGE_INTEGER UserTime;
-    LARGE_INTEGER KernelTime;
-    UNICODE_STRING ImageName;
-    KPRIORITY BasePriority;
-    SIZE_T ProcessId;
-    SIZE_T ParentProcessId;
-    ULONG HandleCount;
-    ULONG SessionId;
-} SYSTEM_PROCESSES, *PSYSTEM_PROCESSES;
+    FORT_APP_VERDICT verdict; /* cached for the process name */
+} FORT_PSNODE, *PFORT_PSNODE;
 
 #if !defined(SystemProcessInformation)
 #    define SystemProcessInformation 5
@@ -92,7 +72,7 @@ typedef struct fort_path_buffer
 
 typedef struct fort_psinfo_hash
 {
-    tommy_key_t pid_hash;
+    UINT32 pid_hash;
     HANDLE processHandle;
     DWORD processId;
     DWORD parentProcessId;
@@ -112,7 +92,7 @@ typedef struct fort_pstree_notify_arg
 
 typedef const FORT_PSTREE_NOTIFY_ARG *PCFORT_PSTREE_NOTIFY_ARG;
 
-#define fort_pstree_proc_hash(process_id) tommy_inthash_u32((UINT32) (process_id))
+#define fort_pstree_proc_hash(process_id) fort_psmap_hash((UINT32) (process_id))
 
 #define fort_pstree_get_proc(ps_tree, index)                                                       \
     ((PFORT_PSNODE) tommy_arrayof_ref(&(ps_tree)->procs, (index)))
@@ -296,11 +276,24 @@ static PFORT_PSNAME fort_pstree_create_service_name(
     return ps_name;
 }
 
+inline static void fort_pstree_proc_verdict_reset(PFORT_PSNODE proc)
+{
+    proc->verdict.conf_generation = 0;
+}
+
+inline static void fort_pstree_proc_set_ps_name(PFORT_PSNODE proc, PFORT_PSNAME ps_name)
+{
+    fort_pstree_proc_verdict_reset(proc);
+
+    /* Publish the initialized name to the readers */
+    WritePointerRelease((PVOID volatile *) &proc->ps_name, ps_name);
+}
+
 static void fort_pstree_proc_set_service_name(PFORT_PSNODE proc, PFORT_PSNAME ps_name)
 {
     assert(proc->ps_name == NULL);
 
-    proc->ps_name = ps_name;
+    fort_pstree_proc_set_ps_name(proc, ps_name);
 
     if (ps_name != NULL) {
         /* Service can't inherit parent's name */
@@ -308,10 +301,30 @@ static void fort_pstree_proc_set_service_name(PFORT_PSNODE proc, PFORT_PSNAME ps
     }
 }
 
+static void fort_pstree_check_proc_service(PFORT_PSTREE ps_tree, PFORT_PSNODE proc)
+{
+    const PFORT_SVCTAB svctab = ps_tree->svctab;
+    if (svctab == NULL || proc->ps_name != NULL)
+        return;
+
+    const PFORT_SVCTAB_ENTRY entry = fort_svctab_find_pid(svctab, proc->map_node.pid);
+    if (entry == NULL)
+        return;
+
+    UNICODE_STRING serviceName;
+    serviceName.Length = entry->name_len;
+    serviceName.MaximumLength = serviceName.Length;
+    serviceName.Buffer = fort_svctab_entry_name(svctab, entry);
+
+    PFORT_PSNAME ps_name = fort_pstree_create_service_name(ps_tree, &serviceName);
+
+    fort_pstree_proc_set_service_name(proc, ps_name);
+}
+
 static void fort_pstree_proc_check_svchost(
         PFORT_PSTREE ps_tree, PCFORT_PSINFO_HASH psi, PFORT_PSNODE proc)
 {
-    if (psi->path == NULL || psi->commandLine == NULL)
+    if (psi->path == NULL)
         return;
 
     if (!fort_pstree_svchost_path_check(psi->path))
@@ -319,66 +332,103 @@ static void fort_pstree_proc_check_svchost(
 
     proc->flags |= FORT_PSNODE_IS_SVCHOST;
 
+    /* Shared or enumerated svchost process: look up its service by process id */
     UNICODE_STRING serviceName;
-    if (!fort_pstree_svchost_check(psi->commandLine, &serviceName))
+    if (psi->commandLine == NULL || !fort_pstree_svchost_check(psi->commandLine, &serviceName)) {
+        fort_pstree_check_proc_service(ps_tree, proc);
         return;
+    }
 
     PFORT_PSNAME ps_name = fort_pstree_create_service_name(ps_tree, &serviceName);
 
     fort_pstree_proc_set_service_name(proc, ps_name);
 }
 
-static PFORT_PSNODE fort_pstree_proc_new(PFORT_PSTREE ps_tree, tommy_key_t pid_hash)
+static void fort_pstree_svctab_set(PFORT_PSTREE ps_tree, PFORT_SVCTAB svctab)
 {
-    tommy_hashdyn_node *proc_node = tommy_list_tail(&ps_tree->free_procs);
-
-    if (proc_node != NULL) {
-        tommy_list_remove_existing(&ps_tree->free_procs, proc_node);
-    } else {
-        tommy_arrayof *procs = &ps_tree->procs;
-        const UINT16 index = ps_tree->procs_n;
+    if (ps_tree->svctab != NULL) {
+        fort_mem_free(ps_tree->svctab, FORT_PSTREE_POOL_TAG);
+    }
 
-        tommy_arrayof_grow(procs, index + 1);
+    ps_tree->svctab = svctab;
+}
 
-        proc_node = tommy_arrayof_ref(procs, index);
-    }
+static void fort_pstree_svctab_update(
+        PFORT_PSTREE ps_tree, const PFORT_SERVICE_INFO_LIST services, ULONG data_len)
+{
+    const ULONG size = fort_svctab_build_size(ps_tree->svctab, services, data_len);
+    if (size == 0)
+        return;
 
-    tommy_hashdyn_insert(&ps_tree->procs_map, proc_node, /*ps_name=*/NULL, pid_hash);
+    PVOID buffer = fort_mem_alloc(size, FORT_PSTREE_POOL_TAG);
+    if (buffer == NULL)
+        return;
 
-    ++ps_tree->procs_n;
+    PFORT_SVCTAB svctab = fort_svctab_build(buffer, ps_tree->svctab, services, data_len);
 
-    return (PFORT_PSNODE) proc_node;
+    fort_pstree_svctab_set(ps_tree, svctab);
 }
 
-static void fort_pstree_proc_del(PFORT_PSTREE ps_tree, PFORT_PSNODE proc)
+static void fort_pstree_procs_reclaim(PFORT_PSTREE ps_tree)
 {
-    --ps_tree->procs_n;
+    PFORT_PSMAP_NODE node = fort_psmap_reclaim(&ps_tree->procs_map);
 
-    /* Delete from pool */
-    fort_pstree_name_del(ps_tree, proc->ps_name);
+    while (node != NULL) {
+        PFORT_PSNODE proc = (PFORT_PSNODE) node;
+        node = node->retired_next;
 
-    proc->ps_name = NULL;
-    proc->process_id = 0;
+        /* Delete from pool */
+        fort_pstree_name_del(ps_tree, proc->ps_name);
 
-    /* Delete from procs map */
-    tommy_hashdyn_remove_existing(&ps_tree->procs_map, (tommy_hashdyn_node *) proc);
+        proc->ps_name = NULL;
 
-    tommy_list_insert_tail_check(&ps_tree->free_procs, (tommy_node *) proc);
+        /* Add to free list */
+        proc->map_node.retired_next = ps_tree->free_procs;
+        ps_tree->free_procs = &proc->map_node;
+    }
 }
 
-static PFORT_PSNODE fort_pstree_find_proc_hash(
-        PFORT_PSTREE ps_tree, DWORD processId, tommy_key_t pid_hash)
+static PFORT_PSNODE fort_pstree_proc_new(PFORT_PSTREE ps_tree, DWORD processId, UINT32 pid_hash)
 {
-    PFORT_PSNODE node = (PFORT_PSNODE) tommy_hashdyn_bucket(&ps_tree->procs_map, pid_hash);
+    fort_pstree_procs_reclaim(ps_tree);
 
-    while (node != NULL) {
-        if (node->process_id == processId)
-            return node;
+    PFORT_PSNODE proc = (PFORT_PSNODE) ps_tree->free_procs;
 
-        node = node->next;
+    if (proc != NULL) {
+        ps_tree->free_procs = proc->map_node.retired_next;
+    } else {
+        tommy_arrayof *procs = &ps_tree->procs;
+        const UINT16 index = ps_tree->procs_size;
+
+        tommy_arrayof_grow(procs, index + 1);
+
+        proc = tommy_arrayof_ref(procs, index);
+
+        ++ps_tree->procs_size;
     }
 
-    return NULL;
+    proc->ps_name = NULL;
+    proc->flags = 0;
+    fort_pstree_proc_verdict_reset(proc);
+
+    /* Add to procs map */
+    fort_psmap_insert(&ps_tree->procs_map, &proc->map_node, processId, pid_hash);
+
+    return proc;
+}
+
+static void fort_pstree_proc_del(PFORT_PSTREE ps_tree, PFORT_PSNODE proc)
+{
+    /* Delete from procs map: the name is freed on reclaim, when no reader can see it */
+    fort_psmap_remove(&ps_tree->procs_map, &proc->map_node);
+
+    fort_pstree_procs_reclaim(ps_tree);
+}
+
+static PFORT_PSNODE fort_pstree_find_proc_hash(
+        PFORT_PSTREE ps_tree, DWORD processId, UINT32 pid_hash)
+{
+    return (PFORT_PSNODE) fort_psmap_find(&ps_tree->procs_map, processId, pid_hash);
 }
 
 static PFORT_PSNODE fort_pstree_find_proc(PFORT_PSTREE ps_tree, DWORD processId)
@@ -386,7 +436,7 @@ static PFORT_PSNODE fort_pstree_find_proc(PFORT_PSTREE ps_tree, DWORD processId)
     if (processId == 0)
         return NULL;
 
-    const tommy_key_t pid_hash = fort_pstree_proc_hash(processId);
+    const UINT32 pid_hash = fort_pstree_proc_hash(processId);
 
     return fort_pstree_find_proc_hash(ps_tree, processId, pid_hash);
 }
@@ -400,7 +450,7 @@ inline static void fort_pstree_proc_set_name(
 
     RtlCopyMemory(ps_name->data, path_buf, path_len);
 
-    proc->ps_name = ps_name;
+    fort_pstree_proc_set_ps_name(proc, ps_name);
 }
 
 inline static void fort_pstree_check_proc_app_flags(PFORT_PSTREE ps_tree, PFORT_PSNODE proc,
@@ -417,6 +467,7 @@ inline static void fort_pstree_check_proc_app_flags(PFORT_PSTREE ps_tree, PFORT_
         }
 
         proc->flags |= FORT_PSNODE_NAME_INHERIT;
+        fort_pstree_proc_verdict_reset(proc);
     }
 }
 
@@ -455,7 +506,7 @@ inline static BOOL fort_pstree_check_proc_inherited(
     assert(ps_name != NULL);
 
     ++ps_name->refcount;
-    proc->ps_name = ps_name;
+    fort_pstree_proc_set_ps_name(proc, ps_name);
 
     proc->flags |= FORT_PSNODE_NAME_INHERITED;
 
@@ -483,13 +534,10 @@ static void fort_pstree_check_proc_inheritance(
 
 static PFORT_PSNODE fort_pstree_handle_new_proc(PFORT_PSTREE ps_tree, PCFORT_PSINFO_HASH psi)
 {
-    PFORT_PSNODE proc = fort_pstree_proc_new(ps_tree, psi->pid_hash);
+    PFORT_PSNODE proc = fort_pstree_proc_new(ps_tree, psi->processId, psi->pid_hash);
     if (proc == NULL)
         return NULL;
 
-    proc->process_id = psi->processId;
-    proc->flags = 0;
-
     fort_pstree_proc_check_svchost(ps_tree, psi, proc);
 
     fort_pstree_check_proc_inheritance(ps_tree, psi, proc);
@@ -580,9 +628,14 @@ inline static BOOL fort_pstree_notify_process_prepare(
         fort_pstree_proc_del(ps_tree, proc);
     }
 
+    /* The process id could be reused by another process */
+    if (ps_tree->svctab != NULL) {
+        fort_svctab_remove_pid(ps_tree->svctab, psi->processId);
+    }
+
     /* Check parent process */
     if (createInfo != NULL && !fort_is_system_process(psi->parentProcessId, -1)) {
-        const tommy_key_t ppid_hash = fort_pstree_proc_hash(psi->parentProcessId);
+        const UINT32 ppid_hash = fort_pstree_proc_hash(psi->parentProcessId);
         PFORT_PSNODE parentProc =
                 fort_pstree_find_proc_hash(ps_tree, psi->parentProcessId, ppid_hash);
 
@@ -673,10 +726,13 @@ FORT_API void fort_pstree_open(PFORT_PSTREE ps_tree)
     fort_pool_list_init(&ps_tree->pool_list);
     fort_pool_init(&ps_tree->pool_list, FORT_PSTREE_NAMES_POOL_SIZE);
 
-    tommy_list_init(&ps_tree->free_procs);
+    ps_tree->free_procs = NULL;
 
     tommy_arrayof_init(&ps_tree->procs, sizeof(FORT_PSNODE));
-    tommy_hashdyn_init(&ps_tree->procs_map);
+
+    fort_psmap_init(&ps_tree->procs_map, ps_tree->procs_buckets, FORT_PSMAP_BUCKET_COUNT);
+
+    fort_psenum_init(&ps_tree->psenum, /*buffer=*/NULL, /*buffer_size=*/0);
 
     KeInitializeSpinLock(&ps_tree->lock);
 
@@ -693,35 +749,34 @@ FORT_API void fort_pstree_close(PFORT_PSTREE ps_tree)
         fort_pool_done(&ps_tree->pool_list);
 
         tommy_arrayof_done(&ps_tree->procs);
-        tommy_hashdyn_done(&ps_tree->procs_map);
+
+        fort_pstree_svctab_set(ps_tree, NULL);
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
 
 inline static BOOL fort_pstree_enum_process_exists(
-        PFORT_PSTREE ps_tree, DWORD processId, tommy_key_t pid_hash)
+        PFORT_PSTREE ps_tree, DWORD processId, UINT32 pid_hash)
 {
-    PFORT_PSNODE proc;
+    const UINT32 read_token = fort_pstree_read_begin(ps_tree);
 
-    KLOCK_QUEUE_HANDLE lock_queue;
-    KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
-    {
-        proc = fort_pstree_find_proc_hash(ps_tree, processId, pid_hash);
-    }
-    KeReleaseInStackQueuedSpinLock(&lock_queue);
+    const PFORT_PSNODE proc = fort_pstree_find_proc_hash(ps_tree, processId, pid_hash);
+
+    fort_pstree_read_end(ps_tree, read_token);
 
     return (proc != NULL);
 }
 
-inline static void fort_pstree_enum_process(PFORT_PSTREE ps_tree, PSYSTEM_PROCESSES processEntry)
+inline static void fort_pstree_enum_process(
+        PFORT_PSTREE ps_tree, const FORT_PSENUM_ENTRY *entry)
 {
-    const DWORD processId = (DWORD) processEntry->ProcessId;
-    const DWORD parentProcessId = (DWORD) processEntry->ParentProcessId;
+    const DWORD processId = entry->process_id;
+    const DWORD parentProcessId = entry->parent_process_id;
 
     if (fort_is_system_process(processId, parentProcessId))
         return; /* skip System (sub)processes */
 
-    const tommy_key_t pid_hash = fort_pstree_proc_hash(processId);
+    const UINT32 pid_hash = fort_pstree_proc_hash(processId);
 
     if (fort_pstree_enum_process_exists(ps_tree, processId, pid_hash))
         return;
@@ -735,49 +790,196 @@ inline static void fort_pstree_enum_process(PFORT_PSTREE ps_tree, PSYSTEM_PROCES
     fort_pstree_handle_created_proc(ps_tree, &psi);
 }
 
-inline static void fort_pstree_enum_processes_loop(
-        PFORT_PSTREE ps_tree, PSYSTEM_PROCESSES processEntry)
+static void fort_pstree_psenum_free(PFORT_PSENUM psenum)
 {
-    for (;;) {
-        fort_pstree_enum_process(ps_tree, processEntry);
-
-        const ULONG nextEntryOffset = processEntry->NextEntryOffset;
-        if (nextEntryOffset == 0)
-            break;
+    if (psenum->buffer != NULL) {
+        fort_mem_free(psenum->buffer, FORT_PSTREE_POOL_TAG);
+    }
 
-        processEntry = (PSYSTEM_PROCESSES) ((PUCHAR) processEntry + nextEntryOffset);
+    if (psenum->pids != NULL) {
+        fort_mem_free(psenum->pids, FORT_PSTREE_POOL_TAG);
     }
+
+    fort_psenum_init(psenum, /*buffer=*/NULL, /*buffer_size=*/0);
 }
 
-FORT_API void fort_pstree_enum_processes(PFORT_PSTREE ps_tree)
+static void fort_pstree_enum_buffer_free(PFORT_PSTREE ps_tree)
+{
+    fort_pstree_psenum_free(&ps_tree->psenum);
+}
+
+static PVOID fort_pstree_enum_buffer_new(ULONG *buffer_size)
 {
     NTSTATUS status;
 
     ULONG bufferSize;
     status = ZwQuerySystemInformation(SystemProcessInformation, NULL, 0, &bufferSize);
     if (status != STATUS_INFO_LENGTH_MISMATCH)
-        return;
+        return NULL;
 
     bufferSize *= 2; /* for possibly new created processes/threads */
     bufferSize = FORT_ALIGN_SIZE(bufferSize, sizeof(PVOID));
 
     PVOID buffer = fort_mem_alloc(bufferSize, FORT_PSTREE_POOL_TAG);
     if (buffer == NULL)
-        return;
+        return NULL;
 
     status = ZwQuerySystemInformation(SystemProcessInformation, buffer, bufferSize, NULL);
-    if (NT_SUCCESS(status)) {
-        fort_pstree_enum_processes_loop(&fort_device()->ps_tree, buffer);
-    } else {
+    if (!NT_SUCCESS(status)) {
         LOG("PsTree: Enum Processes Error: %x\n", status);
         TRACE(FORT_PSTREE_ENUM_PROCESSES_ERROR, status, 0, 0);
+
+        fort_mem_free(buffer, FORT_PSTREE_POOL_TAG);
+        return NULL;
     }
 
-    fort_mem_free(buffer, FORT_PSTREE_POOL_TAG);
+    *buffer_size = bufferSize;
+
+    return buffer;
+}
+
+static BOOL fort_pstree_psenum_new(PFORT_PSENUM psenum)
+{
+    ULONG bufferSize = 0;
+    PVOID buffer = fort_pstree_enum_buffer_new(&bufferSize);
+    if (buffer == NULL)
+        return FALSE;
+
+    fort_psenum_init(psenum, buffer, bufferSize);
+
+    /* Index the processes by id: the pending lookups run under the lock */
+    const UINT32 pids_n = fort_psenum_count(psenum);
+    if (pids_n != 0) {
+        PFORT_PSENUM_PID pids =
+                fort_mem_alloc(pids_n * sizeof(FORT_PSENUM_PID), FORT_PSTREE_POOL_TAG);
+        if (pids != NULL) {
+            fort_psenum_index(psenum, pids, pids_n);
+        }
+    }
+
+    return TRUE;
 }
 
-static BOOL fort_pstree_get_proc_name_locked(PFORT_PSTREE ps_tree, DWORD processId,
-        PUNICODE_STRING path, BOOL *isSvcHost, BOOL *inherited)
+/* Returns TRUE, when the batches must be processed by fort_pstree_enum_processes_batch() */
+FORT_API BOOL fort_pstree_enum_processes(PFORT_PSTREE ps_tree)
+{
+    FORT_PSENUM psenum;
+    if (!fort_pstree_psenum_new(&psenum))
+        return FALSE;
+
+    BOOL started = FALSE;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
+    {
+        /* The previous enumeration is still in progress */
+        if (fort_psenum_is_done(&ps_tree->psenum)) {
+            ps_tree->psenum = psenum;
+
+            started = TRUE;
+        }
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    if (!started) {
+        fort_pstree_psenum_free(&psenum);
+    }
+
+    return started;
+}
+
+static UINT16 fort_pstree_enum_requested_locked(
+        PFORT_PSTREE ps_tree, PFORT_PSENUM_ENTRY entries)
+{
+    UINT16 count = 0;
+
+    for (int i = 0; i < FORT_PSTREE_REQUESTED_PIDS_COUNT; ++i) {
+        LONG volatile *slot = (LONG volatile *) &ps_tree->requested_pids[i];
+
+        const UINT32 processId = (UINT32) InterlockedExchange(slot, 0);
+        if (processId == 0)
+            continue;
+
+        if (fort_psenum_find_pending(&ps_tree->psenum, processId, &entries[count])) {
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+/* Returns TRUE, when there are more batches to process */
+FORT_API BOOL fort_pstree_enum_processes_batch(PFORT_PSTREE ps_tree)
+{
+    FORT_PSENUM_ENTRY entries[FORT_PSENUM_BATCH_SIZE];
+    UINT16 count;
+    BOOL more;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
+    {
+        PFORT_PSENUM psenum = &ps_tree->psenum;
+
+        /* The requested processes are resolved first */
+        count = fort_pstree_enum_requested_locked(ps_tree, entries);
+
+        count += fort_psenum_next_batch(
+                psenum, entries + count, FORT_PSENUM_BATCH_SIZE - count);
+
+        more = !fort_psenum_is_done(psenum);
+        if (!more) {
+            fort_pstree_enum_buffer_free(ps_tree);
+        }
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    for (UINT16 i = 0; i < count; ++i) {
+        fort_pstree_enum_process(ps_tree, &entries[i]);
+    }
+
+    return more;
+}
+
+FORT_API void fort_pstree_enum_processes_cancel(PFORT_PSTREE ps_tree)
+{
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
+    {
+        fort_pstree_enum_buffer_free(ps_tree);
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+}
+
+/* Request the not enumerated yet process to be resolved by the next batch */
+FORT_API void fort_pstree_enum_request_proc(PFORT_PSTREE ps_tree, DWORD processId)
+{
+    if (fort_psenum_is_done(&ps_tree->psenum))
+        return;
+
+    for (int i = 0; i < FORT_PSTREE_REQUESTED_PIDS_COUNT; ++i) {
+        LONG volatile *slot = (LONG volatile *) &ps_tree->requested_pids[i];
+
+        const LONG pid = InterlockedCompareExchange(slot, (LONG) processId, 0);
+        if (pid == 0 || pid == (LONG) processId)
+            break; /* requested */
+    }
+}
+
+FORT_API UINT32 fort_pstree_read_begin(PFORT_PSTREE ps_tree)
+{
+    const UINT32 slot = KeGetCurrentProcessorNumberEx(NULL);
+
+    return fort_psmap_read_begin(&ps_tree->procs_map, slot);
+}
+
+FORT_API void fort_pstree_read_end(PFORT_PSTREE ps_tree, UINT32 read_token)
+{
+    fort_psmap_read_end(&ps_tree->procs_map, read_token);
+}
+
+/* Must be called between fort_pstree_read_begin() and fort_pstree_read_end() */
+FORT_API BOOL fort_pstree_get_proc_name(PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path,
+        BOOL *isSvcHost, BOOL *inherited, PFORT_APP_VERDICT verdict)
 {
     PFORT_PSNODE proc = fort_pstree_find_proc(ps_tree, processId);
     if (proc == NULL)
@@ -800,35 +1002,48 @@ static BOOL fort_pstree_get_proc_name_locked(PFORT_PSTREE ps_tree, DWORD process
 
     *inherited = (procFlags & FORT_PSNODE_NAME_INHERITED) != 0;
 
+    fort_conf_app_verdict_copy(verdict, &proc->verdict);
+
     return TRUE;
 }
 
-FORT_API BOOL fort_pstree_get_proc_name(PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path,
-        BOOL *isSvcHost, BOOL *inherited)
+static void fort_pstree_set_app_verdict_locked(PFORT_PSTREE ps_tree, DWORD processId,
+        PCUNICODE_STRING path, UINT32 conf_generation, FORT_APP_DATA app_data)
 {
-    BOOL res;
+    PFORT_PSNODE proc = fort_pstree_find_proc(ps_tree, processId);
+    if (proc == NULL)
+        return;
 
+    /* The process name could be changed while the verdict was computed */
+    PFORT_PSNAME ps_name = proc->ps_name;
+    if (ps_name == NULL || ps_name->data != path->Buffer)
+        return;
+
+    fort_conf_app_verdict_set(&proc->verdict, conf_generation, app_data);
+}
+
+FORT_API void fort_pstree_set_app_verdict(PFORT_PSTREE ps_tree, DWORD processId,
+        PCUNICODE_STRING path, UINT32 conf_generation, FORT_APP_DATA app_data)
+{
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
     {
-        res = fort_pstree_get_proc_name_locked(ps_tree, processId, path, isSvcHost, inherited);
+        fort_pstree_set_app_verdict_locked(ps_tree, processId, path, conf_generation, app_data);
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
-
-    return res;
 }
 
 inline static void fort_pstree_update_service_proc(
         PFORT_PSTREE ps_tree, PCUNICODE_STRING serviceName, DWORD processId)
 {
-    const tommy_key_t pid_hash = fort_pstree_proc_hash(processId);
+    if (processId == 0)
+        return; /* removed service */
+
+    const UINT32 pid_hash = fort_pstree_proc_hash(processId);
 
     PFORT_PSNODE proc = fort_pstree_find_proc_hash(ps_tree, processId, pid_hash);
     if (proc == NULL) {
-        proc = fort_pstree_proc_new(ps_tree, pid_hash);
-
-        proc->process_id = processId;
-        proc->flags = 0;
+        proc = fort_pstree_proc_new(ps_tree, processId, pid_hash);
     }
 
     if (proc != NULL && proc->ps_name == NULL) {
@@ -863,6 +1078,8 @@ FORT_API void fort_pstree_update_services(
     KLOCK_QUEUE_HANDLE lock_queue;
     KeAcquireInStackQueuedSpinLock(&ps_tree->lock, &lock_queue);
     {
+        fort_pstree_svctab_update(ps_tree, services, data_len);
+
         PCHAR data = (PCHAR) services->data;
         const PCHAR end_data = data + data_len;
 
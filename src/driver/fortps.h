@@ -3,25 +3,40 @@
 
 #include "fortdrv.h"
 
+#include "common/fortpsenum.h"
+#include "common/fortpsmap.h"
+#include "common/fortsvctab.h"
+
 #include "fortcnf.h"
 #include "fortpool.h"
 #include "forttds.h"
 
 #define FORT_PSTREE_ACTIVE 0x0001
 
+#define FORT_PSTREE_REQUESTED_PIDS_COUNT 8
+
 typedef struct fort_pstree
 {
     UCHAR volatile flags;
 
-    UINT16 procs_n;
+    UINT16 procs_size; /* allocated nodes */
 
     FORT_POOL_LIST pool_list;
-    tommy_list free_procs;
+    PFORT_PSMAP_NODE free_procs;
 
     tommy_arrayof procs;
-    tommy_hashdyn procs_map;
 
-    KSPIN_LOCK lock;
+    FORT_PSMAP procs_map;
+    PFORT_PSMAP_NODE volatile procs_buckets[FORT_PSMAP_BUCKET_COUNT];
+
+    FORT_PSENUM psenum; /* startup processes enumeration */
+
+    /* not enumerated yet processes to be resolved first by the worker */
+    UINT32 volatile requested_pids[FORT_PSTREE_REQUESTED_PIDS_COUNT];
+
+    PFORT_SVCTAB svctab; /* services of svchost processes */
+
+    KSPIN_LOCK lock; /* serializes the writers, the readers are lock-free */
 } FORT_PSTREE, *PFORT_PSTREE;
 
 #if defined(__cplusplus)
@@ -32,10 +47,23 @@ FORT_API void fort_pstree_open(PFORT_PSTREE ps_tree);
 
 FORT_API void fort_pstree_close(PFORT_PSTREE ps_tree);
 
-FORT_API void fort_pstree_enum_processes(PFORT_PSTREE ps_tree);
+FORT_API BOOL fort_pstree_enum_processes(PFORT_PSTREE ps_tree);
+
+FORT_API BOOL fort_pstree_enum_processes_batch(PFORT_PSTREE ps_tree);
+
+FORT_API void fort_pstree_enum_processes_cancel(PFORT_PSTREE ps_tree);
+
+FORT_API void fort_pstree_enum_request_proc(PFORT_PSTREE ps_tree, DWORD processId);
+
+FORT_API UINT32 fort_pstree_read_begin(PFORT_PSTREE ps_tree);
+
+FORT_API void fort_pstree_read_end(PFORT_PSTREE ps_tree, UINT32 read_token);
 
 FORT_API BOOL fort_pstree_get_proc_name(PFORT_PSTREE ps_tree, DWORD processId, PUNICODE_STRING path,
-        BOOL *isSvcHost, BOOL *inherited);
+        BOOL *isSvcHost, BOOL *inherited, PFORT_APP_VERDICT verdict);
+
+FORT_API void fort_pstree_set_app_verdict(PFORT_PSTREE ps_tree, DWORD processId,
+        PCUNICODE_STRING path, UINT32 conf_generation, FORT_APP_DATA app_data);
 
 FORT_API void fort_pstree_update_services(
         PFORT_PSTREE ps_tree, const PFORT_SERVICE_INFO_LIST services, ULONG data_len);
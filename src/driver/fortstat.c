@@ -4,6 +4,9 @@
 
 #define FORT_STAT_POOL_TAG 'SwfF'
 
+/* Reserve the flows table ahead, when more than 2/3 of its buckets are used */
+#define FORT_STAT_FLOWS_RESERVE_CAPACITY(count) ((count) + (count) / 2)
+
 #define FORT_PROC_BAD_INDEX ((UINT16) -1)
 #define FORT_PROC_COUNT_MAX 0xFFFF
 
@@ -282,7 +285,7 @@ static void fort_flow_context_remove(PVOID stat_arg, PVOID flow_node)
 
 static PFORT_FLOW fort_flow_get(PFORT_STAT stat, UINT64 flow_id, tommy_key_t flow_hash)
 {
-    PFORT_FLOW flow = (PFORT_FLOW) tommy_hashdyn_bucket(&stat->flows_map, flow_hash);
+    PFORT_FLOW flow = (PFORT_FLOW) fort_flowtab_bucket(&stat->flows_map, flow_hash);
 
     while (flow != NULL) {
         if (flow->flow_id == flow_id)
@@ -297,13 +300,47 @@ static void fort_flow_free(PFORT_STAT stat, PFORT_FLOW flow)
 {
     fort_stat_proc_dec(stat, flow->opt.proc_index);
 
-    tommy_hashdyn_remove_existing(&stat->flows_map, (tommy_hashdyn_node *) flow);
+    fort_flowtab_remove(&stat->flows_map, (PFORT_FLOWTAB_NODE) flow);
 
     /* Add to free chain */
     flow->next = stat->flow_free;
     stat->flow_free = flow;
 }
 
+static void fort_stat_flows_reserve(PFORT_STAT stat, UINT32 capacity)
+{
+    for (;;) {
+        UINT32 size;
+
+        KLOCK_QUEUE_HANDLE lock_queue;
+        KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
+        {
+            size = fort_flowtab_reserve_size(&stat->flows_map, capacity);
+        }
+        KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+        if (size == 0)
+            break;
+
+        PVOID segment = fort_mem_alloc(size, FORT_STAT_POOL_TAG);
+        if (segment == NULL)
+            break;
+
+        BOOL added;
+
+        KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
+        {
+            added = fort_flowtab_segment_add(&stat->flows_map, segment, size);
+        }
+        KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+        /* The table could be grown meanwhile */
+        if (!added) {
+            fort_mem_free(segment, FORT_STAT_POOL_TAG);
+        }
+    }
+}
+
 static PFORT_FLOW fort_flow_new(PFORT_STAT stat, UINT64 flow_id, const tommy_key_t flow_hash,
         BOOL isIPv6, BOOL is_tcp, BOOL inbound)
 {
@@ -322,7 +359,14 @@ static PFORT_FLOW fort_flow_new(PFORT_STAT stat, UINT64 flow_id, const tommy_key
         flow = tommy_arrayof_ref(&stat->flows, size);
     }
 
-    tommy_hashdyn_insert(&stat->flows_map, (tommy_hashdyn_node *) flow, NULL, flow_hash);
+    fort_flowtab_insert(&stat->flows_map, (PFORT_FLOWTAB_NODE) flow, flow_hash);
+
+    /* The worker grows the table out of the lock, it works with longer chains meanwhile */
+    const UINT32 capacity = FORT_STAT_FLOWS_RESERVE_CAPACITY(fort_flowtab_count(&stat->flows_map));
+
+    if (fort_flowtab_reserve_size(&stat->flows_map, capacity) != 0) {
+        fort_stat_flags_set(stat, FORT_STAT_FLOWS_RESERVE, TRUE);
+    }
 
     flow->flow_id = flow_id;
 
@@ -387,7 +431,7 @@ FORT_API void fort_stat_open(PFORT_STAT stat)
     tommy_hashdyn_init(&stat->procs_map);
 
     tommy_arrayof_init(&stat->flows, sizeof(FORT_FLOW));
-    tommy_hashdyn_init(&stat->flows_map);
+    fort_flowtab_init(&stat->flows_map);
 
     KeInitializeSpinLock(&stat->lock);
 }
@@ -402,7 +446,7 @@ FORT_API void fort_stat_close_flows(PFORT_STAT stat)
         if ((flags & FORT_STAT_CLOSED) == 0) {
             fort_stat_flags_set(stat, FORT_STAT_CLOSED, TRUE);
 
-            InterlockedAdd(&stat->flow_closing_count, (LONG) tommy_hashdyn_count(&stat->flows_map));
+            InterlockedAdd(&stat->flow_closing_count, (LONG) fort_flowtab_count(&stat->flows_map));
         }
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
@@ -410,7 +454,7 @@ FORT_API void fort_stat_close_flows(PFORT_STAT stat)
     while (InterlockedAdd(&stat->flow_closing_count, 0) > 0) {
         KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
         {
-            tommy_hashdyn_foreach_node_arg(&stat->flows_map, &fort_flow_context_remove, stat);
+            fort_flowtab_foreach_arg(&stat->flows_map, &fort_flow_context_remove, stat);
         }
         KeReleaseInStackQueuedSpinLock(&lock_queue);
 
@@ -434,7 +478,11 @@ FORT_API void fort_stat_close(PFORT_STAT stat)
     tommy_hashdyn_done(&stat->procs_map);
 
     tommy_arrayof_done(&stat->flows);
-    tommy_hashdyn_done(&stat->flows_map);
+
+    PVOID segment;
+    while ((segment = fort_flowtab_segment_pop(&stat->flows_map)) != NULL) {
+        fort_mem_free(segment, FORT_STAT_POOL_TAG);
+    }
 
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
@@ -466,6 +514,24 @@ FORT_API void fort_stat_conf_update(PFORT_STAT stat, const PFORT_CONF_IO conf_io
         stat->conf_group = conf_io->conf_group;
     }
     KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    fort_stat_flows_reserve(stat, conf_io->flows_capacity);
+}
+
+FORT_API void fort_stat_flows_reserve_ahead(PFORT_STAT stat)
+{
+    fort_stat_flags_set(stat, FORT_STAT_FLOWS_RESERVE, FALSE);
+
+    UINT32 count;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
+    {
+        count = fort_flowtab_count(&stat->flows_map);
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    fort_stat_flows_reserve(stat, FORT_STAT_FLOWS_RESERVE_CAPACITY(count));
 }
 
 FORT_API void fort_stat_conf_flags_update(PFORT_STAT stat, const PFORT_CONF_FLAGS conf_flags)
@@ -578,6 +644,21 @@ FORT_API void fort_flow_classify(PFORT_STAT stat, UINT64 flowContext, UINT32 dat
     KeReleaseInStackQueuedSpinLock(&lock_queue);
 }
 
+FORT_API UINT32 fort_stat_flows_count(PFORT_STAT stat, UINT32 *buckets_n)
+{
+    UINT32 count;
+
+    KLOCK_QUEUE_HANDLE lock_queue;
+    KeAcquireInStackQueuedSpinLock(&stat->lock, &lock_queue);
+    {
+        count = fort_flowtab_count(&stat->flows_map);
+        *buckets_n = fort_flowtab_buckets_count(&stat->flows_map);
+    }
+    KeReleaseInStackQueuedSpinLock(&lock_queue);
+
+    return count;
+}
+
 FORT_API void fort_stat_dpc_begin(PFORT_STAT stat, PKLOCK_QUEUE_HANDLE lock_queue)
 {
     KeAcquireInStackQueuedSpinLockAtDpcLevel(&stat->lock, lock_queue);
@@ -4,6 +4,7 @@
 #include "fortdrv.h"
 
 #include "common/fortconf.h"
+#include "common/fortflowtab.h"
 #include "forttds.h"
 
 #define FORT_STATUS_FLOW_BLOCK STATUS_NOT_SAME_DEVICE
@@ -64,32 +65,21 @@ typedef struct fort_flow_opt
     };
 } FORT_FLOW_OPT, *PFORT_FLOW_OPT;
 
-/* Synchronize with tommy_hashdyn_node! */
+/* Synchronize with FORT_FLOWTAB_NODE! */
 typedef struct fort_flow
 {
     struct fort_flow *next;
-    struct fort_flow *prev;
-
-    union {
-#if defined(_WIN64)
-        UINT64 flow_id;
-#else
-        FORT_FLOW_OPT opt;
-#endif
-        void *data; /* tommy_hashdyn_node::data */
-    };
 
-    tommy_key_t flow_hash; /* tommy_hashdyn_node::index */
+    UINT32 flow_hash; /* FORT_FLOWTAB_NODE::hash */
 
-#if defined(_WIN64)
     FORT_FLOW_OPT opt;
-#else
+
     UINT64 flow_id;
-#endif
 } FORT_FLOW, *PFORT_FLOW;
 
 #define FORT_STAT_LOG                 0x01
 #define FORT_STAT_SYSTEM_TIME_CHANGED 0x02
+#define FORT_STAT_FLOWS_RESERVE       0x04 /* the flows table needs more buckets */
 #define FORT_STAT_CLOSED              0x10 /* used on driver unloading */
 
 #define FORT_STAT_ALE_CALLOUT_IDS_COUNT    4
@@ -134,7 +124,7 @@ typedef struct fort_stat
     tommy_hashdyn procs_map;
 
     tommy_arrayof flows;
-    tommy_hashdyn flows_map;
+    FORT_FLOWTAB flows_map;
 
     FORT_CONF_GROUP conf_group;
 
@@ -165,6 +155,9 @@ FORT_API void fort_stat_log_update(PFORT_STAT stat, BOOL log_stat);
 
 FORT_API void fort_stat_conf_update(PFORT_STAT stat, const PFORT_CONF_IO conf_io);
 
+/* Called by the worker, when FORT_STAT_FLOWS_RESERVE is set */
+FORT_API void fort_stat_flows_reserve_ahead(PFORT_STAT stat);
+
 FORT_API void fort_stat_conf_flags_update(PFORT_STAT stat, const PFORT_CONF_FLAGS conf_flags);
 
 FORT_API NTSTATUS fort_flow_associate(PFORT_STAT stat, UINT64 flow_id, UINT32 process_id,
@@ -175,6 +168,8 @@ FORT_API void fort_flow_delete(PFORT_STAT stat, UINT64 flowContext);
 FORT_API void fort_flow_classify(
         PFORT_STAT stat, UINT64 flowContext, UINT32 data_len, BOOL inbound);
 
+FORT_API UINT32 fort_stat_flows_count(PFORT_STAT stat, UINT32 *buckets_n);
+
 FORT_API void fort_stat_dpc_begin(PFORT_STAT stat, PKLOCK_QUEUE_HANDLE lock_queue);
 
 FORT_API void fort_stat_dpc_end(PKLOCK_QUEUE_HANDLE lock_queue);
@@ -1,9 +1,11 @@
-/* Fort Firewall Driver Trace Events to System Log */
+/* Fort Firewall Driver Trace Events to System Log and Trace Ring */
 
 #include "forttrace.h"
 
 #include "fortdev.h"
 
+#define FORT_TRACE_POOL_TAG 'TwfF'
+
 FORT_API void fort_trace_event(
         NTSTATUS event_code, NTSTATUS status, ULONG error_value, ULONG sequence)
 {
@@ -29,3 +31,34 @@ FORT_API void fort_trace_event(
 
     IoWriteErrorLogEntry(packet);
 }
+
+FORT_API void fort_trace_ring_open(PFORT_TRC_RING ring)
+{
+    LARGE_INTEGER ticks_freq;
+    KeQueryPerformanceCounter(&ticks_freq);
+
+    /* Works without the tracing on allocation failure */
+    PFORT_TRC_RECORD records = fort_mem_alloc(
+            FORT_TRC_RECORDS_SIZE(FORT_TRC_RING_RECORDS), FORT_TRACE_POOL_TAG);
+
+    fort_trc_ring_init(ring, records, FORT_TRC_RING_RECORDS, ticks_freq.QuadPart);
+}
+
+FORT_API void fort_trace_ring_close(PFORT_TRC_RING ring)
+{
+    PFORT_TRC_RECORD records = ring->records;
+
+    fort_trc_ring_init(ring, NULL, 0, 0);
+
+    if (records != NULL) {
+        fort_mem_free(records, FORT_TRACE_POOL_TAG);
+    }
+}
+
+FORT_API void fort_trace_ring_add(UINT16 event_id, UINT32 d0, UINT32 d1, UINT32 d2)
+{
+    const LARGE_INTEGER now = KeQueryPerformanceCounter(NULL);
+    const UINT16 cpu = (UINT16) KeGetCurrentProcessorNumberEx(NULL);
+
+    fort_trc_ring_write(&fort_device()->trace_ring, event_id, cpu, now.QuadPart, d0, d1, d2);
+}
@@ -3,11 +3,16 @@
 
 #include "fortdrv.h"
 
+#include "common/forttrc.h"
+
 #include "evt/fortevt.h"
 
 #define TRACE(event_code, status, error_value, sequence)                                           \
     fort_trace_event((event_code), (status), (error_value), (sequence))
 
+#define TRACE_RING(event_id, d0, d1, d2)                                                           \
+    fort_trace_ring_add((event_id), (UINT32) (d0), (UINT32) (d1), (UINT32) (d2))
+
 #if defined(__cplusplus)
 extern "C" {
 #endif
@@ -15,6 +20,12 @@ extern "C" {
 FORT_API void fort_trace_event(
         NTSTATUS event_code, NTSTATUS status, ULONG error_value, ULONG sequence);
 
+FORT_API void fort_trace_ring_open(PFORT_TRC_RING ring);
+
+FORT_API void fort_trace_ring_close(PFORT_TRC_RING ring);
+
+FORT_API void fort_trace_ring_add(UINT16 event_id, UINT32 d0, UINT32 d1, UINT32 d2);
+
 #ifdef __cplusplus
 } // extern "C"
 #endif
@@ -5,6 +5,8 @@
 
 enum FORT_WORKER_TYPE {
     FORT_WORKER_REAUTH = 0,
+    FORT_WORKER_PSTREE,
+    FORT_WORKER_FLOWS,
     FORT_WORKER_FUNC_COUNT,
 };
 
@@ -121,6 +121,16 @@ typedef struct _SYSTEM_POWER_STATE_CONTEXT
     } DUMMYUNIONNAME;
 } SYSTEM_POWER_STATE_CONTEXT, *PSYSTEM_POWER_STATE_CONTEXT;
 
+typedef struct _FILE_OBJECT
+{
+    SHORT Type;
+    SHORT Size;
+    struct _DEVICE_OBJECT *DeviceObject;
+    PVOID FsContext;
+    PVOID FsContext2;
+    UNICODE_STRING FileName;
+} FILE_OBJECT, *PFILE_OBJECT;
+
 typedef struct
 {
     UCHAR MajorFunction;
@@ -147,6 +157,9 @@ typedef struct
             POWER_ACTION POINTER_ALIGNMENT ShutdownType;
         } Power;
     } Parameters;
+
+    struct _DEVICE_OBJECT *DeviceObject;
+    PFILE_OBJECT FileObject;
 } IO_STACK_LOCATION, *PIO_STACK_LOCATION;
 
 typedef struct
@@ -0,0 +1,20 @@
+isEmpty(GOOGLEBENCHMARK_DIR): GOOGLEBENCHMARK_DIR=$$(GOOGLEBENCHMARK_DIR)
+
+!exists($$GOOGLEBENCHMARK_DIR):message("No Google Benchmark source found: set GOOGLEBENCHMARK_DIR env var.")
+
+GBENCH_PATH = $$GOOGLEBENCHMARK_DIR
+
+requires(exists($$GBENCH_PATH/src/benchmark.cc))
+
+DEFINES += BENCHMARK_STATIC_DEFINE
+
+INCLUDEPATH *= \
+    $$GBENCH_PATH/include
+
+SOURCES += \
+    $$files($$GBENCH_PATH/src/*.cc)
+
+SOURCES -= \
+    $$GBENCH_PATH/src/benchmark_main.cc
+
+win32:LIBS *= -lshlwapi
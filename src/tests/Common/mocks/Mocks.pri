@@ -1,6 +1,10 @@
 
 SOURCES += \
-    $$PWD/mockquotamanager.cpp
+    $$PWD/mockconfappmanager.cpp \
+    $$PWD/mockquotamanager.cpp \
+    $$PWD/mockstatblockmanager.cpp
 
 HEADERS += \
-    $$PWD/mockquotamanager.h
+    $$PWD/mockconfappmanager.h \
+    $$PWD/mockquotamanager.h \
+    $$PWD/mockstatblockmanager.h
@@ -0,0 +1,3 @@
+#include "mockconfappmanager.h"
+
+MockConfAppManager::MockConfAppManager(QObject *parent) : ConfAppManager(parent) { }
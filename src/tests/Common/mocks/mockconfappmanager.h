@@ -0,0 +1,19 @@
+#ifndef MOCKCONFAPPMANAGER_H
+#define MOCKCONFAPPMANAGER_H
+
+#include <googletest.h>
+
+#include <conf/confappmanager.h>
+#include <log/logentryblocked.h>
+
+class MockConfAppManager : public ConfAppManager
+{
+    Q_OBJECT
+
+public:
+    explicit MockConfAppManager(QObject *parent = nullptr);
+
+    MOCK_METHOD1(logBlockedApp, void(const LogEntryBlocked &logEntry));
+};
+
+#endif // MOCKCONFAPPMANAGER_H
@@ -12,12 +12,9 @@ class MockQuotaManager : public QuotaManager
 public:
     explicit MockQuotaManager(QObject *parent = nullptr);
 
-protected:
-    MOCK_CONST_METHOD0(quotaDayAlerted, qint32());
-    MOCK_METHOD1(setQuotaDayAlerted, void(qint32 v));
+    MOCK_CONST_METHOD0(sqliteDb, SqliteDb *());
 
-    MOCK_CONST_METHOD0(quotaMonthAlerted, qint32());
-    MOCK_METHOD1(setQuotaMonthAlerted, void(qint32 v));
+    MOCK_METHOD3(getAppQuotaIds, bool(const QString &appPath, qint64 &appId, qint64 &appGroupId));
 };
 
 #endif // MOCKQUOTAMANAGER_H
@@ -0,0 +1,6 @@
+#include "mockstatblockmanager.h"
+
+MockStatBlockManager::MockStatBlockManager(QObject *parent) :
+    StatBlockManager(":memory:", parent)
+{
+}
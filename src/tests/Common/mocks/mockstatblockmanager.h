@@ -0,0 +1,19 @@
+#ifndef MOCKSTATBLOCKMANAGER_H
+#define MOCKSTATBLOCKMANAGER_H
+
+#include <googletest.h>
+
+#include <log/logentryblockedip.h>
+#include <stat/statblockmanager.h>
+
+class MockStatBlockManager : public StatBlockManager
+{
+    Q_OBJECT
+
+public:
+    explicit MockStatBlockManager(QObject *parent = nullptr);
+
+    MOCK_METHOD1(logBlockedIp, void(const LogEntryBlockedIp &entry));
+};
+
+#endif // MOCKSTATBLOCKMANAGER_H
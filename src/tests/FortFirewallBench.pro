@@ -0,0 +1,8 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    Common \
+    LogTraceReplay \
+    PerfBench
+
+PerfBench.depends = Common
@@ -0,0 +1,23 @@
+include(../../global.pri)
+
+CONFIG += console
+CONFIG -= app_bundle debug_and_release qt
+
+TEMPLATE = app
+
+INCLUDEPATH += $$PWD/../../driver
+
+HEADERS += \
+    fuzz_common.h
+
+SOURCES += \
+    fuzz_conf.c
+
+# Build with clang: qmake CONFIG+=libfuzzer
+# The conf's layout is packed, so unaligned loads are expected
+libfuzzer {
+    QMAKE_CFLAGS += -fsanitize=fuzzer,address,undefined -fno-sanitize=alignment
+    QMAKE_LFLAGS += -fsanitize=fuzzer,address,undefined
+} else {
+    SOURCES += fuzz_main.c
+}
@@ -0,0 +1,63 @@
+#ifndef FUZZ_COMMON_H
+#define FUZZ_COMMON_H
+
+#define FORT_AMALG
+
+#if defined(_WIN32)
+#    include <common/common.h>
+#else
+/* Minimal Windows types to build the driver's common sources on Linux */
+#    define COMMON_H
+
+#    include <stddef.h>
+#    include <stdint.h>
+#    include <string.h>
+
+#    include <common/common_types.h>
+
+typedef int BOOL;
+typedef uint8_t UCHAR, UINT8;
+typedef int8_t INT8;
+typedef uint16_t UINT16, WCHAR;
+typedef int16_t INT16;
+typedef uint32_t UINT32, ULONG, DWORD;
+typedef int32_t INT32, LONG;
+typedef uint64_t UINT64;
+typedef int64_t INT64;
+typedef void *PVOID;
+typedef char *PCHAR;
+typedef const WCHAR *PCWCHAR;
+
+#    define TRUE  1
+#    define FALSE 0
+
+/* Not all of the included API is called by the fuzz target */
+#    define FORT_API static __attribute__((unused))
+
+#    define LOG(...)
+
+#    define FORT_ARRAY_SIZE(a)           (sizeof(a) / sizeof(a[0]))
+#    define FORT_ALIGN_SIZE(size, align) ((((size) + (align - 1)) & ~(align - 1)))
+
+/* Single-threaded fuzzing needs no barriers */
+#    define InterlockedExchange(p, v) (*(p) = (v))
+#    define InterlockedIncrement(p)   (++*(p))
+#    define WriteRelease(p, v)        (*(p) = (v))
+#    define ReadAcquire(p)            (*(p))
+#    define ReadNoFence(p)            (*(p))
+#    define MemoryBarrier()
+
+/* WCHAR is 16-bit, unlike wchar_t */
+#    define wcschr fuzz_wcschr
+
+static const WCHAR *fuzz_wcschr(const WCHAR *str, WCHAR c)
+{
+    for (; *str != c; ++str) {
+        if (*str == 0)
+            return NULL;
+    }
+    return str;
+}
+#endif
+
+#endif // FUZZ_COMMON_H
@@ -0,0 +1,94 @@
+/* Fuzz the driver's conf verifier */
+
+#include "fuzz_common.h"
+
+#include <stdlib.h>
+
+#include <common/fort_wildmatch.c>
+#include <common/fortconf.c>
+
+#define FUZZ_INPUT_CONF  0
+#define FUZZ_INPUT_RULES 1
+#define FUZZ_INPUT_APPS  2
+#define FUZZ_INPUT_ZONES 3
+
+static const WCHAR fuzz_app_path[] = { '\\', 'd', 'e', 'v', 'i', 'c', 'e', '\\', 'a', '.', 'e',
+    'x', 'e', 0 };
+
+static void fuzz_conf_lookup(const PFORT_CONF conf)
+{
+    /* The driver's lookups must stay in bounds of the verified conf */
+    const UINT32 ip4 = 0x0A000001;
+    const ip6_addr_t ip6 = { .addr32 = { 0x20010DB8, 0, 0, 1 } };
+
+    for (int addr_group_index = 0; addr_group_index < 2; ++addr_group_index) {
+        fort_conf_ip_included(conf, NULL, NULL, &ip4, /*isIPv6=*/FALSE, addr_group_index);
+        fort_conf_ip_included(conf, NULL, NULL, ip6.addr32, /*isIPv6=*/TRUE, addr_group_index);
+    }
+
+    fort_conf_app_find(conf, (const PVOID) fuzz_app_path, sizeof(fuzz_app_path) - sizeof(WCHAR),
+            fort_conf_app_exe_find, /*exe_context=*/NULL);
+
+    const FORT_TIME time = { .hour = 12, .minute = 30 };
+    int periods_n = 0;
+
+    fort_conf_app_period_bits(conf, time, &periods_n);
+}
+
+static void fuzz_zones_lookup(const PFORT_CONF_ZONES zones)
+{
+    const UINT32 ip4 = 0x0A000001;
+    const ip6_addr_t ip6 = { .addr32 = { 0x20010DB8, 0, 0, 1 } };
+
+    for (int zone_index = 0; zone_index < FORT_CONF_ZONE_MAX; ++zone_index) {
+        if ((zones->mask & (1u << zone_index)) == 0)
+            continue;
+
+        const PFORT_CONF_ADDR4_LIST addr_list =
+                (const PFORT_CONF_ADDR4_LIST) (zones->data + zones->addr_off[zone_index]);
+
+        fort_conf_ip_inlist(&ip4, addr_list, /*isIPv6=*/FALSE);
+        fort_conf_ip_inlist(ip6.addr32, addr_list, /*isIPv6=*/TRUE);
+    }
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    if (size < 1 || size > FORT_CONF_APPS_LEN_MAX)
+        return 0;
+
+    const uint8_t input_type = data[0] % 4;
+
+    ++data;
+    --size;
+
+    /* Aligned copy as the driver gets in the system buffer */
+    void *buf = malloc(size + 1);
+    memcpy(buf, data, size);
+
+    if (input_type == FUZZ_INPUT_CONF) {
+        const PFORT_CONF conf = buf;
+
+        if (fort_conf_verify(conf, (UINT32) size)) {
+            fuzz_conf_lookup(conf);
+        }
+    } else if (input_type == FUZZ_INPUT_RULES) {
+        const PFORT_CONF_RULES rules = buf;
+
+        fort_conf_rules_verify(rules, (UINT32) size);
+    } else if (input_type == FUZZ_INPUT_ZONES) {
+        const PFORT_CONF_ZONES zones = buf;
+
+        if (fort_conf_zones_verify(zones, (UINT32) size)) {
+            fuzz_zones_lookup(zones);
+        }
+    } else {
+        const PFORT_APP_ENTRIES app_entries = buf;
+
+        fort_conf_app_entries_verify(app_entries, (UINT32) size);
+    }
+
+    free(buf);
+
+    return 0;
+}
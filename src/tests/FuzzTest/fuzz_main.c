@@ -0,0 +1,67 @@
+/* Replay the fuzzer's inputs without libFuzzer */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#define FUZZ_RANDOM_RUNS     100000
+#define FUZZ_RANDOM_SIZE_MAX 512
+
+static int fuzz_replay_file(const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL) {
+        fprintf(stderr, "Cannot open: %s\n", path);
+        return 1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    const long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    uint8_t *data = malloc(size > 0 ? size : 1);
+    const size_t read_size = fread(data, 1, size, fp);
+    fclose(fp);
+
+    LLVMFuzzerTestOneInput(data, read_size);
+
+    free(data);
+
+    return 0;
+}
+
+static void fuzz_random_runs(void)
+{
+    uint8_t data[FUZZ_RANDOM_SIZE_MAX];
+
+    srand(1);
+
+    for (int i = 0; i < FUZZ_RANDOM_RUNS; ++i) {
+        const size_t size = (size_t) rand() % sizeof(data);
+
+        for (size_t j = 0; j < size; ++j) {
+            /* Small values hit the counts and offsets more often */
+            data[j] = (uint8_t) ((rand() & 3) != 0 ? rand() % 8 : rand());
+        }
+
+        LLVMFuzzerTestOneInput(data, size);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2) {
+        fuzz_random_runs();
+        return 0;
+    }
+
+    int res = 0;
+    for (int i = 1; i < argc; ++i) {
+        res |= fuzz_replay_file(argv[i]);
+    }
+
+    return res;
+}
@@ -2,6 +2,7 @@ include(../Common/Common.pri)
 
 HEADERS += \
     tst_logbuffer.h \
+    tst_logtrace.h
 
 SOURCES += \
     tst_main.cpp
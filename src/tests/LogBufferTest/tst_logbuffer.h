@@ -110,6 +110,61 @@ TEST_F(LogBufferTest, blockedIpWriteRead)
     ASSERT_EQ(index, testCount);
 }
 
+TEST_F(LogBufferTest, blockedIpSumWriteRead)
+{
+    const QString path("C:\\test\\");
+
+    const int pathSize = path.size();
+    ASSERT_EQ(pathSize, 8);
+
+    const int entrySize = DriverCommon::logBlockedIpSumSize(pathSize * sizeof(wchar_t));
+
+    const int testCount = 3;
+
+    LogBuffer buf(entrySize * testCount);
+
+    LogEntryBlockedIp entry;
+    entry.setKernelPath(path);
+
+    const qint64 unixTime = DateUtil::getUnixTime();
+
+    // Write
+    for (int i = 0; i < testCount; ++i) {
+        int v = i;
+        entry.setBlockReason(++v);
+        entry.setIpProto(++v);
+        entry.setRemotePort(++v);
+        entry.setRemoteIp4(++v);
+        entry.setPid(++v);
+        entry.setConnCount(1000 + i);
+        entry.setConnTime(unixTime + i);
+
+        buf.writeEntryBlockedIpSum(&entry);
+    }
+
+    ASSERT_EQ(buf.top(), entrySize * testCount);
+
+    // Read
+    int index = 0;
+    while (buf.peekEntryType() == FORT_LOG_TYPE_BLOCKED_IP_SUM) {
+        LogEntryBlockedIp readEntry;
+        buf.readEntryBlockedIpSum(&readEntry);
+
+        const int i = index++;
+        int v = i;
+        ASSERT_EQ(readEntry.type(), FORT_LOG_TYPE_BLOCKED_IP);
+        ASSERT_EQ(readEntry.blockReason(), ++v);
+        ASSERT_EQ(readEntry.ipProto(), ++v);
+        ASSERT_EQ(readEntry.remotePort(), ++v);
+        ASSERT_EQ(readEntry.remoteIp4(), ++v);
+        ASSERT_EQ(readEntry.pid(), ++v);
+        ASSERT_EQ(readEntry.connCount(), 1000 + i);
+        ASSERT_EQ(readEntry.connTime(), unixTime + i);
+        ASSERT_EQ(readEntry.kernelPath(), path);
+    }
+    ASSERT_EQ(index, testCount);
+}
+
 TEST_F(LogBufferTest, timeWriteRead)
 {
     const int entrySize = DriverCommon::logTimeSize();
@@ -0,0 +1,248 @@
+#pragma once
+
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <googletest.h>
+
+#include <conf/firewallconf.h>
+#include <log/logbuffer.h>
+#include <log/logentryblocked.h>
+#include <log/logentryblockedip.h>
+#include <log/logentryprocnew.h>
+#include <log/logentrystattraf.h>
+#include <log/logentrytime.h>
+#include <log/logmanager.h>
+#include <log/logtracefile.h>
+#include <log/logtracereplayer.h>
+#include <stat/statmanager.h>
+#include <util/dateutil.h>
+#include <util/ioc/ioccontainer.h>
+
+#include <mocks/mockconfappmanager.h>
+#include <mocks/mockquotamanager.h>
+#include <mocks/mockstatblockmanager.h>
+
+class LogTraceTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    QTemporaryDir m_tempDir;
+};
+
+void LogTraceTest::SetUp()
+{
+    ASSERT_TRUE(m_tempDir.isValid());
+}
+
+void LogTraceTest::TearDown() { }
+
+namespace {
+
+void writeTimeTrace(const QString &filePath, const QVector<qint64> &unixTimes)
+{
+    LogTraceFile traceFile(filePath);
+    ASSERT_TRUE(traceFile.openWrite());
+
+    for (const qint64 unixTime : unixTimes) {
+        LogBuffer buf;
+
+        LogEntryTime entry(unixTime);
+        entry.setSystemTimeChanged(true);
+        buf.writeEntryTime(&entry);
+
+        ASSERT_TRUE(traceFile.writeBuffer(buf.array().constData(), buf.top()));
+    }
+}
+
+void writeBufferTrace(const QString &filePath, LogBuffer &buf)
+{
+    LogTraceFile traceFile(filePath);
+    ASSERT_TRUE(traceFile.openWrite());
+
+    ASSERT_TRUE(traceFile.writeBuffer(buf.array().constData(), buf.top()));
+}
+
+}
+
+TEST_F(LogTraceTest, fileWriteRead)
+{
+    const QString filePath = m_tempDir.filePath("log.trace");
+    const QVector<qint64> unixTimes = { 1000, 2000, 3000 };
+
+    writeTimeTrace(filePath, unixTimes);
+
+    LogTraceFile traceFile(filePath);
+    ASSERT_TRUE(traceFile.openRead());
+
+    LogBuffer buf;
+    qint64 elapsedNsecs = 0;
+    qint64 lastElapsedNsecs = 0;
+
+    for (const qint64 unixTime : unixTimes) {
+        ASSERT_TRUE(traceFile.readBuffer(&buf, elapsedNsecs));
+        ASSERT_GE(elapsedNsecs, lastElapsedNsecs);
+        lastElapsedNsecs = elapsedNsecs;
+
+        ASSERT_EQ(buf.peekEntryType(), FORT_LOG_TYPE_TIME);
+
+        LogEntryTime entry;
+        buf.readEntryTime(&entry);
+        ASSERT_EQ(entry.unixTime(), unixTime);
+
+        ASSERT_EQ(buf.peekEntryType(), FORT_LOG_TYPE_NONE);
+    }
+
+    ASSERT_FALSE(traceFile.readBuffer(&buf, elapsedNsecs));
+}
+
+TEST_F(LogTraceTest, badFileRead)
+{
+    const QString filePath = m_tempDir.filePath("bad.trace");
+
+    QFile file(filePath);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("not a trace");
+    file.close();
+
+    LogTraceFile traceFile(filePath);
+    ASSERT_FALSE(traceFile.openRead());
+}
+
+TEST_F(LogTraceTest, replay)
+{
+    const QString filePath = m_tempDir.filePath("log.trace");
+
+    writeTimeTrace(filePath, { 1000, 2000 });
+
+    LogManager logManager;
+    QSignalSpy spy(&logManager, &LogManager::systemTimeChanged);
+
+    LogTraceReplayer replayer(&logManager);
+    ASSERT_TRUE(replayer.replay(filePath, LogTraceReplayer::SpeedMax));
+
+    ASSERT_EQ(replayer.bufferCount(), 2);
+    ASSERT_EQ(replayer.entryCount(), 2);
+    ASSERT_EQ(replayer.readStat().count, 2);
+    ASSERT_EQ(replayer.processStat().count, 2);
+    ASSERT_EQ(spy.count(), 2);
+
+    ASSERT_FALSE(replayer.report().isEmpty());
+}
+
+TEST_F(LogTraceTest, replayBlocked)
+{
+    const QString filePath = m_tempDir.filePath("blocked.trace");
+    const QString kernelPath = "\\Device\\HarddiskVolume1\\test.exe";
+
+    {
+        LogBuffer buf;
+
+        LogEntryBlocked blockedEntry(100, kernelPath);
+        blockedEntry.setBlocked(true);
+        buf.writeEntryBlocked(&blockedEntry);
+
+        LogEntryBlockedIp blockedIpEntry;
+        blockedIpEntry.setKernelPath(kernelPath);
+        blockedIpEntry.setPid(200);
+        blockedIpEntry.setBlockReason(FORT_BLOCK_REASON_PROGRAM);
+        blockedIpEntry.setIpProto(6);
+        blockedIpEntry.setRemoteIp4(0x01020304);
+        blockedIpEntry.setRemotePort(443);
+        buf.writeEntryBlockedIp(&blockedIpEntry);
+
+        blockedIpEntry.setPid(300);
+        blockedIpEntry.setConnCount(5);
+        buf.writeEntryBlockedIpSum(&blockedIpEntry);
+
+        writeBufferTrace(filePath, buf);
+    }
+
+    IocContainer ioc;
+    ASSERT_TRUE(ioc.pinToThread());
+
+    NiceMock<MockConfAppManager> confAppManager;
+    ioc.setService<ConfAppManager>(confAppManager);
+
+    NiceMock<MockStatBlockManager> statBlockManager;
+    ioc.setService<StatBlockManager>(statBlockManager);
+
+    EXPECT_CALL(confAppManager,
+            logBlockedApp(AllOf(Property(&LogEntryBlocked::pid, 100u),
+                    Property(&LogEntryBlocked::blocked, true))))
+            .Times(1);
+
+    EXPECT_CALL(statBlockManager,
+            logBlockedIp(AllOf(Property(&LogEntryBlockedIp::pid, 200u),
+                    Property(&LogEntryBlockedIp::remotePort, 443))))
+            .Times(1);
+    EXPECT_CALL(statBlockManager,
+            logBlockedIp(AllOf(Property(&LogEntryBlockedIp::pid, 300u),
+                    Property(&LogEntryBlockedIp::connCount, 5u))))
+            .Times(1);
+
+    LogManager logManager;
+
+    LogTraceReplayer replayer(&logManager);
+    ASSERT_TRUE(replayer.replay(filePath));
+
+    ASSERT_EQ(replayer.bufferCount(), 1);
+    ASSERT_EQ(replayer.entryCount(), 3);
+}
+
+TEST_F(LogTraceTest, replayStatTraf)
+{
+    const QString filePath = m_tempDir.filePath("stat.trace");
+
+    {
+        LogBuffer buf;
+
+        const LogEntryTime timeEntry(DateUtil::getUnixTime());
+        buf.writeEntryTime(&timeEntry);
+
+        const LogEntryProcNew procEntry1(4, "\\Device\\HarddiskVolume1\\test1.exe");
+        buf.writeEntryProcNew(&procEntry1);
+
+        const LogEntryProcNew procEntry2(8, "\\Device\\HarddiskVolume1\\test2.exe");
+        buf.writeEntryProcNew(&procEntry2);
+
+        // (pid, in bytes, out bytes) per process
+        const quint32 trafBytes[] = { 4, 100, 200, 8, 300, 400 };
+
+        const LogEntryStatTraf statEntry(2, trafBytes);
+        buf.writeEntryStatTraf(&statEntry);
+
+        writeBufferTrace(filePath, buf);
+    }
+
+    IocContainer ioc;
+    ASSERT_TRUE(ioc.pinToThread());
+
+    NiceMock<MockQuotaManager> quotaManager;
+    ioc.setService<QuotaManager>(quotaManager);
+
+    FirewallConf conf;
+
+    StatManager statManager(":memory:");
+    ioc.setService(statManager);
+
+    statManager.setUp();
+    statManager.setConf(&conf);
+
+    QSignalSpy spy(&statManager, &StatManager::trafficAdded);
+
+    LogManager logManager;
+
+    LogTraceReplayer replayer(&logManager);
+    ASSERT_TRUE(replayer.replay(filePath));
+
+    ASSERT_EQ(replayer.entryCount(), 4);
+
+    ASSERT_EQ(spy.count(), 1);
+    ASSERT_EQ(spy[0].at(1).toUInt(), 400u);
+    ASSERT_EQ(spy[0].at(2).toUInt(), 600u);
+}
@@ -1,10 +1,13 @@
 #include "tst_logbuffer.h"
+#include "tst_logtrace.h"
 
 #include <QCoreApplication>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <fortmanager.h>
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -12,5 +15,7 @@ int main(int argc, char *argv[])
 
     QCoreApplication app(argc, argv);
 
+    FortManager::setupResources();
+
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,11 @@
+include($$PWD/../../global.pri)
+
+include($$PWD/../../ui/FortFirewallUI.pri)
+
+CONFIG += console
+CONFIG -= app_bundle debug_and_release
+
+TEMPLATE = app
+
+SOURCES += \
+    main.cpp
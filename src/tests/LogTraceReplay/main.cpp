@@ -0,0 +1,112 @@
+#include <QCommandLineParser>
+#include <QGuiApplication>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include <appinfo/appinfocache.h>
+#include <appinfo/appinfomanager.h>
+#include <conf/confappmanager.h>
+#include <conf/confmanager.h>
+#include <driver/drivermanager.h>
+#include <fortmanager.h>
+#include <fortsettings.h>
+#include <log/logmanager.h>
+#include <log/logtracereplayer.h>
+#include <manager/drivelistmanager.h>
+#include <manager/envmanager.h>
+#include <stat/askpendingmanager.h>
+#include <stat/quotamanager.h>
+#include <stat/statblockmanager.h>
+#include <stat/statmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+// Replays a recorded driver log trace through the master services
+// and prints the throughput report
+int main(int argc, char *argv[])
+{
+    QGuiApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replay the driver log trace.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("trace", "Trace file to replay.");
+
+    const QCommandLineOption realTimeOption(
+            "realtime", "Keep the recorded intervals between buffers.");
+    parser.addOption(realTimeOption);
+
+    const QCommandLineOption profileOption("profile",
+            "Directory to store the settings and databases. Temporary by default.", "profile");
+    parser.addOption(profileOption);
+
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        parser.showHelp(1);
+    }
+
+    QTemporaryDir tempDir;
+    const QString profilePath =
+            parser.isSet(profileOption) ? parser.value(profileOption) : tempDir.path();
+
+    FortManager::setupResources();
+
+    EnvManager envManager;
+
+    FortSettings settings;
+    settings.initialize({ app.applicationFilePath(), "--profile", profilePath }, &envManager);
+
+    IocContainer ioc;
+    ioc.pinToThread();
+    ioc.set<FortSettings>(settings);
+    ioc.set<EnvManager>(envManager);
+
+    // The driver device is not opened and the managers are not set up
+    DriverManager driverManager;
+    DriveListManager driveListManager;
+    LogManager logManager;
+
+    ioc.setService(&driverManager, /*flags=*/0);
+    ioc.setService(&driveListManager, /*flags=*/0);
+    ioc.setService(&logManager, /*flags=*/0);
+
+    ioc.setService(new ConfManager(settings.confFilePath()));
+    ioc.setService(new ConfAppManager());
+    ioc.setService(new QuotaManager());
+    ioc.setService(new StatManager(settings.statFilePath()));
+    ioc.setService(new StatBlockManager(settings.statBlockFilePath()));
+    ioc.setService(new AskPendingManager());
+    ioc.setService(new AppInfoManager(settings.cacheFilePath()));
+    ioc.setService(new AppInfoCache());
+
+    ioc.setDependencies<ConfAppManager, ConfManager>();
+    ioc.setDependencies<QuotaManager, ConfManager, ConfAppManager, StatManager>();
+    ioc.setDependencies<StatBlockManager, ConfManager>();
+    ioc.setDependencies<AppInfoCache, AppInfoManager>();
+
+    int rc = 1;
+
+    if (ioc.setUpAll() && IoC<ConfManager>()->load()) {
+        IoC<StatManager>()->setConf(IoC<ConfManager>()->conf());
+
+        const auto speed = parser.isSet(realTimeOption) ? LogTraceReplayer::SpeedRealTime
+                                                        : LogTraceReplayer::SpeedMax;
+
+        LogTraceReplayer replayer(&logManager);
+
+        QTextStream out(stdout);
+
+        if (replayer.replay(args.first(), speed)) {
+            out << replayer.report();
+            rc = 0;
+        } else {
+            out << "Trace open error: " << args.first() << Qt::endl;
+        }
+    }
+
+    ioc.tearDownAll();
+    ioc.autoDeleteAll();
+
+    return rc;
+}
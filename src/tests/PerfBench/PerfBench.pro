@@ -0,0 +1,21 @@
+include(../Common/Common.pri)
+
+# Google Benchmark
+include(../Common/GoogleBenchmark.pri)
+
+HEADERS += \
+    bench_conf.h \
+    bench_data.h \
+    bench_flowtab.h \
+    bench_log.h \
+    bench_logtrace.h \
+    bench_rulesetgraph.h \
+    bench_stat.h \
+    bench_util.h
+
+SOURCES += \
+    bench_main.cpp
+
+# TommyDS
+SOURCES += \
+    ../../3rdparty/tommyds/tommyhashdyn.c
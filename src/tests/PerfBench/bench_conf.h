@@ -0,0 +1,157 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <common/fortconf.h>
+#include <common/fortdef.h>
+
+#include <conf/app.h>
+#include <conf/firewallconf.h>
+#include <driver/drivercommon.h>
+#include <manager/envmanager.h>
+#include <util/conf/confutil.h>
+
+#include "bench_data.h"
+
+class ConfBench : public benchmark::Fixture
+{
+public:
+    void SetUp(const benchmark::State &state) override;
+    void TearDown(const benchmark::State &state) override;
+
+protected:
+    const PFORT_CONF drvConf() const
+    {
+        return (const PFORT_CONF) (m_confUtil.data() + DriverCommon::confIoConfOff());
+    }
+
+protected:
+    QStringList m_lookupPaths;
+    QVector<quint32> m_lookupIps;
+
+    ConfUtil m_confUtil;
+};
+
+void ConfBench::SetUp(const benchmark::State &state)
+{
+    const int count = int(state.range(0));
+
+    EnvManager envManager;
+    FirewallConf conf;
+
+    BenchData::setupConf(conf, count, count);
+
+    m_confUtil.write(conf, nullptr, envManager);
+
+    // Mix of found exe, wildcard, prefix and not found paths
+    m_lookupPaths = BenchData::kernelPaths(BenchData::appPaths(count)
+            + QStringList { "D:\\Games1\\X\\Bin1\\game.exe", "E:\\Portable2\\tool.exe",
+                    "F:\\Unknown\\unknown.exe" });
+
+    m_lookupIps = BenchData::ip4Addresses(1024);
+}
+
+void ConfBench::TearDown(const benchmark::State & /*state*/)
+{
+    m_lookupPaths.clear();
+    m_lookupIps.clear();
+}
+
+BENCHMARK_DEFINE_F(ConfBench, confAppFind)(benchmark::State &state)
+{
+    const PFORT_CONF conf = drvConf();
+    const int pathsCount = m_lookupPaths.size();
+    int index = 0;
+
+    for (auto _ : state) {
+        const QString &path = m_lookupPaths.at(index);
+        if (++index >= pathsCount) {
+            index = 0;
+        }
+
+        const FORT_APP_DATA app_data = fort_conf_app_find(conf, (const PVOID) path.utf16(),
+                quint32(path.size()) * sizeof(WCHAR), fort_conf_app_exe_find,
+                /*exe_context=*/nullptr);
+
+        benchmark::DoNotOptimize(app_data);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(ConfBench, confAppFind)->Arg(100)->Arg(1000)->Arg(10000);
+
+BENCHMARK_DEFINE_F(ConfBench, confIpIncluded)(benchmark::State &state)
+{
+    const PFORT_CONF conf = drvConf();
+    const int ipsCount = m_lookupIps.size();
+    int index = 0;
+
+    for (auto _ : state) {
+        const quint32 ip = m_lookupIps.at(index);
+        if (++index >= ipsCount) {
+            index = 0;
+        }
+
+        const BOOL included = fort_conf_ip_included(conf, /*zone_func=*/nullptr,
+                /*ctx=*/nullptr, &ip, /*isIPv6=*/FALSE, /*addr_group_index=*/0);
+
+        benchmark::DoNotOptimize(included);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_REGISTER_F(ConfBench, confIpIncluded)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void confUtilWrite(benchmark::State &state)
+{
+    const int count = int(state.range(0));
+
+    EnvManager envManager;
+    FirewallConf conf;
+
+    BenchData::setupConf(conf, count, count);
+
+    for (auto _ : state) {
+        ConfUtil confUtil;
+
+        const bool ok = confUtil.write(conf, nullptr, envManager);
+
+        benchmark::DoNotOptimize(ok);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(confUtilWrite)->Arg(100)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+static void confUtilWriteAppEntries(benchmark::State &state)
+{
+    const int count = int(state.range(0));
+
+    QList<App> apps;
+    apps.reserve(count);
+
+    for (const QString &appPath : BenchData::appPaths(count)) {
+        App app;
+        app.appPath = appPath;
+        app.blocked = true;
+
+        apps.append(app);
+    }
+
+    for (auto _ : state) {
+        ConfUtil confUtil;
+
+        // Packed as for the ADDAPPS ioctl and verified as by the driver
+        const bool ok = confUtil.writeAppEntries(apps)
+                && DriverCommon::confAppEntriesVerify(confUtil.data(), confUtil.buffer().size());
+
+        benchmark::DoNotOptimize(ok);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(confUtilWriteAppEntries)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <QRandomGenerator>
+#include <QStringList>
+
+#include <conf/addressgroup.h>
+#include <conf/appgroup.h>
+#include <conf/firewallconf.h>
+#include <util/fileutil.h>
+#include <util/net/netutil.h>
+
+// Fixed synthetic datasets: the same seed gives the same data on every run
+namespace BenchData {
+
+constexpr quint32 RANDOM_SEED = 0x466F7274; // "Fort"
+
+inline QStringList appPaths(int count)
+{
+    QStringList list;
+    list.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        list.append(QString("C:\\Program Files\\Vendor%1\\Product%2\\app%3.exe")
+                        .arg(i % 97)
+                        .arg(i % 31)
+                        .arg(i));
+    }
+
+    return list;
+}
+
+inline QStringList appWildPaths(int count)
+{
+    QStringList list;
+    list.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        list.append(QString("D:\\Games%1\\**\\Bin%2\\*.exe").arg(i).arg(i % 7));
+    }
+
+    return list;
+}
+
+inline QStringList appPrefixPaths(int count)
+{
+    QStringList list;
+    list.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        list.append(QString("E:\\Portable%1\\**").arg(i));
+    }
+
+    return list;
+}
+
+inline QStringList kernelPaths(const QStringList &paths)
+{
+    QStringList list;
+    list.reserve(paths.size());
+
+    for (const QString &path : paths) {
+        list.append(FileUtil::pathToKernelPath(path).toLower());
+    }
+
+    return list;
+}
+
+inline QStringList ip4RangeTexts(int count)
+{
+    QRandomGenerator rand(RANDOM_SEED);
+
+    QStringList list;
+    list.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        const quint32 ip = rand.generate() & 0x7FFFFFFF;
+
+        switch (i % 3) {
+        case 0:
+            list.append(NetUtil::ip4ToText(ip));
+            break;
+        case 1:
+            list.append(NetUtil::ip4ToText(ip & 0xFFFFFF00) + "/24");
+            break;
+        default:
+            list.append(NetUtil::ip4ToText(ip) + '-' + NetUtil::ip4ToText(ip + 1000));
+        }
+    }
+
+    return list;
+}
+
+inline QVector<quint32> ip4Addresses(int count)
+{
+    QRandomGenerator rand(RANDOM_SEED + 1);
+
+    QVector<quint32> list;
+    list.reserve(count);
+
+    for (int i = 0; i < count; ++i) {
+        list.append(rand.generate());
+    }
+
+    return list;
+}
+
+inline void setupConf(FirewallConf &conf, int appCount, int ipCount)
+{
+    AddressGroup *inetGroup = conf.inetAddressGroup();
+
+    inetGroup->setIncludeAll(true);
+    inetGroup->setExcludeAll(false);
+
+    inetGroup->setExcludeText(ip4RangeTexts(ipCount).join('\n'));
+
+    conf.setAppBlockAll(true);
+    conf.setAppAllowAll(false);
+
+    AppGroup *appGroup = new AppGroup();
+    appGroup->setName("Bench");
+    appGroup->setEnabled(true);
+    appGroup->setAllowText(appPaths(appCount).join('\n'));
+    appGroup->setBlockText(
+            (appWildPaths(appCount / 10) + appPrefixPaths(appCount / 10)).join('\n'));
+
+    conf.addAppGroup(appGroup);
+
+    conf.resetEdited(true);
+    conf.prepareToSave();
+}
+
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include <QVector>
+
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include <../3rdparty/tommyds/tommyhashdyn.h>
+}
+
+#include <common/fortflowtab.h>
+
+class FlowTabBench : public benchmark::Fixture
+{
+public:
+    void SetUp(const benchmark::State &state) override;
+    void TearDown(const benchmark::State &state) override;
+
+protected:
+    void insertFlow(int index);
+    void removeFlow(int index);
+
+    static quint32 flowHash(int index);
+
+protected:
+    bool m_flowTabEnabled = false;
+
+    FORT_FLOWTAB m_flowTab;
+    QVector<FORT_FLOWTAB_NODE> m_flowTabNodes;
+
+    tommy_hashdyn m_hashDyn;
+    QVector<tommy_hashdyn_node> m_hashDynNodes;
+};
+
+void FlowTabBench::SetUp(const benchmark::State &state)
+{
+    m_flowTabEnabled = (state.range(0) != 0);
+
+    const int flowsCount = int(state.range(1));
+
+    fort_flowtab_init(&m_flowTab);
+    m_flowTabNodes.resize(flowsCount);
+
+    tommy_hashdyn_init(&m_hashDyn);
+    m_hashDynNodes.resize(flowsCount);
+}
+
+void FlowTabBench::TearDown(const benchmark::State & /*state*/)
+{
+    void *segment;
+    while ((segment = fort_flowtab_segment_pop(&m_flowTab)) != nullptr) {
+        std::free(segment);
+    }
+
+    tommy_hashdyn_done(&m_hashDyn);
+}
+
+void FlowTabBench::insertFlow(int index)
+{
+    const quint32 hash = flowHash(index);
+
+    if (m_flowTabEnabled) {
+        // Provide the segment as the driver does
+        const quint32 size =
+                fort_flowtab_reserve_size(&m_flowTab, fort_flowtab_count(&m_flowTab) + 1);
+        if (size != 0) {
+            fort_flowtab_segment_add(&m_flowTab, std::malloc(size), size);
+        }
+
+        fort_flowtab_insert(&m_flowTab, &m_flowTabNodes[index], hash);
+    } else {
+        tommy_hashdyn_insert(&m_hashDyn, &m_hashDynNodes[index], nullptr, hash);
+    }
+}
+
+void FlowTabBench::removeFlow(int index)
+{
+    if (m_flowTabEnabled) {
+        fort_flowtab_remove(&m_flowTab, &m_flowTabNodes[index]);
+    } else {
+        tommy_hashdyn_remove_existing(&m_hashDyn, &m_hashDynNodes[index]);
+    }
+}
+
+quint32 FlowTabBench::flowHash(int index)
+{
+    return tommy_inthash_u32(quint32(index) * 4);
+}
+
+BENCHMARK_DEFINE_F(FlowTabBench, insertLatency)(benchmark::State &state)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int flowsCount = int(state.range(1));
+
+    QVector<qint64> latencies;
+    latencies.reserve(flowsCount);
+
+    QVector<qint64> p99Latencies;
+    qint64 maxLatency = 0;
+
+    // Connections are opened and closed by bursts
+    for (auto _ : state) {
+        latencies.clear();
+
+        for (int i = 0; i < flowsCount; ++i) {
+            const auto begin = Clock::now();
+
+            insertFlow(i);
+
+            const auto end = Clock::now();
+
+            latencies.append(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+        }
+
+        for (int i = 0; i < flowsCount; ++i) {
+            removeFlow(i);
+        }
+
+        state.PauseTiming();
+        {
+            std::sort(latencies.begin(), latencies.end());
+
+            p99Latencies.append(latencies.at(latencies.size() * 99 / 100));
+            maxLatency = qMax(maxLatency, latencies.last());
+        }
+        state.ResumeTiming();
+    }
+
+    std::sort(p99Latencies.begin(), p99Latencies.end());
+
+    state.counters["p99_ns"] = double(p99Latencies.at(p99Latencies.size() / 2));
+    state.counters["max_ns"] = double(maxLatency);
+
+    state.SetItemsProcessed(state.iterations() * flowsCount);
+}
+
+// Args: 0 - tommy_hashdyn, 1 - flow table; flows count
+BENCHMARK_REGISTER_F(FlowTabBench, insertLatency)
+        ->Args({ 0, 10000 })
+        ->Args({ 1, 10000 })
+        ->Args({ 0, 100000 })
+        ->Args({ 1, 100000 });
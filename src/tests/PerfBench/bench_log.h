@@ -0,0 +1,75 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <driver/drivercommon.h>
+#include <log/logbuffer.h>
+#include <log/logentryblockedip.h>
+
+#include "bench_data.h"
+
+namespace {
+
+LogEntryBlockedIp benchBlockedIpEntry()
+{
+    LogEntryBlockedIp entry;
+    entry.setKernelPath(BenchData::kernelPaths(BenchData::appPaths(1)).first());
+    entry.setBlockReason(FORT_BLOCK_REASON_PROGRAM);
+    entry.setIpProto(6);
+    entry.setLocalPort(50000);
+    entry.setRemotePort(443);
+    entry.setLocalIp4(0x0A000001);
+    entry.setRemoteIp4(0x08080808);
+    entry.setPid(1234);
+
+    return entry;
+}
+
+}
+
+static void logBufferWriteBlockedIp(benchmark::State &state)
+{
+    const LogEntryBlockedIp entry = benchBlockedIpEntry();
+
+    LogBuffer buf;
+
+    for (auto _ : state) {
+        buf.reset();
+
+        while (buf.top() + int(DriverCommon::logBlockedIpSize(1024)) < DriverCommon::bufferSize()) {
+            buf.writeEntryBlockedIp(&entry);
+        }
+    }
+
+    state.SetBytesProcessed(state.iterations() * buf.top());
+}
+
+BENCHMARK(logBufferWriteBlockedIp);
+
+static void logBufferReadBlockedIp(benchmark::State &state)
+{
+    const LogEntryBlockedIp entry = benchBlockedIpEntry();
+
+    LogBuffer buf;
+
+    while (buf.top() + int(DriverCommon::logBlockedIpSize(1024)) < DriverCommon::bufferSize()) {
+        buf.writeEntryBlockedIp(&entry);
+    }
+
+    const int top = buf.top();
+    int entriesCount = 0;
+
+    for (auto _ : state) {
+        buf.reset(top);
+
+        LogEntryBlockedIp readEntry;
+        while (buf.peekEntryType() == FORT_LOG_TYPE_BLOCKED_IP) {
+            buf.readEntryBlockedIp(&readEntry);
+            ++entriesCount;
+        }
+    }
+
+    state.SetItemsProcessed(entriesCount);
+}
+
+BENCHMARK(logBufferReadBlockedIp);
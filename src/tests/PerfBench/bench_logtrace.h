@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QTemporaryDir>
+
+#include <benchmark/benchmark.h>
+
+#include <log/logbuffer.h>
+#include <log/logentryprocnew.h>
+#include <log/logentrytime.h>
+#include <log/logmanager.h>
+#include <log/logtracefile.h>
+#include <log/logtracereplayer.h>
+#include <stat/quotamanager.h>
+#include <stat/statmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+#include <mocks/mockquotamanager.h>
+
+#include "bench_data.h"
+
+namespace {
+
+// Synthetic trace: a time entry and a batch of new processes per buffer
+bool writeProcNewTrace(const QString &filePath, int bufferCount, int procCount)
+{
+    LogTraceFile traceFile(filePath);
+    if (!traceFile.openWrite())
+        return false;
+
+    const QStringList appPaths = BenchData::kernelPaths(BenchData::appPaths(procCount));
+
+    quint32 pid = 0;
+    for (int i = 0; i < bufferCount; ++i) {
+        LogBuffer buf;
+
+        const LogEntryTime timeEntry(1700000000 + i);
+        buf.writeEntryTime(&timeEntry);
+
+        for (const QString &appPath : appPaths) {
+            const LogEntryProcNew entry(++pid * 4, appPath);
+            buf.writeEntryProcNew(&entry);
+        }
+
+        if (!traceFile.writeBuffer(buf.array().constData(), buf.top()))
+            return false;
+    }
+
+    return true;
+}
+
+}
+
+static void logTraceReplay(benchmark::State &state)
+{
+    const int procCount = int(state.range(0));
+
+    QTemporaryDir tempDir;
+    const QString filePath = tempDir.filePath("bench.trace");
+
+    if (!writeProcNewTrace(filePath, /*bufferCount=*/100, procCount)) {
+        state.SkipWithError("Cannot write the trace file");
+        return;
+    }
+
+    IocContainer ioc;
+    ioc.pinToThread();
+
+    NiceMock<MockQuotaManager> quotaManager;
+    ioc.setService<QuotaManager>(quotaManager);
+
+    StatManager statManager(":memory:");
+    ioc.setService(statManager);
+
+    statManager.setUp();
+
+    LogManager logManager;
+    LogTraceReplayer replayer(&logManager);
+
+    qint64 entryCount = 0;
+
+    for (auto _ : state) {
+        replayer.replay(filePath, LogTraceReplayer::SpeedMax);
+
+        entryCount += replayer.entryCount();
+    }
+
+    state.SetItemsProcessed(entryCount);
+
+    state.counters["readAvgNs"] = double(replayer.readStat().averageNsecs());
+    state.counters["processAvgNs"] = double(replayer.processStat().averageNsecs());
+}
+
+BENCHMARK(logTraceReplay)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
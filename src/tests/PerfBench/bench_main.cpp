@@ -0,0 +1,56 @@
+#include "bench_conf.h"
+#include "bench_flowtab.h"
+#include "bench_log.h"
+#include "bench_logtrace.h"
+#include "bench_rulesetgraph.h"
+#include "bench_stat.h"
+#include "bench_util.h"
+
+#include <QCoreApplication>
+
+#include <benchmark/benchmark.h>
+
+namespace {
+
+bool hasArgument(int argc, char *argv[], const char *name)
+{
+    const int nameLen = int(strlen(name));
+
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], name, nameLen) == 0)
+            return true;
+    }
+
+    return false;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Write JSON results by default to track them over time
+    std::vector<char *> args(argv, argv + argc);
+
+    char outArg[] = "--benchmark_out=FortFirewallBench.json";
+    char outFormatArg[] = "--benchmark_out_format=json";
+
+    if (!hasArgument(argc, argv, "--benchmark_out=")) {
+        args.push_back(outArg);
+    }
+    if (!hasArgument(argc, argv, "--benchmark_out_format=")) {
+        args.push_back(outFormatArg);
+    }
+
+    int argsCount = int(args.size());
+
+    ::benchmark::Initialize(&argsCount, args.data());
+    if (::benchmark::ReportUnrecognizedArguments(argsCount, args.data()))
+        return 1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    ::benchmark::Shutdown();
+
+    return 0;
+}
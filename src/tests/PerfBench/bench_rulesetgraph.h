@@ -0,0 +1,132 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+#include <QRandomGenerator>
+#include <QVector>
+
+#include <benchmark/benchmark.h>
+
+#include <util/conf/confutil.h>
+#include <util/conf/rulesetgraph.h>
+
+class RuleSetGraphBench : public benchmark::Fixture
+{
+public:
+    void SetUp(const benchmark::State &state) override;
+    void TearDown(const benchmark::State &state) override;
+
+protected:
+    bool addSubRule(int ruleId, int subRuleId);
+
+protected:
+    int m_rulesCount = 0;
+
+    RuleSetGraph m_graph;
+
+    QVector<QPair<int, int>> m_edges;
+};
+
+void RuleSetGraphBench::SetUp(const benchmark::State &state)
+{
+    m_rulesCount = int(state.range(0));
+
+    const int edgesCount = int(state.range(1));
+
+    QRandomGenerator rand(0x47726168);
+
+    // Initial Rule Sets
+    for (int i = 0; i < edgesCount; ++i) {
+        const int ruleId = rand.bounded(1, m_rulesCount + 1);
+        const int subRuleId = rand.bounded(1, m_rulesCount + 1);
+
+        addSubRule(ruleId, subRuleId);
+    }
+
+    // Candidates to insert
+    m_edges.clear();
+    m_edges.reserve(edgesCount);
+
+    for (int i = 0; i < edgesCount; ++i) {
+        m_edges.append({ rand.bounded(1, m_rulesCount + 1), rand.bounded(1, m_rulesCount + 1) });
+    }
+}
+
+void RuleSetGraphBench::TearDown(const benchmark::State & /*state*/)
+{
+    m_graph.clear();
+}
+
+bool RuleSetGraphBench::addSubRule(int ruleId, int subRuleId)
+{
+    // Check the edge as the Rule Set model does
+    if (m_graph.isLoop(ruleId, subRuleId)
+            || m_graph.depth(ruleId, subRuleId) > ConfUtil::ruleSetDepthMaxCount())
+        return false;
+
+    return m_graph.addSubRule(ruleId, subRuleId);
+}
+
+BENCHMARK_DEFINE_F(RuleSetGraphBench, insertLatency)(benchmark::State &state)
+{
+    using Clock = std::chrono::steady_clock;
+
+    const int edgesCount = int(m_edges.size());
+
+    QVector<qint64> latencies;
+    latencies.reserve(edgesCount);
+
+    QVector<QPair<int, int>> addedEdges;
+    addedEdges.reserve(edgesCount);
+
+    QVector<qint64> p99Latencies;
+    qint64 maxLatency = 0;
+
+    for (auto _ : state) {
+        latencies.clear();
+        addedEdges.clear();
+
+        for (const auto &edge : std::as_const(m_edges)) {
+            const auto begin = Clock::now();
+
+            const bool added = addSubRule(edge.first, edge.second);
+
+            const auto end = Clock::now();
+
+            latencies.append(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count());
+
+            if (added) {
+                addedEdges.append(edge);
+            }
+        }
+
+        // Restore the graph
+        for (const auto &edge : std::as_const(addedEdges)) {
+            m_graph.removeSubRule(edge.first, edge.second);
+        }
+
+        state.PauseTiming();
+        {
+            std::sort(latencies.begin(), latencies.end());
+
+            p99Latencies.append(latencies.at(latencies.size() * 99 / 100));
+            maxLatency = qMax(maxLatency, latencies.last());
+        }
+        state.ResumeTiming();
+    }
+
+    std::sort(p99Latencies.begin(), p99Latencies.end());
+
+    state.counters["p99_ns"] = double(p99Latencies.at(p99Latencies.size() / 2));
+    state.counters["max_ns"] = double(maxLatency);
+
+    state.SetItemsProcessed(state.iterations() * edgesCount);
+}
+
+// Args: rules count; edges count
+BENCHMARK_REGISTER_F(RuleSetGraphBench, insertLatency)
+        ->Args({ 1024, 1000 })
+        ->Args({ 1024, 4000 })
+        ->Args({ 65535, 20000 });
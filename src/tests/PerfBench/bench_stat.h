@@ -0,0 +1,57 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <log/logentryprocnew.h>
+#include <log/logentrystattraf.h>
+#include <stat/quotamanager.h>
+#include <stat/statmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+#include <mocks/mockquotamanager.h>
+
+#include "bench_data.h"
+
+static void statManagerLogStatTraf(benchmark::State &state)
+{
+    const int procCount = int(state.range(0));
+
+    IocContainer ioc;
+    ioc.pinToThread();
+
+    NiceMock<MockQuotaManager> quotaManager;
+    ioc.set<QuotaManager>(quotaManager);
+
+    StatManager statManager(":memory:");
+
+    statManager.setUp();
+
+    // Add apps
+    const QStringList appPaths = BenchData::appPaths(procCount);
+
+    quint32 pid = 0;
+    for (const QString &appPath : appPaths) {
+        LogEntryProcNew entry(++pid * 4, appPath);
+        statManager.logProcNew(entry);
+    }
+
+    // Traffic: (pid, in bytes, out bytes) per process
+    QVector<quint32> trafBytes;
+    trafBytes.reserve(procCount * 3);
+
+    for (int i = 0; i < procCount; ++i) {
+        trafBytes << quint32(i + 1) * 4 << 1500 << 500;
+    }
+
+    const LogEntryStatTraf entry(procCount, trafBytes.constData());
+
+    for (auto _ : state) {
+        const bool ok = statManager.logStatTraf(entry);
+
+        benchmark::DoNotOptimize(ok);
+    }
+
+    state.SetItemsProcessed(state.iterations() * procCount);
+}
+
+BENCHMARK(statManagerLogStatTraf)->Arg(10)->Arg(100)->Arg(1000);
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <common/fort_wildmatch.h>
+
+#include <util/net/iprange.h>
+#include <util/stringutil.h>
+
+#include "bench_data.h"
+
+static void wildmatchPath(benchmark::State &state)
+{
+    const QString pattern = BenchData::kernelPaths({ "C:\\Program Files\\**\\Product7\\*.exe" })
+                                    .first();
+    const QStringList paths = BenchData::kernelPaths(BenchData::appPaths(1024));
+    const int pathsCount = paths.size();
+    int index = 0;
+
+    for (auto _ : state) {
+        const QString &path = paths.at(index);
+        if (++index >= pathsCount) {
+            index = 0;
+        }
+
+        const int res = wildmatch((const wm_char *) pattern.utf16(), (const wm_char *) path.utf16());
+
+        benchmark::DoNotOptimize(res);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(wildmatchPath);
+
+static void ipRangeFromList(benchmark::State &state)
+{
+    const int count = int(state.range(0));
+
+    const QString text = BenchData::ip4RangeTexts(count).join('\n');
+    const StringViewList list = StringUtil::splitView(text, QLatin1Char('\n'));
+
+    for (auto _ : state) {
+        IpRange ipRange;
+
+        const bool ok = ipRange.fromList(list);
+
+        benchmark::DoNotOptimize(ok);
+    }
+
+    state.SetItemsProcessed(state.iterations() * count);
+}
+
+BENCHMARK(ipRangeFromList)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -1,6 +1,7 @@
 include(../Common/Common.pri)
 
 HEADERS += \
+    tst_quotaledger.h \
     tst_stat.h
 
 SOURCES += \
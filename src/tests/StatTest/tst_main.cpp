@@ -1,3 +1,4 @@
+#include "tst_quotaledger.h"
 #include "tst_stat.h"
 
 #include <QCoreApplication>
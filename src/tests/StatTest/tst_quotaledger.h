@@ -0,0 +1,268 @@
+#pragma once
+
+#include <QSignalSpy>
+
+#include <googletest.h>
+
+#include <stat/quotaledger.h>
+#include <stat/quotamanager.h>
+#include <stat/statmanager.h>
+#include <util/dateutil.h>
+
+#include <mocks/mockquotamanager.h>
+
+class QuotaLedgerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static qint64 unixTime(int year, int month, int day, int hour = 0);
+
+protected:
+    StatManager m_statManager { ":memory:" };
+};
+
+void QuotaLedgerTest::SetUp()
+{
+    m_statManager.setUp();
+
+    ASSERT_NE(m_statManager.sqliteDb()->db(), nullptr);
+}
+
+void QuotaLedgerTest::TearDown() { }
+
+qint64 QuotaLedgerTest::unixTime(int year, int month, int day, int hour)
+{
+    return QDateTime(QDate(year, month, day), QTime(hour, 30)).toSecsSinceEpoch();
+}
+
+TEST_F(QuotaLedgerTest, dayRollover)
+{
+    QuotaLedger ledger;
+    ledger.setQuota(QuotaKey::global(), 1000, 10000);
+
+    const QuotaEntry *entry = ledger.entry(QuotaKey::global());
+    ASSERT_NE(entry, nullptr);
+
+    ASSERT_TRUE(ledger.addTraf(unixTime(2024, 3, 15, 22), QuotaKey::global(), 600).isEmpty());
+
+    // The day quota is exceeded
+    const QVector<QuotaAlert> alerts =
+            ledger.addTraf(unixTime(2024, 3, 15, 23), QuotaKey::global(), 500);
+    ASSERT_EQ(alerts.size(), 1);
+    ASSERT_EQ(alerts[0].period, QuotaAlert::PeriodDay);
+    ASSERT_EQ(alerts[0].percent, 100);
+    ASSERT_EQ(alerts[0].bytes, 1100);
+
+    // Alerted once per day
+    ASSERT_TRUE(ledger.addTraf(unixTime(2024, 3, 15, 23), QuotaKey::global(), 500).isEmpty());
+
+    // Next day
+    ASSERT_TRUE(ledger.addTraf(unixTime(2024, 3, 16, 0), QuotaKey::global(), 100).isEmpty());
+    ASSERT_EQ(entry->day.bytes, 100);
+    ASSERT_EQ(entry->day.alertedPercent, 0);
+    ASSERT_EQ(entry->day.trafTime, DateUtil::getUnixDay(unixTime(2024, 3, 16)));
+    ASSERT_EQ(entry->month.bytes, 1700);
+
+    // Next month on the last day of the month
+    ledger.addTraf(unixTime(2024, 3, 31, 23), QuotaKey::global(), 10);
+    ASSERT_EQ(entry->month.bytes, 1710);
+
+    ledger.addTraf(unixTime(2024, 4, 1, 0), QuotaKey::global(), 20);
+    ASSERT_EQ(entry->day.bytes, 20);
+    ASSERT_EQ(entry->month.bytes, 20);
+}
+
+TEST_F(QuotaLedgerTest, monthStartRollover)
+{
+    QuotaLedger ledger(/*monthStart=*/10);
+    ledger.setQuota(QuotaKey::global(), 0, 1000);
+
+    const QuotaEntry *entry = ledger.entry(QuotaKey::global());
+
+    // The month started on March 10
+    ledger.addTraf(unixTime(2024, 3, 10, 0), QuotaKey::global(), 100);
+    ledger.addTraf(unixTime(2024, 4, 9, 23), QuotaKey::global(), 200);
+
+    ASSERT_EQ(entry->month.bytes, 300);
+    ASSERT_EQ(entry->month.trafTime, DateUtil::getUnixMonth(unixTime(2024, 3, 10), 10));
+
+    // The month starts on April 10
+    ledger.addTraf(unixTime(2024, 4, 10, 0), QuotaKey::global(), 400);
+
+    ASSERT_EQ(entry->month.bytes, 400);
+    ASSERT_EQ(entry->month.trafTime, DateUtil::getUnixMonth(unixTime(2024, 4, 10), 10));
+
+    // The month start is changed to the 1st day: the same April month
+    ledger.setMonthStart(1);
+    ledger.addTraf(unixTime(2024, 4, 10, 1), QuotaKey::global(), 50);
+
+    ASSERT_EQ(entry->month.bytes, 450);
+
+    // The month start is changed to the 15th day: the previous March month
+    ledger.setMonthStart(15);
+    ledger.addTraf(unixTime(2024, 4, 10, 2), QuotaKey::global(), 60);
+
+    ASSERT_EQ(entry->month.bytes, 60);
+    ASSERT_EQ(entry->month.trafTime, DateUtil::getUnixMonth(unixTime(2024, 3, 15), 15));
+}
+
+TEST_F(QuotaLedgerTest, alertPercents)
+{
+    QuotaLedger ledger;
+    ledger.setAlertPercents({ 100, 50, 80, 50, 0 });
+    ledger.setQuota(QuotaKey::global(), 1000, 0);
+
+    ASSERT_EQ(ledger.alertPercents(), QVector<qint16>({ 1, 50, 80, 100 }));
+
+    const qint64 t = unixTime(2024, 5, 1);
+
+    ASSERT_EQ(ledger.addTraf(t, QuotaKey::global(), 5).size(), 0);
+    ASSERT_EQ(ledger.addTraf(t, QuotaKey::global(), 10).value(0).percent, 1);
+    ASSERT_EQ(ledger.addTraf(t, QuotaKey::global(), 500).value(0).percent, 50);
+
+    // Report the highest threshold only
+    const QVector<QuotaAlert> alerts = ledger.addTraf(t, QuotaKey::global(), 600);
+    ASSERT_EQ(alerts.size(), 1);
+    ASSERT_EQ(alerts[0].percent, 100);
+
+    ASSERT_TRUE(ledger.addTraf(t, QuotaKey::global(), 1000).isEmpty());
+
+    // Changed quota resets the alerts
+    ledger.setQuota(QuotaKey::global(), 10000, 0);
+    ASSERT_EQ(ledger.addTraf(t, QuotaKey::global(), 0).value(0).percent, 1);
+}
+
+TEST_F(QuotaLedgerTest, restartRecovery)
+{
+    SqliteDb *sqliteDb = m_statManager.sqliteDb();
+
+    const qint64 t = unixTime(2024, 6, 20, 12);
+
+    {
+        QuotaLedger ledger;
+        ledger.setQuota(QuotaKey::global(), 1000, 100000);
+        ledger.setQuota(QuotaKey::app(1), 500, 0);
+        ledger.setQuota(QuotaKey::app(2), 500, 0);
+        ledger.setQuota(QuotaKey::appGroup(1), 0, 5000);
+
+        ledger.addTraf(t, QuotaKey::global(), 2000);
+        ledger.addTraf(t, QuotaKey::app(1), 300);
+        ledger.addTraf(t, QuotaKey::appGroup(1), 300);
+
+        ASSERT_TRUE(ledger.isDirty());
+        ASSERT_TRUE(ledger.saveCheckpoint(sqliteDb));
+        ASSERT_FALSE(ledger.isDirty());
+
+        // Removed quota
+        ledger.setQuota(QuotaKey::app(2), 0, 0);
+        ASSERT_EQ(ledger.count(), 3);
+
+        ledger.addTraf(t + 60, QuotaKey::app(1), 100);
+        ASSERT_TRUE(ledger.saveCheckpoint(sqliteDb));
+    }
+
+    // Restart
+    QuotaLedger ledger;
+    ASSERT_TRUE(ledger.loadCheckpoint(sqliteDb));
+    ASSERT_EQ(ledger.count(), 3);
+    ASSERT_EQ(ledger.entry(QuotaKey::app(2)), nullptr);
+
+    const QuotaEntry *globalEntry = ledger.entry(QuotaKey::global());
+    ASSERT_EQ(globalEntry->day.bytes, 2000);
+    ASSERT_EQ(globalEntry->day.quotaBytes, 1000);
+    ASSERT_EQ(globalEntry->day.alertedPercent, 100);
+    ASSERT_EQ(globalEntry->month.bytes, 2000);
+
+    ASSERT_EQ(ledger.entry(QuotaKey::app(1))->day.bytes, 400);
+    ASSERT_EQ(ledger.entry(QuotaKey::appGroup(1))->month.quotaBytes, 5000);
+
+    // The same quota keeps the alerts
+    ledger.setQuota(QuotaKey::global(), 1000, 100000);
+    ASSERT_TRUE(ledger.addTraf(t + 120, QuotaKey::global(), 100).isEmpty());
+
+    const QVector<QuotaAlert> alerts = ledger.addTraf(t + 180, QuotaKey::app(1), 200);
+    ASSERT_EQ(alerts.size(), 1);
+    ASSERT_EQ(alerts[0].key, QuotaKey::app(1));
+
+    // Restart on the next day
+    ASSERT_TRUE(ledger.saveCheckpoint(sqliteDb));
+
+    QuotaLedger nextLedger;
+    ASSERT_TRUE(nextLedger.loadCheckpoint(sqliteDb));
+
+    nextLedger.addTraf(t + 24 * 3600, QuotaKey::global(), 10);
+
+    globalEntry = nextLedger.entry(QuotaKey::global());
+    ASSERT_EQ(globalEntry->day.bytes, 10);
+    ASSERT_EQ(globalEntry->day.alertedPercent, 0);
+    ASSERT_EQ(globalEntry->month.bytes, 2110);
+}
+
+TEST_F(QuotaLedgerTest, appGroupAccounting)
+{
+    NiceMock<MockQuotaManager> quotaManager;
+
+    ON_CALL(quotaManager, sqliteDb()).WillByDefault(Return(m_statManager.sqliteDb()));
+
+    // App path "appN-groupM"
+    ON_CALL(quotaManager, getAppQuotaIds(_, _, _))
+            .WillByDefault(Invoke([](const QString &appPath, qint64 &appId, qint64 &appGroupId) {
+                const QStringList parts = appPath.split('-');
+                appId = parts[0].mid(3).toLongLong();
+                appGroupId = parts[1].mid(5).toLongLong();
+                return true;
+            }));
+
+    // Cached by app paths
+    EXPECT_CALL(quotaManager, getAppQuotaIds(_, _, _)).Times(4);
+
+    QSignalSpy alertSpy(&quotaManager, &QuotaManager::alert);
+
+    // No scoped quotas
+    quotaManager.addAppTraf(unixTime(2024, 7, 1), "app1-group1", 1000);
+    ASSERT_EQ(quotaManager.ledger().count(), 1);
+
+    quotaManager.setAppGroupQuota(1, 1000, 0);
+    quotaManager.setAppQuota(2, 0, 800);
+
+    constexpr int appsCount = 4;
+    const qint64 t = unixTime(2024, 7, 1, 10);
+
+    for (int i = 0; i < 100; ++i) {
+        const int appIndex = 1 + i % appsCount;
+        const int groupIndex = 1 + appIndex % 2;
+
+        quotaManager.addAppTraf(
+                t + i, QString("app%1-group%2").arg(appIndex).arg(groupIndex), 20);
+    }
+
+    const QuotaLedger &ledger = quotaManager.ledger();
+
+    // The apps 1 & 3 of the group 2 have no quotas
+    ASSERT_EQ(ledger.count(), 3);
+
+    // Group 1: the apps 2 & 4
+    ASSERT_EQ(ledger.entry(QuotaKey::appGroup(1))->day.bytes, 1000);
+    ASSERT_EQ(ledger.entry(QuotaKey::app(2))->month.bytes, 500);
+
+    ASSERT_EQ(alertSpy.count(), 0);
+
+    // Exceed the group's and app's quotas
+    quotaManager.addAppTraf(t + 100, "app2-group1", 400);
+
+    ASSERT_EQ(alertSpy.count(), 2);
+    ASSERT_EQ(alertSpy[0].at(0).toInt(), QuotaManager::AlertAppMonth);
+    ASSERT_EQ(alertSpy[1].at(0).toInt(), QuotaManager::AlertAppGroupDay);
+    ASSERT_EQ(alertSpy[1].at(1).toInt(), 100);
+
+    // The checkpoint of the group
+    ASSERT_TRUE(quotaManager.saveCheckpoint());
+
+    QuotaLedger savedLedger;
+    ASSERT_TRUE(savedLedger.loadCheckpoint(m_statManager.sqliteDb()));
+    ASSERT_EQ(savedLedger.entry(QuotaKey::appGroup(1))->day.bytes, 1400);
+    ASSERT_EQ(savedLedger.entry(QuotaKey::appGroup(1))->day.alertedPercent, 100);
+}
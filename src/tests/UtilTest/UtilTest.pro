@@ -1,12 +1,28 @@
 include(../Common/Common.pri)
 
 HEADERS += \
+    tst_appiconatlas.h \
+    tst_appinfo.h \
+    tst_apppurger.h \
+    tst_askpendingqueue.h \
     tst_bitutil.h \
+    tst_confjournal.h \
     tst_confutil.h \
     tst_fileutil.h \
+    tst_flowtab.h \
+    tst_hostinfo.h \
     tst_ioccontainer.h \
+    tst_metrics.h \
     tst_netutil.h \
-    tst_stringutil.h
+    tst_portrange.h \
+    tst_provdiff.h \
+    tst_psenum.h \
+    tst_psmap.h \
+    tst_ruleexpr.h \
+    tst_rulesetgraph.h \
+    tst_stringutil.h \
+    tst_svctab.h \
+    tst_tracering.h
 
 SOURCES += \
     tst_main.cpp
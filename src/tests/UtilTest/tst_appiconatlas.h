@@ -0,0 +1,156 @@
+#pragma once
+
+#include <QImage>
+#include <QPainter>
+
+#include <googletest.h>
+
+#include <appinfo/appiconatlas.h>
+
+class AppIconAtlasTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+};
+
+void AppIconAtlasTest::SetUp() { }
+
+void AppIconAtlasTest::TearDown() { }
+
+namespace {
+
+constexpr qint64 slotBytes = qint64(AppIconAtlas::slotSize) * AppIconAtlas::slotSize * 4;
+
+QImage testImage(QColor color, int size = AppIconAtlas::slotSize)
+{
+    QImage image(size, size, QImage::Format_ARGB32_Premultiplied);
+    image.fill(color);
+    return image;
+}
+
+QRgb pixmapCenter(const QPixmap &pixmap)
+{
+    const QImage image = pixmap.toImage();
+    return image.pixel(image.width() / 2, image.height() / 2);
+}
+
+}
+
+TEST_F(AppIconAtlasTest, slotAllocation)
+{
+    AppIconAtlas atlas(4 * slotBytes);
+
+    ASSERT_EQ(atlas.maxSlotCount(), 4);
+    ASSERT_EQ(atlas.usedSlotCount(), 0);
+
+    ASSERT_TRUE(atlas.pixmap(1).isNull());
+    ASSERT_EQ(atlas.missCount(), 1);
+
+    atlas.insert(1, testImage(Qt::red));
+    atlas.insert(2, testImage(Qt::green, 16));
+    atlas.insert(3, testImage(Qt::blue, 64)); // scaled down
+
+    ASSERT_EQ(atlas.usedSlotCount(), 3);
+    ASSERT_EQ(atlas.insertCount(), 3);
+
+    ASSERT_EQ(pixmapCenter(atlas.pixmap(1)), QColor(Qt::red).rgb());
+    ASSERT_EQ(pixmapCenter(atlas.pixmap(2)), QColor(Qt::green).rgb());
+    ASSERT_EQ(pixmapCenter(atlas.pixmap(3)), QColor(Qt::blue).rgb());
+
+    const QPixmap pixmap = atlas.pixmap(3);
+    ASSERT_EQ(pixmap.size(), QSize(AppIconAtlas::slotSize, AppIconAtlas::slotSize));
+
+    // The slot pixmap is shared, not copied again
+    ASSERT_EQ(atlas.pixmap(3).cacheKey(), pixmap.cacheKey());
+
+    ASSERT_EQ(atlas.hitCount(), 5);
+
+    // Null ids and images are ignored
+    atlas.insert(0, testImage(Qt::red));
+    atlas.insert(4, QImage());
+    ASSERT_EQ(atlas.usedSlotCount(), 3);
+    ASSERT_TRUE(atlas.icon(0).isNull());
+}
+
+TEST_F(AppIconAtlasTest, slotReuse)
+{
+    AppIconAtlas atlas(4 * slotBytes);
+
+    atlas.insert(1, testImage(Qt::red));
+    atlas.insert(2, testImage(Qt::green));
+
+    const QPixmap oldPixmap = atlas.pixmap(1);
+
+    // Replace the image of the same id in place
+    atlas.insert(1, testImage(Qt::blue));
+    ASSERT_EQ(atlas.usedSlotCount(), 2);
+
+    const QPixmap newPixmap = atlas.pixmap(1);
+    ASSERT_NE(newPixmap.cacheKey(), oldPixmap.cacheKey());
+    ASSERT_EQ(pixmapCenter(newPixmap), QColor(Qt::blue).rgb());
+
+    // The removed slot is given to the next id
+    atlas.remove(1);
+    ASSERT_FALSE(atlas.contains(1));
+    ASSERT_EQ(atlas.usedSlotCount(), 1);
+
+    atlas.insert(3, testImage(Qt::yellow));
+    ASSERT_EQ(atlas.usedSlotCount(), 2);
+    ASSERT_EQ(pixmapCenter(atlas.pixmap(3)), QColor(Qt::yellow).rgb());
+    ASSERT_TRUE(atlas.pixmap(1).isNull());
+
+    ASSERT_EQ(atlas.evictCount(), 0);
+
+    atlas.clear();
+    ASSERT_EQ(atlas.usedSlotCount(), 0);
+    ASSERT_TRUE(atlas.pixmap(2).isNull());
+}
+
+TEST_F(AppIconAtlasTest, slotEviction)
+{
+    AppIconAtlas atlas(3 * slotBytes);
+
+    atlas.insert(1, testImage(Qt::red));
+    atlas.insert(2, testImage(Qt::green));
+    atlas.insert(3, testImage(Qt::blue));
+
+    // Touch the first ids to make the 3rd the least used
+    atlas.pixmap(1);
+    atlas.icon(2);
+
+    atlas.insert(4, testImage(Qt::yellow));
+
+    ASSERT_EQ(atlas.usedSlotCount(), 3);
+    ASSERT_EQ(atlas.evictCount(), 1);
+
+    ASSERT_TRUE(atlas.contains(1));
+    ASSERT_TRUE(atlas.contains(2));
+    ASSERT_FALSE(atlas.contains(3));
+    ASSERT_TRUE(atlas.contains(4));
+
+    ASSERT_EQ(pixmapCenter(atlas.pixmap(4)), QColor(Qt::yellow).rgb());
+
+    // Painting counts as a use
+    {
+        QImage target(AppIconAtlas::slotSize, AppIconAtlas::slotSize,
+                QImage::Format_ARGB32_Premultiplied);
+        target.fill(Qt::transparent);
+
+        QPainter painter(&target);
+        atlas.paint(&painter, target.rect(), 1);
+        painter.end();
+
+        ASSERT_EQ(target.pixel(target.rect().center()), QColor(Qt::red).rgb());
+    }
+
+    atlas.pixmap(4);
+    atlas.insert(5, testImage(Qt::cyan));
+
+    ASSERT_EQ(atlas.evictCount(), 2);
+    ASSERT_FALSE(atlas.contains(2));
+    ASSERT_TRUE(atlas.contains(1));
+    ASSERT_TRUE(atlas.contains(4));
+    ASSERT_TRUE(atlas.contains(5));
+}
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <QImage>
+#include <QTemporaryDir>
+
+#include <googletest.h>
+
+#include <appinfo/appinfoindex.h>
+#include <appinfo/appinfomanager.h>
+
+class AppInfoTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    QTemporaryDir m_tempDir;
+};
+
+void AppInfoTest::SetUp()
+{
+    ASSERT_TRUE(m_tempDir.isValid());
+}
+
+void AppInfoTest::TearDown() { }
+
+namespace {
+
+QString testAppPath(int index)
+{
+    return QString("C:\\test\\app%1.exe").arg(index);
+}
+
+AppInfo testAppInfo(int index)
+{
+    AppInfo appInfo;
+    appInfo.fileDescription = QString("App %1").arg(index);
+    appInfo.productName = "Test";
+    appInfo.fileModTime = QDateTime::fromMSecsSinceEpoch(1700000000000LL + index * 1000);
+    return appInfo;
+}
+
+QImage testAppIcon()
+{
+    QImage image(16, 16, QImage::Format_ARGB32);
+    image.fill(Qt::red);
+    return image;
+}
+
+}
+
+TEST_F(AppInfoTest, indexWriteFind)
+{
+    const QString filePath = m_tempDir.filePath("appinfo.idx");
+
+    QHash<QString, AppInfo> appInfos;
+    for (int i = 1; i <= 3; ++i) {
+        AppInfo appInfo = testAppInfo(i);
+        appInfo.iconId = i * 10;
+        appInfos.insert(testAppPath(i), appInfo);
+    }
+    appInfos[testAppPath(2)].altPath = "C:\\test\\alt.exe";
+
+    ASSERT_TRUE(AppInfoIndex::write(filePath, appInfos));
+
+    AppInfoIndex index(filePath);
+    ASSERT_TRUE(index.open());
+    ASSERT_EQ(index.count(), 3);
+
+    for (auto it = appInfos.constBegin(); it != appInfos.constEnd(); ++it) {
+        AppInfo appInfo;
+        ASSERT_TRUE(index.find(it.key(), appInfo));
+
+        ASSERT_EQ(appInfo.iconId, it->iconId);
+        ASSERT_EQ(appInfo.altPath, it->altPath);
+        ASSERT_EQ(appInfo.fileDescription, it->fileDescription);
+        ASSERT_EQ(appInfo.fileModTime, it->fileModTime);
+        ASSERT_TRUE(appInfo.productName.isEmpty());
+    }
+
+    AppInfo appInfo;
+    ASSERT_FALSE(index.find(testAppPath(4), appInfo));
+}
+
+TEST_F(AppInfoTest, indexMapped)
+{
+    const QString filePath = m_tempDir.filePath("appinfo.db");
+
+    {
+        AppInfoManager manager(filePath);
+        manager.setUp();
+
+        AppInfo appInfo = testAppInfo(1);
+        ASSERT_TRUE(manager.saveToDb(testAppPath(1), appInfo, testAppIcon()));
+
+        // The index is written on tear down
+        manager.tearDown();
+    }
+
+    AppInfoManager manager(filePath);
+    manager.setUp();
+
+    AppInfo appInfo;
+    ASSERT_TRUE(manager.loadInfoFromIndex(testAppPath(1), appInfo));
+    ASSERT_NE(appInfo.iconId, 0);
+    ASSERT_EQ(appInfo.fileDescription, testAppInfo(1).fileDescription);
+
+    ASSERT_FALSE(manager.loadInfoFromIndex(testAppPath(2), appInfo));
+
+    // The saved path is stale in the mapped index
+    AppInfo newAppInfo = testAppInfo(1);
+    newAppInfo.fileDescription = "App 1 New";
+    manager.deleteAppInfo(testAppPath(1), appInfo);
+    ASSERT_TRUE(manager.saveToDb(testAppPath(1), newAppInfo, testAppIcon()));
+
+    ASSERT_FALSE(manager.loadInfoFromIndex(testAppPath(1), appInfo));
+
+    manager.tearDown();
+}
+
+TEST_F(AppInfoTest, loadInfosBatched)
+{
+    constexpr int appCount = 70; // more than two batches of 32 paths
+
+    AppInfoManager manager(":memory:");
+    manager.setUp();
+
+    const QImage appIcon = testAppIcon();
+
+    QStringList appPaths;
+    for (int i = 1; i <= appCount; ++i) {
+        AppInfo appInfo = testAppInfo(i);
+        ASSERT_TRUE(manager.saveToDb(testAppPath(i), appInfo, appIcon));
+
+        appPaths.append(testAppPath(i));
+    }
+
+    // Missing paths are skipped
+    appPaths.insert(40, testAppPath(appCount + 1));
+    appPaths.append(testAppPath(appCount + 2));
+
+    const QHash<QString, AppInfo> appInfos = manager.loadInfosFromDb(appPaths);
+    ASSERT_EQ(appInfos.size(), appCount);
+
+    for (int i = 1; i <= appCount; ++i) {
+        const AppInfo expected = testAppInfo(i);
+        const AppInfo appInfo = appInfos.value(testAppPath(i));
+
+        ASSERT_TRUE(appInfo.isValid());
+        ASSERT_EQ(appInfo.fileDescription, expected.fileDescription);
+        ASSERT_EQ(appInfo.productName, expected.productName);
+        ASSERT_EQ(appInfo.fileModTime, expected.fileModTime);
+
+        // Same as the single path query
+        AppInfo singleAppInfo;
+        ASSERT_TRUE(manager.loadInfoFromDb(testAppPath(i), singleAppInfo));
+        ASSERT_EQ(singleAppInfo.iconId, appInfo.iconId);
+    }
+
+    ASSERT_TRUE(manager.loadInfosFromDb({}).isEmpty());
+
+    manager.tearDown();
+}
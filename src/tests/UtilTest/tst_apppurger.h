@@ -0,0 +1,151 @@
+#pragma once
+
+#include <QDir>
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include <googletest.h>
+
+#include <appinfo/apppurgejob.h>
+#include <appinfo/apppurgemanager.h>
+
+class AppPurgerTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static QVector<qint64> sorted(QVector<qint64> appIds);
+
+protected:
+    static constexpr int dirsCount = 40;
+    static constexpr int dirAppsCount = 100;
+
+    QTemporaryDir m_tempDir;
+
+    QVector<AppPurgeEntry> m_apps;
+    QVector<qint64> m_obsoleteAppIds;
+};
+
+void AppPurgerTest::SetUp()
+{
+    ASSERT_TRUE(m_tempDir.isValid());
+
+    const QDir rootDir(m_tempDir.path());
+
+    qint64 appId = 0;
+
+    for (int dirIndex = 0; dirIndex < dirsCount; ++dirIndex) {
+        const QString dirName = QString("vendor%1").arg(dirIndex);
+        ASSERT_TRUE(rootDir.mkpath(dirName));
+
+        const QDir dir(rootDir.filePath(dirName));
+
+        for (int i = 0; i < dirAppsCount; ++i) {
+            const QString filePath = QDir::toNativeSeparators(dir.filePath(QString("app%1.exe").arg(i)));
+
+            m_apps.append({ .appId = ++appId, .appPath = filePath });
+
+            // Every 7th app is removed
+            if (appId % 7 == 0) {
+                m_obsoleteAppIds.append(appId);
+                continue;
+            }
+
+            QFile file(filePath);
+            ASSERT_TRUE(file.open(QFile::WriteOnly));
+        }
+    }
+
+    // The directory was removed
+    for (int i = 0; i < dirAppsCount; ++i) {
+        const QString filePath = QDir::toNativeSeparators(
+                rootDir.filePath(QString("removed\\app%1.exe").arg(i)));
+
+        m_apps.append({ .appId = ++appId, .appPath = filePath });
+        m_obsoleteAppIds.append(appId);
+    }
+}
+
+void AppPurgerTest::TearDown()
+{
+    m_apps.clear();
+    m_obsoleteAppIds.clear();
+}
+
+QVector<qint64> AppPurgerTest::sorted(QVector<qint64> appIds)
+{
+    std::sort(appIds.begin(), appIds.end());
+    return appIds;
+}
+
+TEST_F(AppPurgerTest, groupByDir)
+{
+    const QVector<AppPurgeJobPtr> jobs = AppPurgeJob::createJobs(m_apps);
+
+    ASSERT_EQ(jobs.size(), dirsCount + 1);
+
+    QVector<qint64> obsoleteAppIds;
+
+    for (const AppPurgeJobPtr &job : jobs) {
+        ASSERT_EQ(job->apps().size(), dirAppsCount);
+
+        job->checkApps();
+
+        ASSERT_EQ(job->checkedCount(), dirAppsCount);
+
+        obsoleteAppIds += job->obsoleteAppIds();
+    }
+
+    ASSERT_EQ(sorted(obsoleteAppIds), m_obsoleteAppIds);
+}
+
+TEST_F(AppPurgerTest, parallelCheck)
+{
+    AppPurgeManager manager;
+
+    QSignalSpy progressSpy(&manager, &AppPurgeManager::progressChanged);
+    QSignalSpy finishedSpy(&manager, &AppPurgeManager::checkFinished);
+
+    manager.checkApps(m_apps);
+
+    ASSERT_TRUE(finishedSpy.wait(30000));
+    ASSERT_EQ(finishedSpy.count(), 1);
+
+    const auto obsoleteAppIds = finishedSpy.first().at(0).value<QVector<qint64>>();
+    ASSERT_EQ(sorted(obsoleteAppIds), m_obsoleteAppIds);
+
+    // Progress by directories
+    ASSERT_EQ(progressSpy.count(), dirsCount + 1);
+    ASSERT_EQ(progressSpy.last().at(0).toInt(), int(m_apps.size()));
+    ASSERT_EQ(progressSpy.last().at(1).toInt(), int(m_apps.size()));
+
+    ASSERT_EQ(manager.checkedCount(), manager.totalCount());
+}
+
+TEST_F(AppPurgerTest, abortCheck)
+{
+    AppPurgeManager manager;
+
+    QSignalSpy finishedSpy(&manager, &AppPurgeManager::checkFinished);
+
+    manager.checkApps(m_apps);
+    manager.abortWorkers();
+
+    // The results of the aborted check are dropped
+    ASSERT_FALSE(finishedSpy.wait(500));
+    ASSERT_LT(manager.checkedCount(), manager.totalCount());
+}
+
+TEST_F(AppPurgerTest, emptyCheck)
+{
+    AppPurgeManager manager;
+
+    QSignalSpy finishedSpy(&manager, &AppPurgeManager::checkFinished);
+
+    manager.checkApps({});
+
+    ASSERT_EQ(finishedSpy.count(), 1);
+}
@@ -0,0 +1,223 @@
+#pragma once
+
+#include <googletest.h>
+
+#include <log/logentryblockedip.h>
+#include <stat/askpendingqueue.h>
+
+class AskPendingQueueTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static LogEntryBlockedIp makeEntry(int appIndex, quint16 port, qint64 connTime);
+};
+
+void AskPendingQueueTest::SetUp() { }
+
+void AskPendingQueueTest::TearDown() { }
+
+LogEntryBlockedIp AskPendingQueueTest::makeEntry(int appIndex, quint16 port, qint64 connTime)
+{
+    LogEntryBlockedIp entry;
+    entry.setKernelPath(QString("C:\\test\\app%1.exe").arg(appIndex));
+    entry.setIpProto(6);
+    entry.setRemoteIp4(0x08080808);
+    entry.setRemotePort(port);
+    entry.setConnTime(connTime);
+    return entry;
+}
+
+TEST_F(AskPendingQueueTest, dedupBurst)
+{
+    constexpr int eventsCount = 100000;
+    constexpr int appsCount = 50;
+    constexpr int portsCount = 10;
+
+    AskPendingQueue queue;
+
+    for (int i = 0; i < eventsCount; ++i) {
+        const int appIndex = i % appsCount;
+        const quint16 port = 80 + (i / appsCount) % portsCount;
+
+        queue.addEntry(makeEntry(appIndex, port, /*connTime=*/i));
+    }
+
+    ASSERT_EQ(queue.count(), appsCount * portsCount);
+
+    const QVector<AskPendingConn> conns = queue.conns();
+    ASSERT_EQ(conns.size(), queue.count());
+
+    quint32 hitsCount = 0;
+    for (const AskPendingConn &conn : conns) {
+        ASSERT_EQ(conn.hitCount, quint32(eventsCount / (appsCount * portsCount)));
+        hitsCount += conn.hitCount;
+    }
+    ASSERT_EQ(hitsCount, quint32(eventsCount));
+
+    // The first and last seen times of the first connection
+    const AskPendingConn *conn = queue.connById(1);
+    ASSERT_NE(conn, nullptr);
+    ASSERT_EQ(conn->remotePort, 80);
+    ASSERT_EQ(conn->firstTime, 0);
+    ASSERT_EQ(conn->lastTime, eventsCount - appsCount * portsCount);
+
+    // IPv6 address makes another connection
+    LogEntryBlockedIp entry6 = makeEntry(0, 80, eventsCount);
+    entry6.setIsIPv6(true);
+    entry6.remoteIp().v6 = {};
+
+    ASSERT_EQ(queue.addEntry(entry6).hitCount, quint32(1));
+    ASSERT_EQ(queue.count(), appsCount * portsCount + 1);
+
+    // Not reported connections are not removed
+    const AskPendingChanges changes = queue.takeChanges();
+    ASSERT_EQ(changes.updatedConns.size(), queue.count());
+    ASSERT_TRUE(changes.removedConnIds.isEmpty());
+
+    ASSERT_TRUE(queue.takeChanges().isEmpty());
+}
+
+TEST_F(AskPendingQueueTest, lruEvictionBurst)
+{
+    constexpr int eventsCount = 100000;
+    constexpr int maxCount = 1000;
+
+    AskPendingQueue queue(maxCount);
+
+    for (int i = 0; i < eventsCount; ++i) {
+        // Hot connection
+        if (i % 10 == 0) {
+            queue.addEntry(makeEntry(0, 1, i));
+        }
+
+        queue.addEntry(makeEntry(1 + i / 60000, quint16(i % 60000), i));
+
+        ASSERT_LE(queue.count(), maxCount);
+    }
+
+    ASSERT_EQ(queue.count(), maxCount);
+
+    const QVector<AskPendingConn> conns = queue.conns();
+
+    // Most recently seen first
+    ASSERT_EQ(conns.first().lastTime, eventsCount - 1);
+    for (int i = 1; i < conns.size(); ++i) {
+        ASSERT_GE(conns[i - 1].lastTime, conns[i].lastTime);
+    }
+
+    // The hot connection is kept
+    const AskPendingConn *hotConn = queue.connById(1);
+    ASSERT_NE(hotConn, nullptr);
+    ASSERT_EQ(hotConn->hitCount, quint32(eventsCount / 10));
+
+    const quint32 hotConnId = hotConn->connId;
+
+    // Evicted connections were not reported yet
+    AskPendingChanges changes = queue.takeChanges();
+    ASSERT_EQ(changes.updatedConns.size(), maxCount);
+    ASSERT_TRUE(changes.removedConnIds.isEmpty());
+
+    // Evict the reported connections
+    for (int i = 0; i < maxCount / 2; ++i) {
+        queue.addEntry(makeEntry(100, quint16(i), eventsCount + i));
+    }
+
+    changes = queue.takeChanges();
+    ASSERT_EQ(changes.updatedConns.size(), maxCount / 2);
+    ASSERT_EQ(changes.removedConnIds.size(), maxCount / 2);
+    ASSERT_FALSE(changes.removedConnIds.contains(hotConnId));
+}
+
+TEST_F(AskPendingQueueTest, updateConn)
+{
+    AskPendingQueue queue;
+
+    const AskPendingConn conn1 = queue.addEntry(makeEntry(1, 80, 100));
+    const AskPendingConn conn2 = queue.addEntry(makeEntry(2, 80, 200));
+    queue.takeChanges();
+
+    // Update the existing connection in place
+    AskPendingConn conn = conn1;
+    conn.hitCount = 5;
+    conn.lastTime = 300;
+    queue.updateConn(conn);
+
+    ASSERT_EQ(queue.count(), 2);
+    ASSERT_EQ(queue.conns().first().connId, conn1.connId);
+    ASSERT_EQ(queue.connById(conn1.connId)->hitCount, 5u);
+
+    AskPendingChanges changes = queue.takeChanges();
+    ASSERT_EQ(changes.updatedConns.size(), 1);
+    ASSERT_EQ(changes.updatedConns.first().connId, conn1.connId);
+    ASSERT_TRUE(changes.removedConnIds.isEmpty());
+
+    // Change the key of the existing connection
+    conn.remotePort = 443;
+    queue.updateConn(conn);
+
+    ASSERT_EQ(queue.count(), 2);
+    ASSERT_EQ(queue.addEntry(makeEntry(1, 443, 400)).connId, conn1.connId);
+
+    changes = queue.takeChanges();
+    ASSERT_EQ(changes.updatedConns.size(), 1);
+    ASSERT_TRUE(changes.removedConnIds.isEmpty());
+
+    // Another connection id with the same key replaces the old one
+    conn = conn2;
+    conn.connId = 10;
+    queue.updateConn(conn);
+
+    ASSERT_EQ(queue.count(), 2);
+    ASSERT_EQ(queue.connById(conn2.connId), nullptr);
+    ASSERT_NE(queue.connById(10), nullptr);
+
+    changes = queue.takeChanges();
+    ASSERT_EQ(changes.updatedConns.size(), 1);
+    ASSERT_EQ(changes.updatedConns.first().connId, 10u);
+    ASSERT_EQ(changes.removedConnIds, QVector<quint32>({ conn2.connId }));
+}
+
+TEST_F(AskPendingQueueTest, replicaChanges)
+{
+    AskPendingQueue queue;
+    AskPendingQueue replica;
+
+    const auto applyChanges = [&] {
+        const AskPendingChanges changes = queue.takeChanges();
+
+        for (const AskPendingConn &conn : changes.updatedConns) {
+            replica.updateConn(conn);
+        }
+        for (const quint32 connId : changes.removedConnIds) {
+            replica.removeConn(connId);
+        }
+    };
+
+    for (int i = 0; i < 1000; ++i) {
+        queue.addEntry(makeEntry(i % 7, quint16(i % 13), i));
+    }
+    applyChanges();
+
+    ASSERT_EQ(replica.count(), queue.count());
+
+    // Decide the app
+    ASSERT_EQ(queue.removeAppPath("C:\\test\\app3.exe"), 13);
+
+    queue.addEntry(makeEntry(1, 1, 2000));
+    applyChanges();
+
+    ASSERT_EQ(replica.count(), queue.count());
+
+    for (const AskPendingConn &conn : queue.conns()) {
+        const AskPendingConn *replicaConn = replica.connById(conn.connId);
+
+        ASSERT_NE(replicaConn, nullptr);
+        ASSERT_EQ(replicaConn->appPath, conn.appPath);
+        ASSERT_EQ(replicaConn->remotePort, conn.remotePort);
+        ASSERT_EQ(replicaConn->hitCount, conn.hitCount);
+        ASSERT_EQ(replicaConn->lastTime, conn.lastTime);
+    }
+}
@@ -0,0 +1,357 @@
+#pragma once
+
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+
+#include <googletest.h>
+
+#include <conf/addressgroup.h>
+#include <conf/appgroup.h>
+#include <conf/confchangejournal.h>
+#include <conf/confmanager.h>
+#include <conf/firewallconf.h>
+#include <util/ioc/ioccontainer.h>
+
+// Flags & ini options, saved to the ini file by FortSettings
+struct TestConfIni
+{
+    QVariant flags;
+    QVariantMap iniMap;
+};
+
+class TestConfManager : public ConfManager
+{
+public:
+    explicit TestConfManager(const QString &filePath, TestConfIni &confIni) :
+        ConfManager(filePath), m_confIni(confIni)
+    {
+    }
+
+protected:
+    void readConfIni(FirewallConf &conf) const override
+    {
+        if (!m_confIni.flags.isNull()) {
+            conf.flagsFromVariant(m_confIni.flags);
+        }
+    }
+
+    void writeConfIni(const FirewallConf &conf) override
+    {
+        if (conf.flagsEdited()) {
+            m_confIni.flags = conf.flagsToVariant();
+        }
+
+        if (!conf.iniEdited())
+            return;
+
+        const QVariantMap &iniMap = conf.ini().map();
+        for (auto it = iniMap.constBegin(); it != iniMap.constEnd(); ++it) {
+            if (!it.key().endsWith('_')) {
+                m_confIni.iniMap.insert(it.key(), it.value());
+            }
+        }
+    }
+
+private:
+    TestConfIni &m_confIni;
+};
+
+class ConfJournalTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static void editConf(FirewallConf &conf, QRandomGenerator &rand);
+
+    static void saveConf(ConfManager &confManager, QRandomGenerator &rand);
+
+    static QVariant fullLoadVariant(ConfManager &confManager);
+
+protected:
+    IocContainer m_ioc;
+
+    TestConfIni m_confIni;
+
+    QTemporaryDir m_tempDir;
+};
+
+void ConfJournalTest::SetUp()
+{
+    m_ioc.pinToThread();
+
+    ASSERT_TRUE(m_tempDir.isValid());
+}
+
+void ConfJournalTest::TearDown() { }
+
+void ConfJournalTest::editConf(FirewallConf &conf, QRandomGenerator &rand)
+{
+    const int appGroupsCount = conf.appGroups().size();
+
+    switch (rand.bounded(7)) {
+    case 0: {
+        AddressGroup *addrGroup = conf.addressGroups().at(rand.bounded(2));
+        addrGroup->setIncludeAll(rand.bounded(2) != 0);
+        addrGroup->setExcludeText(QString("10.%1.0.0/16").arg(rand.bounded(256)));
+
+        conf.setOptEdited();
+    } break;
+    case 1: {
+        if (appGroupsCount >= 16)
+            return;
+
+        conf.addAppGroupByName(QString("Group %1").arg(rand.bounded(1000)));
+
+        // The app groups' enabled states are saved in the flags
+        conf.setOptEdited();
+        conf.setFlagsEdited();
+    } break;
+    case 2: {
+        if (appGroupsCount <= 1)
+            return;
+
+        const int index = 1 + rand.bounded(appGroupsCount - 1);
+        conf.removeAppGroup(index, index);
+
+        conf.setOptEdited();
+        conf.setFlagsEdited();
+    } break;
+    case 3: {
+        conf.moveAppGroup(rand.bounded(appGroupsCount), rand.bounded(appGroupsCount));
+
+        conf.setOptEdited();
+        conf.setFlagsEdited();
+    } break;
+    case 4: {
+        AppGroup *appGroup = conf.appGroups().at(rand.bounded(appGroupsCount));
+        appGroup->setEnabled(rand.bounded(2) != 0);
+        appGroup->setBlockText(QString("C:\\App%1\\**").arg(rand.bounded(1000)));
+        appGroup->setSpeedLimitIn(rand.bounded(10000));
+
+        conf.setOptEdited();
+        conf.setFlagsEdited();
+    } break;
+    case 5: {
+        conf.setBlockTraffic(rand.bounded(2) != 0);
+        conf.setLogBlocked(rand.bounded(2) != 0);
+        conf.setActivePeriodFrom(QString("%1:00").arg(rand.bounded(24)));
+
+        conf.setFlagsEdited();
+    } break;
+    case 6: {
+        conf.ini().setLogDebug(rand.bounded(2) != 0);
+        conf.ini().setPassword("secret"); // transient
+
+        conf.setIniEdited();
+    } break;
+    }
+}
+
+void ConfJournalTest::saveConf(ConfManager &confManager, QRandomGenerator &rand)
+{
+    confManager.initConfToEdit();
+
+    FirewallConf *conf = confManager.confToEdit();
+
+    const int editsCount = 1 + rand.bounded(3);
+    for (int i = 0; i < editsCount; ++i) {
+        editConf(*conf, rand);
+    }
+
+    if (!conf->anyEdited()) {
+        confManager.setConfToEdit(nullptr);
+        return;
+    }
+
+    ASSERT_TRUE(confManager.saveConf(*conf));
+
+    confManager.applySavedConf(conf);
+    confManager.setConfToEdit(nullptr);
+}
+
+QVariant ConfJournalTest::fullLoadVariant(ConfManager &confManager)
+{
+    FirewallConf conf;
+    if (!confManager.loadConf(conf))
+        return {};
+
+    return conf.toVariant();
+}
+
+TEST_F(ConfJournalTest, randomEditsReplay)
+{
+    for (const quint32 seed : { 1, 7, 42 }) {
+        TestConfManager confManager(":memory:", m_confIni);
+        confManager.setUp();
+
+        ASSERT_TRUE(confManager.load());
+
+        QRandomGenerator rand(seed);
+
+        // The client's copy of the conf
+        FirewallConf clientConf;
+        clientConf.copy(*confManager.conf());
+
+        qint64 clientRevision = confManager.journal().revision();
+
+        QVariantMap journalIniMap;
+
+        for (int i = 0; i < 100; ++i) {
+            saveConf(confManager, rand);
+
+            QVector<ConfChange> changes;
+            ASSERT_TRUE(confManager.journal().changesSince(clientRevision, changes));
+
+            ConfChangeJournal::applyChanges(clientConf, changes);
+            clientRevision = confManager.journal().revision();
+
+            for (const ConfChange &change : changes) {
+                ASSERT_GT(change.revision, 0);
+
+                if (change.type == ConfChange::TypeIni) {
+                    journalIniMap.insert(change.data.toMap());
+                }
+            }
+
+            ASSERT_EQ(clientConf.toVariant(), fullLoadVariant(confManager));
+            ASSERT_EQ(clientConf.toVariant(), confManager.conf()->toVariant());
+        }
+
+        // The transient ini options are not journaled
+        ASSERT_FALSE(journalIniMap.isEmpty());
+        ASSERT_FALSE(journalIniMap.contains("base/password_"));
+        ASSERT_EQ(journalIniMap, m_confIni.iniMap);
+
+        m_confIni = {};
+    }
+}
+
+TEST_F(ConfJournalTest, patchVariant)
+{
+    TestConfManager confManager(":memory:", m_confIni);
+    confManager.setUp();
+    ASSERT_TRUE(confManager.load());
+
+    // The patches are sent to clients
+    QVariant confVar;
+    QObject::connect(&confManager, &ConfManager::confChanged, [&](bool onlyFlags) {
+        confVar = confManager.toPatchVariant(onlyFlags);
+    });
+
+    TestConfManager clientManager(":memory:", m_confIni);
+    clientManager.conf()->copy(*confManager.conf());
+    clientManager.journal().setRevision(confManager.journal().revision());
+
+    QRandomGenerator rand(3);
+
+    for (int i = 0; i < 50; ++i) {
+        confVar.clear();
+
+        saveConf(confManager, rand);
+
+        if (confVar.isNull())
+            continue;
+
+        ASSERT_TRUE(clientManager.applyPatchVariant(confVar));
+        ASSERT_EQ(clientManager.journal().revision(), confManager.journal().revision());
+
+        clientManager.conf()->resetEdited();
+        ASSERT_EQ(clientManager.conf()->toVariant(), confManager.conf()->toVariant());
+    }
+
+    // The client is out of sync
+    clientManager.journal().setRevision(0);
+
+    ASSERT_FALSE(clientManager.applyPatchVariant(confManager.toPatchVariant(/*onlyFlags=*/false)));
+}
+
+TEST_F(ConfJournalTest, restartSurvival)
+{
+    const QString filePath = m_tempDir.filePath("conf.db");
+
+    FirewallConf clientConf;
+    qint64 clientRevision;
+
+    QRandomGenerator rand(5);
+
+    {
+        TestConfManager confManager(filePath, m_confIni);
+        confManager.setUp();
+        ASSERT_TRUE(confManager.load());
+
+        clientConf.copy(*confManager.conf());
+        clientRevision = confManager.journal().revision();
+
+        for (int i = 0; i < 30; ++i) {
+            saveConf(confManager, rand);
+        }
+
+        ASSERT_GT(confManager.journal().revision(), clientRevision);
+    }
+
+    // Restart
+    TestConfManager confManager(filePath, m_confIni);
+    confManager.setUp();
+
+    QVector<ConfChange> changes;
+    ASSERT_TRUE(confManager.journal().changesSince(clientRevision, changes));
+    ASSERT_EQ(changes.size(), confManager.journal().revision() - clientRevision);
+
+    ConfChangeJournal::applyChanges(clientConf, changes);
+
+    ASSERT_EQ(clientConf.toVariant(), fullLoadVariant(confManager));
+
+    // The revisions continue
+    const qint64 revision = confManager.journal().revision();
+
+    ASSERT_TRUE(confManager.load());
+
+    for (int i = 0; i < 10; ++i) {
+        saveConf(confManager, rand);
+    }
+
+    ASSERT_GT(confManager.journal().changes().constFirst().revision, 0);
+    ASSERT_GT(confManager.journal().revision(), revision);
+}
+
+TEST_F(ConfJournalTest, maxCount)
+{
+    ConfChangeJournal journal(/*maxCount=*/4);
+
+    FirewallConf conf;
+
+    for (int i = 0; i < 6; ++i) {
+        conf.resetEdited();
+        conf.setBlockTraffic(i % 2 != 0);
+        conf.setFlagsEdited();
+
+        journal.addEdits(conf, ConfChangeJournal::collectEdits(conf));
+    }
+
+    ASSERT_EQ(journal.revision(), 6);
+    ASSERT_EQ(journal.minRevision(), 2);
+    ASSERT_EQ(journal.changes().size(), 4);
+
+    QVector<ConfChange> changes;
+    ASSERT_FALSE(journal.changesSince(1, changes));
+    ASSERT_FALSE(journal.changesSince(7, changes));
+
+    ASSERT_TRUE(journal.changesSince(2, changes));
+    ASSERT_EQ(changes.size(), 4);
+    ASSERT_EQ(changes.first().revision, 3);
+
+    ASSERT_TRUE(journal.changesSince(6, changes));
+    ASSERT_TRUE(changes.isEmpty());
+
+    // Compact variant of the changes
+    const QVector<ConfChange> journalChanges = journal.changes();
+    const QVariant changesVar = ConfChangeJournal::changesToVariant(journalChanges);
+
+    const QVector<ConfChange> varChanges = ConfChangeJournal::changesFromVariant(changesVar);
+    ASSERT_EQ(varChanges.size(), journalChanges.size());
+    ASSERT_EQ(varChanges.last().revision, 6);
+    ASSERT_EQ(varChanges.last().type, ConfChange::TypeFlags);
+    ASSERT_EQ(varChanges.last().data, journalChanges.last().data);
+}
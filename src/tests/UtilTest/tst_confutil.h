@@ -1,10 +1,16 @@
 #pragma once
 
+#include <functional>
+
+#include <QElapsedTimer>
 #include <QSignalSpy>
 
 #include <googletest.h>
 
+#include <common/fortconf.h>
+
 #include <conf/addressgroup.h>
+#include <conf/app.h>
 #include <conf/appgroup.h>
 #include <conf/firewallconf.h>
 #include <driver/drivercommon.h>
@@ -13,6 +19,7 @@
 #include <util/conf/confappswalker.h>
 #include <util/conf/confutil.h>
 #include <util/fileutil.h>
+#include <util/net/iprange.h>
 #include <util/net/netutil.h>
 
 class ConfUtilTest : public Test
@@ -129,6 +136,291 @@ TEST_F(ConfUtilTest, confWriteRead)
     ASSERT_EQ(int(DriverCommon::confAppGroupIndex(firefoxFlags)), 1);
 }
 
+namespace {
+
+QByteArray writeAppConf(const QString &blockText, const QString &allowText)
+{
+    EnvManager envManager;
+    FirewallConf conf;
+
+    conf.setAppBlockAll(true);
+    conf.setAppAllowAll(false);
+
+    AppGroup *appGroup = new AppGroup();
+    appGroup->setName("Apps");
+    appGroup->setEnabled(true);
+    appGroup->setBlockText(blockText);
+    appGroup->setAllowText(allowText);
+
+    conf.addAppGroup(appGroup);
+
+    conf.resetEdited(true);
+    conf.prepareToSave();
+
+    ConfUtil confUtil;
+
+    if (!confUtil.write(conf, nullptr, envManager))
+        return {};
+
+    return confUtil.buffer();
+}
+
+FORT_APP_DATA cachedAppFind(
+        PFORT_APP_VERDICT verdict, quint32 confGeneration, const char *data, const QString &path)
+{
+    FORT_APP_DATA app_data;
+    if (fort_conf_app_verdict_get(verdict, confGeneration, &app_data))
+        return app_data;
+
+    app_data = {};
+    app_data.flags.v = DriverCommon::confAppFind(data, path);
+
+    fort_conf_app_verdict_set(verdict, confGeneration, app_data);
+
+    return app_data;
+}
+
+}
+
+TEST_F(ConfUtilTest, appVerdictGeneration)
+{
+    const QString path = FileUtil::pathToKernelPath("C:\\Utils\\Test\\test.exe");
+
+    const QByteArray bufAllow = writeAppConf(QString(), "C:\\Utils\\Test\\test.exe");
+    const QByteArray bufBlock = writeAppConf("C:\\Utils\\Test\\test.exe", QString());
+    ASSERT_FALSE(bufAllow.isEmpty());
+    ASSERT_FALSE(bufBlock.isEmpty());
+
+    const char *dataAllow = bufAllow.constData() + DriverCommon::confIoConfOff();
+    const char *dataBlock = bufBlock.constData() + DriverCommon::confIoConfOff();
+
+    qint8 blockReason = FORT_BLOCK_REASON_UNKNOWN;
+
+    FORT_APP_VERDICT verdict = {};
+    FORT_APP_DATA app_data;
+
+    // Not cached yet
+    ASSERT_FALSE(fort_conf_app_verdict_get(&verdict, 1, &app_data));
+
+    quint32 volatile confGeneration = 0;
+    ASSERT_EQ(fort_conf_generation_bump(&confGeneration), 1u);
+
+    app_data = cachedAppFind(&verdict, confGeneration, dataAllow, path);
+    ASSERT_FALSE(DriverCommon::confAppBlocked(dataAllow, app_data.flags.v, &blockReason));
+
+    // Cached verdict is reused for the same generation
+    ASSERT_TRUE(fort_conf_app_verdict_get(&verdict, confGeneration, &app_data));
+    ASSERT_FALSE(DriverCommon::confAppBlocked(dataAllow, app_data.flags.v, &blockReason));
+
+    // Conf is changed: the cached verdict must not be used
+    ASSERT_EQ(fort_conf_generation_bump(&confGeneration), 2u);
+    ASSERT_FALSE(fort_conf_app_verdict_get(&verdict, confGeneration, &app_data));
+
+    app_data = cachedAppFind(&verdict, confGeneration, dataBlock, path);
+    ASSERT_EQ(app_data.flags.v, DriverCommon::confAppFind(dataBlock, path));
+    ASSERT_TRUE(DriverCommon::confAppBlocked(dataBlock, app_data.flags.v, &blockReason));
+    ASSERT_EQ(blockReason, FORT_BLOCK_REASON_APP_GROUP_FOUND);
+
+    // Zero generation never matches, even on wrap around
+    confGeneration = 0xFFFFFFFF;
+    ASSERT_EQ(fort_conf_generation_bump(&confGeneration), 1u);
+    ASSERT_EQ(confGeneration, 1u);
+    ASSERT_FALSE(fort_conf_app_verdict_get(&verdict, 0, &app_data));
+
+    fort_conf_app_verdict_set(&verdict, 0, app_data);
+    ASSERT_FALSE(fort_conf_app_verdict_get(&verdict, 0, &app_data));
+}
+
+TEST_F(ConfUtilTest, confVerify)
+{
+    const QByteArray buf = writeAppConf("System\nC:\\Utils\\Test\\**",
+            "?:\\Utils\\Dev\\Git\\**\nC:\\Utils\\Firefox\\Bin\\firefox.exe");
+    ASSERT_FALSE(buf.isEmpty());
+
+    const quint32 confLen = quint32(buf.size()) - DriverCommon::confIoConfOff();
+
+    // Written conf is valid
+    ASSERT_TRUE(DriverCommon::confVerify(buf.constData() + DriverCommon::confIoConfOff(), confLen));
+
+    // Truncated conf
+    ASSERT_FALSE(DriverCommon::confVerify(
+            buf.constData() + DriverCommon::confIoConfOff(), confLen - sizeof(quint32)));
+
+    const auto verifyCorrupted = [&](const std::function<void(PFORT_CONF conf)> &corrupt) {
+        QByteArray badBuf = buf;
+        PFORT_CONF conf = PFORT_CONF(badBuf.data() + DriverCommon::confIoConfOff());
+
+        corrupt(conf);
+
+        return DriverCommon::confVerify(conf, confLen);
+    };
+
+    // Sections out of order
+    ASSERT_FALSE(verifyCorrupted(
+            [](PFORT_CONF conf) { conf->exe_apps_off = conf->wild_apps_off - 1; }));
+    ASSERT_FALSE(verifyCorrupted([&](PFORT_CONF conf) { conf->exe_apps_off = confLen; }));
+
+    // Too many apps
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF conf) { conf->exe_apps_n += 1; }));
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF conf) { conf->wild_apps_n += 1; }));
+
+    // Too many periods
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF conf) { conf->app_periods_n = 1; }));
+
+    // Odd path length of an app
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF conf) {
+        PFORT_APP_ENTRY app_entry = PFORT_APP_ENTRY(conf->data + conf->exe_apps_off);
+        app_entry->path_len += 1;
+    }));
+
+    // Address list's count out of the group
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF conf) {
+        const PFORT_CONF_ADDR_GROUP addr_group = fort_conf_addr_group_ref(conf, 1);
+        PFORT_CONF_ADDR4_LIST addr_list = fort_conf_addr_group_include_list_ref(addr_group);
+        addr_list->ip_n += 1000;
+    }));
+}
+
+TEST_F(ConfUtilTest, appEntriesBatch)
+{
+    constexpr int appsCount = 10000;
+
+    QList<App> apps;
+    apps.reserve(appsCount + 1);
+
+    for (int i = 0; i < appsCount; ++i) {
+        App app;
+        app.appPath = QString("C:\\Apps\\Vendor%1\\app%2.exe").arg(i % 97).arg(i);
+        app.groupIndex = i % 2;
+        app.blocked = (i % 3 == 0);
+        app.killProcess = (i % 5 == 0);
+
+        apps.append(app);
+    }
+
+    // Duplicate path is written once
+    apps.append(apps.first());
+
+    ConfUtil confUtil;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ASSERT_TRUE(confUtil.writeAppEntries(apps));
+
+    const quint32 len = quint32(confUtil.buffer().size());
+
+    ASSERT_TRUE(DriverCommon::confAppEntriesVerify(confUtil.data(), len));
+
+    // Packed and verified in one pass
+    ASSERT_LT(timer.elapsed(), 1000);
+
+    // Check the packed entries
+    const PFORT_APP_ENTRIES app_entries = PFORT_APP_ENTRIES(confUtil.data());
+    ASSERT_EQ(int(app_entries->apps_n), appsCount);
+
+    QHash<QString, FORT_APP_DATA> appDataMap;
+
+    const char *data = app_entries->data;
+    for (int i = 0; i < appsCount; ++i) {
+        const PFORT_APP_ENTRY app_entry = PFORT_APP_ENTRY(data);
+
+        const QString kernelPath = QString::fromWCharArray(
+                (const wchar_t *) app_entry->path, app_entry->path_len / sizeof(wchar_t));
+        appDataMap.insert(kernelPath, app_entry->app_data);
+
+        data += FORT_CONF_APP_ENTRY_SIZE(app_entry->path_len);
+    }
+
+    ASSERT_EQ(data, confUtil.data() + len);
+    ASSERT_EQ(appDataMap.size(), appsCount);
+
+    for (int i = 0; i < appsCount; ++i) {
+        const App &app = apps.at(i);
+        const FORT_APP_DATA app_data =
+                appDataMap.value(FileUtil::pathToKernelPath(app.appPath), {});
+
+        ASSERT_TRUE(app_data.flags.found) << i;
+        ASSERT_EQ(int(app_data.flags.group_index), app.groupIndex);
+        ASSERT_EQ(bool(app_data.flags.blocked), app.blocked);
+        ASSERT_EQ(bool(app_data.flags.kill_process), app.killProcess);
+        ASSERT_FALSE(app_data.flags.is_new);
+    }
+
+    // Malformed batches are rejected by the driver
+    const auto verifyCorrupted = [&](const std::function<void(PFORT_APP_ENTRIES)> &corrupt,
+                                         quint32 badLen) {
+        QByteArray badBuf = confUtil.buffer();
+
+        corrupt(PFORT_APP_ENTRIES(badBuf.data()));
+
+        return DriverCommon::confAppEntriesVerify(badBuf.constData(), badLen);
+    };
+
+    ASSERT_FALSE(verifyCorrupted([](PFORT_APP_ENTRIES) { }, len - 1));
+    ASSERT_FALSE(verifyCorrupted([](PFORT_APP_ENTRIES) { }, 1));
+    ASSERT_FALSE(
+            verifyCorrupted([](PFORT_APP_ENTRIES app_entries) { app_entries->apps_n += 1; }, len));
+    ASSERT_FALSE(verifyCorrupted(
+            [](PFORT_APP_ENTRIES app_entries) {
+                PFORT_APP_ENTRY app_entry = PFORT_APP_ENTRY(app_entries->data);
+                app_entry->path_len += 1;
+            },
+            len));
+
+    // Single entry of ADDAPP
+    const PFORT_APP_ENTRY app_entry = PFORT_APP_ENTRY(app_entries->data);
+    const quint32 entrySize = FORT_CONF_APP_ENTRY_SIZE(app_entry->path_len);
+
+    ASSERT_TRUE(DriverCommon::confAppVerify(app_entry, entrySize));
+    ASSERT_FALSE(DriverCommon::confAppVerify(app_entry, entrySize - 1));
+}
+
+TEST_F(ConfUtilTest, zonesVerify)
+{
+    IpRange ipRange;
+    ASSERT_TRUE(ipRange.fromText("10.0.0.0/24\n192.168.1.1\n::1"));
+
+    ConfUtil zoneUtil;
+    zoneUtil.writeZone(ipRange);
+
+    const QByteArray zoneData = zoneUtil.buffer();
+    const quint32 zonesMask = (1u << 0) | (1u << 3);
+
+    ConfUtil confUtil;
+    confUtil.writeZones(zonesMask, zonesMask, 2 * zoneData.size(), { zoneData, zoneData });
+
+    const quint32 len = quint32(confUtil.buffer().size());
+
+    ASSERT_TRUE(DriverCommon::confZonesVerify(confUtil.data(), len));
+
+    // Malformed zones are rejected by the driver
+    const auto verifyCorrupted = [&](const std::function<void(PFORT_CONF_ZONES)> &corrupt,
+                                         quint32 badLen) {
+        QByteArray badBuf = confUtil.buffer();
+
+        corrupt(PFORT_CONF_ZONES(badBuf.data()));
+
+        return DriverCommon::confZonesVerify(badBuf.constData(), badLen);
+    };
+
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF_ZONES) { }, len - 1));
+    ASSERT_FALSE(verifyCorrupted([](PFORT_CONF_ZONES) { }, 1));
+    ASSERT_FALSE(verifyCorrupted([&](PFORT_CONF_ZONES zones) { zones->addr_off[3] = len; }, len));
+    ASSERT_FALSE(verifyCorrupted(
+            [&](PFORT_CONF_ZONES zones) {
+                zones->mask |= (1u << 5);
+                zones->addr_off[5] = len - FORT_CONF_ZONES_DATA_OFF;
+            },
+            len));
+    ASSERT_FALSE(verifyCorrupted(
+            [](PFORT_CONF_ZONES zones) {
+                PFORT_CONF_ADDR4_LIST addr_list = PFORT_CONF_ADDR4_LIST(zones->data);
+                addr_list->ip_n = FORT_CONF_IP_MAX + 1;
+            },
+            len));
+}
+
 TEST_F(ConfUtilTest, checkPeriod)
 {
     const quint8 h = 15, m = 35;
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/fortflowtab.h>
+
+namespace FlowTab {
+
+struct Node
+{
+    FORT_FLOWTAB_NODE tabNode; // must be first
+
+    quint64 flowId;
+};
+
+inline quint32 flowHash(quint64 flowId)
+{
+    const quint32 hash = quint32(flowId ^ (flowId >> 32)) * 0x9E3779B1u;
+    return hash ^ (hash >> 16);
+}
+
+}
+
+class FlowTabTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void init(int nodesCount);
+
+    void provideSegments(quint32 capacity);
+
+    void insertFlow(int index);
+
+    FlowTab::Node *findFlow(quint64 flowId);
+
+protected:
+    FORT_FLOWTAB *m_tab = nullptr;
+
+    QVector<FlowTab::Node> m_nodes;
+    QList<QByteArray> m_segments;
+};
+
+void FlowTabTest::SetUp()
+{
+    m_tab = new FORT_FLOWTAB();
+    fort_flowtab_init(m_tab);
+}
+
+void FlowTabTest::TearDown()
+{
+    // All provided segments are returned
+    int segmentsCount = 0;
+    while (fort_flowtab_segment_pop(m_tab) != nullptr) {
+        ++segmentsCount;
+    }
+    ASSERT_EQ(segmentsCount, m_segments.size());
+
+    delete m_tab;
+    m_tab = nullptr;
+}
+
+void FlowTabTest::init(int nodesCount)
+{
+    m_nodes = QVector<FlowTab::Node>(nodesCount);
+
+    for (int i = 0; i < nodesCount; ++i) {
+        m_nodes[i].flowId = 0x100000000ULL + i * 4;
+    }
+}
+
+void FlowTabTest::provideSegments(quint32 capacity)
+{
+    quint32 size;
+    while ((size = fort_flowtab_reserve_size(m_tab, capacity)) != 0) {
+        // Not zeroed segment
+        QByteArray segment(int(size), '\xCD');
+
+        ASSERT_TRUE(fort_flowtab_segment_add(m_tab, segment.data(), size));
+
+        m_segments.append(segment);
+    }
+}
+
+void FlowTabTest::insertFlow(int index)
+{
+    FlowTab::Node &node = m_nodes[index];
+
+    fort_flowtab_insert(m_tab, &node.tabNode, FlowTab::flowHash(node.flowId));
+}
+
+FlowTab::Node *FlowTabTest::findFlow(quint64 flowId)
+{
+    PFORT_FLOWTAB_NODE tabNode = fort_flowtab_bucket(m_tab, FlowTab::flowHash(flowId));
+
+    while (tabNode != nullptr) {
+        auto node = reinterpret_cast<FlowTab::Node *>(tabNode);
+        if (node->flowId == flowId)
+            return node;
+
+        tabNode = tabNode->next;
+    }
+
+    return nullptr;
+}
+
+TEST_F(FlowTabTest, insertFindRemove)
+{
+    constexpr int nodesCount = 10000;
+
+    init(nodesCount);
+
+    for (int i = 0; i < nodesCount; ++i) {
+        provideSegments(fort_flowtab_count(m_tab) + 1);
+        insertFlow(i);
+    }
+    ASSERT_EQ(fort_flowtab_count(m_tab), quint32(nodesCount));
+
+    // The table is grown by splits
+    ASSERT_GE(fort_flowtab_buckets_count(m_tab), quint32(nodesCount));
+
+    for (const FlowTab::Node &node : m_nodes) {
+        ASSERT_EQ(findFlow(node.flowId), &node);
+    }
+    ASSERT_EQ(findFlow(3), nullptr);
+
+    for (int i = 0; i < nodesCount; i += 2) {
+        fort_flowtab_remove(m_tab, &m_nodes[i].tabNode);
+    }
+    ASSERT_EQ(fort_flowtab_count(m_tab), quint32(nodesCount / 2));
+
+    for (int i = 0; i < nodesCount; ++i) {
+        const FlowTab::Node &node = m_nodes[i];
+        ASSERT_EQ(findFlow(node.flowId), (i % 2 == 0) ? nullptr : &node);
+    }
+}
+
+TEST_F(FlowTabTest, lateSegments)
+{
+    constexpr int nodesCount = 1000;
+
+    init(nodesCount);
+
+    // Without segments the table works with longer chains
+    for (int i = 0; i < nodesCount; ++i) {
+        insertFlow(i);
+    }
+    ASSERT_EQ(fort_flowtab_buckets_count(m_tab), FORT_FLOWTAB_BUCKETS_MIN);
+
+    provideSegments(nodesCount);
+
+    // The splits catch up with the next inserts
+    for (int i = 0; i < nodesCount; i += 2) {
+        fort_flowtab_remove(m_tab, &m_nodes[i].tabNode);
+        insertFlow(i);
+    }
+    ASSERT_GT(fort_flowtab_buckets_count(m_tab), FORT_FLOWTAB_BUCKETS_MIN);
+
+    for (const FlowTab::Node &node : m_nodes) {
+        ASSERT_EQ(findFlow(node.flowId), &node);
+    }
+}
+
+TEST_F(FlowTabTest, segmentSize)
+{
+    const quint32 size = fort_flowtab_reserve_size(m_tab, FORT_FLOWTAB_BUCKETS_MIN + 1);
+    ASSERT_EQ(size, FORT_FLOWTAB_BUCKETS_MIN * sizeof(PFORT_FLOWTAB_NODE));
+
+    QByteArray segment(int(size), '\0');
+
+    // Wrong size of the next segment
+    ASSERT_FALSE(fort_flowtab_segment_add(m_tab, segment.data(), size * 2));
+
+    ASSERT_TRUE(fort_flowtab_segment_add(m_tab, segment.data(), size));
+    m_segments.append(segment);
+
+    ASSERT_EQ(fort_flowtab_reserve_size(m_tab, FORT_FLOWTAB_BUCKETS_MIN * 2), 0u);
+}
+
+TEST_F(FlowTabTest, foreachRemove)
+{
+    constexpr int nodesCount = 500;
+
+    init(nodesCount);
+    provideSegments(nodesCount);
+
+    for (int i = 0; i < nodesCount; ++i) {
+        insertFlow(i);
+    }
+
+    int removedCount = 0;
+
+    // The callback removes the visited node
+    fort_flowtab_foreach_arg(
+            m_tab,
+            [](PVOID arg, PVOID tabNode) {
+                fort_flowtab_remove(PFORT_FLOWTAB(arg), PFORT_FLOWTAB_NODE(tabNode));
+            },
+            m_tab);
+
+    for (const FlowTab::Node &node : m_nodes) {
+        if (findFlow(node.flowId) == nullptr) {
+            ++removedCount;
+        }
+    }
+
+    ASSERT_EQ(removedCount, nodesCount);
+    ASSERT_EQ(fort_flowtab_count(m_tab), 0u);
+}
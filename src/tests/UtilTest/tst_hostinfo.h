@@ -0,0 +1,302 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <googletest.h>
+
+#include <sqlite/dbquery.h>
+
+#include <hostinfo/hostinfocache.h>
+#include <hostinfo/hostresolver.h>
+
+class FakeHostResolver : public HostResolver
+{
+public:
+    explicit FakeHostResolver(int latencyMsec = 0, qint32 ttlSecs = 0) :
+        m_latencyMsec(latencyMsec), m_ttlSecs(ttlSecs)
+    {
+    }
+
+    void setFailed(const QString &address)
+    {
+        QMutexLocker locker(&m_mutex);
+        m_failedAddresses.insert(address);
+    }
+
+    int callCount(const QString &address) const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_callCounts.value(address);
+    }
+
+    int maxRunningCount() const
+    {
+        QMutexLocker locker(&m_mutex);
+        return m_maxRunningCount;
+    }
+
+    HostLookup lookupHost(const QString &address) override
+    {
+        bool failed;
+        {
+            QMutexLocker locker(&m_mutex);
+            ++m_callCounts[address];
+            m_maxRunningCount = qMax(m_maxRunningCount, ++m_runningCount);
+            failed = m_failedAddresses.contains(address);
+        }
+
+        QThread::msleep(m_latencyMsec);
+
+        {
+            QMutexLocker locker(&m_mutex);
+            --m_runningCount;
+        }
+
+        if (failed)
+            return {};
+
+        return { .ok = true, .ttlSecs = m_ttlSecs, .hostName = "host-" + address };
+    }
+
+private:
+    const int m_latencyMsec = 0;
+    const qint32 m_ttlSecs = 0;
+
+    int m_runningCount = 0;
+    int m_maxRunningCount = 0;
+
+    mutable QMutex m_mutex;
+
+    QSet<QString> m_failedAddresses;
+    QHash<QString, int> m_callCounts;
+};
+
+class TestHostInfoCache : public HostInfoCache
+{
+public:
+    using HostInfoCache::HostInfoCache;
+
+    void setUnixTime(qint64 v) { m_unixTime = v; }
+    void addSecs(qint64 secs) { m_unixTime += secs; }
+
+    bool waitLookups()
+    {
+        return QTest::qWaitFor([&] { return pendingCount() == 0; }, 5000);
+    }
+
+protected:
+    qint64 currentUnixTime() const override { return m_unixTime; }
+
+private:
+    qint64 m_unixTime = 1700000000;
+};
+
+class HostInfoTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    QTemporaryDir m_tempDir;
+};
+
+void HostInfoTest::SetUp()
+{
+    ASSERT_TRUE(m_tempDir.isValid());
+}
+
+void HostInfoTest::TearDown() { }
+
+TEST_F(HostInfoTest, inFlightDedup)
+{
+    auto resolver = QSharedPointer<FakeHostResolver>::create(/*latencyMsec=*/200);
+
+    TestHostInfoCache cache;
+    cache.setResolver(resolver);
+    cache.setLookupConcurrency(4);
+    cache.setUp();
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_EQ(cache.hostName("10.0.0.1"), QString());
+        ASSERT_EQ(cache.hostName("10.0.0.2"), QString());
+    }
+
+    ASSERT_EQ(cache.pendingCount(), 2);
+
+    ASSERT_TRUE(cache.waitLookups());
+
+    ASSERT_EQ(resolver->callCount("10.0.0.1"), 1);
+    ASSERT_EQ(resolver->callCount("10.0.0.2"), 1);
+
+    ASSERT_EQ(cache.hostName("10.0.0.1"), "host-10.0.0.1");
+    ASSERT_EQ(cache.pendingCount(), 0);
+}
+
+TEST_F(HostInfoTest, concurrencyLimit)
+{
+    auto resolver = QSharedPointer<FakeHostResolver>::create(/*latencyMsec=*/50);
+
+    TestHostInfoCache cache;
+    cache.setResolver(resolver);
+    cache.setLookupConcurrency(2);
+    cache.setUp();
+
+    for (int i = 0; i < 10; ++i) {
+        cache.hostName(QString("10.0.1.%1").arg(i));
+    }
+
+    ASSERT_TRUE(cache.waitLookups());
+
+    ASSERT_GE(resolver->maxRunningCount(), 1);
+    ASSERT_LE(resolver->maxRunningCount(), 2);
+}
+
+TEST_F(HostInfoTest, ttlExpiry)
+{
+    auto resolver = QSharedPointer<FakeHostResolver>::create();
+    resolver->setFailed("10.0.0.2");
+
+    TestHostInfoCache cache;
+    cache.setResolver(resolver);
+    cache.setPositiveTtlSecs(100);
+    cache.setNegativeTtlSecs(10);
+    cache.setUp();
+
+    cache.hostName("10.0.0.1");
+    cache.hostName("10.0.0.2");
+    ASSERT_TRUE(cache.waitLookups());
+
+    // Cached
+    ASSERT_EQ(cache.hostName("10.0.0.1"), "host-10.0.0.1");
+    ASSERT_EQ(cache.hostName("10.0.0.2"), QString());
+    ASSERT_EQ(cache.pendingCount(), 0);
+
+    // The negative entry is expired
+    cache.addSecs(10);
+
+    ASSERT_EQ(cache.hostName("10.0.0.1"), "host-10.0.0.1");
+    ASSERT_EQ(cache.hostName("10.0.0.2"), QString());
+    ASSERT_EQ(cache.pendingCount(), 1);
+    ASSERT_TRUE(cache.waitLookups());
+
+    ASSERT_EQ(resolver->callCount("10.0.0.1"), 1);
+    ASSERT_EQ(resolver->callCount("10.0.0.2"), 2);
+
+    // The positive entry is expired: the stale name is used till the lookup is finished
+    cache.addSecs(100);
+
+    ASSERT_EQ(cache.hostName("10.0.0.1"), "host-10.0.0.1");
+    ASSERT_TRUE(cache.waitLookups());
+
+    ASSERT_EQ(resolver->callCount("10.0.0.1"), 2);
+}
+
+TEST_F(HostInfoTest, backendTtl)
+{
+    auto resolver = QSharedPointer<FakeHostResolver>::create(/*latencyMsec=*/0, /*ttlSecs=*/5);
+
+    TestHostInfoCache cache;
+    cache.setResolver(resolver);
+    cache.setUp();
+
+    cache.hostName("10.0.0.1");
+    ASSERT_TRUE(cache.waitLookups());
+
+    cache.addSecs(4);
+    cache.hostName("10.0.0.1");
+    ASSERT_EQ(cache.pendingCount(), 0);
+
+    cache.addSecs(1);
+    cache.hostName("10.0.0.1");
+    ASSERT_EQ(cache.pendingCount(), 1);
+    ASSERT_TRUE(cache.waitLookups());
+
+    ASSERT_EQ(resolver->callCount("10.0.0.1"), 2);
+}
+
+TEST_F(HostInfoTest, restartSurvival)
+{
+    const QString filePath = m_tempDir.filePath("hostinfo.db");
+
+    {
+        auto resolver = QSharedPointer<FakeHostResolver>::create();
+        resolver->setFailed("10.0.0.2");
+
+        TestHostInfoCache cache(filePath);
+        cache.setResolver(resolver);
+        cache.setPositiveTtlSecs(100);
+        cache.setNegativeTtlSecs(10);
+        cache.setUp();
+
+        cache.hostName("10.0.0.1");
+        cache.hostName("10.0.0.2");
+        ASSERT_TRUE(cache.waitLookups());
+    }
+
+    // Restart with a failing backend
+    auto resolver = QSharedPointer<FakeHostResolver>::create();
+    resolver->setFailed("10.0.0.1");
+    resolver->setFailed("10.0.0.2");
+
+    {
+        TestHostInfoCache cache(filePath);
+        cache.setResolver(resolver);
+        cache.setUp();
+
+        ASSERT_EQ(cache.hostName("10.0.0.1"), "host-10.0.0.1");
+        ASSERT_EQ(cache.hostName("10.0.0.2"), QString());
+        ASSERT_EQ(cache.pendingCount(), 0);
+
+        ASSERT_EQ(resolver->callCount("10.0.0.1"), 0);
+        ASSERT_EQ(resolver->callCount("10.0.0.2"), 0);
+    }
+
+    // Restart after the expiration: the expired entries are purged
+    {
+        TestHostInfoCache cache(filePath);
+        cache.setResolver(resolver);
+        cache.setUnixTime(1700000000 + 100);
+        cache.setUp();
+
+        ASSERT_EQ(cache.hostName("10.0.0.1"), QString());
+        ASSERT_EQ(cache.pendingCount(), 1);
+        ASSERT_TRUE(cache.waitLookups());
+
+        ASSERT_EQ(resolver->callCount("10.0.0.1"), 1);
+    }
+}
+
+TEST_F(HostInfoTest, batchedSave)
+{
+    auto resolver = QSharedPointer<FakeHostResolver>::create();
+
+    TestHostInfoCache cache;
+    cache.setResolver(resolver);
+    cache.setUp();
+
+    const auto savedCount = [&] {
+        return DbQuery(cache.sqliteDb()).sql("SELECT count(*) FROM host;").execute().toInt();
+    };
+
+    for (int i = 0; i < 10; ++i) {
+        cache.hostName(QString("10.0.2.%1").arg(i));
+    }
+    ASSERT_TRUE(cache.waitLookups());
+
+    // Not saved yet, but found
+    ASSERT_EQ(savedCount(), 0);
+    ASSERT_EQ(cache.hostName("10.0.2.1"), "host-10.0.2.1");
+
+    // Saved together
+    ASSERT_TRUE(QTest::qWaitFor([&] { return savedCount() == 10; }, 5000));
+
+    ASSERT_EQ(cache.hostName("10.0.2.1"), "host-10.0.2.1");
+    ASSERT_EQ(resolver->callCount("10.0.2.1"), 1);
+}
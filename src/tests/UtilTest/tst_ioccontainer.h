@@ -1,6 +1,11 @@
 #pragma once
 
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QSignalSpy>
+#include <QThread>
+#include <QThreadPool>
+#include <QTimer>
 
 #include <googletest.h>
 
@@ -47,6 +52,64 @@ public:
     }
 };
 
+class TimerService : public QTimer, public IocService
+{
+public:
+};
+
+struct SetUpLog
+{
+    void begin()
+    {
+        QMutexLocker locker(&mutex);
+        maxRunningCount = qMax(maxRunningCount, ++runningCount);
+    }
+
+    void end(int id, QThread *thread, bool isPinned)
+    {
+        QMutexLocker locker(&mutex);
+        --runningCount;
+        finishedIds.append(id);
+        threads.insert(id, thread);
+        if (!isPinned) {
+            unpinnedIds.append(id);
+        }
+    }
+
+    int runningCount = 0;
+    int maxRunningCount = 0;
+
+    QVector<int> finishedIds;
+    QVector<int> unpinnedIds;
+    QHash<int, QThread *> threads;
+
+    QMutex mutex;
+};
+
+template<int N>
+class S : public IocService
+{
+public:
+    explicit S(SetUpLog &log, int sleepMsecs = 0) : m_log(log), m_sleepMsecs(sleepMsecs) { }
+
+    void setUp() override
+    {
+        m_log.begin();
+
+        if (m_sleepMsecs > 0) {
+            QThread::msleep(m_sleepMsecs);
+        }
+
+        m_log.end(N, QThread::currentThread(), IoCPinned() != nullptr);
+    }
+
+private:
+    SetUpLog &m_log;
+    const int m_sleepMsecs;
+};
+
+constexpr quint8 parallelFlags = IocContainer::IsService | IocContainer::ParallelSetUp;
+
 }
 
 class IocContainerTest : public Test
@@ -133,3 +196,147 @@ TEST_F(IocContainerTest, mockSetUp)
     container.remove<IocTest::A>();
     ASSERT_EQ(container.size(), containerSize);
 }
+
+TEST_F(IocContainerTest, dependencyOrder)
+{
+    IocContainer container;
+    ASSERT_TRUE(container.pinToThread());
+
+    IocTest::SetUpLog log;
+
+    IocTest::S<1> s1(log, 20);
+    IocTest::S<2> s2(log, 20);
+    IocTest::S<3> s3(log);
+    IocTest::S<4> s4(log);
+
+    container.setService(&s1, IocTest::parallelFlags);
+    container.setService(&s2, IocTest::parallelFlags);
+    container.setService(s3);
+    container.setService(&s4, IocTest::parallelFlags);
+
+    container.setDependencies<IocTest::S<1>, IocTest::S<2>, IocTest::S<3>>();
+    container.setDependencies<IocTest::S<3>, IocTest::S<2>>();
+    container.setDependencies<IocTest::S<4>, IocTest::S<1>>();
+
+    ASSERT_TRUE(container.cyclicTypeIds().isEmpty());
+    ASSERT_TRUE(container.setUpAll());
+
+    ASSERT_EQ(log.finishedIds, QVector<int>({ 2, 3, 1, 4 }));
+    ASSERT_TRUE(log.unpinnedIds.isEmpty());
+
+    // Thread-affine services are set up in the current thread
+    ASSERT_EQ(log.threads.value(3), QThread::currentThread());
+    ASSERT_NE(log.threads.value(1), QThread::currentThread());
+
+    ASSERT_EQ(container.setUpTimes().size(), 4);
+
+    // Set up once
+    ASSERT_TRUE(container.setUpAll());
+    ASSERT_EQ(log.finishedIds.size(), 4);
+}
+
+TEST_F(IocContainerTest, cyclicDependencies)
+{
+    IocContainer container;
+
+    IocTest::SetUpLog log;
+
+    IocTest::S<1> s1(log);
+    IocTest::S<2> s2(log);
+    IocTest::S<3> s3(log);
+    IocTest::S<4> s4(log);
+
+    container.setService(&s1, IocTest::parallelFlags);
+    container.setService(s2);
+    container.setService(s3);
+    container.setService(s4);
+
+    container.setDependencies<IocTest::S<1>, IocTest::S<2>>();
+    container.setDependencies<IocTest::S<2>, IocTest::S<1>>();
+    container.setDependencies<IocTest::S<3>, IocTest::S<2>>();
+
+    const QVector<int> cyclicIds = container.cyclicTypeIds();
+    ASSERT_EQ(cyclicIds.size(), 3);
+    ASSERT_TRUE(cyclicIds.contains(IocContainer::getTypeId<IocTest::S<1>>()));
+    ASSERT_TRUE(cyclicIds.contains(IocContainer::getTypeId<IocTest::S<3>>()));
+    ASSERT_FALSE(cyclicIds.contains(IocContainer::getTypeId<IocTest::S<4>>()));
+
+    // Set up sequentially
+    ASSERT_FALSE(container.setUpAll());
+    ASSERT_EQ(log.finishedIds.size(), 4);
+    ASSERT_EQ(log.maxRunningCount, 1);
+
+    // Self-dependency
+    IocContainer selfContainer;
+    selfContainer.setService(s1);
+    selfContainer.setDependencies<IocTest::S<1>, IocTest::S<1>>();
+
+    ASSERT_EQ(selfContainer.cyclicTypeIds().size(), 1);
+}
+
+TEST_F(IocContainerTest, parallelSpeedup)
+{
+    constexpr int sleepMsecs = 200;
+
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const int maxThreadCount = threadPool->maxThreadCount();
+    threadPool->setMaxThreadCount(qMax(maxThreadCount, 4));
+
+    IocContainer container;
+
+    IocTest::SetUpLog log;
+
+    IocTest::S<1> s1(log, sleepMsecs);
+    IocTest::S<2> s2(log, sleepMsecs);
+    IocTest::S<3> s3(log, sleepMsecs);
+    IocTest::S<4> s4(log, sleepMsecs);
+
+    container.setService(&s1, IocTest::parallelFlags);
+    container.setService(&s2, IocTest::parallelFlags);
+    container.setService(&s3, IocTest::parallelFlags);
+    container.setService(&s4, IocTest::parallelFlags);
+
+    QElapsedTimer timer;
+    timer.start();
+
+    ASSERT_TRUE(container.setUpAll());
+
+    const qint64 elapsedMsecs = timer.elapsed();
+
+    threadPool->setMaxThreadCount(maxThreadCount);
+
+    ASSERT_EQ(log.finishedIds.size(), 4);
+    ASSERT_GT(log.maxRunningCount, 1);
+    ASSERT_LT(elapsedMsecs, 3 * sleepMsecs);
+
+    const QVector<IocSetUpTime> setupTimes = container.setUpTimes();
+    ASSERT_EQ(setupTimes.size(), 4);
+
+    for (const IocSetUpTime &t : setupTimes) {
+        ASSERT_TRUE(t.isParallel);
+        ASSERT_GE(t.msecs, sleepMsecs - 20);
+    }
+
+    ASSERT_TRUE(container.setUpReport().contains("parallel"));
+}
+
+TEST_F(IocContainerTest, setUpReport)
+{
+    IocContainer container;
+
+    IocTest::A a;
+    IocTest::TimerService timer;
+
+    container.setService(a);
+    container.setService(timer);
+
+    ASSERT_TRUE(container.setUpAll());
+
+    const QString report = container.setUpReport();
+    ASSERT_EQ(report.count('\n'), 1);
+
+    // The QObject services are named by their meta-objects
+    ASSERT_TRUE(report.contains("QTimer: start="));
+    ASSERT_TRUE(report.contains(
+            QString("#%1: start=").arg(IocContainer::getTypeId<IocTest::A>())));
+}
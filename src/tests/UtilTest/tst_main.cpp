@@ -1,21 +1,41 @@
+#include "tst_appiconatlas.h"
+#include "tst_appinfo.h"
+#include "tst_apppurger.h"
+#include "tst_askpendingqueue.h"
 #include "tst_bitutil.h"
+#include "tst_confjournal.h"
 #include "tst_confutil.h"
 #include "tst_fileutil.h"
+#include "tst_flowtab.h"
+#include "tst_hostinfo.h"
 #include "tst_ioccontainer.h"
+#include "tst_metrics.h"
 #include "tst_netutil.h"
+#include "tst_portrange.h"
+#include "tst_provdiff.h"
+#include "tst_psenum.h"
+#include "tst_psmap.h"
+#include "tst_ruleexpr.h"
+#include "tst_rulesetgraph.h"
 #include "tst_stringutil.h"
+#include "tst_svctab.h"
+#include "tst_tracering.h"
 
-#include <QCoreApplication>
+#include <QGuiApplication>
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <fortmanager.h>
+
 int main(int argc, char *argv[])
 {
     ::testing::InitGoogleTest(&argc, argv);
     ::testing::InitGoogleMock(&argc, argv);
 
-    QCoreApplication app(argc, argv);
+    QGuiApplication app(argc, argv);
+
+    FortManager::setupResources();
 
     return RUN_ALL_TESTS();
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/fortmetrics.h>
+
+class MetricsTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+protected:
+    FORT_METRICS m_metrics;
+    QVector<FORT_METRICS_SLOT> m_slots;
+};
+
+void MetricsTest::SetUp()
+{
+    m_slots.resize(4);
+
+    // 1 tick = 100 ns
+    fort_metrics_init(&m_metrics, m_slots.data(), m_slots.size(), 10 * 1000 * 1000);
+}
+
+void MetricsTest::TearDown()
+{
+    m_slots.clear();
+}
+
+TEST_F(MetricsTest, histBucket)
+{
+    ASSERT_EQ(fort_metrics_hist_bucket(0), 0);
+    ASSERT_EQ(fort_metrics_hist_bucket(1), 0);
+    ASSERT_EQ(fort_metrics_hist_bucket(2), 1);
+    ASSERT_EQ(fort_metrics_hist_bucket(3), 1);
+    ASSERT_EQ(fort_metrics_hist_bucket(1023), 9);
+    ASSERT_EQ(fort_metrics_hist_bucket(1024), 10);
+    ASSERT_EQ(fort_metrics_hist_bucket(0xFFFFFFFFFFULL), FORT_METRICS_HIST_BUCKETS - 1);
+
+    ASSERT_EQ(fort_metrics_hist_bucket_max(0), 1u);
+    ASSERT_EQ(fort_metrics_hist_bucket_max(9), 1023u);
+
+    // Bucket's upper bound stays in the bucket
+    for (UINT16 i = 0; i < FORT_METRICS_HIST_BUCKETS - 1; ++i) {
+        ASSERT_EQ(fort_metrics_hist_bucket(fort_metrics_hist_bucket_max(i)), i);
+    }
+}
+
+TEST_F(MetricsTest, histPercentile)
+{
+    FORT_METRICS_HIST hist {};
+
+    ASSERT_EQ(fort_metrics_hist_percentile(&hist, 50), 0u);
+
+    // 90 fast and 10 slow samples
+    for (int i = 0; i < 90; ++i) {
+        fort_metrics_hist_add(&hist, 100); // bucket 6
+    }
+    for (int i = 0; i < 10; ++i) {
+        fort_metrics_hist_add(&hist, 5000); // bucket 12
+    }
+
+    ASSERT_EQ(fort_metrics_hist_count(&hist), 100u);
+    ASSERT_EQ(hist.sum_ns, 90u * 100 + 10u * 5000);
+
+    ASSERT_EQ(fort_metrics_hist_percentile(&hist, 50), fort_metrics_hist_bucket_max(6));
+    ASSERT_EQ(fort_metrics_hist_percentile(&hist, 90), fort_metrics_hist_bucket_max(6));
+    ASSERT_EQ(fort_metrics_hist_percentile(&hist, 91), fort_metrics_hist_bucket_max(12));
+    ASSERT_EQ(fort_metrics_hist_percentile(&hist, 99), fort_metrics_hist_bucket_max(12));
+}
+
+TEST_F(MetricsTest, ticksToNs)
+{
+    ASSERT_EQ(fort_metrics_ticks_to_ns(&m_metrics, 0), 0u);
+    ASSERT_EQ(fort_metrics_ticks_to_ns(&m_metrics, -1), 0u);
+    ASSERT_EQ(fort_metrics_ticks_to_ns(&m_metrics, 1), 100u);
+    ASSERT_EQ(fort_metrics_ticks_to_ns(&m_metrics, 15 * 1000 * 1000), 1500000000u);
+
+    // No overflow for a long uptime
+    const INT64 dayTicks = 24LL * 3600 * 10 * 1000 * 1000;
+    ASSERT_EQ(fort_metrics_ticks_to_ns(&m_metrics, dayTicks), 24ULL * 3600 * 1000000000ULL);
+}
+
+TEST_F(MetricsTest, snapshot)
+{
+    for (UINT32 slot = 0; slot < 8; ++slot) {
+        fort_metrics_inc(&m_metrics, slot, FORT_METRICS_CLASSIFY);
+        fort_metrics_latency_add(&m_metrics, slot, FORT_METRICS_HIST_ALE_CLASSIFY, 10); // 1 us
+    }
+    fort_metrics_inc(&m_metrics, 1, FORT_METRICS_BLOCK);
+
+    FORT_DRIVER_METRICS out;
+    fort_metrics_snapshot(&m_metrics, &out);
+
+    ASSERT_EQ(out.version, FORT_METRICS_VERSION);
+    ASSERT_EQ(out.size, sizeof(FORT_DRIVER_METRICS));
+    ASSERT_EQ(out.slots_n, m_slots.size());
+
+    ASSERT_EQ(out.counters[FORT_METRICS_CLASSIFY], 8u);
+    ASSERT_EQ(out.counters[FORT_METRICS_BLOCK], 1u);
+    ASSERT_EQ(out.counters[FORT_METRICS_PERMIT], 0u);
+
+    const PFORT_METRICS_HIST hist = &out.hists[FORT_METRICS_HIST_ALE_CLASSIFY];
+    ASSERT_EQ(fort_metrics_hist_count(hist), 8u);
+    ASSERT_EQ(hist->sum_ns, 8u * 1000);
+    ASSERT_EQ(hist->buckets[fort_metrics_hist_bucket(1000)], 8u);
+
+    ASSERT_EQ(fort_metrics_hist_count(&out.hists[FORT_METRICS_HIST_FLOW_CLASSIFY]), 0u);
+}
+
+TEST_F(MetricsTest, noSlots)
+{
+    fort_metrics_init(&m_metrics, nullptr, 4, 1000);
+
+    fort_metrics_inc(&m_metrics, 0, FORT_METRICS_CLASSIFY);
+    fort_metrics_latency_add(&m_metrics, 0, FORT_METRICS_HIST_ALE_CLASSIFY, 1);
+
+    FORT_DRIVER_METRICS out;
+    fort_metrics_snapshot(&m_metrics, &out);
+
+    ASSERT_EQ(out.slots_n, 0);
+    ASSERT_EQ(out.counters[FORT_METRICS_CLASSIFY], 0u);
+}
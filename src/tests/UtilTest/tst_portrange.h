@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QBitArray>
+#include <QRandomGenerator>
+
+#include <googletest.h>
+
+#include <common/fortconf.h>
+
+#include <util/conf/confutil.h>
+#include <util/net/portrange.h>
+
+class PortRangeTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void checkEncoding(const PortRange &portRange, const QBitArray &ports, int portEncoding);
+};
+
+void PortRangeTest::SetUp() { }
+
+void PortRangeTest::TearDown() { }
+
+void PortRangeTest::checkEncoding(
+        const PortRange &portRange, const QBitArray &ports, int portEncoding)
+{
+    ConfUtil confUtil;
+    ASSERT_EQ(confUtil.writePorts(portRange, portEncoding), portEncoding);
+
+    const char *portData = confUtil.data();
+
+    for (int port = 0; port < 65536; ++port) {
+        ASSERT_EQ(bool(fort_conf_port_included(quint16(port), portData, portEncoding)),
+                ports.testBit(port))
+                << "encoding=" << portEncoding << " port=" << port;
+    }
+}
+
+TEST_F(PortRangeTest, parse)
+{
+    PortRange portRange;
+
+    ASSERT_FALSE(portRange.fromText("80-70"));
+    ASSERT_FALSE(portRange.fromText("65536"));
+    ASSERT_FALSE(portRange.fromText("80-"));
+    ASSERT_EQ(portRange.errorLineNo(), 1);
+
+    ASSERT_TRUE(portRange.fromText("80\n443\n8080-8090\n8085-8100\n443"));
+    ASSERT_EQ(portRange.toText(), QString("80\n443\n8080-8100\n"));
+
+    // Single ports inside of the ranges are merged
+    ASSERT_TRUE(portRange.fromText("10-20\n15\n21"));
+    ASSERT_EQ(portRange.toText(), QString("10-21\n"));
+}
+
+TEST_F(PortRangeTest, selectEncoding)
+{
+    PortRange portRange;
+    ConfUtil confUtil;
+
+    // Sparse ports
+    ASSERT_TRUE(portRange.fromText("53\n80\n443\n1024-2047"));
+    ASSERT_EQ(confUtil.writePorts(portRange), FORT_CONF_PORT_ENCODING_LIST);
+
+    // Block aligned ranges
+    QString text;
+    for (int i = 0; i < 300; ++i) {
+        text += QString("%1\n").arg(i * 2);
+    }
+    ASSERT_TRUE(portRange.fromText(text + "1024-65535"));
+    ASSERT_GT(portRange.portSize(), 255);
+    ASSERT_EQ(confUtil.writePorts(portRange), FORT_CONF_PORT_ENCODING_BLOCKS);
+    ASSERT_EQ(confUtil.buffer().size(), int(FORT_CONF_PORT_BLOCKS_SIZE(3)));
+
+    // Dense ports in all blocks
+    text.clear();
+    for (int i = 0; i < 65536; i += 7) {
+        text += QString("%1\n").arg(i);
+    }
+    ASSERT_TRUE(portRange.fromText(text));
+    ASSERT_EQ(confUtil.writePorts(portRange), FORT_CONF_PORT_ENCODING_BITMAP);
+    ASSERT_EQ(confUtil.buffer().size(), FORT_CONF_PORT_BITMAP_SIZE);
+
+    // The list can't hold more than 255 ports
+    ASSERT_EQ(confUtil.writePorts(portRange, FORT_CONF_PORT_ENCODING_LIST), -1);
+}
+
+TEST_F(PortRangeTest, encodingsEquivalence)
+{
+    QRandomGenerator rand(0x506F7274);
+
+    for (int trial = 0; trial < 50; ++trial) {
+        QBitArray ports(65536);
+        QString text;
+
+        const int portsCount = rand.bounded(1, 200);
+        for (int i = 0; i < portsCount; ++i) {
+            const int port = rand.bounded(65536);
+
+            ports.setBit(port);
+            text += QString("%1\n").arg(port);
+        }
+
+        const int rangesCount = rand.bounded(0, 30);
+        for (int i = 0; i < rangesCount; ++i) {
+            const int from = rand.bounded(65536);
+            const int to = qMin(from + rand.bounded(1, 2000), 65535);
+
+            ports.fill(true, from, to + 1);
+            text += QString("%1-%2\n").arg(QString::number(from), QString::number(to));
+        }
+
+        PortRange portRange;
+        ASSERT_TRUE(portRange.fromText(text));
+
+        checkEncoding(portRange, ports, FORT_CONF_PORT_ENCODING_LIST);
+        checkEncoding(portRange, ports, FORT_CONF_PORT_ENCODING_BITMAP);
+        checkEncoding(portRange, ports, FORT_CONF_PORT_ENCODING_BLOCKS);
+    }
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <googletest.h>
+
+#include <common/fortprov.h>
+
+class ProvDiffTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static FORT_PROV_BOOT_CONF bootConf(bool bootFilter, bool filterLocals);
+
+    static FORT_PROV_STATE state(const FORT_PROV_BOOT_CONF bootConf);
+
+    static FORT_PROV_DIFF diff(const FORT_PROV_BOOT_CONF oldConf, const FORT_PROV_BOOT_CONF newConf);
+};
+
+void ProvDiffTest::SetUp() { }
+
+void ProvDiffTest::TearDown() { }
+
+FORT_PROV_BOOT_CONF ProvDiffTest::bootConf(bool bootFilter, bool filterLocals)
+{
+    FORT_PROV_BOOT_CONF conf;
+    conf.v = 0;
+    conf.boot_filter = bootFilter;
+    conf.filter_locals = filterLocals;
+    return conf;
+}
+
+FORT_PROV_STATE ProvDiffTest::state(const FORT_PROV_BOOT_CONF bootConf)
+{
+    FORT_PROV_STATE state;
+    fort_prov_state_build(bootConf, &state);
+    return state;
+}
+
+FORT_PROV_DIFF ProvDiffTest::diff(
+        const FORT_PROV_BOOT_CONF oldConf, const FORT_PROV_BOOT_CONF newConf)
+{
+    FORT_PROV_STATE oldState = state(oldConf);
+    FORT_PROV_STATE newState = state(newConf);
+
+    FORT_PROV_DIFF diff;
+    fort_prov_state_diff(&oldState, &newState, &diff);
+    return diff;
+}
+
+namespace {
+
+constexpr quint32 bootOnlyItems =
+        FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_BOOT_FILTERS, 4)
+        | FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_PERSIST_FILTERS, 4);
+
+constexpr quint32 calloutItems = FORT_PROV_ITEMS_MASK(FORT_PROV_ITEM_CALLOUTS, 12);
+
+constexpr quint32 allItems = FORT_PROV_ITEMS_MASK(0, FORT_PROV_ITEM_COUNT);
+
+}
+
+TEST_F(ProvDiffTest, stateBuild)
+{
+    const FORT_PROV_STATE plain = state(bootConf(false, false));
+    ASSERT_EQ(plain.items, allItems & ~bootOnlyItems);
+    ASSERT_EQ(plain.boot_items, 0u);
+
+    const FORT_PROV_STATE boot = state(bootConf(true, true));
+    ASSERT_EQ(boot.items, allItems);
+    ASSERT_NE(boot.boot_items & FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER), 0u);
+    ASSERT_NE(boot.boot_items & FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER), 0u);
+    ASSERT_EQ(boot.boot_items & calloutItems, 0u);
+    ASSERT_NE(boot.provider_data, plain.provider_data);
+}
+
+TEST_F(ProvDiffTest, itemDeps)
+{
+    // Dependencies go first
+    for (int item = 0; item < FORT_PROV_ITEM_COUNT; ++item) {
+        const quint32 deps = fort_prov_item_deps(item);
+        ASSERT_EQ(deps & ~FORT_PROV_ITEMS_MASK(0, item), 0u);
+    }
+
+    ASSERT_EQ(fort_prov_item_deps(FORT_PROV_ITEM_CALLOUT_FILTERS + 2),
+            FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_SUBLAYER)
+                    | FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_CALLOUTS + 2));
+}
+
+TEST_F(ProvDiffTest, allTransitions)
+{
+    for (int o = 0; o < 4; ++o) {
+        for (int n = 0; n < 4; ++n) {
+            const FORT_PROV_BOOT_CONF oldConf = bootConf(o & 1, o & 2);
+            const FORT_PROV_BOOT_CONF newConf = bootConf(n & 1, n & 2);
+
+            const FORT_PROV_STATE oldState = state(oldConf);
+            const FORT_PROV_STATE newState = state(newConf);
+
+            FORT_PROV_DIFF d = diff(oldConf, newConf);
+
+            SCOPED_TRACE(std::to_string(o) + " -> " + std::to_string(n));
+
+            // Only the installed items are removed, only the desired items are added
+            ASSERT_EQ(d.remove_items & ~oldState.items, 0u);
+            ASSERT_EQ(d.add_items & ~newState.items, 0u);
+
+            // The diff turns the old state into the new one
+            ASSERT_EQ((oldState.items & ~d.remove_items) | d.add_items, newState.items);
+
+            // No changes for the same conf
+            if (o == n) {
+                ASSERT_EQ(d.remove_items, 0u);
+                ASSERT_EQ(d.add_items, 0u);
+                continue;
+            }
+
+            // Kept items must not depend on re-created ones
+            const quint32 keptItems = oldState.items & ~d.remove_items;
+            for (int item = 0; item < FORT_PROV_ITEM_COUNT; ++item) {
+                if ((keptItems & FORT_PROV_ITEM_BIT(item)) != 0) {
+                    ASSERT_EQ(fort_prov_item_deps(item) & d.remove_items, 0u);
+                }
+            }
+
+            // Kept items have the desired variant
+            ASSERT_EQ(keptItems & (oldState.boot_items ^ newState.boot_items), 0u);
+
+            // The provider keeps the boot conf
+            ASSERT_NE(d.add_items & FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER), 0u);
+
+            // Callouts are never re-created
+            ASSERT_EQ(d.remove_items & calloutItems, 0u);
+
+            const bool bootChanged = (o & 1) != (n & 1);
+            ASSERT_EQ(bool(fort_prov_diff_flows_removed(&d)), bootChanged);
+
+            if (!bootChanged) {
+                // Only the provider's data is changed
+                ASSERT_EQ(d.remove_items, FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER));
+                ASSERT_EQ(d.add_items, FORT_PROV_ITEM_BIT(FORT_PROV_ITEM_PROVIDER));
+            }
+        }
+    }
+}
+
+TEST_F(ProvDiffTest, registerAll)
+{
+    FORT_PROV_STATE emptyState = { 0 };
+    FORT_PROV_STATE bootState = state(bootConf(true, false));
+
+    FORT_PROV_DIFF d;
+    fort_prov_state_diff(&emptyState, &bootState, &d);
+
+    ASSERT_EQ(d.remove_items, 0u);
+    ASSERT_EQ(d.add_items, allItems);
+    ASSERT_EQ(d.boot_items, bootState.boot_items);
+    ASSERT_FALSE(fort_prov_diff_flows_removed(&d));
+}
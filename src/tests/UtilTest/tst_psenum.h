@@ -0,0 +1,187 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/fortpsenum.h>
+
+class PsEnumTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    // Synthetic SYSTEM_PROCESS_INFORMATION buffer
+    QByteArray processesBuffer(const QVector<quint32> &pids, int threadsInfoSize = 0);
+
+    QVector<quint32> enumBatches(FORT_PSENUM &psenum, quint16 batchSize);
+};
+
+void PsEnumTest::SetUp() { }
+
+void PsEnumTest::TearDown() { }
+
+QByteArray PsEnumTest::processesBuffer(const QVector<quint32> &pids, int threadsInfoSize)
+{
+    const int entrySize = int(sizeof(FORT_SYSTEM_PROCESS)) + threadsInfoSize;
+
+    QByteArray buffer(entrySize * pids.size(), '\0');
+
+    for (int i = 0; i < pids.size(); ++i) {
+        auto process = reinterpret_cast<PFORT_SYSTEM_PROCESS>(buffer.data() + i * entrySize);
+
+        const bool isLast = (i == pids.size() - 1);
+
+        process->NextEntryOffset = isLast ? 0 : entrySize;
+        process->ProcessId = pids[i];
+        process->ParentProcessId = pids[i] + 1;
+    }
+
+    return buffer;
+}
+
+QVector<quint32> PsEnumTest::enumBatches(FORT_PSENUM &psenum, quint16 batchSize)
+{
+    QVector<quint32> pids;
+    QVector<FORT_PSENUM_ENTRY> entries(batchSize);
+
+    while (!fort_psenum_is_done(&psenum)) {
+        const quint16 count = fort_psenum_next_batch(&psenum, entries.data(), batchSize);
+
+        for (int i = 0; i < count; ++i) {
+            const FORT_PSENUM_ENTRY &entry = entries[i];
+
+            EXPECT_EQ(entry.parent_process_id, entry.process_id + 1);
+
+            pids.append(entry.process_id);
+        }
+    }
+
+    return pids;
+}
+
+TEST_F(PsEnumTest, batches)
+{
+    const QVector<quint32> pids = { 8, 12, 16, 20, 24, 28, 32, 36 };
+
+    QByteArray buffer = processesBuffer(pids, /*threadsInfoSize=*/80);
+
+    FORT_PSENUM psenum;
+    fort_psenum_init(&psenum, buffer.data(), buffer.size());
+
+    ASSERT_FALSE(fort_psenum_is_done(&psenum));
+
+    ASSERT_EQ(enumBatches(psenum, 3), pids);
+
+    ASSERT_TRUE(fort_psenum_is_done(&psenum));
+    ASSERT_EQ(psenum.batches_n, 3u);
+    ASSERT_EQ(psenum.procs_n, quint32(pids.size()));
+}
+
+TEST_F(PsEnumTest, pending)
+{
+    const QVector<quint32> pids = { 20, 8, 24, 12, 16 };
+
+    QByteArray buffer = processesBuffer(pids);
+
+    FORT_PSENUM psenum;
+    fort_psenum_init(&psenum, buffer.data(), buffer.size());
+
+    FORT_PSENUM_ENTRY entries[2];
+    FORT_PSENUM_ENTRY entry;
+
+    // Not indexed
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 8, &entry));
+
+    ASSERT_EQ(fort_psenum_count(&psenum), quint32(pids.size()));
+
+    QVector<FORT_PSENUM_PID> pidsIndex(pids.size());
+    fort_psenum_index(&psenum, pidsIndex.data(), pidsIndex.size());
+    ASSERT_EQ(psenum.pids_n, quint32(pids.size()));
+
+    for (int i = 1; i < pidsIndex.size(); ++i) {
+        ASSERT_LT(pidsIndex[i - 1].process_id, pidsIndex[i].process_id);
+    }
+
+    for (const quint32 pid : pids) {
+        ASSERT_TRUE(fort_psenum_find_pending(&psenum, pid, &entry));
+        ASSERT_EQ(entry.process_id, pid);
+        ASSERT_EQ(entry.parent_process_id, pid + 1);
+    }
+
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 4, &entry));
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 10, &entry));
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 28, &entry));
+
+    ASSERT_EQ(fort_psenum_next_batch(&psenum, entries, 2), 2);
+
+    // The enumerated processes are not pending anymore
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 20, &entry));
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 8, &entry));
+    ASSERT_TRUE(fort_psenum_find_pending(&psenum, 12, &entry));
+    ASSERT_EQ(entry.process_id, 12u);
+
+    ASSERT_EQ(fort_psenum_next_batch(&psenum, entries, 2), 2);
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 12, &entry));
+    ASSERT_TRUE(fort_psenum_find_pending(&psenum, 16, &entry));
+
+    ASSERT_EQ(fort_psenum_next_batch(&psenum, entries, 2), 1);
+    ASSERT_TRUE(fort_psenum_is_done(&psenum));
+
+    ASSERT_FALSE(fort_psenum_find_pending(&psenum, 16, &entry));
+}
+
+TEST_F(PsEnumTest, pendingMany)
+{
+    // Descending process ids
+    QVector<quint32> pids;
+    for (quint32 pid = 4000; pid > 0; pid -= 4) {
+        pids.append(pid);
+    }
+
+    QByteArray buffer = processesBuffer(pids);
+
+    FORT_PSENUM psenum;
+    fort_psenum_init(&psenum, buffer.data(), buffer.size());
+
+    QVector<FORT_PSENUM_PID> pidsIndex(fort_psenum_count(&psenum));
+    fort_psenum_index(&psenum, pidsIndex.data(), pidsIndex.size());
+
+    FORT_PSENUM_ENTRY entry;
+
+    for (const quint32 pid : pids) {
+        ASSERT_TRUE(fort_psenum_find_pending(&psenum, pid, &entry));
+        ASSERT_EQ(entry.process_id, pid);
+
+        ASSERT_FALSE(fort_psenum_find_pending(&psenum, pid + 1, &entry));
+    }
+}
+
+TEST_F(PsEnumTest, badBuffer)
+{
+    FORT_PSENUM psenum;
+    FORT_PSENUM_ENTRY entries[4];
+
+    // Empty
+    fort_psenum_init(&psenum, nullptr, 0);
+    ASSERT_TRUE(fort_psenum_is_done(&psenum));
+    ASSERT_EQ(fort_psenum_next_batch(&psenum, entries, 4), 0);
+
+    // Next entry is out of the buffer
+    QByteArray buffer = processesBuffer({ 8, 12 });
+    reinterpret_cast<PFORT_SYSTEM_PROCESS>(buffer.data())->NextEntryOffset = buffer.size() * 2;
+
+    fort_psenum_init(&psenum, buffer.data(), buffer.size());
+    ASSERT_EQ(fort_psenum_next_batch(&psenum, entries, 4), 1);
+    ASSERT_TRUE(fort_psenum_is_done(&psenum));
+
+    // Truncated last entry
+    buffer = processesBuffer({ 8, 12 });
+    buffer.chop(8);
+
+    fort_psenum_init(&psenum, buffer.data(), buffer.size());
+    ASSERT_EQ(enumBatches(psenum, 4), QVector<quint32>({ 8 }));
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <QAtomicInteger>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/fortpsmap.h>
+
+namespace PsMap {
+
+constexpr quint32 valueMagic = 0x5A5A0000;
+constexpr quint32 valuePoison = 0xDEADBEEF;
+
+struct Node
+{
+    FORT_PSMAP_NODE mapNode; // must be first
+
+    QAtomicInteger<quint32> value;
+};
+
+inline quint32 pidValue(quint32 pid)
+{
+    return pid ^ valueMagic;
+}
+
+}
+
+class PsMapTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void init(int bucketsCount, int nodesCount);
+
+    PsMap::Node *newNode();
+    void reclaimNodes();
+
+    void insertPid(quint32 pid);
+    bool removePid(quint32 pid);
+
+    PsMap::Node *findPid(quint32 pid);
+
+protected:
+    FORT_PSMAP *m_map = nullptr;
+    QVector<PFORT_PSMAP_NODE> m_buckets;
+
+    QVector<PsMap::Node> m_nodes;
+    QVector<PsMap::Node *> m_freeNodes;
+};
+
+void PsMapTest::SetUp()
+{
+    m_map = new FORT_PSMAP();
+}
+
+void PsMapTest::TearDown()
+{
+    delete m_map;
+    m_map = nullptr;
+}
+
+void PsMapTest::init(int bucketsCount, int nodesCount)
+{
+    m_buckets.resize(bucketsCount);
+    fort_psmap_init(m_map, m_buckets.data(), bucketsCount);
+
+    m_nodes = QVector<PsMap::Node>(nodesCount);
+
+    m_freeNodes.clear();
+    for (PsMap::Node &node : m_nodes) {
+        m_freeNodes.append(&node);
+    }
+}
+
+PsMap::Node *PsMapTest::newNode()
+{
+    if (m_freeNodes.isEmpty()) {
+        reclaimNodes();
+    }
+
+    return m_freeNodes.isEmpty() ? nullptr : m_freeNodes.takeLast();
+}
+
+void PsMapTest::reclaimNodes()
+{
+    PFORT_PSMAP_NODE mapNode = fort_psmap_reclaim(m_map);
+
+    while (mapNode != nullptr) {
+        auto node = reinterpret_cast<PsMap::Node *>(mapNode);
+        mapNode = mapNode->retired_next;
+
+        // No reader must see the reclaimed node
+        node->value.storeRelease(PsMap::valuePoison);
+
+        m_freeNodes.append(node);
+    }
+}
+
+void PsMapTest::insertPid(quint32 pid)
+{
+    PsMap::Node *node = newNode();
+    if (node == nullptr)
+        return;
+
+    node->value.storeRelaxed(PsMap::pidValue(pid));
+
+    fort_psmap_insert(m_map, &node->mapNode, pid, fort_psmap_hash(pid));
+}
+
+bool PsMapTest::removePid(quint32 pid)
+{
+    PFORT_PSMAP_NODE mapNode = fort_psmap_find(m_map, pid, fort_psmap_hash(pid));
+    if (mapNode == nullptr)
+        return false;
+
+    fort_psmap_remove(m_map, mapNode);
+
+    reclaimNodes();
+
+    return true;
+}
+
+PsMap::Node *PsMapTest::findPid(quint32 pid)
+{
+    return reinterpret_cast<PsMap::Node *>(
+            fort_psmap_find(m_map, pid, fort_psmap_hash(pid)));
+}
+
+TEST_F(PsMapTest, insertFindRemove)
+{
+    init(16, 64);
+
+    for (quint32 pid = 4; pid <= 4 * 50; pid += 4) {
+        insertPid(pid);
+    }
+    ASSERT_EQ(m_map->count, 50u);
+
+    for (quint32 pid = 4; pid <= 4 * 50; pid += 4) {
+        const PsMap::Node *node = findPid(pid);
+        ASSERT_NE(node, nullptr);
+        ASSERT_EQ(node->value.loadRelaxed(), PsMap::pidValue(pid));
+    }
+
+    ASSERT_EQ(findPid(3), nullptr);
+    ASSERT_EQ(findPid(4 * 51), nullptr);
+
+    ASSERT_TRUE(removePid(8));
+    ASSERT_FALSE(removePid(8));
+    ASSERT_EQ(findPid(8), nullptr);
+    ASSERT_NE(findPid(12), nullptr);
+    ASSERT_EQ(m_map->count, 49u);
+}
+
+TEST_F(PsMapTest, readerKeepsRetired)
+{
+    init(16, 8);
+
+    insertPid(100);
+
+    const UINT32 readToken = fort_psmap_read_begin(m_map, 0);
+
+    PsMap::Node *node = findPid(100);
+    ASSERT_NE(node, nullptr);
+
+    ASSERT_TRUE(removePid(100));
+
+    // The active reader blocks the reclaim of the removed node
+    for (int i = 0; i < 4; ++i) {
+        reclaimNodes();
+    }
+    ASSERT_EQ(node->value.loadRelaxed(), PsMap::pidValue(100));
+
+    fort_psmap_read_end(m_map, readToken);
+
+    // The reader is gone: the node is reclaimed
+    reclaimNodes();
+    ASSERT_EQ(node->value.loadRelaxed(), PsMap::valuePoison);
+}
+
+TEST_F(PsMapTest, concurrentStress)
+{
+    constexpr int readersCount = 4;
+    constexpr int writersCount = 2;
+    constexpr int writerIterations = 200000;
+    constexpr quint32 pidsCount = 512;
+
+    init(64, pidsCount + 256);
+
+    QMutex writerMutex;
+    QAtomicInt writersDone = 0;
+    QAtomicInt foundCount = 0;
+    QAtomicInt violationsCount = 0;
+
+    QList<QThread *> threads;
+
+    for (int w = 0; w < writersCount; ++w) {
+        threads.append(QThread::create([&, w] {
+            QRandomGenerator rand(0x466F7274 + w);
+
+            for (int i = 0; i < writerIterations; ++i) {
+                const quint32 pid = 4 * (1 + rand.bounded(pidsCount));
+
+                QMutexLocker locker(&writerMutex);
+
+                if (!removePid(pid)) {
+                    insertPid(pid);
+                }
+            }
+
+            writersDone.fetchAndAddOrdered(1);
+        }));
+    }
+
+    for (int r = 0; r < readersCount; ++r) {
+        threads.append(QThread::create([&, r] {
+            QRandomGenerator rand(0x52656164 + r);
+
+            while (writersDone.loadAcquire() < writersCount) {
+                const quint32 pid = 4 * (1 + rand.bounded(pidsCount));
+
+                const UINT32 readToken = fort_psmap_read_begin(m_map, r);
+
+                const PsMap::Node *node = findPid(pid);
+                if (node != nullptr) {
+                    foundCount.fetchAndAddRelaxed(1);
+
+                    if (node->value.loadAcquire() != PsMap::pidValue(pid)) {
+                        violationsCount.fetchAndAddRelaxed(1);
+                    }
+                }
+
+                fort_psmap_read_end(m_map, readToken);
+            }
+        }));
+    }
+
+    for (QThread *thread : threads) {
+        thread->start();
+    }
+
+    for (QThread *thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+
+    ASSERT_GT(foundCount.loadRelaxed(), 0);
+    ASSERT_EQ(violationsCount.loadRelaxed(), 0);
+
+    // All reader slots are released
+    for (int i = 0; i < FORT_PSMAP_READER_SLOTS; ++i) {
+        ASSERT_EQ(LONG(m_map->readers[i].count[0]), 0);
+        ASSERT_EQ(LONG(m_map->readers[i].count[1]), 0);
+    }
+}
@@ -0,0 +1,273 @@
+#pragma once
+
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/fortconf.h>
+
+#include <util/conf/confruleswalker.h>
+#include <util/conf/confutil.h>
+#include <util/conf/ruleexpr.h>
+#include <util/fileutil.h>
+
+namespace {
+
+class TestRulesWalker : public ConfRulesWalker
+{
+public:
+    explicit TestRulesWalker(const QVector<Rule> &rules) : m_rules(rules) { }
+
+    bool walkRules(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds, int &maxRuleId,
+            const std::function<walkRulesCallback> &func) const override
+    {
+        maxRuleId = 0;
+
+        for (const Rule &rule : m_rules) {
+            maxRuleId = qMax(maxRuleId, rule.ruleId);
+
+            const RuleSetIndex ruleSetIndex = {
+                .index = quint32(ruleIds.size()),
+                .count = quint8(rule.ruleSet.size()),
+            };
+            ruleSetMap.insert(rule.ruleId, ruleSetIndex);
+
+            ruleIds.append(rule.ruleSet);
+        }
+
+        for (Rule rule : m_rules) {
+            if (!func(rule))
+                return false;
+        }
+
+        return true;
+    }
+
+private:
+    QVector<Rule> m_rules;
+};
+
+}
+
+class RuleExprTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void checkError(const QString &text, int lineNo, int columnNo, const QString &message = {});
+    void checkSerialized(const QString &text, const QString &fileName);
+};
+
+void RuleExprTest::SetUp() { }
+
+void RuleExprTest::TearDown() { }
+
+void RuleExprTest::checkError(
+        const QString &text, int lineNo, int columnNo, const QString &message)
+{
+    RuleExpr ruleExpr;
+
+    ASSERT_FALSE(ruleExpr.parse(text));
+    ASSERT_EQ(ruleExpr.errorLineNo(), lineNo);
+    ASSERT_EQ(ruleExpr.errorColumnNo(), columnNo);
+
+    if (!message.isEmpty()) {
+        ASSERT_EQ(ruleExpr.errorMessage(), message);
+    }
+}
+
+void RuleExprTest::checkSerialized(const QString &text, const QString &fileName)
+{
+    RuleExpr ruleExpr;
+    ASSERT_TRUE(ruleExpr.parse(text));
+
+    ConfUtil confUtil;
+    confUtil.writeRuleExpr(ruleExpr);
+
+    const QByteArray golden = FileUtil::readFileData(":/data/ruleexpr/" + fileName);
+    ASSERT_FALSE(golden.isEmpty());
+
+    ASSERT_EQ(confUtil.buffer().toHex(), golden.toHex());
+}
+
+TEST_F(RuleExprTest, endpoint)
+{
+    RuleExpr ruleExpr;
+
+    ASSERT_TRUE(ruleExpr.parse("(1.1.1.1-8.8.8.8, ::1):udp(43, 80-8080)"));
+    ASSERT_EQ(ruleExpr.filters().size(), 2);
+
+    const RuleFilter &root = ruleExpr.filterAt(0);
+    ASSERT_TRUE(root.isList());
+    ASSERT_EQ(root.children, QVector<int>({ 1 }));
+
+    const RuleFilter &filter = ruleExpr.filterAt(1);
+    ASSERT_FALSE(filter.isList());
+    ASSERT_FALSE(filter.isOr);
+    ASSERT_FALSE(filter.isLocal);
+    ASSERT_EQ(filter.protoFlags, RuleFilter::ProtoUdp);
+
+    ASSERT_EQ(filter.addressList.size(), 2);
+    ASSERT_EQ(filter.addressList.at(0), QLatin1String("1.1.1.1-8.8.8.8"));
+    ASSERT_EQ(filter.addressList.at(1), QLatin1String("::1"));
+
+    ASSERT_EQ(filter.portList.size(), 2);
+    ASSERT_EQ(filter.portList.at(0), QLatin1String("43"));
+    ASSERT_EQ(filter.portList.at(1), QLatin1String("80-8080"));
+}
+
+TEST_F(RuleExprTest, localAndAnyAddress)
+{
+    RuleExpr ruleExpr;
+
+    ASSERT_TRUE(ruleExpr.parse("LOCAL:tcp *:80"));
+    ASSERT_EQ(ruleExpr.filters().size(), 3);
+
+    const RuleFilter &local = ruleExpr.filterAt(1);
+    ASSERT_TRUE(local.isLocal);
+    ASSERT_TRUE(local.addressList.isEmpty());
+    ASSERT_TRUE(local.portList.isEmpty());
+    ASSERT_EQ(local.protoFlags, RuleFilter::ProtoTcp);
+
+    const RuleFilter &remote = ruleExpr.filterAt(2);
+    ASSERT_FALSE(remote.isOr);
+    ASSERT_FALSE(remote.isLocal);
+    ASSERT_TRUE(remote.addressList.isEmpty());
+    ASSERT_EQ(remote.portList.size(), 1);
+    ASSERT_EQ(remote.pos, 10);
+}
+
+TEST_F(RuleExprTest, alternatives)
+{
+    RuleExpr ruleExpr;
+
+    // Lines and "or" separate the alternatives, empty lines and comments are skipped
+    ASSERT_TRUE(ruleExpr.parse("1.1.1.1 # first\n\n2.2.2.2 or 3.3.3.3 *:53"));
+
+    const RuleFilter &root = ruleExpr.filterAt(0);
+    ASSERT_EQ(root.children.size(), 4);
+
+    ASSERT_FALSE(ruleExpr.filterAt(root.children[0]).isOr);
+    ASSERT_TRUE(ruleExpr.filterAt(root.children[1]).isOr);
+    ASSERT_TRUE(ruleExpr.filterAt(root.children[2]).isOr);
+    ASSERT_FALSE(ruleExpr.filterAt(root.children[3]).isOr);
+
+    // Only comments
+    ASSERT_TRUE(ruleExpr.parse("# 1.1.1.1\n"));
+    ASSERT_TRUE(ruleExpr.isEmpty());
+}
+
+TEST_F(RuleExprTest, groups)
+{
+    RuleExpr ruleExpr;
+
+    ASSERT_TRUE(ruleExpr.parse("{ 10.0.0.0/8 or { 192.168.0.0/16 } } *:tcp"));
+
+    const RuleFilter &root = ruleExpr.filterAt(0);
+    ASSERT_EQ(root.children.size(), 2);
+
+    const RuleFilter &group = ruleExpr.filterAt(root.children[0]);
+    ASSERT_TRUE(group.isList());
+    ASSERT_EQ(group.children.size(), 2);
+
+    const RuleFilter &subGroup = ruleExpr.filterAt(group.children[1]);
+    ASSERT_TRUE(subGroup.isList());
+    ASSERT_TRUE(subGroup.isOr);
+    ASSERT_EQ(subGroup.children.size(), 1);
+
+    // Depth limit
+    const QString depthMaxText = QString("{").repeated(ConfUtil::ruleDepthMaxCount()) + "1.1.1.1"
+            + QString("}").repeated(ConfUtil::ruleDepthMaxCount());
+    ASSERT_TRUE(ruleExpr.parse(depthMaxText));
+    ASSERT_FALSE(ruleExpr.parse("{" + depthMaxText + "}"));
+}
+
+TEST_F(RuleExprTest, errorPositions)
+{
+    checkError("or 1.1.1.1", 1, 1, "Unexpected 'or'");
+    checkError("1.1.1.1 or", 1, 9, "Missing filter after 'or'");
+    checkError("1.1.1.1\n  { }", 2, 3, "Empty group");
+    checkError("{ 1.1.1.1", 1, 10, "Missing '}'");
+    checkError("1.1.1.1\n(2.2.2.2,\n 3.3.3.3", 3, 9, "Missing ')'");
+    checkError("()", 1, 1, "Empty list");
+    checkError("(1.1.1.1,,2.2.2.2)", 1, 10, "Unexpected ','");
+    checkError("*", 1, 2, "Missing ports");
+    checkError("1.1.1.1:", 1, 9, "Missing ports");
+    checkError("1.1.1.1:(80)x", 1, 13);
+    checkError("}", 1, 1);
+
+    // Address and port errors point to the bad value
+    checkError("1.1.1.1\n *:(80, 90-x)", 2, 9);
+    checkError("(1.1.1.1,\n   1.1.1.300)", 2, 4);
+    checkError("1.1.1.1:(90-80)", 1, 10, "Bad range");
+}
+
+TEST_F(RuleExprTest, serializeEndpoint)
+{
+    checkSerialized("1.1.1.1:udp(43)", "address_udp.bin");
+    checkSerialized("(1.1.1.1-8.8.8.8):(43,80-8080)", "ranges.bin");
+    checkSerialized("local:tcp(80, 443)", "local_tcp.bin");
+}
+
+TEST_F(RuleExprTest, serializeAlternatives)
+{
+    checkSerialized("{ 10.0.0.0/8 or 192.168.0.0/16 } *:tcp", "group_or.bin");
+    checkSerialized("(::1, 10.0.0.1):80\n2.2.2.2", "ip6_or.bin");
+}
+
+TEST_F(RuleExprTest, writeRules)
+{
+    Rule rule1;
+    rule1.ruleId = 1;
+    rule1.ruleText = "1.1.1.1:udp(43)";
+    rule1.ruleSet = { 3 };
+
+    Rule rule3;
+    rule3.ruleId = 3;
+    rule3.acceptZones = 0x01;
+
+    ConfUtil confUtil;
+    ASSERT_TRUE(confUtil.writeRules(TestRulesWalker({ rule1, rule3 })));
+
+    QByteArray buf = confUtil.buffer();
+    PFORT_CONF_RULES rules = PFORT_CONF_RULES(buf.data());
+    ASSERT_TRUE(fort_conf_rules_verify(rules, buf.size()));
+
+    // Gap in the rule ids
+    ASSERT_NE(fort_conf_rule_ref(rules, 1), nullptr);
+    ASSERT_EQ(fort_conf_rule_ref(rules, 2), nullptr);
+    ASSERT_NE(fort_conf_rule_ref(rules, 3), nullptr);
+    ASSERT_EQ(fort_conf_rule_ref(rules, 4), nullptr);
+
+    ASSERT_TRUE(fort_conf_rule_ref(rules, 1)->has_expr);
+    ASSERT_TRUE(fort_conf_rule_ref(rules, 3)->has_zones);
+
+    // The missing rule's offset must be the marker or valid
+    {
+        QByteArray badBuf = buf;
+        PFORT_CONF_RULES badRules = PFORT_CONF_RULES(badBuf.data());
+
+        UINT32 *rule_offsets = (UINT32 *) badRules->data;
+        rule_offsets[2] = FORT_CONF_RULE_OFF_NONE - 1;
+
+        ASSERT_FALSE(fort_conf_rules_verify(badRules, badBuf.size()));
+    }
+
+    // Bad rule text: the rule is skipped
+    Rule badRule;
+    badRule.ruleId = 2;
+    badRule.ruleText = "1.1.1.1:";
+
+    ASSERT_TRUE(confUtil.writeRules(TestRulesWalker({ rule1, badRule, rule3 })));
+    ASSERT_FALSE(confUtil.hasError());
+
+    buf = confUtil.buffer();
+    rules = PFORT_CONF_RULES(buf.data());
+    ASSERT_TRUE(fort_conf_rules_verify(rules, buf.size()));
+
+    ASSERT_NE(fort_conf_rule_ref(rules, 1), nullptr);
+    ASSERT_EQ(fort_conf_rule_ref(rules, 2), nullptr);
+    ASSERT_NE(fort_conf_rule_ref(rules, 3), nullptr);
+}
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <QRandomGenerator>
+
+#include <googletest.h>
+
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/conf/confutil.h>
+#include <util/conf/rulesetgraph.h>
+
+namespace {
+
+const char *const sqlCreateRuleSet = "CREATE TABLE rule_set("
+                                     "  rule_set_id INTEGER PRIMARY KEY,"
+                                     "  rule_id INTEGER NOT NULL,"
+                                     "  sub_rule_id INTEGER NOT NULL,"
+                                     "  order_index INTEGER NOT NULL"
+                                     ");"
+                                     "CREATE INDEX rule_set_rule_id_idx ON rule_set(rule_id);"
+                                     "CREATE INDEX rule_set_sub_rule_id_idx ON rule_set(sub_rule_id);";
+
+const char *const sqlInsertRuleSet = "INSERT INTO rule_set(rule_id, sub_rule_id, order_index)"
+                                     "  VALUES(?1, ?2, ?3);";
+
+const char *const sqlDeleteSubRule = "DELETE FROM rule_set"
+                                     "  WHERE rule_id = ?1 AND sub_rule_id = ?2;";
+
+const char *const sqlDeleteRule = "DELETE FROM rule_set"
+                                  "  WHERE rule_id = ?1 OR sub_rule_id = ?1;";
+
+const char *const sqlSelectRuleSets = "SELECT t.rule_id, t.sub_rule_id"
+                                      "  FROM rule_set t"
+                                      "  ORDER BY t.rule_id, t.order_index;";
+
+// The former recursive check of ConfRuleManager
+const char *const sqlSelectRuleSetLoop = "WITH RECURSIVE"
+                                         "  parents(rule_id, level) AS ("
+                                         "    VALUES(?1, 0)"
+                                         "    UNION ALL"
+                                         "    SELECT t.rule_id, p.level + 1"
+                                         "      FROM rule_set t"
+                                         "      JOIN parents p ON p.rule_id = t.sub_rule_id"
+                                         "  ),"
+                                         "  children(rule_id, level) AS ("
+                                         "    VALUES(?2, 0)"
+                                         "    UNION ALL"
+                                         "    SELECT t.sub_rule_id, c.level + 1"
+                                         "      FROM rule_set t"
+                                         "      JOIN children c ON c.rule_id = t.rule_id"
+                                         "  )"
+                                         "SELECT * FROM (VALUES ("
+                                         "  (SELECT 1"
+                                         "    FROM parents p"
+                                         "    JOIN children c ON c.rule_id = p.rule_id"
+                                         "    LIMIT 1),"
+                                         "  ((SELECT MAX(level) FROM parents)"
+                                         "    + (SELECT MAX(level) FROM children))"
+                                         "));";
+
+}
+
+class RuleSetGraphTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void addSubRule(int ruleId, int subRuleId);
+    void removeSubRule(int ruleId, int subRuleId);
+    void removeRule(int ruleId);
+
+    void checkEdge(int ruleId, int subRuleId);
+    void checkRuleSets();
+    void checkOrder(int maxRuleId);
+
+protected:
+    int m_orderIndex = 0;
+
+    SqliteDb m_sqliteDb { ":memory:" };
+
+    RuleSetGraph m_graph;
+};
+
+void RuleSetGraphTest::SetUp()
+{
+    ASSERT_TRUE(m_sqliteDb.open());
+    ASSERT_TRUE(m_sqliteDb.execute(sqlCreateRuleSet));
+}
+
+void RuleSetGraphTest::TearDown()
+{
+    m_sqliteDb.close();
+}
+
+void RuleSetGraphTest::addSubRule(int ruleId, int subRuleId)
+{
+    ASSERT_TRUE(m_graph.addSubRule(ruleId, subRuleId));
+
+    ASSERT_TRUE(DbQuery(&m_sqliteDb)
+                        .sql(sqlInsertRuleSet)
+                        .vars({ ruleId, subRuleId, ++m_orderIndex })
+                        .executeOk());
+}
+
+void RuleSetGraphTest::removeSubRule(int ruleId, int subRuleId)
+{
+    m_graph.removeSubRule(ruleId, subRuleId);
+
+    ASSERT_TRUE(DbQuery(&m_sqliteDb).sql(sqlDeleteSubRule).vars({ ruleId, subRuleId }).executeOk());
+}
+
+void RuleSetGraphTest::removeRule(int ruleId)
+{
+    m_graph.removeRule(ruleId);
+
+    ASSERT_TRUE(DbQuery(&m_sqliteDb).sql(sqlDeleteRule).vars({ ruleId }).executeOk());
+}
+
+void RuleSetGraphTest::checkEdge(int ruleId, int subRuleId)
+{
+    const auto list = DbQuery(&m_sqliteDb)
+                              .sql(sqlSelectRuleSetLoop)
+                              .vars({ ruleId, subRuleId })
+                              .execute(2)
+                              .toList();
+
+    const bool isLoop = (list[0].toInt() != 0);
+    const int depth = list[1].toInt();
+
+    ASSERT_EQ(m_graph.isLoop(ruleId, subRuleId), isLoop)
+            << "rule=" << ruleId << " sub-rule=" << subRuleId;
+
+    if (!isLoop) {
+        ASSERT_EQ(m_graph.depth(ruleId, subRuleId), depth)
+                << "rule=" << ruleId << " sub-rule=" << subRuleId;
+    }
+}
+
+void RuleSetGraphTest::checkRuleSets()
+{
+    ruleset_map_t ruleSetMap;
+    ruleid_arr_t ruleIds;
+    m_graph.fillRuleSetMap(ruleSetMap, ruleIds);
+
+    ruleid_arr_t sqlRuleIds;
+    QHash<int, int> sqlRuleSetCounts;
+
+    SqliteStmt stmt;
+    ASSERT_TRUE(DbQuery(&m_sqliteDb).sql(sqlSelectRuleSets).prepare(stmt));
+
+    while (stmt.step() == SqliteStmt::StepRow) {
+        const int ruleId = stmt.columnInt(0);
+        const int subRuleId = stmt.columnInt(1);
+
+        sqlRuleIds.append(subRuleId);
+        ++sqlRuleSetCounts[ruleId];
+    }
+
+    ASSERT_EQ(ruleIds, sqlRuleIds);
+    ASSERT_EQ(ruleSetMap.size(), sqlRuleSetCounts.size());
+
+    for (auto it = sqlRuleSetCounts.constBegin(); it != sqlRuleSetCounts.constEnd(); ++it) {
+        const RuleSetIndex ruleSetIndex = ruleSetMap.value(it.key());
+
+        ASSERT_EQ(int(ruleSetIndex.count), it.value());
+        ASSERT_EQ(ruleIds.mid(ruleSetIndex.index, ruleSetIndex.count),
+                m_graph.subRuleIds(it.key()));
+    }
+}
+
+void RuleSetGraphTest::checkOrder(int maxRuleId)
+{
+    for (int ruleId = 1; ruleId <= maxRuleId; ++ruleId) {
+        const RuleSetNode &ruleNode = m_graph.nodeAt(ruleId);
+
+        for (const int subRuleId : ruleNode.subRuleIds) {
+            ASSERT_LT(ruleNode.order, m_graph.nodeAt(subRuleId).order)
+                    << "rule=" << ruleId << " sub-rule=" << subRuleId;
+        }
+    }
+}
+
+TEST_F(RuleSetGraphTest, loopAndDepth)
+{
+    addSubRule(1, 2);
+    addSubRule(2, 3);
+    addSubRule(1, 3);
+
+    ASSERT_TRUE(m_graph.isLoop(1, 1));
+    ASSERT_TRUE(m_graph.isLoop(3, 1));
+    ASSERT_TRUE(m_graph.isLoop(2, 1));
+    ASSERT_FALSE(m_graph.isLoop(1, 3));
+    ASSERT_FALSE(m_graph.isLoop(4, 1));
+
+    ASSERT_FALSE(m_graph.addSubRule(3, 1));
+    ASSERT_EQ(m_graph.subRuleIds(3).size(), 0);
+
+    ASSERT_EQ(m_graph.parentDepth(3), 2);
+    ASSERT_EQ(m_graph.subDepth(1), 2);
+    ASSERT_EQ(m_graph.depth(3, 4), 2);
+
+    // The longest path is shortened
+    removeSubRule(2, 3);
+    ASSERT_EQ(m_graph.parentDepth(3), 1);
+    ASSERT_EQ(m_graph.subDepth(1), 1);
+
+    // The sub-rule ordered before the rule
+    addSubRule(5, 6);
+    addSubRule(6, 1);
+    ASSERT_EQ(m_graph.depth(4, 5), 3);
+    ASSERT_TRUE(m_graph.isLoop(3, 5));
+
+    checkOrder(6);
+    checkRuleSets();
+
+    for (int ruleId = 1; ruleId <= 6; ++ruleId) {
+        for (int subRuleId = 1; subRuleId <= 6; ++subRuleId) {
+            checkEdge(ruleId, subRuleId);
+        }
+    }
+}
+
+TEST_F(RuleSetGraphTest, deepChain)
+{
+    constexpr int rulesCount = 2000;
+
+    // Add the chain from the bottom to reorder all rules on each edge
+    for (int ruleId = rulesCount - 1; ruleId >= 1; --ruleId) {
+        addSubRule(ruleId, ruleId + 1);
+    }
+
+    checkOrder(rulesCount);
+
+    ASSERT_EQ(m_graph.parentDepth(rulesCount), rulesCount - 1);
+    ASSERT_EQ(m_graph.subDepth(1), rulesCount - 1);
+
+    checkEdge(rulesCount, 1);
+    checkEdge(rulesCount / 2, 1);
+    checkEdge(1, rulesCount);
+    checkEdge(rulesCount, rulesCount + 1);
+
+    // Split the chain
+    removeSubRule(rulesCount / 2, rulesCount / 2 + 1);
+
+    ASSERT_EQ(m_graph.parentDepth(rulesCount), rulesCount / 2 - 1);
+    ASSERT_EQ(m_graph.subDepth(1), rulesCount / 2 - 1);
+
+    checkEdge(rulesCount, 1);
+    checkEdge(rulesCount / 2, rulesCount / 2 + 1);
+
+    // Join the halves in reverse
+    addSubRule(rulesCount, 1);
+
+    checkOrder(rulesCount);
+    checkEdge(rulesCount / 2, rulesCount / 2 + 1);
+    checkEdge(rulesCount / 2 + 1, rulesCount / 2);
+    checkRuleSets();
+}
+
+TEST_F(RuleSetGraphTest, randomAgainstSql)
+{
+    constexpr int rulesCount = 3000;
+    constexpr int stepsCount = 6000;
+
+    QRandomGenerator rand(0x52756C65);
+
+    for (int step = 0; step < stepsCount; ++step) {
+        const int ruleId = rand.bounded(1, rulesCount + 1);
+        const int action = rand.bounded(100);
+
+        if (action < 80) {
+            const int subRuleId = rand.bounded(1, rulesCount + 1);
+
+            checkEdge(ruleId, subRuleId);
+
+            // Add the edge, as the Rule Set model does
+            if (m_graph.subRuleIds(ruleId).size() < ConfUtil::ruleSetMaxCount()
+                    && !m_graph.subRuleIds(ruleId).contains(subRuleId)
+                    && !m_graph.isLoop(ruleId, subRuleId)
+                    && m_graph.depth(ruleId, subRuleId) <= ConfUtil::ruleSetDepthMaxCount()) {
+                addSubRule(ruleId, subRuleId);
+            }
+        } else if (action < 95) {
+            const RuleSetList &subRuleIds = m_graph.subRuleIds(ruleId);
+
+            if (!subRuleIds.isEmpty()) {
+                removeSubRule(ruleId, subRuleIds.at(rand.bounded(int(subRuleIds.size()))));
+            }
+        } else {
+            removeRule(ruleId);
+        }
+    }
+
+    checkOrder(rulesCount);
+    checkRuleSets();
+
+    for (int i = 0; i < 1000; ++i) {
+        checkEdge(rand.bounded(1, rulesCount + 1), rand.bounded(1, rulesCount + 1));
+    }
+}
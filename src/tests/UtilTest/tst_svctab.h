@@ -0,0 +1,275 @@
+#pragma once
+
+#include <QByteArray>
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/fortsvctab.h>
+
+#include <util/conf/confutil.h>
+#include <util/service/serviceinfo.h>
+
+class SvcTabTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    static ServiceInfo serviceInfo(const QString &serviceName, quint32 processId);
+
+    PFORT_SVCTAB build(const QByteArray &listBuf);
+    PFORT_SVCTAB buildFull(const QVector<ServiceInfo> &services);
+    PFORT_SVCTAB buildDelta(const QVector<ServiceInfo> &services);
+
+    QString findPidName(quint32 processId) const;
+    quint32 findNamePid(const QString &serviceName) const;
+
+protected:
+    QByteArray m_tabBuf;
+    QByteArray m_oldTabBuf;
+
+    PFORT_SVCTAB m_tab = nullptr;
+};
+
+void SvcTabTest::SetUp() { }
+
+void SvcTabTest::TearDown() { }
+
+ServiceInfo SvcTabTest::serviceInfo(const QString &serviceName, quint32 processId)
+{
+    ServiceInfo info;
+    info.isRunning = (processId != 0);
+    info.processId = processId;
+    info.serviceName = serviceName;
+    return info;
+}
+
+PFORT_SVCTAB SvcTabTest::build(const QByteArray &listBuf)
+{
+    const auto services = (const PFORT_SERVICE_INFO_LIST) listBuf.data();
+    const ULONG dataLen = listBuf.size() - FORT_SERVICE_INFO_LIST_DATA_OFF;
+
+    // Keep the old table alive while building the new one
+    m_oldTabBuf.swap(m_tabBuf);
+
+    const ULONG size = fort_svctab_build_size(m_tab, services, dataLen);
+    if (size == 0)
+        return nullptr;
+
+    m_tabBuf.resize(size);
+
+    m_tab = fort_svctab_build(m_tabBuf.data(), m_tab, services, dataLen);
+
+    return m_tab;
+}
+
+PFORT_SVCTAB SvcTabTest::buildFull(const QVector<ServiceInfo> &services)
+{
+    int runningServicesCount = 0;
+    for (const ServiceInfo &info : services) {
+        if (info.isRunning) {
+            ++runningServicesCount;
+        }
+    }
+
+    ConfUtil confUtil;
+    confUtil.writeServices(services, runningServicesCount);
+
+    return build(confUtil.buffer());
+}
+
+PFORT_SVCTAB SvcTabTest::buildDelta(const QVector<ServiceInfo> &services)
+{
+    ConfUtil confUtil;
+    confUtil.writeServicesDelta(services);
+
+    return build(confUtil.buffer());
+}
+
+QString SvcTabTest::findPidName(quint32 processId) const
+{
+    const PFORT_SVCTAB_ENTRY entry = fort_svctab_find_pid(m_tab, processId);
+    if (entry == nullptr)
+        return {};
+
+    return QString::fromUtf16(
+            (const char16_t *) fort_svctab_entry_name(m_tab, entry), entry->name_len / 2);
+}
+
+quint32 SvcTabTest::findNamePid(const QString &serviceName) const
+{
+    const PFORT_SVCTAB_ENTRY entry = fort_svctab_find_name(m_tab, (PCWCH) serviceName.utf16(),
+            quint16(serviceName.size() * sizeof(char16_t)));
+
+    return (entry != nullptr) ? entry->process_id : quint32(-1);
+}
+
+TEST_F(SvcTabTest, build)
+{
+    ASSERT_NE(buildFull({ serviceInfo("Dnscache", 1204), serviceInfo("BFE", 1308),
+                      serviceInfo("Stopped", 0), serviceInfo("mpssvc", 1308) }),
+            nullptr);
+
+    ASSERT_EQ(m_tab->count, 3);
+
+    ASSERT_EQ(findPidName(1204), "dnscache");
+    ASSERT_EQ(findPidName(1308), "bfe"); // first service of the shared process
+    ASSERT_EQ(findPidName(1400), QString());
+    ASSERT_EQ(findPidName(0), QString());
+
+    ASSERT_EQ(findNamePid("DNSCACHE"), 1204u);
+    ASSERT_EQ(findNamePid("MpsSvc"), 1308u);
+    ASSERT_EQ(findNamePid("Stopped"), quint32(-1));
+
+    // Full list replaces the table
+    ASSERT_NE(buildFull({ serviceInfo("BFE", 2000) }), nullptr);
+
+    ASSERT_EQ(m_tab->count, 1);
+    ASSERT_EQ(findPidName(1204), QString());
+    ASSERT_EQ(findPidName(2000), "bfe");
+}
+
+TEST_F(SvcTabTest, deltaApply)
+{
+    ASSERT_NE(buildFull({ serviceInfo("Dnscache", 1204), serviceInfo("BFE", 1308) }), nullptr);
+
+    // Restarted and added services
+    ASSERT_NE(buildDelta({ serviceInfo("Dnscache", 2404), serviceInfo("WinHttpAutoProxySvc", 88) }),
+            nullptr);
+
+    ASSERT_EQ(findPidName(1204), QString());
+    ASSERT_EQ(findPidName(2404), "dnscache");
+    ASSERT_EQ(findPidName(1308), "bfe");
+    ASSERT_EQ(findPidName(88), "winhttpautoproxysvc");
+
+    // Removed service
+    ASSERT_NE(buildDelta({ serviceInfo("BFE", 0) }), nullptr);
+
+    ASSERT_EQ(findPidName(1308), QString());
+    ASSERT_EQ(findNamePid("bfe"), 0u);
+    ASSERT_EQ(findPidName(2404), "dnscache");
+
+    // The removed entries are dropped by the next delta
+    ASSERT_NE(buildDelta({ serviceInfo("Dnscache", 2404) }), nullptr);
+
+    ASSERT_EQ(m_tab->count, 2);
+    ASSERT_EQ(findNamePid("bfe"), quint32(-1));
+
+    // Exited process
+    ASSERT_TRUE(fort_svctab_remove_pid(m_tab, 88));
+    ASSERT_FALSE(fort_svctab_remove_pid(m_tab, 88));
+    ASSERT_EQ(findPidName(88), QString());
+    ASSERT_EQ(findPidName(2404), "dnscache");
+}
+
+TEST_F(SvcTabTest, removeSharedPid)
+{
+    ASSERT_NE(buildFull({ serviceInfo("BFE", 1308), serviceInfo("Dnscache", 1204),
+                      serviceInfo("mpssvc", 1308), serviceInfo("PolicyAgent", 1308) }),
+            nullptr);
+
+    ASSERT_EQ(m_tab->count, 4);
+    ASSERT_EQ(findNamePid("PolicyAgent"), 1308u);
+
+    // All services of the exited shared process
+    ASSERT_TRUE(fort_svctab_remove_pid(m_tab, 1308));
+    ASSERT_FALSE(fort_svctab_remove_pid(m_tab, 1308));
+
+    ASSERT_EQ(findPidName(1308), QString());
+
+    // The removed entries are compacted
+    ASSERT_EQ(m_tab->count, 1);
+    ASSERT_EQ(findNamePid("bfe"), quint32(-1));
+    ASSERT_EQ(findNamePid("mpssvc"), quint32(-1));
+    ASSERT_EQ(findNamePid("PolicyAgent"), quint32(-1));
+
+    ASSERT_EQ(findPidName(1204), "dnscache");
+}
+
+TEST_F(SvcTabTest, removeCompact)
+{
+    QVector<ServiceInfo> services;
+    for (int i = 0; i < 10; ++i) {
+        services.append(serviceInfo(QString("svc%1").arg(i), 4 * (i + 1)));
+    }
+
+    ASSERT_NE(buildFull(services), nullptr);
+    ASSERT_EQ(m_tab->count, 10);
+
+    const quint32 namesSize = m_tab->names_size;
+
+    // Not compacted while the removed entries are few
+    ASSERT_TRUE(fort_svctab_remove_pid(m_tab, 4 * 3));
+    ASSERT_TRUE(fort_svctab_remove_pid(m_tab, 4 * 5));
+
+    ASSERT_EQ(m_tab->count, 10);
+    ASSERT_EQ(m_tab->removed_count, 2);
+    ASSERT_EQ(findNamePid("svc2"), 0u);
+
+    // Compacted by the removed entry, which exceeds the quarter of the live ones
+    ASSERT_TRUE(fort_svctab_remove_pid(m_tab, 4 * 8));
+
+    ASSERT_EQ(m_tab->count, 7);
+    ASSERT_EQ(m_tab->removed_count, 0);
+    ASSERT_EQ(m_tab->names_size, namesSize - 3 * 4 * sizeof(char16_t));
+
+    for (const ServiceInfo &info : services) {
+        const bool removed = (info.processId == 4 * 3 || info.processId == 4 * 5
+                || info.processId == 4 * 8);
+
+        ASSERT_EQ(findPidName(info.processId), removed ? QString() : info.serviceName);
+        ASSERT_EQ(findNamePid(info.serviceName), removed ? quint32(-1) : info.processId);
+    }
+
+    // Service churn doesn't grow the table
+    for (int i = 0; i < 100; ++i) {
+        const quint32 processId = 4 * (100 + i);
+
+        ASSERT_NE(buildDelta({ serviceInfo("svc0", processId) }), nullptr);
+        ASSERT_TRUE(fort_svctab_remove_pid(m_tab, processId));
+    }
+
+    ASSERT_LE(m_tab->count, 7);
+    ASSERT_LE(m_tab->count_max, 7);
+}
+
+TEST_F(SvcTabTest, collisions)
+{
+    // Process ids of the same slot in the index of 1024 slots
+    constexpr quint32 pidStep = 4 * 1024;
+
+    QVector<ServiceInfo> services;
+    for (int i = 0; i < 8; ++i) {
+        services.append(serviceInfo(QString("svc%1").arg(i), 4 + i * pidStep));
+    }
+    for (int i = 8; i < 300; ++i) {
+        services.append(serviceInfo(QString("svc%1").arg(i), 4 * (i + 1000)));
+    }
+
+    ASSERT_NE(buildFull(services), nullptr);
+    ASSERT_EQ(m_tab->count, 300);
+    ASSERT_EQ(m_tab->index_mask, 1023u);
+
+    for (const ServiceInfo &info : services) {
+        ASSERT_EQ(findPidName(info.processId), info.serviceName);
+        ASSERT_EQ(findNamePid(info.serviceName), info.processId);
+    }
+
+    // Removed entry in the middle of the probing chain
+    ASSERT_TRUE(fort_svctab_remove_pid(m_tab, 4 + 3 * pidStep));
+    ASSERT_EQ(findPidName(4 + 3 * pidStep), QString());
+    ASSERT_EQ(findPidName(4 + 7 * pidStep), "svc7");
+}
+
+TEST_F(SvcTabTest, badList)
+{
+    ConfUtil confUtil;
+    confUtil.writeServices({ serviceInfo("Dnscache", 1204) }, 1);
+
+    QByteArray listBuf = confUtil.buffer();
+    listBuf.chop(4); // truncated name
+
+    ASSERT_EQ(build(listBuf), nullptr);
+}
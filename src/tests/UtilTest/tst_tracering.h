@@ -0,0 +1,168 @@
+#pragma once
+
+#include <QVector>
+
+#include <googletest.h>
+
+#include <common/forttrc.h>
+#include <driver/tracedecoder.h>
+
+class TraceRingTest : public Test
+{
+    // Test interface
+protected:
+    void SetUp();
+    void TearDown();
+
+    void init(int recordsCount);
+
+    QByteArray readRing(int recordsCount);
+
+protected:
+    FORT_TRC_RING m_ring;
+    QVector<FORT_TRC_RECORD> m_records;
+};
+
+void TraceRingTest::SetUp()
+{
+    init(16);
+}
+
+void TraceRingTest::TearDown()
+{
+    fort_trc_ring_init(&m_ring, nullptr, 0, 0);
+    m_records.clear();
+}
+
+void TraceRingTest::init(int recordsCount)
+{
+    m_records = QVector<FORT_TRC_RECORD>(recordsCount);
+
+    // 1 tick = 1 us
+    fort_trc_ring_init(&m_ring, m_records.data(), recordsCount, 1000 * 1000);
+}
+
+QByteArray TraceRingTest::readRing(int recordsCount)
+{
+    QByteArray buf(TraceDecoder::bufferSize(recordsCount), '\0');
+
+    const UINT32 size = fort_trc_ring_read(&m_ring, buf.data(), buf.size());
+    buf.resize(size);
+
+    return buf;
+}
+
+TEST_F(TraceRingTest, encodeDecode)
+{
+    fort_trc_ring_write(&m_ring, FORT_TRC_CONF_APPLY, 0, 1000, 4096, 0, 0);
+    fort_trc_ring_write(&m_ring, FORT_TRC_FLOW_ASSOCIATE, 1, 1500, 0x89ABCDEF, 0x1, 1234);
+    fort_trc_ring_write(&m_ring, FORT_TRC_SHAPER_DEQUEUE, 2, 2001500, 3, 7, 100);
+
+    TraceDecoder decoder;
+    int count = 0;
+    ASSERT_TRUE(decoder.read(readRing(16), &count));
+    ASSERT_EQ(count, 3);
+    ASSERT_EQ(decoder.lostCount(), 0u);
+    ASSERT_EQ(decoder.ticksFreq(), 1000 * 1000);
+
+    const auto &records = decoder.records();
+    ASSERT_EQ(records.size(), 3);
+
+    ASSERT_EQ(records[0].seq, 0);
+    ASSERT_EQ(records[0].eventId, FORT_TRC_CONF_APPLY);
+    ASSERT_EQ(records[0].data[0], 4096u);
+
+    ASSERT_EQ(records[1].seq, 1);
+    ASSERT_EQ(records[1].cpu, 1);
+    ASSERT_EQ(records[1].timestamp, 1500);
+
+    ASSERT_EQ(decoder.recordTimeUs(records[2]), 2000500);
+
+    ASSERT_EQ(decoder.recordText(records[1]),
+            "1 +0.000500 cpu1 FLOW_ASSOCIATE flow=0x189abcdef pid=1234");
+    ASSERT_EQ(decoder.recordText(records[2]),
+            "2 +2.000500 cpu2 SHAPER_DEQUEUE queue=3 packets=7 queued=100");
+
+    const QStringList csvLines = decoder.toCsv().split('\n', Qt::SkipEmptyParts);
+    ASSERT_EQ(csvLines.size(), 4);
+    ASSERT_EQ(csvLines[0], "seq,time_us,cpu,event,data0,data1,data2");
+    ASSERT_EQ(csvLines[1], "0,0,0,CONF_APPLY,4096,0,0");
+
+    // The ring is drained
+    int emptyCount = -1;
+    ASSERT_TRUE(decoder.read(readRing(16), &emptyCount));
+    ASSERT_EQ(emptyCount, 0);
+    ASSERT_EQ(decoder.records().size(), 3);
+}
+
+TEST_F(TraceRingTest, partialRead)
+{
+    for (int i = 0; i < 10; ++i) {
+        fort_trc_ring_write(&m_ring, FORT_TRC_BUFFER_FLUSH, 0, i, i, 0, 0);
+    }
+
+    TraceDecoder decoder;
+    int count = 0;
+
+    ASSERT_TRUE(decoder.read(readRing(4), &count));
+    ASSERT_EQ(count, 4);
+
+    ASSERT_TRUE(decoder.read(readRing(16), &count));
+    ASSERT_EQ(count, 6);
+
+    const auto &records = decoder.records();
+    ASSERT_EQ(records.size(), 10);
+
+    for (int i = 0; i < records.size(); ++i) {
+        ASSERT_EQ(records[i].seq, i);
+        ASSERT_EQ(records[i].data[0], quint32(i));
+    }
+}
+
+TEST_F(TraceRingTest, overflow)
+{
+    constexpr int writesCount = 16 * 2 + 3;
+
+    for (int i = 0; i < writesCount; ++i) {
+        fort_trc_ring_write(&m_ring, FORT_TRC_FLOW_DELETE, 0, i, i, 0, 0);
+    }
+
+    TraceDecoder decoder;
+    int count = 0;
+    ASSERT_TRUE(decoder.read(readRing(64), &count));
+
+    // Only the newest records are kept
+    ASSERT_EQ(count, 16);
+    ASSERT_EQ(decoder.lostCount(), quint32(writesCount - 16));
+
+    const auto &records = decoder.records();
+    ASSERT_EQ(records.first().seq, writesCount - 16);
+    ASSERT_EQ(records.last().seq, writesCount - 1);
+    ASSERT_EQ(records.last().data[0], quint32(writesCount - 1));
+
+    // The lost count is reset on read
+    TraceDecoder decoder2;
+    ASSERT_TRUE(decoder2.read(readRing(64)));
+    ASSERT_EQ(decoder2.lostCount(), 0u);
+}
+
+TEST_F(TraceRingTest, badInput)
+{
+    TraceDecoder decoder;
+
+    ASSERT_FALSE(decoder.read(QByteArray()));
+
+    // Truncated records
+    fort_trc_ring_write(&m_ring, FORT_TRC_REAUTH, 0, 0, 0, 0, 0);
+    QByteArray buf = readRing(16);
+    buf.chop(1);
+    ASSERT_FALSE(decoder.read(buf));
+
+    // No records without the ring's buffer
+    fort_trc_ring_init(&m_ring, nullptr, 0, 0);
+    fort_trc_ring_write(&m_ring, FORT_TRC_REAUTH, 0, 0, 0, 0, 0);
+
+    int count = -1;
+    ASSERT_TRUE(decoder.read(readRing(16), &count));
+    ASSERT_EQ(count, 0);
+}
@@ -10,17 +10,22 @@ TEMPLATE = lib
 
 SOURCES += \
     appinfo/appbasejob.cpp \
+    appinfo/appiconatlas.cpp \
     appinfo/appiconjob.cpp \
     appinfo/appinfo.cpp \
     appinfo/appinfocache.cpp \
+    appinfo/appinfoindex.cpp \
     appinfo/appinfojob.cpp \
     appinfo/appinfomanager.cpp \
     appinfo/appinfoutil.cpp \
     appinfo/appinfoworker.cpp \
+    appinfo/apppurgejob.cpp \
+    appinfo/apppurgemanager.cpp \
     conf/addressgroup.cpp \
     conf/app.cpp \
     conf/appgroup.cpp \
     conf/confappmanager.cpp \
+    conf/confchangejournal.cpp \
     conf/confmanager.cpp \
     conf/confrulemanager.cpp \
     conf/confzonemanager.cpp \
@@ -33,6 +38,8 @@ SOURCES += \
     control/controlworker.cpp \
     driver/drivercommon.cpp \
     driver/drivermanager.cpp \
+    driver/drivermetrics.cpp \
+    driver/tracedecoder.cpp \
     driver/driverworker.cpp \
     form/basecontroller.cpp \
     form/controls/appinforow.cpp \
@@ -94,6 +101,7 @@ SOURCES += \
     form/rule/rulescontroller.cpp \
     form/rule/ruleswindow.cpp \
     form/stat/pages/connectionspage.cpp \
+    form/stat/pages/diagnosticspage.cpp \
     form/stat/pages/statbasepage.cpp \
     form/stat/pages/statmainpage.cpp \
     form/stat/pages/trafficpage.cpp \
@@ -112,6 +120,7 @@ SOURCES += \
     hostinfo/hostinfocache.cpp \
     hostinfo/hostinfojob.cpp \
     hostinfo/hostinfomanager.cpp \
+    hostinfo/hostresolver.cpp \
     log/logbuffer.cpp \
     log/logentry.cpp \
     log/logentryblocked.cpp \
@@ -120,6 +129,8 @@ SOURCES += \
     log/logentrystattraf.cpp \
     log/logentrytime.cpp \
     log/logmanager.cpp \
+    log/logtracefile.cpp \
+    log/logtracereplayer.cpp \
     manager/autoupdatemanager.cpp \
     manager/dberrormanager.cpp \
     manager/drivelistmanager.cpp \
@@ -158,14 +169,17 @@ SOURCES += \
     rpc/taskmanagerrpc.cpp \
     rpc/windowmanagerfake.cpp \
     stat/askpendingmanager.cpp \
+    stat/askpendingqueue.cpp \
     stat/deleteconnblockjob.cpp \
     stat/logblockedipjob.cpp \
+    stat/quotaledger.cpp \
     stat/quotamanager.cpp \
     stat/statblockbasejob.cpp \
     stat/statblockmanager.cpp \
     stat/statblockworker.cpp \
     stat/statmanager.cpp \
     stat/statsql.cpp \
+    task/taskapppurger.cpp \
     task/taskdownloader.cpp \
     task/taskeditinfo.cpp \
     task/taskinfo.cpp \
@@ -184,6 +198,7 @@ SOURCES += \
     util/conf/appparseoptions.cpp \
     util/conf/confutil.cpp \
     util/conf/ruleexpr.cpp \
+    util/conf/rulesetgraph.cpp \
     util/dateutil.cpp \
     util/device.cpp \
     util/fileutil.cpp \
@@ -227,17 +242,22 @@ SOURCES += \
 
 HEADERS += \
     appinfo/appbasejob.h \
+    appinfo/appiconatlas.h \
     appinfo/appiconjob.h \
     appinfo/appinfo.h \
     appinfo/appinfocache.h \
+    appinfo/appinfoindex.h \
     appinfo/appinfojob.h \
     appinfo/appinfomanager.h \
     appinfo/appinfoutil.h \
     appinfo/appinfoworker.h \
+    appinfo/apppurgejob.h \
+    appinfo/apppurgemanager.h \
     conf/addressgroup.h \
     conf/app.h \
     conf/appgroup.h \
     conf/confappmanager.h \
+    conf/confchangejournal.h \
     conf/confmanager.h \
     conf/confrulemanager.h \
     conf/confzonemanager.h \
@@ -251,6 +271,8 @@ HEADERS += \
     control/controlworker.h \
     driver/drivercommon.h \
     driver/drivermanager.h \
+    driver/drivermetrics.h \
+    driver/tracedecoder.h \
     driver/driverworker.h \
     form/basecontroller.h \
     form/controls/appinforow.h \
@@ -312,6 +334,7 @@ HEADERS += \
     form/rule/rulescontroller.h \
     form/rule/ruleswindow.h \
     form/stat/pages/connectionspage.h \
+    form/stat/pages/diagnosticspage.h \
     form/stat/pages/statbasepage.h \
     form/stat/pages/statmainpage.h \
     form/stat/pages/trafficpage.h \
@@ -331,6 +354,7 @@ HEADERS += \
     hostinfo/hostinfocache.h \
     hostinfo/hostinfojob.h \
     hostinfo/hostinfomanager.h \
+    hostinfo/hostresolver.h \
     log/logbuffer.h \
     log/logentry.h \
     log/logentryblocked.h \
@@ -339,6 +363,8 @@ HEADERS += \
     log/logentrystattraf.h \
     log/logentrytime.h \
     log/logmanager.h \
+    log/logtracefile.h \
+    log/logtracereplayer.h \
     manager/autoupdatemanager.h \
     manager/dberrormanager.h \
     manager/drivelistmanager.h \
@@ -377,14 +403,17 @@ HEADERS += \
     rpc/taskmanagerrpc.h \
     rpc/windowmanagerfake.h \
     stat/askpendingmanager.h \
+    stat/askpendingqueue.h \
     stat/deleteconnblockjob.h \
     stat/logblockedipjob.h \
+    stat/quotaledger.h \
     stat/quotamanager.h \
     stat/statblockbasejob.h \
     stat/statblockmanager.h \
     stat/statblockworker.h \
     stat/statmanager.h \
     stat/statsql.h \
+    task/taskapppurger.h \
     task/taskdownloader.h \
     task/taskeditinfo.h \
     task/taskinfo.h \
@@ -406,6 +435,7 @@ HEADERS += \
     util/conf/confruleswalker.h \
     util/conf/confutil.h \
     util/conf/ruleexpr.h \
+    util/conf/rulesetgraph.h \
     util/dateutil.h \
     util/device.h \
     util/fileutil.h \
@@ -459,6 +489,7 @@ RESOURCES += \
 OTHER_FILES += \
     appinfo/migrations/*.sql \
     conf/migrations/*.sql \
+    hostinfo/migrations/*.sql \
     stat/migrations/block/*.sql \
     stat/migrations/conn/*.sql \
     stat/migrations/traf/*.sql
@@ -466,6 +497,7 @@ OTHER_FILES += \
 RESOURCES += \
     appinfo/appinfo_migrations.qrc \
     conf/conf_migrations.qrc \
+    hostinfo/hostinfo_migrations.qrc \
     stat/stat_migrations.qrc
 
 # Zone
@@ -0,0 +1,249 @@
+#include "appiconatlas.h"
+
+#include <QIconEngine>
+#include <QPainter>
+#include <QPointer>
+
+namespace {
+
+constexpr int pageSlotCount = AppIconAtlas::pageSlotsPerRow * AppIconAtlas::pageSlotsPerRow;
+constexpr int pageSize = AppIconAtlas::pageSlotsPerRow * AppIconAtlas::slotSize;
+
+constexpr qint64 slotBytes = qint64(AppIconAtlas::slotSize) * AppIconAtlas::slotSize * 4;
+
+// Paints from the atlas page at paint time, so the views don't hold pixmap copies
+class AppIconEngine : public QIconEngine
+{
+public:
+    explicit AppIconEngine(AppIconAtlas *atlas, qint64 iconId) :
+        m_iconId(iconId), m_atlas(atlas)
+    {
+    }
+
+    void paint(QPainter *painter, const QRect &rect, QIcon::Mode /*mode*/,
+            QIcon::State /*state*/) override
+    {
+        if (m_atlas) {
+            m_atlas->paint(painter, rect, m_iconId);
+        }
+    }
+
+    QPixmap pixmap(const QSize &size, QIcon::Mode /*mode*/, QIcon::State /*state*/) override
+    {
+        const QPixmap pixmap = m_atlas ? m_atlas->pixmap(m_iconId) : QPixmap();
+
+        return (pixmap.isNull() || pixmap.size() == size)
+                ? pixmap
+                : pixmap.scaled(size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+
+    QSize actualSize(const QSize &size, QIcon::Mode /*mode*/, QIcon::State /*state*/) override
+    {
+        return size;
+    }
+
+    QIconEngine *clone() const override { return new AppIconEngine(m_atlas, m_iconId); }
+
+    QString key() const override { return "AppIconAtlas"; }
+
+private:
+    const qint64 m_iconId = 0;
+
+    QPointer<AppIconAtlas> m_atlas;
+};
+
+}
+
+AppIconAtlas::AppIconAtlas(qint64 budgetBytes, QObject *parent) :
+    QObject(parent), m_maxSlotCount(int(qMax(budgetBytes / slotBytes, qint64(1))))
+{
+}
+
+double AppIconAtlas::hitRatio() const
+{
+    const quint64 total = m_hitCount + m_missCount;
+
+    return total != 0 ? double(m_hitCount) / double(total) : 0.0;
+}
+
+QIcon AppIconAtlas::icon(qint64 iconId)
+{
+    int slot;
+    if (!touchSlot(iconId, slot))
+        return {};
+
+    return QIcon(new AppIconEngine(this, iconId));
+}
+
+QPixmap AppIconAtlas::pixmap(qint64 iconId)
+{
+    int slot;
+    if (!touchSlot(iconId, slot))
+        return {};
+
+    QPixmap &pixmap = m_slots[slot].pixmap;
+    if (pixmap.isNull()) {
+        pixmap = slotPage(slot).copy(slotRect(slot));
+    }
+
+    return pixmap;
+}
+
+void AppIconAtlas::insert(qint64 iconId, const QImage &image)
+{
+    if (iconId == 0 || image.isNull())
+        return;
+
+    int slot = m_slotByIcon.value(iconId, -1);
+    if (slot < 0) {
+        slot = takeFreeSlot();
+
+        m_slots[slot].iconId = iconId;
+        m_slotByIcon.insert(iconId, slot);
+    }
+
+    m_slots[slot].lastUsed = ++m_tick;
+    m_slots[slot].pixmap = {};
+
+    const QImage slotImage = (image.width() > slotSize || image.height() > slotSize)
+            ? prepareImage(image)
+            : image;
+
+    const QRect rect = slotRect(slot);
+
+    QPainter painter(&slotPage(slot));
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(rect, Qt::transparent);
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    // Center the smaller images
+    const QPoint pos = rect.topLeft()
+            + QPoint((slotSize - slotImage.width()) / 2, (slotSize - slotImage.height()) / 2);
+    painter.drawImage(pos, slotImage);
+
+    ++m_insertCount;
+}
+
+void AppIconAtlas::remove(qint64 iconId)
+{
+    const int slot = m_slotByIcon.value(iconId, -1);
+    if (slot < 0)
+        return;
+
+    m_slotByIcon.remove(iconId);
+
+    m_slots[slot] = {};
+    m_freeSlots.append(slot);
+}
+
+void AppIconAtlas::clear()
+{
+    m_pages.clear();
+    m_slots.clear();
+    m_freeSlots.clear();
+    m_slotByIcon.clear();
+}
+
+void AppIconAtlas::paint(QPainter *painter, const QRect &rect, qint64 iconId)
+{
+    const int slot = m_slotByIcon.value(iconId, -1);
+    if (slot < 0)
+        return;
+
+    m_slots[slot].lastUsed = ++m_tick;
+
+    const QRect sourceRect = slotRect(slot);
+
+    if (rect.size() != sourceRect.size()) {
+        painter->setRenderHint(QPainter::SmoothPixmapTransform);
+    }
+
+    painter->drawPixmap(rect, slotPage(slot), sourceRect);
+}
+
+QImage AppIconAtlas::prepareImage(const QImage &image)
+{
+    if (image.isNull())
+        return {};
+
+    const QImage scaledImage = (image.width() > slotSize || image.height() > slotSize)
+            ? image.scaled(slotSize, slotSize, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+            : image;
+
+    return scaledImage.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+}
+
+bool AppIconAtlas::touchSlot(qint64 iconId, int &slot)
+{
+    if (iconId == 0)
+        return false; // no icon
+
+    slot = m_slotByIcon.value(iconId, -1);
+
+    if (slot < 0) {
+        ++m_missCount;
+        return false;
+    }
+
+    ++m_hitCount;
+    m_slots[slot].lastUsed = ++m_tick;
+
+    return true;
+}
+
+int AppIconAtlas::takeFreeSlot()
+{
+    if (!m_freeSlots.isEmpty())
+        return m_freeSlots.takeLast();
+
+    if (m_slots.size() < m_maxSlotCount) {
+        m_slots.append({});
+        return m_slots.size() - 1;
+    }
+
+    return takeLeastUsedSlot();
+}
+
+int AppIconAtlas::takeLeastUsedSlot()
+{
+    // Linear scan: eviction happens only on a full atlas of some hundreds of slots
+    int lruSlot = 0;
+
+    const int slotsCount = m_slots.size();
+    for (int i = 1; i < slotsCount; ++i) {
+        if (m_slots[i].lastUsed < m_slots[lruSlot].lastUsed) {
+            lruSlot = i;
+        }
+    }
+
+    m_slotByIcon.remove(m_slots[lruSlot].iconId);
+    m_slots[lruSlot] = {};
+
+    ++m_evictCount;
+
+    return lruSlot;
+}
+
+QPixmap &AppIconAtlas::slotPage(int slot)
+{
+    const int pageIndex = slot / pageSlotCount;
+
+    while (m_pages.size() <= pageIndex) {
+        QPixmap page(pageSize, pageSize);
+        page.fill(Qt::transparent);
+
+        m_pages.append(page);
+    }
+
+    return m_pages[pageIndex];
+}
+
+QRect AppIconAtlas::slotRect(int slot)
+{
+    const int pageSlot = slot % pageSlotCount;
+
+    const int x = (pageSlot % pageSlotsPerRow) * slotSize;
+    const int y = (pageSlot / pageSlotsPerRow) * slotSize;
+
+    return QRect(x, y, slotSize, slotSize);
+}
@@ -0,0 +1,81 @@
+#ifndef APPICONATLAS_H
+#define APPICONATLAS_H
+
+#include <QHash>
+#include <QIcon>
+#include <QObject>
+#include <QPixmap>
+#include <QVector>
+
+#include <util/classhelpers.h>
+
+// Decoded app icons in fixed-size slots of shared pixmap pages, keyed by icon id
+class AppIconAtlas : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int slotSize = 32;
+    static constexpr int pageSlotsPerRow = 16; // 512x512 px pages
+
+    explicit AppIconAtlas(qint64 budgetBytes = 8 * 1024 * 1024, QObject *parent = nullptr);
+    CLASS_DELETE_COPY_MOVE(AppIconAtlas)
+
+    int maxSlotCount() const { return m_maxSlotCount; }
+    int usedSlotCount() const { return m_slotByIcon.size(); }
+
+    quint64 hitCount() const { return m_hitCount; }
+    quint64 missCount() const { return m_missCount; }
+    quint64 insertCount() const { return m_insertCount; }
+    quint64 evictCount() const { return m_evictCount; }
+
+    double hitRatio() const;
+
+    bool contains(qint64 iconId) const { return m_slotByIcon.contains(iconId); }
+
+    // Null icon/pixmap when the icon is not in the atlas
+    QIcon icon(qint64 iconId);
+    QPixmap pixmap(qint64 iconId);
+
+    void insert(qint64 iconId, const QImage &image);
+    void remove(qint64 iconId);
+    void clear();
+
+    void paint(QPainter *painter, const QRect &rect, qint64 iconId);
+
+    // Scale and convert on a worker thread to keep the GUI thread work minimal
+    static QImage prepareImage(const QImage &image);
+
+private:
+    bool touchSlot(qint64 iconId, int &slot);
+
+    int takeFreeSlot();
+    int takeLeastUsedSlot();
+
+    QPixmap &slotPage(int slot);
+    static QRect slotRect(int slot);
+
+private:
+    struct Slot
+    {
+        qint64 iconId = 0;
+        quint64 lastUsed = 0;
+        QPixmap pixmap; // copied from the page on first request
+    };
+
+    int m_maxSlotCount = 0;
+
+    quint64 m_tick = 0;
+
+    quint64 m_hitCount = 0;
+    quint64 m_missCount = 0;
+    quint64 m_insertCount = 0;
+    quint64 m_evictCount = 0;
+
+    QVector<QPixmap> m_pages;
+    QVector<Slot> m_slots;
+    QVector<int> m_freeSlots;
+    QHash<qint64, int> m_slotByIcon;
+};
+
+#endif // APPICONATLAS_H
@@ -2,16 +2,33 @@
 
 #include <util/worker/workerobject.h>
 
+#include "appiconatlas.h"
 #include "appinfomanager.h"
 
-AppIconJob::AppIconJob(const QString &appPath, qint64 iconId) :
-    AppBaseJob(appPath), m_iconId(iconId)
+namespace {
+constexpr int ICON_BATCH_MAX_COUNT = 32;
+}
+
+AppIconJob::AppIconJob(qint64 iconId) : m_iconIds({ iconId }) { }
+
+bool AppIconJob::mergeJob(const WorkerJob &job)
 {
+    const auto iconJob = dynamic_cast<const AppIconJob *>(&job);
+    if (!iconJob || m_iconIds.size() + iconJob->iconIds().size() > ICON_BATCH_MAX_COUNT)
+        return false;
+
+    for (const qint64 iconId : iconJob->iconIds()) {
+        if (!m_iconIds.contains(iconId)) {
+            m_iconIds.append(iconId);
+        }
+    }
+
+    return true;
 }
 
 void AppIconJob::doJob(WorkerObject &worker)
 {
-    loadAppIcon(static_cast<AppInfoManager *>(worker.manager()));
+    loadAppIcons(static_cast<AppInfoManager *>(worker.manager()));
 }
 
 void AppIconJob::reportResult(WorkerObject &worker)
@@ -19,13 +36,23 @@ void AppIconJob::reportResult(WorkerObject &worker)
     emitFinished(static_cast<AppInfoManager *>(worker.manager()));
 }
 
-void AppIconJob::loadAppIcon(AppInfoManager *manager)
+void AppIconJob::loadAppIcons(AppInfoManager *manager)
 {
-    // Try to load from DB
-    m_image = manager->loadIconFromDb(iconId());
+    m_images.reserve(m_iconIds.size());
+
+    for (const qint64 iconId : std::as_const(m_iconIds)) {
+        // Decode and scale here to keep the GUI thread work minimal
+        const QImage image = manager->loadIconFromDb(iconId);
+
+        m_images.append(AppIconAtlas::prepareImage(image));
+    }
 }
 
 void AppIconJob::emitFinished(AppInfoManager *manager)
 {
-    emit manager->lookupIconFinished(appPath(), m_image);
+    const int count = m_images.size();
+
+    for (int i = 0; i < count; ++i) {
+        emit manager->lookupIconFinished(m_iconIds.at(i), m_images.at(i));
+    }
 }
@@ -2,29 +2,31 @@
 #define APPICONJOB_H
 
 #include <QImage>
+#include <QVector>
 
-#include "appbasejob.h"
+#include <util/worker/workerjob.h>
 
 class AppInfoManager;
 
-class AppIconJob : public AppBaseJob
+class AppIconJob : public WorkerJob
 {
 public:
-    explicit AppIconJob(const QString &appPath, qint64 iconId);
+    explicit AppIconJob(qint64 iconId);
 
-    qint64 iconId() const { return m_iconId; }
+    const QVector<qint64> &iconIds() const { return m_iconIds; }
+
+    bool mergeJob(const WorkerJob &job) override;
 
     void doJob(WorkerObject &worker) override;
     void reportResult(WorkerObject &worker) override;
 
 private:
-    void loadAppIcon(AppInfoManager *manager);
+    void loadAppIcons(AppInfoManager *manager);
     void emitFinished(AppInfoManager *manager);
 
 private:
-    const qint64 m_iconId = 0;
-
-    QImage m_image;
+    QVector<qint64> m_iconIds;
+    QVector<QImage> m_images;
 };
 
 #endif // APPICONJOB_H
@@ -2,12 +2,17 @@
 
 #include <QIcon>
 #include <QImage>
+#include <QLoggingCategory>
 
 #include <util/iconcache.h>
 #include <util/ioc/ioccontainer.h>
 
 #include "appinfomanager.h"
 
+namespace {
+const QLoggingCategory LC("appInfo.cache");
+}
+
 AppInfoCache::AppInfoCache(QObject *parent) : QObject(parent), m_cache(1000)
 {
     connect(&m_triggerTimer, &QTimer::timeout, this, &AppInfoCache::cacheChanged);
@@ -26,11 +31,16 @@ void AppInfoCache::setUp()
 void AppInfoCache::tearDown()
 {
     disconnect(IoC<AppInfoManager>());
+
+    qCDebug(LC) << "Icon atlas: slots" << m_iconAtlas.usedSlotCount() << "of"
+                << m_iconAtlas.maxSlotCount() << "decoded" << m_iconAtlas.insertCount()
+                << "evicted" << m_iconAtlas.evictCount() << "hit ratio"
+                << m_iconAtlas.hitRatio();
 }
 
 QString AppInfoCache::appName(const QString &appPath)
 {
-    AppInfo appInfo = this->appInfo(appPath);
+    AppInfo appInfo = appInfoBrief(appPath);
     if (!appInfo.isValid()) {
         IoC<AppInfoManager>()->loadInfoFromFs(appPath, appInfo);
     }
@@ -39,26 +49,26 @@ QString AppInfoCache::appName(const QString &appPath)
 
 QPixmap AppInfoCache::appPixmap(const QString &appPath, const QString &nullIconPath)
 {
-    QPixmap pixmap;
-    if (IconCache::find(appPath, &pixmap))
-        return pixmap;
+    const qint64 iconId = appIconId(appPath);
 
-    const auto info = appInfo(appPath);
-    if (info.isValid()) {
-        IoC<AppInfoManager>()->lookupAppIcon(appPath, info.iconId);
-    }
+    const QPixmap pixmap = m_iconAtlas.pixmap(iconId);
+    if (!pixmap.isNull())
+        return pixmap;
 
-    pixmap = IconCache::file(
+    return IconCache::file(
             !nullIconPath.isEmpty() ? nullIconPath : ":/icons/application-window-96.png");
-
-    IconCache::insert(appPath, pixmap);
-
-    return pixmap;
 }
 
 QIcon AppInfoCache::appIcon(const QString &appPath, const QString &nullIconPath)
 {
-    return appPixmap(appPath, nullIconPath);
+    const qint64 iconId = appIconId(appPath);
+
+    const QIcon icon = m_iconAtlas.icon(iconId);
+    if (!icon.isNull())
+        return icon;
+
+    return IconCache::icon(
+            !nullIconPath.isEmpty() ? nullIconPath : ":/icons/application-window-96.png");
 }
 
 AppInfo AppInfoCache::appInfo(const QString &appPath)
@@ -82,25 +92,65 @@ AppInfo AppInfoCache::appInfo(const QString &appPath)
     return appInfo;
 }
 
+void AppInfoCache::prefetchAppInfos(const QStringList &appPaths)
+{
+    QStringList missingPaths;
+
+    for (const QString &appPath : appPaths) {
+        if (missingPaths.size() >= m_cache.maxCost())
+            break;
+
+        if (!appPath.isEmpty() && !m_cache.contains(appPath)) {
+            missingPaths.append(appPath);
+        }
+    }
+
+    auto appInfoManager = IoC<AppInfoManager>();
+
+    const auto appInfos = appInfoManager->loadInfosFromDb(missingPaths);
+
+    for (const QString &appPath : missingPaths) {
+        const auto it = appInfos.constFind(appPath);
+        const bool lookupRequired = (it == appInfos.constEnd());
+
+        if (lookupRequired) {
+            appInfoManager->lookupAppInfo(appPath);
+        }
+
+        m_cache.insert(appPath, lookupRequired ? new AppInfo() : new AppInfo(it.value()),
+                /*cost=*/1);
+    }
+}
+
 void AppInfoCache::handleFinishedInfoLookup(const QString &appPath, const AppInfo &info)
 {
+    m_appIconIds.remove(appPath); // invalidate cached icon id
+
     AppInfo *appInfo = m_cache.object(appPath);
     if (!appInfo)
         return;
 
+    const qint64 oldIconId = appInfo->iconId;
+
     *appInfo = info;
 
-    IconCache::remove(appPath); // invalidate cached icon
+    // The app's icon was replaced: the DB may give a freed icon id to the new image,
+    // so the atlas slot of the new id may still hold an old image
+    if (oldIconId != 0 && oldIconId != info.iconId) {
+        m_iconAtlas.remove(info.iconId);
+    }
 
     emitCacheChanged();
 }
 
-void AppInfoCache::handleFinishedIconLookup(const QString &appPath, const QImage &image)
+void AppInfoCache::handleFinishedIconLookup(qint64 iconId, const QImage &image)
 {
+    m_pendingIconIds.remove(iconId);
+
     if (image.isNull())
         return;
 
-    IconCache::insert(appPath, QPixmap::fromImage(image)); // update cached icon
+    m_iconAtlas.insert(iconId, image); // update cached icon
 
     emitCacheChanged();
 }
@@ -127,6 +177,53 @@ void AppInfoCache::appInfoCached(const QString &appPath, AppInfo &info, bool &lo
     }
 }
 
+AppInfo AppInfoCache::appInfoBrief(const QString &appPath)
+{
+    // Name and icon id from the mapped index, without a DB query
+    if (!appPath.isEmpty() && !m_cache.contains(appPath)) {
+        auto appInfoManager = IoC<AppInfoManager>();
+
+        AppInfo appInfo;
+        if (appInfoManager->loadInfoFromIndex(appPath, appInfo)) {
+            m_cache.insert(appPath, new AppInfo(appInfo), /*cost=*/1);
+
+            // The worker checks the file modification and loads the full info
+            appInfoManager->lookupAppInfo(appPath);
+
+            return appInfo;
+        }
+    }
+
+    return appInfo(appPath);
+}
+
+qint64 AppInfoCache::appIconId(const QString &appPath)
+{
+    constexpr int maxAppIconIdsCount = 10000;
+
+    if (appPath.isEmpty())
+        return 0;
+
+    auto it = m_appIconIds.constFind(appPath);
+    if (it == m_appIconIds.constEnd()) {
+        if (m_appIconIds.size() >= maxAppIconIdsCount) {
+            m_appIconIds.clear();
+        }
+
+        it = m_appIconIds.insert(appPath, appInfoBrief(appPath).iconId);
+    }
+
+    const qint64 iconId = it.value();
+
+    if (iconId != 0 && !m_iconAtlas.contains(iconId) && !m_pendingIconIds.contains(iconId)) {
+        m_pendingIconIds.insert(iconId);
+
+        IoC<AppInfoManager>()->lookupAppIcon(iconId);
+    }
+
+    return iconId;
+}
+
 void AppInfoCache::emitCacheChanged()
 {
     m_triggerTimer.startTrigger();
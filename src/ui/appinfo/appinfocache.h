@@ -3,10 +3,12 @@
 
 #include <QCache>
 #include <QObject>
+#include <QSet>
 
 #include <util/ioc/iocservice.h>
 #include <util/triggertimer.h>
 
+#include "appiconatlas.h"
 #include "appinfo.h"
 
 class AppInfoCache : public QObject, public IocService
@@ -16,6 +18,8 @@ class AppInfoCache : public QObject, public IocService
 public:
     explicit AppInfoCache(QObject *parent = nullptr);
 
+    const AppIconAtlas &iconAtlas() const { return m_iconAtlas; }
+
     void setUp() override;
     void tearDown() override;
 
@@ -26,21 +30,33 @@ public:
 
     AppInfo appInfo(const QString &appPath);
 
+    // Load the missing infos with batched DB queries
+    void prefetchAppInfos(const QStringList &appPaths);
+
 signals:
     void cacheChanged();
 
 private slots:
     void handleFinishedInfoLookup(const QString &appPath, const AppInfo &info);
-    void handleFinishedIconLookup(const QString &appPath, const QImage &image);
+    void handleFinishedIconLookup(qint64 iconId, const QImage &image);
 
 private:
     void appInfoCached(const QString &appPath, AppInfo &info, bool &lookupRequired);
 
+    AppInfo appInfoBrief(const QString &appPath);
+
+    qint64 appIconId(const QString &appPath);
+
     void emitCacheChanged();
 
 private:
     QCache<QString, AppInfo> m_cache;
 
+    QHash<QString, qint64> m_appIconIds;
+    QSet<qint64> m_pendingIconIds;
+
+    AppIconAtlas m_iconAtlas;
+
     TriggerTimer m_triggerTimer;
 };
 
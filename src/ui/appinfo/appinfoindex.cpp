@@ -0,0 +1,229 @@
+#include "appinfoindex.h"
+
+#include <algorithm>
+
+#include <QLoggingCategory>
+#include <QSaveFile>
+
+namespace {
+
+const QLoggingCategory LC("appInfo.index");
+
+constexpr quint32 indexMagic = 0x58444941; // "AIDX"
+constexpr quint32 indexVersion = 1;
+
+struct IndexHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 count;
+    quint32 textLength; // in UTF-16 code units
+};
+
+struct IndexEntry
+{
+    quint64 pathHash;
+    qint64 iconId;
+    qint64 fileModTime; // msecs since epoch
+    quint32 pathOffset;
+    quint32 pathLength;
+    quint32 altPathOffset;
+    quint32 altPathLength;
+    quint32 fileDescrOffset;
+    quint32 fileDescrLength;
+};
+
+// Stable across runs, unlike qHash()
+quint64 pathHash(const QString &path)
+{
+    quint64 hash = 0xCBF29CE484222325ULL;
+
+    for (const QChar c : path) {
+        hash ^= c.unicode();
+        hash *= 0x100000001B3ULL;
+    }
+
+    return hash;
+}
+
+const IndexHeader *indexHeader(const uchar *data)
+{
+    return reinterpret_cast<const IndexHeader *>(data);
+}
+
+const IndexEntry *indexEntries(const uchar *data)
+{
+    return reinterpret_cast<const IndexEntry *>(data + sizeof(IndexHeader));
+}
+
+qint64 indexTextOffset(quint32 count)
+{
+    return qint64(sizeof(IndexHeader)) + qint64(count) * qint64(sizeof(IndexEntry));
+}
+
+void appendText(QString &texts, const QString &text, quint32 &offset, quint32 &length)
+{
+    offset = quint32(texts.size());
+    length = quint32(text.size());
+
+    texts.append(text);
+}
+
+}
+
+AppInfoIndex::AppInfoIndex(const QString &filePath) : m_file(filePath) { }
+
+AppInfoIndex::~AppInfoIndex()
+{
+    close();
+}
+
+int AppInfoIndex::count() const
+{
+    return isOpen() ? int(indexHeader(m_data)->count) : 0;
+}
+
+bool AppInfoIndex::open()
+{
+    if (m_file.fileName().isEmpty() || !m_file.exists())
+        return false;
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qCWarning(LC) << "File open error:" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+
+    if (fileSize >= qint64(sizeof(IndexHeader))) {
+        m_data = m_file.map(0, fileSize);
+        m_dataSize = fileSize;
+    }
+
+    if (!m_data) {
+        close();
+        return false;
+    }
+
+    const IndexHeader *header = indexHeader(m_data);
+
+    if (header->magic != indexMagic || header->version != indexVersion
+            || m_dataSize
+                    < indexTextOffset(header->count)
+                            + qint64(header->textLength) * qint64(sizeof(char16_t))) {
+        qCWarning(LC) << "Bad index file:" << m_file.fileName();
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void AppInfoIndex::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar *>(m_data));
+        m_data = nullptr;
+        m_dataSize = 0;
+    }
+
+    m_file.close();
+}
+
+bool AppInfoIndex::find(const QString &appPath, AppInfo &appInfo) const
+{
+    if (!isOpen())
+        return false;
+
+    const quint32 count = indexHeader(m_data)->count;
+    const IndexEntry *entries = indexEntries(m_data);
+    const IndexEntry *entriesEnd = entries + count;
+
+    const quint64 hash = pathHash(appPath);
+
+    const IndexEntry *entry = std::lower_bound(entries, entriesEnd, hash,
+            [](const IndexEntry &e, quint64 h) { return e.pathHash < h; });
+
+    for (; entry != entriesEnd && entry->pathHash == hash; ++entry) {
+        const char16_t *path = text(entry->pathOffset, entry->pathLength);
+        if (!path || QStringView(path, entry->pathLength) != appPath)
+            continue;
+
+        const char16_t *altPath = text(entry->altPathOffset, entry->altPathLength);
+        const char16_t *fileDescr = text(entry->fileDescrOffset, entry->fileDescrLength);
+        if (!altPath || !fileDescr)
+            return false;
+
+        appInfo.iconId = entry->iconId;
+        appInfo.fileModTime = QDateTime::fromMSecsSinceEpoch(entry->fileModTime);
+        appInfo.altPath = QStringView(altPath, entry->altPathLength).toString();
+        appInfo.fileDescription = QStringView(fileDescr, entry->fileDescrLength).toString();
+
+        return true;
+    }
+
+    return false;
+}
+
+bool AppInfoIndex::write(const QString &filePath, const QHash<QString, AppInfo> &appInfos)
+{
+    QVector<IndexEntry> entries;
+    entries.reserve(appInfos.size());
+
+    QString texts;
+
+    for (auto it = appInfos.constBegin(); it != appInfos.constEnd(); ++it) {
+        const QString &appPath = it.key();
+        const AppInfo &appInfo = it.value();
+
+        IndexEntry entry;
+        entry.pathHash = pathHash(appPath);
+        entry.iconId = appInfo.iconId;
+        entry.fileModTime = appInfo.fileModTime.toMSecsSinceEpoch();
+
+        appendText(texts, appPath, entry.pathOffset, entry.pathLength);
+        appendText(texts, appInfo.altPath, entry.altPathOffset, entry.altPathLength);
+        appendText(texts, appInfo.fileDescription, entry.fileDescrOffset, entry.fileDescrLength);
+
+        entries.append(entry);
+    }
+
+    std::sort(entries.begin(), entries.end(),
+            [](const IndexEntry &a, const IndexEntry &b) { return a.pathHash < b.pathHash; });
+
+    const IndexHeader header = {
+        .magic = indexMagic,
+        .version = indexVersion,
+        .count = quint32(entries.size()),
+        .textLength = quint32(texts.size()),
+    };
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(LC) << "File open error:" << filePath << file.errorString();
+        return false;
+    }
+
+    file.write((const char *) &header, sizeof(header));
+    file.write((const char *) entries.constData(), entries.size() * sizeof(IndexEntry));
+    file.write((const char *) texts.utf16(), texts.size() * sizeof(char16_t));
+
+    if (!file.commit()) {
+        qCWarning(LC) << "File write error:" << filePath << file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+const char16_t *AppInfoIndex::text(quint32 offset, quint32 length) const
+{
+    const IndexHeader *header = indexHeader(m_data);
+
+    if (quint64(offset) + length > header->textLength)
+        return nullptr;
+
+    const uchar *texts = m_data + indexTextOffset(header->count);
+
+    return reinterpret_cast<const char16_t *>(texts) + offset;
+}
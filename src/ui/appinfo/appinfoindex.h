@@ -0,0 +1,43 @@
+#ifndef APPINFOINDEX_H
+#define APPINFOINDEX_H
+
+#include <QFile>
+#include <QHash>
+
+#include <util/classhelpers.h>
+
+#include "appinfo.h"
+
+// Compact read-only snapshot of app names and icon ids, memory-mapped at startup
+class AppInfoIndex
+{
+public:
+    explicit AppInfoIndex(const QString &filePath = QString());
+    ~AppInfoIndex();
+    CLASS_DELETE_COPY_MOVE(AppInfoIndex)
+
+    QString filePath() const { return m_file.fileName(); }
+
+    bool isOpen() const { return m_data != nullptr; }
+
+    int count() const;
+
+    bool open();
+    void close();
+
+    // Fills only the alternate path, file description, modification time and icon id
+    bool find(const QString &appPath, AppInfo &appInfo) const;
+
+    static bool write(const QString &filePath, const QHash<QString, AppInfo> &appInfos);
+
+private:
+    const char16_t *text(quint32 offset, quint32 length) const;
+
+private:
+    QFile m_file;
+
+    const uchar *m_data = nullptr;
+    qint64 m_dataSize = 0;
+};
+
+#endif // APPINFOINDEX_H
@@ -1,5 +1,6 @@
 #include "appinfomanager.h"
 
+#include <QFileInfo>
 #include <QImage>
 #include <QLoggingCategory>
 
@@ -20,6 +21,8 @@ constexpr int DATABASE_USER_VERSION = 6;
 
 constexpr int APP_CACHE_MAX_COUNT = 2000;
 
+constexpr int APP_BATCH_MAX_COUNT = 32;
+
 const char *const sqlSelectAppInfo = "SELECT alt_path, file_descr, company_name,"
                                      "    product_name, product_ver, file_mod_time, icon_id"
                                      "  FROM app WHERE path = ?1;";
@@ -28,6 +31,10 @@ const char *const sqlUpdateAppAccessTime = "UPDATE app"
                                            "  SET access_time = datetime('now')"
                                            "  WHERE path = ?1;";
 
+const char *const sqlSelectAppIndexInfos = "SELECT path, alt_path, file_descr, file_mod_time,"
+                                           "    icon_id"
+                                           "  FROM app;";
+
 const char *const sqlSelectIconImage = "SELECT image FROM icon WHERE icon_id = ?1;";
 
 const char *const sqlSelectIconIdByHash = "SELECT icon_id FROM icon WHERE hash = ?1;";
@@ -56,10 +63,62 @@ const char *const sqlDeleteIconIfNotUsed = "DELETE FROM icon"
 
 const char *const sqlDeleteApp = "DELETE FROM app WHERE path = ?1;";
 
+// Appends "?1, ?2, ..., ?N);" for the batched path lists
+QByteArray sqlPathList(const char *sql)
+{
+    QByteArray res(sql);
+
+    for (int i = 1; i <= APP_BATCH_MAX_COUNT; ++i) {
+        res += (i == 1 ? "?" : ", ?") + QByteArray::number(i);
+    }
+
+    return res + ");";
+}
+
+const char *sqlSelectAppInfos()
+{
+    static const QByteArray sql =
+            sqlPathList("SELECT path, alt_path, file_descr, company_name,"
+                        "    product_name, product_ver, file_mod_time, icon_id"
+                        "  FROM app WHERE path IN (");
+    return sql.constData();
+}
+
+const char *sqlUpdateAppsAccessTime()
+{
+    static const QByteArray sql = sqlPathList("UPDATE app"
+                                              "  SET access_time = datetime('now')"
+                                              "  WHERE path IN (");
+    return sql.constData();
+}
+
+QString indexFilePath(const QString &dbFilePath)
+{
+    if (dbFilePath.isEmpty() || dbFilePath.startsWith(':'))
+        return {}; // in-memory database
+
+    const QFileInfo fi(dbFilePath);
+
+    return fi.path() + '/' + fi.completeBaseName() + ".idx";
+}
+
+void fillAppInfo(SqliteStmt *stmt, int column, AppInfo &appInfo)
+{
+    appInfo.altPath = stmt->columnText(column + 0);
+    appInfo.fileDescription = stmt->columnText(column + 1);
+    appInfo.companyName = stmt->columnText(column + 2);
+    appInfo.productName = stmt->columnText(column + 3);
+    appInfo.productVersion = stmt->columnText(column + 4);
+    appInfo.fileModTime = stmt->columnDateTime(column + 5);
+    appInfo.iconId = stmt->columnInt64(column + 6);
+}
+
 }
 
 AppInfoManager::AppInfoManager(const QString &filePath, QObject *parent, quint32 openFlags) :
-    WorkerManager(parent), m_sqliteDb(new SqliteDb(filePath, openFlags))
+    WorkerManager(parent),
+    m_sqliteDb(new SqliteDb(filePath, openFlags)),
+    m_index(indexFilePath(filePath))
 {
     setMaxWorkersCount(1);
 }
@@ -67,6 +126,15 @@ AppInfoManager::AppInfoManager(const QString &filePath, QObject *parent, quint32
 void AppInfoManager::setUp()
 {
     setupDb();
+    setupIndex();
+
+    connect(this, &AppInfoManager::lookupInfoFinished, this,
+            [this](const QString &appPath) { invalidateIndexPath(appPath); });
+}
+
+void AppInfoManager::tearDown()
+{
+    saveIndex();
 }
 
 WorkerObject *AppInfoManager::createWorker()
@@ -79,9 +147,9 @@ void AppInfoManager::lookupAppInfo(const QString &appPath)
     enqueueJob(WorkerJobPtr(new AppInfoJob(appPath)));
 }
 
-void AppInfoManager::lookupAppIcon(const QString &appPath, qint64 iconId)
+void AppInfoManager::lookupAppIcon(qint64 iconId)
 {
-    enqueueJob(WorkerJobPtr(new AppIconJob(appPath, iconId)));
+    enqueueJob(WorkerJobPtr(new AppIconJob(iconId)));
 }
 
 void AppInfoManager::checkLookupInfoFinished(const QString &appPath)
@@ -110,22 +178,19 @@ bool AppInfoManager::loadInfoFromDb(const QString &appPath, AppInfo &appInfo)
     QMutexLocker locker(&m_mutex);
 
     // Load version info
-    SqliteStmt stmt;
-    if (!stmt.prepare(sqliteDb()->db(), sqlSelectAppInfo))
-        return false;
+    SqliteStmt *stmt = sqliteDb()->stmt(sqlSelectAppInfo);
 
-    stmt.bindText(1, appPath);
+    stmt->bindText(1, appPath);
 
-    if (stmt.step() != SqliteStmt::StepRow)
-        return false;
+    const bool ok = (stmt->step() == SqliteStmt::StepRow);
+    if (ok) {
+        fillAppInfo(stmt, /*column=*/0, appInfo);
+    }
 
-    appInfo.altPath = stmt.columnText(0);
-    appInfo.fileDescription = stmt.columnText(1);
-    appInfo.companyName = stmt.columnText(2);
-    appInfo.productName = stmt.columnText(3);
-    appInfo.productVersion = stmt.columnText(4);
-    appInfo.fileModTime = stmt.columnDateTime(5);
-    appInfo.iconId = stmt.columnInt64(6);
+    stmt->reset();
+
+    if (!ok)
+        return false;
 
     // Update last access time
     updateAppAccessTime(appPath);
@@ -133,9 +198,96 @@ bool AppInfoManager::loadInfoFromDb(const QString &appPath, AppInfo &appInfo)
     return true;
 }
 
+QHash<QString, AppInfo> AppInfoManager::loadInfosFromDb(const QStringList &appPaths)
+{
+    QHash<QString, AppInfo> appInfos;
+
+    if (appPaths.isEmpty())
+        return appInfos;
+
+    QMutexLocker locker(&m_mutex);
+
+    const int pathsCount = appPaths.size();
+
+    for (int i = 0; i < pathsCount; i += APP_BATCH_MAX_COUNT) {
+        const int count = qMin(pathsCount - i, APP_BATCH_MAX_COUNT);
+
+        loadInfosFromDbBatch(appPaths, i, count, appInfos);
+    }
+
+    // Update last access time
+    if (!appInfos.isEmpty()) {
+        updateAppsAccessTime(appInfos.keys());
+    }
+
+    return appInfos;
+}
+
+void AppInfoManager::loadInfosFromDbBatch(
+        const QStringList &appPaths, int index, int count, QHash<QString, AppInfo> &appInfos)
+{
+    SqliteStmt *stmt = sqliteDb()->stmt(sqlSelectAppInfos());
+
+    for (int i = 0; i < APP_BATCH_MAX_COUNT; ++i) {
+        if (i < count) {
+            stmt->bindText(i + 1, appPaths.at(index + i));
+        } else {
+            stmt->bindNull(i + 1);
+        }
+    }
+
+    while (stmt->step() == SqliteStmt::StepRow) {
+        AppInfo appInfo;
+        fillAppInfo(stmt, /*column=*/1, appInfo);
+
+        appInfos.insert(stmt->columnText(0), appInfo);
+    }
+
+    stmt->reset();
+}
+
+bool AppInfoManager::loadInfoFromIndex(const QString &appPath, AppInfo &appInfo)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_indexStalePaths.contains(appPath))
+        return false;
+
+    return m_index.find(appPath, appInfo);
+}
+
 void AppInfoManager::updateAppAccessTime(const QString &appPath)
 {
-    DbQuery(sqliteDb()).sql(sqlUpdateAppAccessTime).vars({ appPath }).executeOk();
+    SqliteStmt *stmt = sqliteDb()->stmt(sqlUpdateAppAccessTime);
+
+    stmt->bindText(1, appPath);
+
+    sqliteDb()->done(stmt);
+}
+
+void AppInfoManager::updateAppsAccessTime(const QStringList &appPaths)
+{
+    const int pathsCount = appPaths.size();
+
+    sqliteDb()->beginWriteTransaction();
+
+    for (int i = 0; i < pathsCount; i += APP_BATCH_MAX_COUNT) {
+        SqliteStmt *stmt = sqliteDb()->stmt(sqlUpdateAppsAccessTime());
+
+        for (int j = 0; j < APP_BATCH_MAX_COUNT; ++j) {
+            const int index = i + j;
+
+            if (index < pathsCount) {
+                stmt->bindText(j + 1, appPaths.at(index));
+            } else {
+                stmt->bindNull(j + 1);
+            }
+        }
+
+        sqliteDb()->done(stmt);
+    }
+
+    sqliteDb()->commitTransaction();
 }
 
 bool AppInfoManager::setupDb()
@@ -161,6 +313,57 @@ bool AppInfoManager::setupDb()
     return true;
 }
 
+void AppInfoManager::setupIndex()
+{
+    if (m_index.open()) {
+        qCDebug(LC) << "Index mapped:" << m_index.filePath() << m_index.count();
+    }
+}
+
+void AppInfoManager::saveIndex()
+{
+    if (m_index.filePath().isEmpty() || (sqliteDb()->openFlags() & SqliteDb::OpenReadOnly) != 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    QHash<QString, AppInfo> appInfos;
+
+    SqliteStmt stmt;
+    if (!stmt.prepare(sqliteDb()->db(), sqlSelectAppIndexInfos))
+        return;
+
+    while (stmt.step() == SqliteStmt::StepRow) {
+        AppInfo appInfo;
+        appInfo.altPath = stmt.columnText(1);
+        appInfo.fileDescription = stmt.columnText(2);
+        appInfo.fileModTime = stmt.columnDateTime(3);
+        appInfo.iconId = stmt.columnInt64(4);
+
+        appInfos.insert(stmt.columnText(0), appInfo);
+    }
+
+    // Unmap the old snapshot to replace it
+    m_index.close();
+    m_indexStalePaths.clear();
+
+    AppInfoIndex::write(m_index.filePath(), appInfos);
+}
+
+void AppInfoManager::invalidateIndexPath(const QString &appPath)
+{
+    QMutexLocker locker(&m_mutex);
+
+    setIndexPathStale(appPath);
+}
+
+void AppInfoManager::setIndexPathStale(const QString &appPath)
+{
+    if (m_index.isOpen()) {
+        m_indexStalePaths.insert(appPath);
+    }
+}
+
 void AppInfoManager::saveAppIcon(const QImage &appIcon, QVariant &iconId, bool &ok)
 {
     const uint iconHash = uint(qHashBits(appIcon.constBits(), size_t(appIcon.sizeInBytes())));
@@ -240,6 +443,8 @@ bool AppInfoManager::saveToDb(const QString &appPath, AppInfo &appInfo, const QI
     if (ok) {
         appInfo.iconId = iconId.toLongLong();
 
+        setIndexPathStale(appPath);
+
         // Delete excess info
         deleteExcessAppInfos();
     }
@@ -354,5 +559,7 @@ void AppInfoManager::deleteApps(const QStringList &appPaths, bool &ok)
 
 void AppInfoManager::deleteApp(const QString &appPath, bool &ok)
 {
+    setIndexPathStale(appPath);
+
     DbQuery(sqliteDb(), &ok).sql(sqlDeleteApp).vars({ appPath }).executeOk();
 }
@@ -2,6 +2,7 @@
 #define APPINFOMANAGER_H
 
 #include <QMutex>
+#include <QSet>
 
 #include <sqlite/sqlitetypes.h>
 
@@ -10,6 +11,7 @@
 #include <util/worker/workermanager.h>
 
 #include "appinfo.h"
+#include "appinfoindex.h"
 
 class AppInfoManager : public WorkerManager, public IocService
 {
@@ -23,11 +25,15 @@ public:
     SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
 
     void setUp() override;
+    void tearDown() override;
 
     bool loadInfoFromFs(const QString &appPath, AppInfo &appInfo);
     QImage loadIconFromFs(const QString &appPath, const AppInfo &appInfo);
 
     bool loadInfoFromDb(const QString &appPath, AppInfo &appInfo);
+    QHash<QString, AppInfo> loadInfosFromDb(const QStringList &appPaths);
+
+    bool loadInfoFromIndex(const QString &appPath, AppInfo &appInfo);
     QImage loadIconFromDb(qint64 iconId);
 
     bool saveToDb(const QString &appPath, AppInfo &appInfo, const QImage &appIcon);
@@ -37,22 +43,33 @@ public:
 
 signals:
     void lookupInfoFinished(const QString &appPath, const AppInfo &appInfo);
-    void lookupIconFinished(const QString &appPath, const QImage &image);
+    void lookupIconFinished(qint64 iconId, const QImage &image);
 
 public slots:
     virtual void lookupAppInfo(const QString &appPath);
-    void lookupAppIcon(const QString &appPath, qint64 iconId);
+    void lookupAppIcon(qint64 iconId);
 
     void checkLookupInfoFinished(const QString &appPath);
 
 protected:
     WorkerObject *createWorker() override;
+    bool canMergeJobs() const override { return true; }
 
     virtual void updateAppAccessTime(const QString &appPath);
+    virtual void updateAppsAccessTime(const QStringList &appPaths);
 
 private:
     bool setupDb();
 
+    void setupIndex();
+    void saveIndex();
+
+    void invalidateIndexPath(const QString &appPath);
+    void setIndexPathStale(const QString &appPath);
+
+    void loadInfosFromDbBatch(const QStringList &appPaths, int index, int count,
+            QHash<QString, AppInfo> &appInfos);
+
     void saveAppIcon(const QImage &appIcon, QVariant &iconId, bool &ok);
     void saveAppInfo(
             const QString &appPath, const AppInfo &appInfo, const QVariant &iconId, bool &ok);
@@ -72,6 +89,9 @@ private:
 private:
     SqliteDbPtr m_sqliteDb;
     QMutex m_mutex;
+
+    AppInfoIndex m_index;
+    QSet<QString> m_indexStalePaths;
 };
 
 #endif // APPINFOMANAGER_H
@@ -1,5 +1,6 @@
 #include "appinfoutil.h"
 
+#include <QDir>
 #include <QImage>
 #include <QVarLengthArray>
 
@@ -254,6 +255,18 @@ bool fileExists(const QString &appPath)
     return res;
 }
 
+QStringList fileNames(const QString &dirPath)
+{
+    const auto wow64FsRedir = disableWow64FsRedirection();
+
+    const QStringList res =
+            QDir(dirPath).entryList(QDir::Files | QDir::Hidden | QDir::System, QDir::NoSort);
+
+    revertWow64FsRedirection(wow64FsRedir);
+
+    return res;
+}
+
 QDateTime fileModTime(const QString &appPath)
 {
     if (appPath.isEmpty() || FileUtil::isSystemApp(appPath))
@@ -15,6 +15,7 @@ void initThread();
 void doneThread();
 
 bool fileExists(const QString &appPath);
+QStringList fileNames(const QString &dirPath);
 QDateTime fileModTime(const QString &appPath);
 
 bool openFolder(const QString &appPath);
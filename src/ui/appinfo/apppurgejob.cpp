@@ -0,0 +1,82 @@
+#include "apppurgejob.h"
+
+#include <QHash>
+#include <QSet>
+
+#include <util/worker/workermanager.h>
+#include <util/worker/workerobject.h>
+
+#include "apppurgemanager.h"
+#include "appinfoutil.h"
+
+namespace {
+
+int pathSeparatorIndex(const QString &path)
+{
+    return qMax(path.lastIndexOf('\\'), path.lastIndexOf('/'));
+}
+
+}
+
+AppPurgeJob::AppPurgeJob(const QString &dirPath) : WorkerJob(dirPath) { }
+
+void AppPurgeJob::checkApps(const WorkerManager *manager)
+{
+    // One listing answers for all files of the directory
+    QSet<QString> fileNames;
+    for (const QString &fileName : AppInfoUtil::fileNames(dirPath())) {
+        fileNames.insert(fileName.toLower());
+    }
+
+    for (const AppPurgeEntry &app : std::as_const(m_apps)) {
+        if (manager && manager->aborted())
+            break;
+
+        ++m_checkedCount;
+
+        const QString fileName = app.appPath.mid(pathSeparatorIndex(app.appPath) + 1).toLower();
+        if (fileNames.contains(fileName))
+            continue;
+
+        // The directory may be not listable, check the file itself
+        if (!AppInfoUtil::fileExists(app.appPath)) {
+            m_obsoleteAppIds.append(app.appId);
+        }
+    }
+}
+
+void AppPurgeJob::doJob(WorkerObject &worker)
+{
+    checkApps(worker.manager());
+}
+
+void AppPurgeJob::reportResult(WorkerObject &worker)
+{
+    auto manager = static_cast<AppPurgeManager *>(worker.manager());
+
+    emit manager->appsChecked(m_obsoleteAppIds, m_checkedCount);
+}
+
+QVector<AppPurgeJobPtr> AppPurgeJob::createJobs(const QVector<AppPurgeEntry> &apps)
+{
+    QVector<AppPurgeJobPtr> jobs;
+    QHash<QString, int> jobIndexes;
+
+    for (const AppPurgeEntry &app : apps) {
+        // With the trailing separator for the drive's root directory
+        const QString dirPath = app.appPath.left(pathSeparatorIndex(app.appPath) + 1);
+        const QString dirKey = dirPath.toLower();
+
+        int jobIndex = jobIndexes.value(dirKey, -1);
+        if (jobIndex < 0) {
+            jobIndex = jobs.size();
+            jobIndexes.insert(dirKey, jobIndex);
+
+            jobs.append(AppPurgeJobPtr::create(dirPath));
+        }
+
+        jobs[jobIndex]->addApp(app);
+    }
+
+    return jobs;
+}
@@ -0,0 +1,47 @@
+#ifndef APPPURGEJOB_H
+#define APPPURGEJOB_H
+
+#include <QVector>
+
+#include <util/worker/workerjob.h>
+
+struct AppPurgeEntry
+{
+    qint64 appId = 0;
+    QString appPath;
+};
+
+class AppPurgeJob;
+
+using AppPurgeJobPtr = QSharedPointer<AppPurgeJob>;
+
+// Checks the existence of the apps of one directory
+class AppPurgeJob : public WorkerJob
+{
+public:
+    explicit AppPurgeJob(const QString &dirPath);
+
+    const QString &dirPath() const { return text(); }
+
+    const QVector<AppPurgeEntry> &apps() const { return m_apps; }
+    void addApp(const AppPurgeEntry &app) { m_apps.append(app); }
+
+    int checkedCount() const { return m_checkedCount; }
+    const QVector<qint64> &obsoleteAppIds() const { return m_obsoleteAppIds; }
+
+    void checkApps(const WorkerManager *manager = nullptr);
+
+    void doJob(WorkerObject &worker) override;
+    void reportResult(WorkerObject &worker) override;
+
+    // Group the apps by directories
+    static QVector<AppPurgeJobPtr> createJobs(const QVector<AppPurgeEntry> &apps);
+
+private:
+    int m_checkedCount = 0;
+
+    QVector<AppPurgeEntry> m_apps;
+    QVector<qint64> m_obsoleteAppIds;
+};
+
+#endif // APPPURGEJOB_H
@@ -0,0 +1,48 @@
+#include "apppurgemanager.h"
+
+#include <QThread>
+
+namespace {
+
+constexpr int APP_PURGE_WORKERS_MAX = 4;
+
+}
+
+AppPurgeManager::AppPurgeManager(QObject *parent) : WorkerManager(parent)
+{
+    setMaxWorkersCount(qBound(1, QThread::idealThreadCount(), APP_PURGE_WORKERS_MAX));
+
+    connect(this, &AppPurgeManager::appsChecked, this, &AppPurgeManager::onAppsChecked,
+            Qt::QueuedConnection);
+}
+
+void AppPurgeManager::checkApps(const QVector<AppPurgeEntry> &apps)
+{
+    m_totalCount = apps.size();
+    m_checkedCount = 0;
+    m_obsoleteAppIds.clear();
+
+    if (apps.isEmpty()) {
+        emit checkFinished(m_obsoleteAppIds);
+        return;
+    }
+
+    for (const AppPurgeJobPtr &job : AppPurgeJob::createJobs(apps)) {
+        enqueueJob(job);
+    }
+}
+
+void AppPurgeManager::onAppsChecked(const QVector<qint64> &obsoleteAppIds, int checkedCount)
+{
+    if (aborted())
+        return;
+
+    m_checkedCount += checkedCount;
+    m_obsoleteAppIds += obsoleteAppIds;
+
+    emit progressChanged(m_checkedCount, m_totalCount);
+
+    if (m_checkedCount >= m_totalCount) {
+        emit checkFinished(m_obsoleteAppIds);
+    }
+}
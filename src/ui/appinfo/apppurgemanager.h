@@ -0,0 +1,44 @@
+#ifndef APPPURGEMANAGER_H
+#define APPPURGEMANAGER_H
+
+#include <util/classhelpers.h>
+#include <util/worker/workermanager.h>
+
+#include "apppurgejob.h"
+
+// Checks the existence of the apps in parallel
+class AppPurgeManager : public WorkerManager
+{
+    Q_OBJECT
+
+public:
+    explicit AppPurgeManager(QObject *parent = nullptr);
+    CLASS_DELETE_COPY_MOVE(AppPurgeManager)
+
+    int totalCount() const { return m_totalCount; }
+    int checkedCount() const { return m_checkedCount; }
+
+    const QVector<qint64> &obsoleteAppIds() const { return m_obsoleteAppIds; }
+
+    QString workerName() const override { return "AppPurgeWorker"; }
+
+signals:
+    void appsChecked(const QVector<qint64> &obsoleteAppIds, int checkedCount);
+
+    void progressChanged(int checkedCount, int totalCount);
+    void checkFinished(const QVector<qint64> &obsoleteAppIds);
+
+public slots:
+    void checkApps(const QVector<AppPurgeEntry> &apps);
+
+private:
+    void onAppsChecked(const QVector<qint64> &obsoleteAppIds, int checkedCount);
+
+private:
+    int m_totalCount = 0;
+    int m_checkedCount = 0;
+
+    QVector<qint64> m_obsoleteAppIds;
+};
+
+#endif // APPPURGEMANAGER_H
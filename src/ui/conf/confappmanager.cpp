@@ -8,13 +8,15 @@
 #include <sqlite/sqlitestmt.h>
 
 #include <appinfo/appinfocache.h>
-#include <appinfo/appinfoutil.h>
+#include <appinfo/apppurgejob.h>
 #include <conf/app.h>
 #include <driver/drivermanager.h>
 #include <log/logentryblocked.h>
 #include <log/logmanager.h>
 #include <manager/drivelistmanager.h>
 #include <manager/envmanager.h>
+#include <task/taskinfo.h>
+#include <task/taskmanager.h>
 #include <util/conf/confutil.h>
 #include <util/dateutil.h>
 #include <util/fileutil.h>
@@ -55,10 +57,10 @@ constexpr int APP_END_TIMER_INTERVAL_MAX = 24 * 60 * 60 * 1000; // 1 day
     "    g.order_index as group_index,"                                                            \
     "    (alert.app_id IS NOT NULL) as alerted"
 
-const char *const sqlSelectAppById = "SELECT" SELECT_APP_FIELDS "  FROM app t"
-                                     "    JOIN app_group g ON g.app_group_id = t.app_group_id"
-                                     "    LEFT JOIN app_alert alert ON alert.app_id = t.app_id"
-                                     "    WHERE t.app_id = ?1;";
+const char *const sqlSelectAppsByIds = "SELECT" SELECT_APP_FIELDS "  FROM app t"
+                                       "    JOIN app_group g ON g.app_group_id = t.app_group_id"
+                                       "    LEFT JOIN app_alert alert ON alert.app_id = t.app_id"
+                                       "    WHERE t.app_id IN (%1);";
 
 const char *const sqlSelectApps = "SELECT" SELECT_APP_FIELDS "  FROM app t"
                                   "    JOIN app_group g ON g.app_group_id = t.app_group_id"
@@ -80,6 +82,9 @@ const char *const sqlSelectEndedApps = "SELECT" SELECT_APP_FIELDS "  FROM app t"
 
 const char *const sqlSelectAppIdByPath = "SELECT app_id FROM app WHERE path = ?1;";
 
+const char *const sqlSelectAppIdsByPath =
+        "SELECT app_id, app_group_id FROM app WHERE path = ?1;";
+
 const char *const sqlUpsertApp = "INSERT INTO app(app_group_id, origin_path, path, name, notes,"
                                  "    is_wildcard, use_group_perm, apply_child, kill_child,"
                                  "    lan_only, parked, log_blocked, log_conn,"
@@ -110,18 +115,33 @@ const char *const sqlUpdateApp = "UPDATE app"
 
 const char *const sqlUpdateAppName = "UPDATE app SET name = ?2 WHERE app_id = ?1;";
 
-const char *const sqlDeleteApp = "DELETE FROM app WHERE app_id = ?1 RETURNING path, is_wildcard;";
+const char *const sqlDeleteApps = "DELETE FROM app WHERE app_id IN (%1)"
+                                  "  RETURNING path, is_wildcard;";
 
 const char *const sqlInsertAppAlert = "INSERT INTO app_alert(app_id) VALUES(?1);";
 
 const char *const sqlDeleteAppAlert = "DELETE FROM app_alert WHERE app_id = ?1;";
 
-const char *const sqlUpdateAppBlocked = "UPDATE app SET blocked = ?2, kill_process = ?3"
-                                        "  WHERE app_id = ?1;";
+const char *const sqlUpdateAppsBlocked = "UPDATE app SET blocked = ?1, kill_process = ?2"
+                                         "  WHERE app_id IN (%1);";
+
+const char *const sqlDeleteAppsAlert = "DELETE FROM app_alert WHERE app_id IN (%1);";
 
 using AppsMap = QHash<qint64, QString>;
 using AppIdsArray = QVector<qint64>;
 
+QString sqlWithAppIds(const char *sql, const QVector<qint64> &appIdList)
+{
+    QStringList appIds;
+    appIds.reserve(appIdList.size());
+
+    for (const qint64 appId : appIdList) {
+        appIds.append(QString::number(appId));
+    }
+
+    return QString::fromLatin1(sql).arg(appIds.join(','));
+}
+
 }
 
 ConfAppManager::ConfAppManager(QObject *parent) : QObject(parent)
@@ -297,6 +317,20 @@ qint64 ConfAppManager::appIdByPath(const QString &appOriginPath, QString &normPa
     return DbQuery(sqliteDb()).sql(sqlSelectAppIdByPath).vars({ normPath }).execute().toLongLong();
 }
 
+bool ConfAppManager::appIdsByPath(const QString &appPath, qint64 &appId, qint64 &appGroupId)
+{
+    const QString normPath = FileUtil::normalizePath(appPath);
+
+    SqliteStmt stmt;
+    if (!DbQuery(sqliteDb()).sql(sqlSelectAppIdsByPath).vars({ normPath }).prepareRow(stmt))
+        return false;
+
+    appId = stmt.columnInt64(0);
+    appGroupId = stmt.columnInt64(1);
+
+    return true;
+}
+
 bool ConfAppManager::addOrUpdateAppPath(
         const QString &appOriginPath, bool blocked, bool killProcess)
 {
@@ -381,11 +415,9 @@ bool ConfAppManager::deleteApps(const QVector<qint64> &appIdList)
     bool ok = true;
     bool isWildcard = false;
 
-    for (const qint64 appId : appIdList) {
-        if (!deleteApp(appId, isWildcard)) {
-            ok = false;
-            break;
-        }
+    // Bounded transactions to not lock the DB for long
+    for (int i = 0; ok && i < appIdList.size(); i += DeleteAppsChunkSize) {
+        ok = deleteAppsChunk(appIdList.mid(i, DeleteAppsChunkSize), isWildcard);
     }
 
     if (isWildcard) {
@@ -395,28 +427,36 @@ bool ConfAppManager::deleteApps(const QVector<qint64> &appIdList)
     return ok;
 }
 
-bool ConfAppManager::deleteApp(qint64 appId, bool &isWildcard)
+bool ConfAppManager::deleteAppsChunk(const QVector<qint64> &appIdList, bool &isWildcard)
 {
     bool ok = false;
+    QStringList appPaths;
 
     beginTransaction();
+    {
+        SqliteStmt stmt;
+        if (DbQuery(sqliteDb()).sql(sqlWithAppIds(sqlDeleteApps, appIdList)).prepare(stmt)) {
+            SqliteStmt::StepResult res;
+            while ((res = stmt.step()) == SqliteStmt::StepRow) {
+                if (stmt.columnBool(1)) {
+                    isWildcard = true;
+                } else {
+                    appPaths.append(stmt.columnText(0));
+                }
+            }
 
-    const QVariantList vars = { appId };
-
-    const auto resList = DbQuery(sqliteDb(), &ok).sql(sqlDeleteApp).vars(vars).execute(2).toList();
+            ok = (res == SqliteStmt::StepDone);
+        }
+    }
 
     if (ok) {
-        DbQuery(sqliteDb(), &ok).sql(sqlDeleteAppAlert).vars(vars).executeOk();
+        DbQuery(sqliteDb(), &ok).sql(sqlWithAppIds(sqlDeleteAppsAlert, appIdList)).executeOk();
     }
 
     commitTransaction(ok);
 
     if (ok) {
-        const QString appPath = resList.at(0).toString();
-
-        if (resList.at(1).toBool()) {
-            isWildcard = true;
-        } else {
+        for (const QString &appPath : std::as_const(appPaths)) {
             updateDriverDeleteApp(appPath);
         }
 
@@ -428,58 +468,40 @@ bool ConfAppManager::deleteApp(qint64 appId, bool &isWildcard)
 
 bool ConfAppManager::purgeApps()
 {
-    quint32 driveMask = -1;
-    if (conf()->ini().progPurgeOnMounted()) {
-        driveMask = FileUtil::mountedDriveMask(FileUtil::driveMask());
-    }
+    // Check and delete the obsolete apps in background
+    IoC<TaskManager>()->runTask(TaskInfo::AppPurger);
 
-    const auto appIdList = collectObsoleteApps(driveMask);
-    if (appIdList.isEmpty())
-        return true;
-
-    // Delete obsolete apps
-    return deleteApps(appIdList);
+    return true;
 }
 
 bool ConfAppManager::updateAppsBlocked(
         const QVector<qint64> &appIdList, bool blocked, bool killProcess)
 {
-    bool ok = true;
-    bool isWildcard = (appIdList.size() > 7);
-
-    for (const qint64 appId : appIdList) {
-        if (!updateAppBlocked(appId, blocked, killProcess, isWildcard)) {
-            ok = false;
-            break;
-        }
-    }
+    if (appIdList.isEmpty())
+        return true;
 
-    if (isWildcard) {
-        updateDriverConf();
-    }
+    QList<App> apps;
+    if (!loadAppsByIds(appIdList, apps))
+        return false;
 
-    return ok;
-}
+    // Skip the not changed apps
+    QList<App> changedApps;
+    QVector<qint64> changedAppIdList;
 
-bool ConfAppManager::updateAppBlocked(
-        qint64 appId, bool blocked, bool killProcess, bool &isWildcard)
-{
-    App app;
-    app.appId = appId;
-    if (!loadAppById(app))
-        return false;
+    for (App &app : apps) {
+        if (checkAppBlockedChanged(app, blocked, killProcess)) {
+            changedApps.append(app);
+            changedAppIdList.append(app.appId);
+        }
+    }
 
-    if (!checkAppBlockedChanged(app, blocked, killProcess))
+    if (changedApps.isEmpty())
         return true;
 
-    if (!saveAppBlocked(app))
+    if (!saveAppsBlocked(changedAppIdList, blocked, killProcess))
         return false;
 
-    if (app.isWildcard) {
-        isWildcard = true;
-    } else {
-        updateDriverUpdateApp(app);
-    }
+    updateDriverUpdateApps(changedApps);
 
     return true;
 }
@@ -500,9 +522,14 @@ bool ConfAppManager::checkAppBlockedChanged(App &app, bool blocked, bool killPro
     return true;
 }
 
-QVector<qint64> ConfAppManager::collectObsoleteApps(quint32 driveMask)
+QVector<AppPurgeEntry> ConfAppManager::collectPurgeApps() const
 {
-    QVector<qint64> appIdList;
+    quint32 driveMask = -1;
+    if (conf()->ini().progPurgeOnMounted()) {
+        driveMask = FileUtil::mountedDriveMask(FileUtil::driveMask());
+    }
+
+    QVector<AppPurgeEntry> apps;
 
     SqliteStmt stmt;
     if (!DbQuery(sqliteDb()).sql(sqlSelectAppsToPurge).prepare(stmt))
@@ -515,15 +542,10 @@ QVector<qint64> ConfAppManager::collectObsoleteApps(quint32 driveMask)
         if ((mask & driveMask) == 0)
             continue; // skip non-path or not-mounted
 
-        if (!AppInfoUtil::fileExists(appPath)) {
-            const qint64 appId = stmt.columnInt64(0);
-            appIdList.append(appId);
-
-            qCDebug(LC) << "Obsolete app:" << appId << appPath;
-        }
+        apps.append({ .appId = stmt.columnInt64(0), .appPath = appPath });
     }
 
-    return appIdList;
+    return apps;
 }
 
 bool ConfAppManager::walkApps(const std::function<walkAppsCallback> &func) const
@@ -543,18 +565,22 @@ bool ConfAppManager::walkApps(const std::function<walkAppsCallback> &func) const
     return true;
 }
 
-bool ConfAppManager::saveAppBlocked(const App &app)
+bool ConfAppManager::saveAppsBlocked(
+        const QVector<qint64> &appIdList, bool blocked, bool killProcess)
 {
     bool ok = true;
 
     beginTransaction();
 
-    const QVariantList vars = { app.appId, app.blocked, app.killProcess };
+    const QVariantList vars = { blocked, killProcess };
 
-    DbQuery(sqliteDb(), &ok).sql(sqlUpdateAppBlocked).vars(vars).executeOk();
+    DbQuery(sqliteDb(), &ok)
+            .sql(sqlWithAppIds(sqlUpdateAppsBlocked, appIdList))
+            .vars(vars)
+            .executeOk();
 
     if (ok) {
-        DbQuery(sqliteDb(), &ok).sql(sqlDeleteAppAlert).vars({ app.appId }).executeOk();
+        DbQuery(sqliteDb(), &ok).sql(sqlWithAppIds(sqlDeleteAppsAlert, appIdList)).executeOk();
     }
 
     commitTransaction(ok);
@@ -616,6 +642,7 @@ bool ConfAppManager::updateDriverConf(bool onlyFlags)
     }
 
     auto driverManager = IoC<DriverManager>();
+
     if (!driverManager->writeConf(confUtil.buffer(), onlyFlags)) {
         qCWarning(LC) << "Update driver error:" << driverManager->errorMessage();
         return false;
@@ -626,17 +653,20 @@ bool ConfAppManager::updateDriverConf(bool onlyFlags)
     return true;
 }
 
-bool ConfAppManager::loadAppById(App &app)
+bool ConfAppManager::loadAppsByIds(const QVector<qint64> &appIdList, QList<App> &apps)
 {
     SqliteStmt stmt;
-    if (!DbQuery(sqliteDb()).sql(sqlSelectAppById).prepare(stmt))
+    if (!DbQuery(sqliteDb()).sql(sqlWithAppIds(sqlSelectAppsByIds, appIdList)).prepare(stmt))
         return false;
 
-    stmt.bindInt64(1, app.appId);
-    if (stmt.step() != SqliteStmt::StepRow)
-        return false;
+    apps.reserve(appIdList.size());
 
-    fillApp(app, stmt);
+    while (stmt.step() == SqliteStmt::StepRow) {
+        App app;
+        fillApp(app, stmt);
+
+        apps.append(app);
+    }
 
     return true;
 }
@@ -695,6 +725,34 @@ bool ConfAppManager::updateDriverUpdateApp(const App &app, bool remove)
     return true;
 }
 
+bool ConfAppManager::updateDriverUpdateApps(const QList<App> &apps)
+{
+    // Wildcard paths are parsed in the full conf
+    const bool isWildcard = std::any_of(
+            apps.constBegin(), apps.constEnd(), [](const App &app) { return app.isWildcard; });
+    if (isWildcard)
+        return updateDriverConf();
+
+    ConfUtil confUtil;
+
+    // Too many apps for one batch: send the full conf
+    if (!confUtil.writeAppEntries(apps)) {
+        qCDebug(LC) << "Driver apps batch error:" << confUtil.errorMessage();
+        return updateDriverConf();
+    }
+
+    // Some entries may be added on error: resync by the full conf
+    auto driverManager = IoC<DriverManager>();
+    if (!driverManager->writeApps(confUtil.buffer())) {
+        qCWarning(LC) << "Update driver apps error:" << driverManager->errorMessage();
+        return updateDriverConf();
+    }
+
+    m_driveMask |= confUtil.driveMask();
+
+    return true;
+}
+
 bool ConfAppManager::updateDriverUpdateAppConf(const App &app)
 {
     return app.isWildcard ? updateDriverConf() : updateDriverUpdateApp(app);
@@ -15,6 +15,7 @@ class AppGroup;
 class ConfManager;
 class FirewallConf;
 class LogEntryBlocked;
+struct AppPurgeEntry;
 
 class ConfAppManager : public QObject, public ConfAppsWalker, public IocService
 {
@@ -24,6 +25,8 @@ public:
     explicit ConfAppManager(QObject *parent = nullptr);
     CLASS_DELETE_COPY_MOVE(ConfAppManager)
 
+    constexpr static int DeleteAppsChunkSize = 100;
+
     ConfManager *confManager() const;
     SqliteDb *sqliteDb() const;
 
@@ -31,9 +34,10 @@ public:
 
     void setUp() override;
 
-    void logBlockedApp(const LogEntryBlocked &logEntry);
+    virtual void logBlockedApp(const LogEntryBlocked &logEntry);
 
     qint64 appIdByPath(const QString &appOriginPath, QString &normPath);
+    bool appIdsByPath(const QString &appPath, qint64 &appId, qint64 &appGroupId);
 
     virtual bool addOrUpdateAppPath(const QString &appOriginPath, bool blocked, bool killProcess);
     virtual bool deleteAppPath(const QString &appOriginPath);
@@ -48,7 +52,10 @@ public:
 
     bool walkApps(const std::function<walkAppsCallback> &func) const override;
 
-    bool saveAppBlocked(const App &app);
+    // Snapshot of the apps to check their existence
+    QVector<AppPurgeEntry> collectPurgeApps() const;
+
+    bool saveAppsBlocked(const QVector<qint64> &appIdList, bool blocked, bool killProcess);
     void updateAppEndTimes();
 
     qint64 getAlertAppId();
@@ -72,23 +79,21 @@ private:
     void beginAddOrUpdateApp(App &app, const AppGroup &appGroup, bool onlyUpdate, bool &ok);
     void endAddOrUpdateApp(const App &app, bool onlyUpdate);
 
-    bool deleteApp(qint64 appId, bool &isWildcard);
+    bool deleteAppsChunk(const QVector<qint64> &appIdList, bool &isWildcard);
 
-    bool updateAppBlocked(qint64 appId, bool blocked, bool killProcess, bool &isWildcard);
     bool checkAppBlockedChanged(App &app, bool blocked, bool killProcess);
 
-    QVector<qint64> collectObsoleteApps(quint32 driveMask);
-
 private:
     void emitAppAlerted();
     void emitAppsChanged();
     void emitAppUpdated();
 
-    bool loadAppById(App &app);
+    bool loadAppsByIds(const QVector<qint64> &appIdList, QList<App> &apps);
     static void fillApp(App &app, const SqliteStmt &stmt);
 
     bool updateDriverDeleteApp(const QString &appPath);
     bool updateDriverUpdateApp(const App &app, bool remove = false);
+    bool updateDriverUpdateApps(const QList<App> &apps);
     bool updateDriverUpdateAppConf(const App &app);
 
     bool beginTransaction();
@@ -0,0 +1,314 @@
+#include "confchangejournal.h"
+
+#include <QDataStream>
+
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include "addressgroup.h"
+#include "appgroup.h"
+
+namespace {
+
+const char *const sqlSelectConfJournal = "SELECT revision, type, item_id, data"
+                                         "  FROM conf_journal"
+                                         "  ORDER BY revision DESC"
+                                         "  LIMIT ?1;";
+
+const char *const sqlInsertConfJournal = "INSERT INTO conf_journal(revision, type, item_id, data)"
+                                         "  VALUES(?1, ?2, ?3, ?4);";
+
+const char *const sqlDeleteConfJournal = "DELETE FROM conf_journal WHERE revision <= ?1;";
+
+QByteArray variantToData(const QVariant &v)
+{
+    QByteArray data;
+
+    QDataStream stream(&data, QDataStream::WriteOnly);
+    stream << v;
+
+    return data;
+}
+
+QVariant dataToVariant(const QByteArray &data)
+{
+    QDataStream stream(data);
+
+    QVariant v;
+    stream >> v;
+
+    return v;
+}
+
+// Transient keys (e.g. passwords) are not saved to the ini file
+bool isTransientIniKey(const QString &key)
+{
+    return key.endsWith('_');
+}
+
+AppGroup *appGroupById(const FirewallConf &conf, qint64 appGroupId)
+{
+    for (AppGroup *appGroup : conf.appGroups()) {
+        if (appGroup->id() == appGroupId)
+            return appGroup;
+    }
+    return nullptr;
+}
+
+}
+
+ConfChangeJournal::ConfChangeJournal(int maxCount) : m_maxCount(maxCount) { }
+
+qint64 ConfChangeJournal::minRevision() const
+{
+    return m_changes.isEmpty() ? m_revision : m_changes.first().revision - 1;
+}
+
+ConfEdits ConfChangeJournal::collectEdits(const FirewallConf &conf)
+{
+    ConfEdits edits;
+
+    if (conf.optEdited()) {
+        int index = 0;
+        for (const AddressGroup *addrGroup : conf.addressGroups()) {
+            if (addrGroup->edited() || addrGroup->id() == 0) {
+                edits.addressGroupIndexes.append(index);
+            }
+            ++index;
+        }
+
+        index = 0;
+        for (const AppGroup *appGroup : conf.appGroups()) {
+            if (appGroup->edited() || appGroup->id() == 0) {
+                edits.appGroupIndexes.append(index);
+            }
+            ++index;
+        }
+
+        edits.appGroupsEdited = !(edits.appGroupIndexes.isEmpty()
+                && conf.removedAppGroupIdList().isEmpty());
+    }
+
+    edits.flagsEdited = conf.flagsEdited();
+
+    if (conf.iniEdited()) {
+        const QVariantMap &iniMap = conf.ini().map();
+
+        for (auto it = iniMap.constBegin(); it != iniMap.constEnd(); ++it) {
+            if (!isTransientIniKey(it.key())) {
+                edits.ini.insert(it.key(), it.value());
+            }
+        }
+    }
+
+    return edits;
+}
+
+QVector<ConfChange> ConfChangeJournal::addEdits(const FirewallConf &conf, const ConfEdits &edits)
+{
+    QVector<ConfChange> changes;
+
+    for (const int index : edits.addressGroupIndexes) {
+        const AddressGroup *addrGroup = conf.addressGroups().at(index);
+
+        changes.append({
+                .type = ConfChange::TypeAddressGroup,
+                .itemId = index,
+                .data = addrGroup->toVariant(),
+        });
+    }
+
+    for (const int index : edits.appGroupIndexes) {
+        const AppGroup *appGroup = conf.appGroups().at(index);
+
+        changes.append({
+                .type = ConfChange::TypeAppGroup,
+                .itemId = appGroup->id(),
+                .data = appGroup->toVariant(),
+        });
+    }
+
+    if (edits.appGroupsEdited) {
+        QVariantList appGroupIds;
+        for (const AppGroup *appGroup : conf.appGroups()) {
+            appGroupIds.append(appGroup->id());
+        }
+
+        changes.append({ .type = ConfChange::TypeAppGroupIds, .data = appGroupIds });
+    }
+
+    if (edits.flagsEdited) {
+        changes.append({ .type = ConfChange::TypeFlags, .data = conf.flagsToVariant() });
+    }
+
+    if (!edits.ini.isEmpty()) {
+        changes.append({ .type = ConfChange::TypeIni, .data = edits.ini });
+    }
+
+    for (ConfChange &change : changes) {
+        change.revision = ++m_revision;
+
+        m_changes.append(change);
+    }
+
+    trimChanges();
+
+    return changes;
+}
+
+bool ConfChangeJournal::changesSince(qint64 revision, QVector<ConfChange> &changes) const
+{
+    if (revision < minRevision() || revision > m_revision)
+        return false;
+
+    const int count = int(m_revision - revision);
+
+    changes = m_changes.mid(m_changes.size() - count);
+
+    return true;
+}
+
+bool ConfChangeJournal::load(SqliteDb *sqliteDb)
+{
+    m_changes.clear();
+
+    SqliteStmt stmt;
+    if (!DbQuery(sqliteDb).sql(sqlSelectConfJournal).vars({ m_maxCount }).prepare(stmt))
+        return false;
+
+    while (stmt.step() == SqliteStmt::StepRow) {
+        ConfChange change;
+        change.revision = stmt.columnInt64(0);
+        change.type = qint8(stmt.columnInt(1));
+        change.itemId = stmt.columnInt64(2);
+        change.data = dataToVariant(stmt.columnBlob(3));
+
+        m_changes.prepend(change);
+    }
+
+    m_revision = m_changes.isEmpty() ? 0 : m_changes.last().revision;
+
+    return true;
+}
+
+bool ConfChangeJournal::save(SqliteDb *sqliteDb, const QVector<ConfChange> &changes)
+{
+    if (changes.isEmpty())
+        return true;
+
+    sqliteDb->beginWriteTransaction();
+
+    SqliteStmt stmt;
+    bool ok = DbQuery(sqliteDb).sql(sqlInsertConfJournal).prepare(stmt);
+
+    for (auto it = changes.constBegin(); ok && it != changes.constEnd(); ++it) {
+        stmt.bindInt64(1, it->revision);
+        stmt.bindInt(2, it->type);
+        stmt.bindInt64(3, it->itemId);
+        stmt.bindBlob(4, variantToData(it->data));
+
+        ok = sqliteDb->done(&stmt);
+    }
+
+    // Remove the old changes
+    if (ok) {
+        ok = DbQuery(sqliteDb)
+                     .sql(sqlDeleteConfJournal)
+                     .vars({ m_revision - m_maxCount })
+                     .executeOk();
+    }
+
+    return sqliteDb->endTransaction(ok);
+}
+
+FirewallConf::EditedFlags ConfChangeJournal::applyChanges(
+        FirewallConf &conf, const QVector<ConfChange> &changes)
+{
+    FirewallConf::EditedFlags editedFlags = FirewallConf::NoneEdited;
+
+    for (const ConfChange &change : changes) {
+        switch (change.type) {
+        case ConfChange::TypeAddressGroup: {
+            const auto &addressGroups = conf.addressGroups();
+            if (change.itemId >= 0 && change.itemId < addressGroups.size()) {
+                addressGroups.at(change.itemId)->fromVariant(change.data);
+            }
+
+            editedFlags |= FirewallConf::OptEdited;
+        } break;
+        case ConfChange::TypeAppGroup: {
+            AppGroup *appGroup = appGroupById(conf, change.itemId);
+            if (!appGroup) {
+                appGroup = new AppGroup();
+                conf.addAppGroup(appGroup);
+            }
+
+            appGroup->fromVariant(change.data);
+
+            editedFlags |= FirewallConf::OptEdited;
+        } break;
+        case ConfChange::TypeAppGroupIds: {
+            QVector<qint64> appGroupIds;
+            for (const QVariant &v : change.data.toList()) {
+                appGroupIds.append(v.toLongLong());
+            }
+
+            conf.arrangeAppGroups(appGroupIds);
+
+            editedFlags |= FirewallConf::OptEdited;
+        } break;
+        case ConfChange::TypeFlags: {
+            conf.flagsFromVariant(change.data);
+
+            editedFlags |= FirewallConf::FlagsEdited;
+        } break;
+        case ConfChange::TypeIni: {
+            // The ini options are re-read from the settings
+            editedFlags |= FirewallConf::IniEdited;
+        } break;
+        }
+    }
+
+    return editedFlags;
+}
+
+QVariant ConfChangeJournal::changesToVariant(const QVector<ConfChange> &changes)
+{
+    QVariantList list;
+
+    for (const ConfChange &change : changes) {
+        list.append(QVariantList {
+                int(change.type), change.revision, change.itemId, change.data });
+    }
+
+    return list;
+}
+
+QVector<ConfChange> ConfChangeJournal::changesFromVariant(const QVariant &v)
+{
+    QVector<ConfChange> changes;
+
+    for (const QVariant &changeVar : v.toList()) {
+        const QVariantList list = changeVar.toList();
+        if (list.size() != 4)
+            continue;
+
+        changes.append({
+                .type = qint8(list.at(0).toInt()),
+                .revision = list.at(1).toLongLong(),
+                .itemId = list.at(2).toLongLong(),
+                .data = list.at(3),
+        });
+    }
+
+    return changes;
+}
+
+void ConfChangeJournal::trimChanges()
+{
+    const int excessCount = int(m_changes.size()) - m_maxCount;
+    if (excessCount > 0) {
+        m_changes.remove(0, excessCount);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef CONFCHANGEJOURNAL_H
+#define CONFCHANGEJOURNAL_H
+
+#include <QVariant>
+#include <QVector>
+
+#include "firewallconf.h"
+
+class SqliteDb;
+
+struct ConfChange
+{
+    enum Type : qint8 {
+        TypeAddressGroup = 1, // item id is the group's index
+        TypeAppGroup, // item id is the group's id
+        TypeAppGroupIds, // ordered ids of the app groups, without the removed ones
+        TypeFlags,
+        TypeIni, // changed keys of the ini options
+    };
+
+    qint8 type = 0;
+    qint64 revision = 0;
+    qint64 itemId = 0;
+    QVariant data;
+};
+
+// Edited items of the conf, collected before saving
+struct ConfEdits
+{
+    bool appGroupsEdited = false; // added, moved or removed
+
+    bool flagsEdited = false;
+
+    QVector<int> addressGroupIndexes;
+    QVector<int> appGroupIndexes;
+
+    QVariantMap ini;
+};
+
+// Revisions of the saved conf's edits.
+// The changes are kept in memory and saved to the "conf_journal" table.
+class ConfChangeJournal
+{
+public:
+    explicit ConfChangeJournal(int maxCount = DefaultMaxCount);
+
+    constexpr static int DefaultMaxCount = 1000;
+
+    int maxCount() const { return m_maxCount; }
+
+    qint64 revision() const { return m_revision; }
+    void setRevision(qint64 v) { m_revision = v; }
+
+    // The oldest revision to get the changes since
+    qint64 minRevision() const;
+
+    const QVector<ConfChange> &changes() const { return m_changes; }
+
+    static ConfEdits collectEdits(const FirewallConf &conf);
+
+    // Returns the new changes of the saved conf
+    QVector<ConfChange> addEdits(const FirewallConf &conf, const ConfEdits &edits);
+
+    bool changesSince(qint64 revision, QVector<ConfChange> &changes) const;
+
+    bool load(SqliteDb *sqliteDb);
+    bool save(SqliteDb *sqliteDb, const QVector<ConfChange> &changes);
+
+    static FirewallConf::EditedFlags applyChanges(
+            FirewallConf &conf, const QVector<ConfChange> &changes);
+
+    static QVariant changesToVariant(const QVector<ConfChange> &changes);
+    static QVector<ConfChange> changesFromVariant(const QVariant &v);
+
+private:
+    void trimChanges();
+
+private:
+    int m_maxCount = 0;
+
+    qint64 m_revision = 0;
+
+    QVector<ConfChange> m_changes;
+};
+
+#endif // CONFCHANGEJOURNAL_H
@@ -34,7 +34,7 @@ namespace {
 
 const QLoggingCategory LC("conf");
 
-constexpr int DATABASE_USER_VERSION = 41;
+constexpr int DATABASE_USER_VERSION = 42;
 
 const char *const sqlSelectAddressGroups = "SELECT addr_group_id, include_all, exclude_all,"
                                            "    include_zones, exclude_zones,"
@@ -437,7 +437,9 @@ IniUser &ConfManager::iniUser() const
 
 void ConfManager::setUp()
 {
-    setupDb();
+    if (setupDb()) {
+        loadJournal();
+    }
 }
 
 void ConfManager::initConfToEdit()
@@ -501,6 +503,16 @@ FirewallConf *ConfManager::createConf()
     return conf;
 }
 
+void ConfManager::readConfIni(FirewallConf &conf) const
+{
+    IoC<FortSettings>()->readConfIni(conf);
+}
+
+void ConfManager::writeConfIni(const FirewallConf &conf)
+{
+    IoC<FortSettings>()->writeConfIni(conf);
+}
+
 bool ConfManager::setupDb()
 {
     if (!sqliteDb()->open()) {
@@ -556,7 +568,7 @@ bool ConfManager::loadConf(FirewallConf &conf)
         }
     }
 
-    IoC<FortSettings>()->readConfIni(conf);
+    readConfIni(conf);
 
     return true;
 }
@@ -579,15 +591,20 @@ bool ConfManager::saveConf(FirewallConf &conf)
 
     conf.prepareToSave();
 
+    // Only the edited rows are saved
+    const ConfEdits edits = ConfChangeJournal::collectEdits(conf);
+
     if (conf.optEdited() && !saveToDb(conf))
         return false;
 
-    IoC<FortSettings>()->writeConfIni(conf);
+    writeConfIni(conf);
 
     if (conf.taskEdited()) {
         saveTasksByIni(conf.ini());
     }
 
+    saveJournal(conf, edits);
+
     conf.afterSaved();
 
     return true;
@@ -657,9 +674,24 @@ void ConfManager::saveIniUser(bool edited, bool onlyFlags)
 
 QVariant ConfManager::toPatchVariant(bool onlyFlags) const
 {
-    return onlyFlags ? conf()->toVariant(/*onlyEdited=*/true) // send only flags to clients
-                     : FirewallConf::editedFlagsToVariant(
-                               FirewallConf::AllEdited); // clients have to reload all from storage
+    QVariantMap map;
+
+    if (onlyFlags) {
+        map = conf()->toVariant(/*onlyEdited=*/true).toMap(); // send only flags to clients
+    } else {
+        map = FirewallConf::editedFlagsToVariant(FirewallConf::AllEdited).toMap();
+
+        // Clients apply the changes since their revision or reload all from storage
+        QVector<ConfChange> changes;
+        if (m_journal.changesSince(m_patchRevision, changes)) {
+            map["changes"] = ConfChangeJournal::changesToVariant(changes);
+        }
+    }
+
+    map["fromRevision"] = m_patchRevision;
+    map["revision"] = m_journal.revision();
+
+    return map;
 }
 
 bool ConfManager::saveVariant(const QVariant &confVar)
@@ -691,6 +723,38 @@ bool ConfManager::saveVariant(const QVariant &confVar)
     return true;
 }
 
+bool ConfManager::applyPatchVariant(const QVariant &confVar)
+{
+    const QVariantMap map = confVar.toMap();
+
+    const bool isSynced = (m_journal.revision() == map["fromRevision"].toLongLong());
+
+    m_journal.setRevision(map["revision"].toLongLong());
+
+    const uint editedFlags = FirewallConf::editedFlagsFromVariant(confVar);
+
+    if ((editedFlags & FirewallConf::OptEdited) == 0) {
+        // Apply only flags
+        conf()->fromVariant(confVar, /*onlyEdited=*/true);
+        return true;
+    }
+
+    const QVector<ConfChange> changes = ConfChangeJournal::changesFromVariant(map["changes"]);
+    if (!isSynced || changes.isEmpty())
+        return false;
+
+    const FirewallConf::EditedFlags changedFlags =
+            ConfChangeJournal::applyChanges(*conf(), changes);
+
+    if ((changedFlags & FirewallConf::IniEdited) != 0) {
+        readConfIni(*conf());
+    }
+
+    conf()->resetEdited(true);
+
+    return true;
+}
+
 bool ConfManager::loadTasks(const QList<TaskInfo *> &taskInfos)
 {
     for (TaskInfo *taskInfo : taskInfos) {
@@ -857,6 +921,15 @@ void ConfManager::updateDriverServices(
     IoC<DriverManager>()->writeServices(confUtil.buffer());
 }
 
+void ConfManager::updateDriverServicesDelta(const QVector<ServiceInfo> &services)
+{
+    ConfUtil confUtil;
+
+    confUtil.writeServicesDelta(services);
+
+    IoC<DriverManager>()->writeServices(confUtil.buffer());
+}
+
 bool ConfManager::loadFromDb(FirewallConf &conf, bool &isNew)
 {
     // Load Address Groups
@@ -892,6 +965,26 @@ bool ConfManager::saveToDb(const FirewallConf &conf)
     return ok;
 }
 
+void ConfManager::loadJournal()
+{
+    if (!m_journal.load(sqliteDb())) {
+        qCWarning(LC) << "Journal load error:" << sqliteDb()->errorMessage();
+    }
+
+    m_patchRevision = m_journal.revision();
+}
+
+void ConfManager::saveJournal(const FirewallConf &conf, const ConfEdits &edits)
+{
+    m_patchRevision = m_journal.revision();
+
+    const QVector<ConfChange> changes = m_journal.addEdits(conf, edits);
+
+    if (!m_journal.save(sqliteDb(), changes)) {
+        qCWarning(LC) << "Journal save error:" << sqliteDb()->errorMessage();
+    }
+}
+
 void ConfManager::saveTasksByIni(const IniOptions &ini)
 {
     // Task Info List
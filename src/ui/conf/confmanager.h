@@ -9,6 +9,8 @@
 #include <util/ioc/iocservice.h>
 #include <util/service/serviceinfo.h>
 
+#include "confchangejournal.h"
+
 class FirewallConf;
 class IniOptions;
 class IniUser;
@@ -30,6 +32,9 @@ public:
     IniUser &iniUser() const;
     IniUser *iniUserToEdit() const { return m_iniUserToEdit; }
 
+    ConfChangeJournal &journal() { return m_journal; }
+    const ConfChangeJournal &journal() const { return m_journal; }
+
     void setUp() override;
 
     void initConfToEdit();
@@ -52,6 +57,8 @@ public:
     QVariant toPatchVariant(bool onlyFlags) const;
     bool saveVariant(const QVariant &confVar);
 
+    bool applyPatchVariant(const QVariant &confVar);
+
     bool loadTasks(const QList<TaskInfo *> &taskInfos);
     bool saveTasks(const QList<TaskInfo *> &taskInfos);
 
@@ -67,6 +74,7 @@ public:
 
     void updateServices();
     void updateDriverServices(const QVector<ServiceInfo> &services, int runningServicesCount);
+    void updateDriverServicesDelta(const QVector<ServiceInfo> &services);
 
 signals:
     void confChanged(bool onlyFlags);
@@ -77,6 +85,9 @@ protected:
     void setConf(FirewallConf *newConf);
     FirewallConf *createConf();
 
+    virtual void readConfIni(FirewallConf &conf) const;
+    virtual void writeConfIni(const FirewallConf &conf);
+
 private:
     bool setupDb();
 
@@ -87,6 +98,9 @@ private:
     bool loadFromDb(FirewallConf &conf, bool &isNew);
     bool saveToDb(const FirewallConf &conf);
 
+    void loadJournal();
+    void saveJournal(const FirewallConf &conf, const ConfEdits &edits);
+
     void saveTasksByIni(const IniOptions &ini);
 
     bool loadTask(TaskInfo *taskInfo);
@@ -102,6 +116,10 @@ private:
     FirewallConf *m_confToEdit = nullptr;
 
     IniUser *m_iniUserToEdit = nullptr;
+
+    qint64 m_patchRevision = 0; // of the last patch to clients
+
+    ConfChangeJournal m_journal;
 };
 
 #endif // CONFMANAGER_H
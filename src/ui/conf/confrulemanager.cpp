@@ -73,48 +73,22 @@ const char *const sqlSelectRuleSet = "SELECT t.sub_rule_id, r.name"
 const char *const sqlSelectRulesCountByType = "SELECT COUNT(*) FROM rule t"
                                               "  WHERE t.rule_type = ?1;";
 
-const char *const sqlSelectRuleSetLoop = "WITH RECURSIVE"
-                                         "  parents(rule_id, level) AS ("
-                                         "    VALUES(?1, 0)"
-                                         "    UNION ALL"
-                                         "    SELECT t.rule_id, p.level + 1"
-                                         "      FROM rule_set t"
-                                         "      JOIN parents p ON p.rule_id = t.sub_rule_id"
-                                         "  ),"
-                                         "  children(rule_id, level) AS ("
-                                         "    VALUES(?2, 0)"
-                                         "    UNION ALL"
-                                         "    SELECT t.sub_rule_id, c.level + 1"
-                                         "      FROM rule_set t"
-                                         "      JOIN children c ON c.rule_id = t.rule_id"
-                                         "  )"
-                                         "SELECT * FROM (VALUES ("
-                                         "  (SELECT 1"
-                                         "    FROM parents p"
-                                         "    JOIN children c ON c.rule_id = p.rule_id"
-                                         "    LIMIT 1),"
-                                         "  ((SELECT MAX(level) FROM parents)"
-                                         "    + (SELECT MAX(level) FROM children))"
-                                         "));";
-
 const char *const sqlUpdateRuleName = "UPDATE rule SET name = ?2 WHERE rule_id = ?1;";
 
 const char *const sqlUpdateRuleEnabled = "UPDATE rule SET enabled = ?2 WHERE rule_id = ?1;";
 
-bool driverWriteRules(ConfUtil &confUtil, QByteArray &buf, int entrySize, bool onlyFlags = false)
+bool driverWriteRules(ConfUtil &confUtil, bool onlyFlags = false)
 {
-    if (entrySize == 0) {
+    if (confUtil.hasError()) {
         qCWarning(LC) << "Driver config error:" << confUtil.errorMessage();
         return false;
     }
 
-#if 0
     auto driverManager = IoC<DriverManager>();
-    if (!driverManager->writeRules(buf, entrySize, onlyFlags)) {
+    if (!driverManager->writeRules(confUtil.buffer(), onlyFlags)) {
         qCWarning(LC) << "Update driver error:" << driverManager->errorMessage();
         return false;
     }
-#endif
 
     return true;
 }
@@ -138,6 +112,21 @@ void ConfRuleManager::setUp()
     m_confManager = IoCDependency<ConfManager>();
 }
 
+const RuleSetGraph &ConfRuleManager::ruleSetGraph() const
+{
+    if (!m_ruleSetGraphLoaded) {
+        loadRuleSetGraph();
+    }
+
+    return m_ruleSetGraph;
+}
+
+void ConfRuleManager::resetRuleSetGraph()
+{
+    m_ruleSetGraphLoaded = false;
+    m_ruleSetGraph.clear();
+}
+
 void ConfRuleManager::loadRuleSet(Rule &rule, QStringList &ruleSetNames)
 {
     rule.ruleSetEdited = false;
@@ -186,16 +175,12 @@ int ConfRuleManager::rulesCountByType(Rule::RuleType ruleType)
 
 bool ConfRuleManager::checkRuleSetValid(int ruleId, int subRuleId, int extraDepth)
 {
-    const auto list = DbQuery(sqliteDb())
-                              .sql(sqlSelectRuleSetLoop)
-                              .vars({ ruleId, subRuleId })
-                              .execute(2)
-                              .toList();
+    const RuleSetGraph &graph = ruleSetGraph();
 
-    const int loopId = list[0].toInt();
-    const int depth = list[1].toInt();
+    if (graph.isLoop(ruleId, subRuleId))
+        return false;
 
-    return loopId == 0 && (depth + extraDepth) <= ConfUtil::ruleSetDepthMaxCount();
+    return (graph.depth(ruleId, subRuleId) + extraDepth) <= ConfUtil::ruleSetDepthMaxCount();
 }
 
 bool ConfRuleManager::addOrUpdateRule(Rule &rule)
@@ -237,6 +222,10 @@ bool ConfRuleManager::addOrUpdateRule(Rule &rule)
     if (!ok)
         return false;
 
+    if (rule.ruleSetEdited && m_ruleSetGraphLoaded) {
+        m_ruleSetGraph.setRuleSet(rule.ruleId, rule.ruleSet);
+    }
+
     updateDriverRules();
 
     if (isNew) {
@@ -269,6 +258,10 @@ bool ConfRuleManager::deleteRule(int ruleId)
     commitTransaction(ok);
 
     if (ok) {
+        if (m_ruleSetGraphLoaded) {
+            m_ruleSetGraph.removeRule(ruleId);
+        }
+
         emit ruleRemoved(ruleId);
 
         updateDriverRules();
@@ -326,7 +319,7 @@ bool ConfRuleManager::walkRules(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds
 
     maxRuleId = DbQuery(sqliteDb()).sql(sqlSelectMaxRuleId).execute().toInt();
 
-    walkRulesMap(ruleSetMap, ruleIds);
+    ruleSetGraph().fillRuleSetMap(ruleSetMap, ruleIds);
 
     ok = walkRulesLoop(func);
 
@@ -335,40 +328,22 @@ bool ConfRuleManager::walkRules(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds
     return ok;
 }
 
-void ConfRuleManager::walkRulesMap(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds) const
+void ConfRuleManager::loadRuleSetGraph() const
 {
+    m_ruleSetGraph.clear();
+    m_ruleSetGraphLoaded = true;
+
     SqliteStmt stmt;
     if (!DbQuery(sqliteDb()).sql(sqlSelectRuleSets).prepare(stmt))
         return;
 
-    int prevRuleId = 0;
-    int prevIndex = 0;
-
-    int index = 0;
-    for (;;) {
-        const bool isStepRow = (stmt.step() == SqliteStmt::StepRow);
-
+    while (stmt.step() == SqliteStmt::StepRow) {
         const int ruleId = stmt.columnInt(0);
         const int subRuleId = stmt.columnInt(1);
 
-        if (prevRuleId != ruleId) {
-            const RuleSetIndex ruleSetIndex = {
-                .index = quint32(prevIndex),
-                .count = quint8(index - prevIndex),
-            };
-
-            ruleSetMap.insert(prevRuleId, ruleSetIndex);
-
-            prevRuleId = ruleId;
-            prevIndex = index;
+        if (!m_ruleSetGraph.addSubRule(ruleId, subRuleId)) {
+            qCWarning(LC) << "Rule Set loop skipped:" << ruleId << "->" << subRuleId;
         }
-
-        ruleIds.append(subRuleId);
-
-        ++index;
-
-        if (!isStepRow)
-            break;
     }
 }
 
@@ -407,19 +382,16 @@ void ConfRuleManager::updateDriverRules()
 
     confUtil.writeRules(*this);
 
-    // driverWriteRules(confUtil, confUtil.buffer(), entrySize);
+    driverWriteRules(confUtil);
 }
 
 bool ConfRuleManager::updateDriverRuleFlag(int ruleId, bool enabled)
 {
     ConfUtil confUtil;
 
-#if 0
     confUtil.writeRuleFlag(ruleId, enabled);
 
-    return driverWriteRules(confUtil, confUtil.buffer(), /*onlyFlags=*/true);
-#endif
-    return true;
+    return driverWriteRules(confUtil, /*onlyFlags=*/true);
 }
 
 bool ConfRuleManager::beginTransaction()
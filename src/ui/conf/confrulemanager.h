@@ -8,6 +8,7 @@
 #include <conf/rule.h>
 #include <util/classhelpers.h>
 #include <util/conf/confruleswalker.h>
+#include <util/conf/rulesetgraph.h>
 #include <util/ioc/iocservice.h>
 
 class ConfManager;
@@ -25,6 +26,9 @@ public:
 
     void setUp() override;
 
+    const RuleSetGraph &ruleSetGraph() const;
+    void resetRuleSetGraph();
+
     void loadRuleSet(Rule &rule, QStringList &ruleSetNames);
     void saveRuleSet(Rule &rule);
 
@@ -47,7 +51,8 @@ signals:
     void ruleUpdated();
 
 private:
-    void walkRulesMap(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds) const;
+    void loadRuleSetGraph() const;
+
     bool walkRulesLoop(const std::function<walkRulesCallback> &func) const;
 
     static void fillRule(Rule &rule, const SqliteStmt &stmt);
@@ -59,6 +64,9 @@ private:
 
 private:
     ConfManager *m_confManager = nullptr;
+
+    mutable bool m_ruleSetGraphLoaded = false;
+    mutable RuleSetGraph m_ruleSetGraph;
 };
 
 #endif // CONFRULEMANAGER_H
@@ -252,6 +252,32 @@ void FirewallConf::removeAppGroup(int from, int to)
     setAppGroupsEdited(lo, m_appGroups.size() - 1);
 }
 
+void FirewallConf::arrangeAppGroups(const QVector<qint64> &appGroupIds)
+{
+    QList<AppGroup *> appGroups;
+    appGroups.reserve(appGroupIds.size());
+
+    for (const qint64 appGroupId : appGroupIds) {
+        for (AppGroup *appGroup : std::as_const(m_appGroups)) {
+            if (appGroup->id() == appGroupId) {
+                appGroups.append(appGroup);
+                break;
+            }
+        }
+    }
+
+    // Delete the removed app. groups
+    for (AppGroup *appGroup : std::as_const(m_appGroups)) {
+        if (!appGroups.contains(appGroup)) {
+            appGroup->deleteLater();
+        }
+    }
+
+    m_appGroups = appGroups;
+
+    emit appGroupsChanged();
+}
+
 void FirewallConf::clearRemovedAppGroupIdList() const
 {
     m_removedAppGroupIdList.clear();
@@ -135,6 +135,9 @@ public:
     QVariant toVariant(bool onlyEdited = false) const;
     void fromVariant(const QVariant &v, bool onlyEdited = false);
 
+    QVariant flagsToVariant() const;
+    void flagsFromVariant(const QVariant &v);
+
     static QVariant editedFlagsToVariant(uint editedFlags);
     static uint editedFlagsFromVariant(const QVariant &v);
 
@@ -147,6 +150,7 @@ public slots:
     void addDefaultAppGroup();
     void moveAppGroup(int from, int to);
     void removeAppGroup(int from, int to);
+    void arrangeAppGroups(const QVector<qint64> &appGroupIds);
 
     void setupDefaultAddressGroups();
 
@@ -161,9 +165,6 @@ private:
     void loadAppGroupBits();
     void applyAppGroupBits();
 
-    QVariant flagsToVariant() const;
-    void flagsFromVariant(const QVariant &v);
-
     QVariant addressesToVariant() const;
     void addressesFromVariant(const QVariant &v);
 
@@ -5,10 +5,12 @@
 
 #define DEFAULT_APP_GROUP_BITS         0xFFFF
 #define DEFAULT_MONTH_START            1
+#define DEFAULT_QUOTA_ALERT_PERCENTS   "100"
 #define DEFAULT_TRAF_HOUR_KEEP_DAYS    90 // ~3 months
 #define DEFAULT_TRAF_DAY_KEEP_DAYS     365 // ~1 year
 #define DEFAULT_TRAF_MONTH_KEEP_MONTHS 36 // ~3 years
 #define DEFAULT_LOG_IP_KEEP_COUNT      10000
+#define DEFAULT_FLOWS_CAPACITY         4096
 
 class IniOptions : public MapSettings
 {
@@ -45,12 +47,6 @@ public:
     bool checkPasswordOnUninstall() const { return valueBool("protect/checkPasswordOnUninstall"); }
     void setCheckPasswordOnUninstall(bool v) { setValue("protect/checkPasswordOnUninstall", v); }
 
-    int quotaDayAlerted() const { return valueInt("quota/dayAlerted"); }
-    void setQuotaDayAlerted(int v) { setValue("quota/dayAlerted", v); }
-
-    int quotaMonthAlerted() const { return valueInt("quota/monthAlerted"); }
-    void setQuotaMonthAlerted(int v) { setValue("quota/monthAlerted", v); }
-
     int quotaDayMb() const { return valueInt("quota/quotaDayMb"); }
     void setQuotaDayMb(int v) { setValue("quota/quotaDayMb", v); }
 
@@ -60,9 +56,19 @@ public:
     bool quotaBlockInetTraffic() const { return valueBool("quota/blockInetTraffic"); }
     void setQuotaBlockInternet(bool v) { setValue("quota/blockInetTraffic", v); }
 
+    // Comma separated percents of quotas
+    QString quotaAlertPercents() const
+    {
+        return valueText("quota/alertPercents", DEFAULT_QUOTA_ALERT_PERCENTS);
+    }
+    void setQuotaAlertPercents(const QString &v) { setValue("quota/alertPercents", v); }
+
     int monthStart() const { return valueInt("stat/monthStart", DEFAULT_MONTH_START); }
     void setMonthStart(int v) { setValue("stat/monthStart", v); }
 
+    int flowsCapacity() const { return valueInt("stat/flowsCapacity", DEFAULT_FLOWS_CAPACITY); }
+    void setFlowsCapacity(int v) { setValue("stat/flowsCapacity", v); }
+
     int trafHourKeepDays() const
     {
         return valueInt("stat/trafHourKeepDays", DEFAULT_TRAF_HOUR_KEEP_DAYS);
@@ -122,3 +122,10 @@ CREATE TABLE task(
   last_success INTEGER NOT NULL,
   data BLOB
 );
+
+CREATE TABLE conf_journal(
+  revision INTEGER PRIMARY KEY,
+  type INTEGER NOT NULL,
+  item_id INTEGER NOT NULL,
+  data BLOB
+);
@@ -22,6 +22,9 @@ const char *const commandString(Command cmd)
         CASE_STRING(Rpc_AppInfoManager_lookupAppInfo)
         CASE_STRING(Rpc_AppInfoManager_checkLookupInfoFinished)
 
+        CASE_STRING(Rpc_AskPendingManager_decideApps)
+        CASE_STRING(Rpc_AskPendingManager_connsChanged)
+
         CASE_STRING(Rpc_AutoUpdateManager_startDownload)
         CASE_STRING(Rpc_AutoUpdateManager_runInstaller)
         CASE_STRING(Rpc_AutoUpdateManager_updateState)
@@ -61,6 +64,7 @@ const char *const commandString(Command cmd)
         CASE_STRING(Rpc_ConfZoneManager_zoneRemoved)
         CASE_STRING(Rpc_ConfZoneManager_zoneUpdated)
 
+        CASE_STRING(Rpc_DriverManager_readStatsData)
         CASE_STRING(Rpc_DriverManager_updateState)
 
         CASE_STRING(Rpc_QuotaManager_alert)
@@ -97,6 +101,7 @@ const char *const rpcManagerString(RpcManager rpcManager)
     switch (rpcManager) {
         CASE_STRING(Rpc_NoneManager)
         CASE_STRING(Rpc_AppInfoManager)
+        CASE_STRING(Rpc_AskPendingManager)
         CASE_STRING(Rpc_AutoUpdateManager)
         CASE_STRING(Rpc_ConfManager)
         CASE_STRING(Rpc_ConfAppManager)
@@ -129,6 +134,9 @@ RpcManager managerByCommand(Command cmd)
         Rpc_AppInfoManager, // Rpc_AppInfoManager_lookupAppInfo,
         Rpc_AppInfoManager, // Rpc_AppInfoManager_checkLookupFinished,
 
+        Rpc_AskPendingManager, // Rpc_AskPendingManager_decideApps,
+        Rpc_AskPendingManager, // Rpc_AskPendingManager_connsChanged,
+
         Rpc_AutoUpdateManager, // Rpc_AutoUpdateManager_startDownload,
         Rpc_AutoUpdateManager, // Rpc_AutoUpdateManager_runInstaller,
         Rpc_AutoUpdateManager, // Rpc_AutoUpdateManager_updateState,
@@ -169,6 +177,7 @@ RpcManager managerByCommand(Command cmd)
         Rpc_ConfZoneManager, // Rpc_ConfZoneManager_zoneRemoved,
         Rpc_ConfZoneManager, // Rpc_ConfZoneManager_zoneUpdated,
 
+        Rpc_DriverManager, // Rpc_DriverManager_readStatsData,
         Rpc_DriverManager, // Rpc_DriverManager_updateState,
 
         Rpc_QuotaManager, // Rpc_QuotaManager_alert,
@@ -215,6 +224,9 @@ bool commandRequiresValidation(Command cmd)
         true, // Rpc_AppInfoManager_lookupAppInfo,
         0, // Rpc_AppInfoManager_checkLookupFinished,
 
+        true, // Rpc_AskPendingManager_decideApps,
+        0, // Rpc_AskPendingManager_connsChanged,
+
         true, // Rpc_AutoUpdateManager_startDownload,
         true, // Rpc_AutoUpdateManager_runInstaller,
         0, // Rpc_AutoUpdateManager_updateState,
@@ -255,6 +267,7 @@ bool commandRequiresValidation(Command cmd)
         0, // Rpc_ConfZoneManager_zoneRemoved,
         0, // Rpc_ConfZoneManager_zoneUpdated,
 
+        true, // Rpc_DriverManager_readStatsData,
         0, // Rpc_DriverManager_updateState,
 
         0, // Rpc_QuotaManager_alert,
@@ -22,6 +22,9 @@ enum Command : qint8 {
     Rpc_AppInfoManager_lookupAppInfo,
     Rpc_AppInfoManager_checkLookupInfoFinished,
 
+    Rpc_AskPendingManager_decideApps,
+    Rpc_AskPendingManager_connsChanged,
+
     Rpc_AutoUpdateManager_startDownload,
     Rpc_AutoUpdateManager_runInstaller,
     Rpc_AutoUpdateManager_updateState,
@@ -62,6 +65,7 @@ enum Command : qint8 {
     Rpc_ConfZoneManager_zoneRemoved,
     Rpc_ConfZoneManager_zoneUpdated,
 
+    Rpc_DriverManager_readStatsData,
     Rpc_DriverManager_updateState,
 
     Rpc_QuotaManager_alert,
@@ -92,6 +96,7 @@ enum Command : qint8 {
 enum RpcManager : qint8 {
     Rpc_NoneManager = 0,
     Rpc_AppInfoManager,
+    Rpc_AskPendingManager,
     Rpc_AutoUpdateManager,
     Rpc_ConfManager,
     Rpc_ConfAppManager,
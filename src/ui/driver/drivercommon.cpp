@@ -12,6 +12,11 @@ QString deviceName()
     return QLatin1String(FORT_DEVICE_NAME);
 }
 
+QString statsDeviceName()
+{
+    return QLatin1String(FORT_DEVICE_STATS_NAME);
+}
+
 quint32 ioctlValidate()
 {
     return FORT_IOCTL_VALIDATE;
@@ -57,6 +62,31 @@ quint32 ioctlSetZoneFlag()
     return FORT_IOCTL_SETZONEFLAG;
 }
 
+quint32 ioctlGetStats()
+{
+    return FORT_IOCTL_GETSTATS;
+}
+
+quint32 ioctlGetTrace()
+{
+    return FORT_IOCTL_GETTRACE;
+}
+
+quint32 ioctlSetRules()
+{
+    return FORT_IOCTL_SETRULES;
+}
+
+quint32 ioctlSetRuleFlag()
+{
+    return FORT_IOCTL_SETRULEFLAG;
+}
+
+quint32 ioctlAddApps()
+{
+    return FORT_IOCTL_ADDAPPS;
+}
+
 quint32 userErrorCode()
 {
     return FORT_ERROR_USER_ERROR;
@@ -97,6 +127,16 @@ quint32 logBlockedIpSize(quint32 pathLen, bool isIPv6)
     return FORT_LOG_BLOCKED_IP_SIZE(pathLen, isIPv6);
 }
 
+quint32 logBlockedIpSumHeaderSize()
+{
+    return FORT_LOG_BLOCKED_IP_SUM_HEADER_SIZE;
+}
+
+quint32 logBlockedIpSumSize(quint32 pathLen, bool isIPv6)
+{
+    return FORT_LOG_BLOCKED_IP_SUM_SIZE(pathLen, isIPv6);
+}
+
 quint32 logProcNewHeaderSize()
 {
     return FORT_LOG_PROC_NEW_HEADER_SIZE;
@@ -158,6 +198,18 @@ void logBlockedIpHeaderRead(const char *input, int *isIPv6, int *inbound, int *i
             localPort, remotePort, &localIp->v4, &remoteIp->v4, pid, pathLen);
 }
 
+void logBlockedIpSumHeaderWrite(
+        char *output, quint32 hitCount, qint64 firstTime, qint64 lastTime)
+{
+    fort_log_blocked_ip_sum_header_write(output, hitCount, firstTime, lastTime);
+}
+
+void logBlockedIpSumHeaderRead(
+        const char *input, quint32 *hitCount, qint64 *firstTime, qint64 *lastTime)
+{
+    fort_log_blocked_ip_sum_header_read(input, hitCount, firstTime, lastTime);
+}
+
 void logProcNewHeaderWrite(char *output, quint32 pid, quint32 pathLen)
 {
     fort_log_proc_new_header_write(output, pid, pathLen);
@@ -168,6 +220,11 @@ void logProcNewHeaderRead(const char *input, quint32 *pid, quint32 *pathLen)
     fort_log_proc_new_header_read(input, pid, pathLen);
 }
 
+void logStatTrafHeaderWrite(char *output, quint16 procCount)
+{
+    fort_log_stat_traf_header_write(output, procCount);
+}
+
 void logStatTrafHeaderRead(const char *input, quint16 *procCount)
 {
     fort_log_stat_traf_header_read(input, procCount);
@@ -190,6 +247,34 @@ void confAppPermsMaskInit(void *drvConf)
     fort_conf_app_perms_mask_init(conf, conf->flags.group_bits);
 }
 
+bool confVerify(const void *drvConf, quint32 confLen)
+{
+    const PFORT_CONF conf = (const PFORT_CONF) drvConf;
+
+    return fort_conf_verify(conf, confLen);
+}
+
+bool confAppEntriesVerify(const void *appEntries, quint32 len)
+{
+    const PFORT_APP_ENTRIES app_entries = (const PFORT_APP_ENTRIES) appEntries;
+
+    return fort_conf_app_entries_verify(app_entries, len);
+}
+
+bool confAppVerify(const void *appEntry, quint32 len)
+{
+    const PFORT_APP_ENTRY app_entry = (const PFORT_APP_ENTRY) appEntry;
+
+    return fort_conf_app_verify(app_entry, len);
+}
+
+bool confZonesVerify(const void *drvZones, quint32 len)
+{
+    const PFORT_CONF_ZONES zones = (const PFORT_CONF_ZONES) drvZones;
+
+    return fort_conf_zones_verify(zones, len);
+}
+
 bool confIpInRange(
         const void *drvConf, const quint32 *ip, bool isIPv6, bool included, int addrGroupIndex)
 {
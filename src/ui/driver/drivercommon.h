@@ -8,6 +8,7 @@
 namespace DriverCommon {
 
 QString deviceName();
+QString statsDeviceName();
 
 quint32 ioctlValidate();
 quint32 ioctlSetServices();
@@ -18,6 +19,11 @@ quint32 ioctlAddApp();
 quint32 ioctlDelApp();
 quint32 ioctlSetZones();
 quint32 ioctlSetZoneFlag();
+quint32 ioctlGetStats();
+quint32 ioctlGetTrace();
+quint32 ioctlSetRules();
+quint32 ioctlSetRuleFlag();
+quint32 ioctlAddApps();
 
 quint32 userErrorCode();
 
@@ -33,6 +39,9 @@ quint32 logBlockedSize(quint32 pathLen);
 quint32 logBlockedIpHeaderSize(bool isIPv6 = false);
 quint32 logBlockedIpSize(quint32 pathLen, bool isIPv6 = false);
 
+quint32 logBlockedIpSumHeaderSize();
+quint32 logBlockedIpSumSize(quint32 pathLen, bool isIPv6 = false);
+
 quint32 logProcNewHeaderSize();
 quint32 logProcNewSize(quint32 pathLen);
 
@@ -54,9 +63,15 @@ void logBlockedIpHeaderRead(const char *input, int *isIPv6, int *inbound, int *i
         quint8 *blockReason, quint8 *ipProto, quint16 *localPort, quint16 *remotePort,
         ip_addr_t *localIp, ip_addr_t *remoteIp, quint32 *pid, quint32 *pathLen);
 
+void logBlockedIpSumHeaderWrite(
+        char *output, quint32 hitCount, qint64 firstTime, qint64 lastTime);
+void logBlockedIpSumHeaderRead(
+        const char *input, quint32 *hitCount, qint64 *firstTime, qint64 *lastTime);
+
 void logProcNewHeaderWrite(char *output, quint32 pid, quint32 pathLen);
 void logProcNewHeaderRead(const char *input, quint32 *pid, quint32 *pathLen);
 
+void logStatTrafHeaderWrite(char *output, quint16 procCount);
 void logStatTrafHeaderRead(const char *input, quint16 *procCount);
 
 void logTimeWrite(char *output, int systemTimeChanged, qint64 unixTime);
@@ -64,6 +79,11 @@ void logTimeRead(const char *input, int *systemTimeChanged, qint64 *unixTime);
 
 void confAppPermsMaskInit(void *drvConf);
 
+bool confVerify(const void *drvConf, quint32 confLen);
+bool confAppEntriesVerify(const void *appEntries, quint32 len);
+bool confAppVerify(const void *appEntry, quint32 len);
+bool confZonesVerify(const void *drvZones, quint32 len);
+
 bool confIpInRange(const void *drvConf, const quint32 *ip, bool isIPv6 = false,
         bool included = false, int addrGroupIndex = 0);
 bool confIp4InRange(const void *drvConf, quint32 ip, bool included = false, int addrGroupIndex = 0);
@@ -5,8 +5,12 @@
 
 #include <conf/firewallconf.h>
 #include <driver/drivercommon.h>
+#include <driver/drivermetrics.h>
+#include <driver/tracedecoder.h>
+#include <fortsettings.h>
 #include <util/device.h>
 #include <util/fileutil.h>
+#include <util/ioc/ioccontainer.h>
 #include <util/osutil.h>
 
 #include "driverworker.h"
@@ -16,6 +20,8 @@ DriverManager::DriverManager(QObject *parent, bool useDevice) : QObject(parent)
     if (useDevice) {
         setupWorker();
     }
+
+    setupMetricsTimer();
 }
 
 DriverManager::~DriverManager()
@@ -53,12 +59,18 @@ bool DriverManager::isDeviceOpened() const
 
 void DriverManager::setUp()
 {
+    const QString logTraceFilePath = IoC<FortSettings>()->logTraceFilePath();
+    if (!logTraceFilePath.isEmpty()) {
+        driverWorker()->setLogTraceFilePath(logTraceFilePath);
+    }
+
     QThreadPool::globalInstance()->start(driverWorker());
 }
 
 void DriverManager::setupWorker()
 {
     m_device = new Device(this);
+    m_statsDevice = new Device(this);
     m_driverWorker = new DriverWorker(device()); // autoDelete = true
 }
 
@@ -69,6 +81,22 @@ void DriverManager::closeWorker()
     }
 }
 
+void DriverManager::setupMetricsTimer()
+{
+    m_metricsTimer.setInterval(metricsPollingInterval);
+
+    connect(&m_metricsTimer, &QTimer::timeout, this, &DriverManager::pollMetrics);
+}
+
+void DriverManager::pollMetrics()
+{
+    DriverMetrics metrics;
+    if (!readMetrics(metrics))
+        return;
+
+    emit metricsUpdated(metrics);
+}
+
 bool DriverManager::openDevice()
 {
     const bool res = device()->open(DriverCommon::deviceName());
@@ -82,6 +110,8 @@ bool DriverManager::openDevice()
 
 bool DriverManager::closeDevice()
 {
+    statsDevice()->close();
+
     const bool res = device()->close();
 
     updateErrorCode(true);
@@ -111,6 +141,11 @@ bool DriverManager::writeApp(QByteArray &buf, bool remove)
     return writeData(remove ? DriverCommon::ioctlDelApp() : DriverCommon::ioctlAddApp(), buf);
 }
 
+bool DriverManager::writeApps(QByteArray &buf)
+{
+    return writeData(DriverCommon::ioctlAddApps(), buf);
+}
+
 bool DriverManager::writeZones(QByteArray &buf, bool onlyFlags)
 {
     const auto code = onlyFlags ? DriverCommon::ioctlSetZoneFlag() : DriverCommon::ioctlSetZones();
@@ -118,6 +153,13 @@ bool DriverManager::writeZones(QByteArray &buf, bool onlyFlags)
     return writeData(code, buf);
 }
 
+bool DriverManager::writeRules(QByteArray &buf, bool onlyFlags)
+{
+    const auto code = onlyFlags ? DriverCommon::ioctlSetRuleFlag() : DriverCommon::ioctlSetRules();
+
+    return writeData(code, buf);
+}
+
 bool DriverManager::writeData(quint32 code, QByteArray &buf)
 {
     if (!isDeviceOpened())
@@ -136,6 +178,72 @@ bool DriverManager::writeData(quint32 code, QByteArray &buf)
     return res;
 }
 
+bool DriverManager::readMetrics(DriverMetrics &metrics)
+{
+    QByteArray buf(DriverMetrics::bufferSize(), '\0');
+
+    return readStatsData(DriverCommon::ioctlGetStats(), buf) && metrics.read(buf);
+}
+
+bool DriverManager::readTrace(TraceDecoder &decoder)
+{
+    constexpr int recordsCount = 1024;
+
+    // Drain the ring: one more pass for the records added while reading.
+    // It runs on the GUI thread, so the busy driver must not keep it looping.
+    const int maxPasses = TraceDecoder::ringRecordsCount() / recordsCount + 1;
+
+    for (int pass = 0; pass < maxPasses; ++pass) {
+        QByteArray buf(TraceDecoder::bufferSize(recordsCount), '\0');
+
+        int count = 0;
+        if (!readStatsData(DriverCommon::ioctlGetTrace(), buf) || !decoder.read(buf, &count))
+            return false;
+
+        if (count < recordsCount)
+            break;
+    }
+
+    return true;
+}
+
+void DriverManager::startMetricsPolling()
+{
+    if (m_metricsPollingCount++ == 0) {
+        m_metricsTimer.start();
+        pollMetrics();
+    }
+}
+
+void DriverManager::stopMetricsPolling()
+{
+    if (m_metricsPollingCount > 0 && --m_metricsPollingCount == 0) {
+        m_metricsTimer.stop();
+
+        if (statsDevice()) {
+            statsDevice()->close();
+        }
+    }
+}
+
+bool DriverManager::readStatsData(quint32 code, QByteArray &buf)
+{
+    // The own file of statistics doesn't interrupt the pending log read of the worker
+    // and doesn't change the error code of the driver's device
+    if (!statsDevice()->isOpened()
+            && !statsDevice()->open(DriverCommon::statsDeviceName(), Device::ReadOnly))
+        return false;
+
+    qsizetype retSize = 0;
+
+    if (!statsDevice()->ioctl(code, nullptr, 0, buf.data(), buf.size(), &retSize))
+        return false;
+
+    buf.resize(retSize);
+
+    return true;
+}
+
 bool DriverManager::checkReinstallDriver()
 {
     return executeCommand("check-reinstall.bat");
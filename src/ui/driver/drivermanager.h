@@ -2,23 +2,29 @@
 #define DRIVERMANAGER_H
 
 #include <QObject>
+#include <QTimer>
 
 #include <util/classhelpers.h>
 #include <util/ioc/iocservice.h>
 
 class Device;
+class DriverMetrics;
 class DriverWorker;
+class TraceDecoder;
 
 class DriverManager : public QObject, public IocService
 {
     Q_OBJECT
 
 public:
+    static constexpr int metricsPollingInterval = 5000; // msecs
+
     explicit DriverManager(QObject *parent = nullptr, bool useDevice = true);
     ~DriverManager() override;
     CLASS_DELETE_COPY_MOVE(DriverManager)
 
     Device *device() const { return m_device; }
+    Device *statsDevice() const { return m_statsDevice; }
     DriverWorker *driverWorker() const { return m_driverWorker; }
 
     quint32 errorCode() const { return m_errorCode; }
@@ -33,10 +39,20 @@ public:
     bool reinstallDriver();
     bool uninstallDriver();
 
+    bool readMetrics(DriverMetrics &metrics);
+    bool readTrace(TraceDecoder &decoder);
+
+    void startMetricsPolling();
+    void stopMetricsPolling();
+
+    virtual bool readStatsData(quint32 code, QByteArray &buf);
+
 signals:
     void errorCodeChanged();
     void isDeviceOpenedChanged();
 
+    void metricsUpdated(const DriverMetrics &metrics);
+
 public slots:
     virtual bool openDevice();
     virtual bool closeDevice();
@@ -46,7 +62,9 @@ public slots:
     bool writeServices(QByteArray &buf);
     bool writeConf(QByteArray &buf, bool onlyFlags = false);
     bool writeApp(QByteArray &buf, bool remove = false);
+    bool writeApps(QByteArray &buf);
     bool writeZones(QByteArray &buf, bool onlyFlags = false);
+    bool writeRules(QByteArray &buf, bool onlyFlags = false);
 
 protected:
     void setErrorCode(quint32 v);
@@ -57,6 +75,9 @@ private:
     void setupWorker();
     void closeWorker();
 
+    void setupMetricsTimer();
+    void pollMetrics();
+
     bool writeData(quint32 code, QByteArray &buf);
 
     static bool executeCommand(const QString &fileName);
@@ -65,7 +86,11 @@ private:
     quint32 m_errorCode = 0;
 
     Device *m_device = nullptr;
+    Device *m_statsDevice = nullptr;
     DriverWorker *m_driverWorker = nullptr;
+
+    int m_metricsPollingCount = 0;
+    QTimer m_metricsTimer;
 };
 
 #endif // DRIVERMANAGER_H
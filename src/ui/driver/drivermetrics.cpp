@@ -0,0 +1,49 @@
+#include "drivermetrics.h"
+
+quint64 DriverMetrics::latencyCount(Histogram hist) const
+{
+    return fort_metrics_hist_count(PFORT_METRICS_HIST(&m_metrics.hists[hist]));
+}
+
+quint64 DriverMetrics::latencyAverageNs(Histogram hist) const
+{
+    const quint64 count = latencyCount(hist);
+
+    return (count == 0) ? 0 : m_metrics.hists[hist].sum_ns / count;
+}
+
+quint64 DriverMetrics::latencyPercentileNs(Histogram hist, int percent) const
+{
+    return fort_metrics_hist_percentile(PFORT_METRICS_HIST(&m_metrics.hists[hist]), percent);
+}
+
+QVector<quint32> DriverMetrics::latencyBuckets(Histogram hist) const
+{
+    const auto &buckets = m_metrics.hists[hist].buckets;
+
+    return QVector<quint32>(std::begin(buckets), std::end(buckets));
+}
+
+quint64 DriverMetrics::bucketMaxNs(int bucket)
+{
+    return fort_metrics_hist_bucket_max(bucket);
+}
+
+bool DriverMetrics::read(const QByteArray &buf)
+{
+    m_valid = false;
+
+    if (buf.size() < bufferSize())
+        return false;
+
+    const auto metrics = reinterpret_cast<const FORT_DRIVER_METRICS *>(buf.constData());
+
+    // Newer driver could append fields
+    if (metrics->version != FORT_METRICS_VERSION || metrics->size < bufferSize())
+        return false;
+
+    m_metrics = *metrics;
+    m_valid = true;
+
+    return true;
+}
@@ -0,0 +1,55 @@
+#ifndef DRIVERMETRICS_H
+#define DRIVERMETRICS_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include <common/fortmetrics.h>
+
+class DriverMetrics
+{
+public:
+    enum Counter : qint8 {
+        CounterClassify = FORT_METRICS_CLASSIFY,
+        CounterPermit = FORT_METRICS_PERMIT,
+        CounterBlock = FORT_METRICS_BLOCK,
+        CounterLogOverflow = FORT_METRICS_LOG_OVERFLOW,
+        CounterPendingDrop = FORT_METRICS_PENDING_DROP,
+        CounterShaperDrop = FORT_METRICS_SHAPER_DROP,
+        CounterFlowClassify = FORT_METRICS_FLOW_CLASSIFY,
+        CounterCount = FORT_METRICS_COUNTER_COUNT
+    };
+
+    enum Histogram : qint8 {
+        HistAleClassify = FORT_METRICS_HIST_ALE_CLASSIFY,
+        HistFlowClassify = FORT_METRICS_HIST_FLOW_CLASSIFY,
+        HistCount = FORT_METRICS_HIST_COUNT
+    };
+
+    bool isValid() const { return m_valid; }
+
+    quint32 flowsCount() const { return m_metrics.flows_n; }
+    quint32 flowBucketsCount() const { return m_metrics.flow_buckets_n; }
+
+    quint64 counter(Counter counter) const { return m_metrics.counters[counter]; }
+
+    quint64 latencyCount(Histogram hist) const;
+    quint64 latencyAverageNs(Histogram hist) const;
+    quint64 latencyPercentileNs(Histogram hist, int percent) const;
+
+    QVector<quint32> latencyBuckets(Histogram hist) const;
+
+    static int bucketsCount() { return FORT_METRICS_HIST_BUCKETS; }
+    static quint64 bucketMaxNs(int bucket);
+
+    static int bufferSize() { return sizeof(FORT_DRIVER_METRICS); }
+
+    bool read(const QByteArray &buf);
+
+private:
+    bool m_valid = false;
+
+    FORT_DRIVER_METRICS m_metrics {};
+};
+
+#endif // DRIVERMETRICS_H
@@ -2,11 +2,25 @@
 
 #include <driver/drivercommon.h>
 #include <log/logbuffer.h>
+#include <log/logtracefile.h>
 #include <util/device.h>
 #include <util/osutil.h>
 
 DriverWorker::DriverWorker(Device *device, QObject *parent) : QObject(parent), m_device(device) { }
 
+DriverWorker::~DriverWorker() = default;
+
+void DriverWorker::setLogTraceFilePath(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_logTraceFile.reset(new LogTraceFile(filePath));
+
+    if (!m_logTraceFile->openWrite()) {
+        m_logTraceFile.reset();
+    }
+}
+
 void DriverWorker::run()
 {
     OsUtil::setCurrentThreadName("DriverWorker");
@@ -119,9 +133,20 @@ void DriverWorker::readLog()
 
     if (success) {
         m_logBuffer->reset(nr);
+
+        writeLogTrace(array.constData(), int(nr));
     } else if (!m_cancelled) {
         errorCode = OsUtil::lastErrorCode();
     }
 
     emitReadLogResult(success, errorCode);
 }
+
+void DriverWorker::writeLogTrace(const char *data, int size)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_logTraceFile && !m_logTraceFile->writeBuffer(data, size)) {
+        m_logTraceFile.reset(); // stop tracing on write error
+    }
+}
@@ -4,10 +4,12 @@
 #include <QMutex>
 #include <QObject>
 #include <QRunnable>
+#include <QScopedPointer>
 #include <QWaitCondition>
 
 class Device;
 class LogBuffer;
+class LogTraceFile;
 
 class DriverWorker : public QObject, public QRunnable
 {
@@ -15,6 +17,9 @@ class DriverWorker : public QObject, public QRunnable
 
 public:
     explicit DriverWorker(Device *device, QObject *parent = nullptr);
+    ~DriverWorker() override;
+
+    void setLogTraceFilePath(const QString &filePath);
 
     void run() override;
 
@@ -33,6 +38,8 @@ private:
 
     void readLog();
 
+    void writeLogTrace(const char *data, int size);
+
 private:
     volatile bool m_isLogReading = false;
     volatile bool m_cancelled = false;
@@ -42,6 +49,8 @@ private:
 
     LogBuffer *m_logBuffer = nullptr;
 
+    QScopedPointer<LogTraceFile> m_logTraceFile;
+
     QMutex m_mutex;
     QWaitCondition m_bufferWaitCondition;
     QWaitCondition m_cancelledWaitCondition;
@@ -0,0 +1,180 @@
+#include "tracedecoder.h"
+
+#include <common/forttrc.h>
+
+namespace {
+
+QString flowIdText(quint32 low, quint32 high)
+{
+    return "0x" + QString::number((quint64(high) << 32) | low, 16);
+}
+
+QString statusText(quint32 status)
+{
+    return "0x" + QString::number(status, 16).rightJustified(8, '0');
+}
+
+}
+
+bool TraceDecoder::read(const QByteArray &buf, int *count)
+{
+    if (buf.size() < int(sizeof(FORT_TRC_HEADER)))
+        return false;
+
+    const auto header = reinterpret_cast<const FORT_TRC_HEADER *>(buf.constData());
+
+    if (header->version != FORT_TRC_VERSION || header->record_size != sizeof(FORT_TRC_RECORD))
+        return false;
+
+    const qint64 recordsSize = qint64(header->count) * sizeof(FORT_TRC_RECORD);
+    if (buf.size() - int(sizeof(FORT_TRC_HEADER)) < recordsSize)
+        return false;
+
+    m_lostCount += header->lost;
+    m_ticksFreq = header->ticks_freq;
+
+    const auto recs =
+            reinterpret_cast<const FORT_TRC_RECORD *>(buf.constData() + FORT_TRC_RECORDS_OFF);
+
+    m_records.reserve(m_records.size() + header->count);
+
+    for (quint32 i = 0; i < header->count; ++i) {
+        const FORT_TRC_RECORD &r = recs[i];
+
+        TraceRecord rec;
+        rec.seq = r.seq;
+        rec.timestamp = r.timestamp;
+        rec.eventId = r.event_id;
+        rec.cpu = r.cpu;
+        std::copy(std::begin(r.data), std::end(r.data), std::begin(rec.data));
+
+        m_records.append(rec);
+    }
+
+    if (count) {
+        *count = header->count;
+    }
+
+    return true;
+}
+
+void TraceDecoder::clear()
+{
+    m_lostCount = 0;
+    m_ticksFreq = 0;
+    m_records.clear();
+}
+
+qint64 TraceDecoder::recordTimeUs(const TraceRecord &rec) const
+{
+    if (m_ticksFreq <= 0 || m_records.isEmpty())
+        return 0;
+
+    // Relative to the first record
+    const qint64 ticks = rec.timestamp - m_records.first().timestamp;
+
+    return (ticks / m_ticksFreq) * 1000000 + (ticks % m_ticksFreq) * 1000000 / m_ticksFreq;
+}
+
+QString TraceDecoder::recordText(const TraceRecord &rec) const
+{
+    const qint64 timeUs = recordTimeUs(rec);
+
+    return QString("%1 +%2.%3 cpu%4 %5 %6")
+            .arg(QString::number(rec.seq), QString::number(timeUs / 1000000),
+                    QString::number(timeUs % 1000000).rightJustified(6, '0'),
+                    QString::number(rec.cpu), eventName(rec.eventId), eventDataText(rec));
+}
+
+QString TraceDecoder::toText() const
+{
+    QString text;
+
+    if (m_lostCount != 0) {
+        text += QString("# lost: %1\n").arg(m_lostCount);
+    }
+
+    for (const TraceRecord &rec : m_records) {
+        text += recordText(rec) + '\n';
+    }
+
+    return text;
+}
+
+QString TraceDecoder::toCsv() const
+{
+    QString text = "seq,time_us,cpu,event,data0,data1,data2\n";
+
+    for (const TraceRecord &rec : m_records) {
+        text += QString("%1,%2,%3,%4,%5,%6,%7\n")
+                        .arg(QString::number(rec.seq), QString::number(recordTimeUs(rec)),
+                                QString::number(rec.cpu), eventName(rec.eventId),
+                                QString::number(rec.data[0]), QString::number(rec.data[1]),
+                                QString::number(rec.data[2]));
+    }
+
+    return text;
+}
+
+QString TraceDecoder::eventName(quint16 eventId)
+{
+    switch (eventId) {
+    case FORT_TRC_CONF_APPLY:
+        return "CONF_APPLY";
+    case FORT_TRC_REAUTH:
+        return "REAUTH";
+    case FORT_TRC_FLOW_ASSOCIATE:
+        return "FLOW_ASSOCIATE";
+    case FORT_TRC_FLOW_DELETE:
+        return "FLOW_DELETE";
+    case FORT_TRC_SHAPER_ENQUEUE:
+        return "SHAPER_ENQUEUE";
+    case FORT_TRC_SHAPER_DEQUEUE:
+        return "SHAPER_DEQUEUE";
+    case FORT_TRC_BUFFER_FLUSH:
+        return "BUFFER_FLUSH";
+    default:
+        return QString("EVENT_%1").arg(eventId);
+    }
+}
+
+QString TraceDecoder::eventDataText(const TraceRecord &rec)
+{
+    const quint32 *data = rec.data;
+
+    switch (rec.eventId) {
+    case FORT_TRC_CONF_APPLY:
+        return QString("size=%1 status=%2").arg(QString::number(data[0]), statusText(data[1]));
+    case FORT_TRC_REAUTH:
+        return QString("status=%1").arg(statusText(data[0]));
+    case FORT_TRC_FLOW_ASSOCIATE:
+        return QString("flow=%1 pid=%2")
+                .arg(flowIdText(data[0], data[1]), QString::number(data[2]));
+    case FORT_TRC_FLOW_DELETE:
+        return QString("flow=%1").arg(flowIdText(data[0], data[1]));
+    case FORT_TRC_SHAPER_ENQUEUE:
+        return QString("queue=%1 length=%2 queued=%3")
+                .arg(QString::number(data[0]), QString::number(data[1]),
+                        QString::number(data[2]));
+    case FORT_TRC_SHAPER_DEQUEUE:
+        return QString("queue=%1 packets=%2 queued=%3")
+                .arg(QString::number(data[0]), QString::number(data[1]),
+                        QString::number(data[2]));
+    case FORT_TRC_BUFFER_FLUSH:
+        return QString("size=%1").arg(data[0]);
+    default:
+        return QString("data=%1,%2,%3")
+                .arg(QString::number(data[0]), QString::number(data[1]),
+                        QString::number(data[2]));
+    }
+}
+
+int TraceDecoder::bufferSize(int recordsCount)
+{
+    return FORT_TRC_RECORDS_OFF + FORT_TRC_RECORDS_SIZE(recordsCount);
+}
+
+int TraceDecoder::ringRecordsCount()
+{
+    return FORT_TRC_RING_RECORDS;
+}
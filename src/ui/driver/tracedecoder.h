@@ -0,0 +1,52 @@
+#ifndef TRACEDECODER_H
+#define TRACEDECODER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+struct TraceRecord
+{
+    qint64 seq = 0;
+    qint64 timestamp = 0;
+
+    quint16 eventId = 0;
+    quint16 cpu = 0;
+
+    quint32 data[3] = {};
+};
+
+class TraceDecoder
+{
+public:
+    quint32 lostCount() const { return m_lostCount; }
+    qint64 ticksFreq() const { return m_ticksFreq; }
+
+    const QVector<TraceRecord> &records() const { return m_records; }
+
+    // Appends the records of FORT_IOCTL_GETTRACE output
+    bool read(const QByteArray &buf, int *count = nullptr);
+
+    void clear();
+
+    qint64 recordTimeUs(const TraceRecord &rec) const;
+
+    QString recordText(const TraceRecord &rec) const;
+
+    QString toText() const;
+    QString toCsv() const;
+
+    static QString eventName(quint16 eventId);
+    static QString eventDataText(const TraceRecord &rec);
+
+    static int bufferSize(int recordsCount);
+    static int ringRecordsCount();
+
+private:
+    quint32 m_lostCount = 0;
+    qint64 m_ticksFreq = 0;
+
+    QVector<TraceRecord> m_records;
+};
+
+#endif // TRACEDECODER_H
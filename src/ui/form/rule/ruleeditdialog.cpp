@@ -19,8 +19,10 @@
 #include <manager/windowmanager.h>
 #include <model/rulesetmodel.h>
 #include <util/conf/confutil.h>
+#include <util/conf/ruleexpr.h>
 #include <util/iconcache.h>
 #include <util/net/netutil.h>
+#include <util/textareautil.h>
 
 #include "rulescontroller.h"
 #include "ruleswindow.h"
@@ -142,7 +144,11 @@ void RuleEditDialog::retranslateRulePlaceholderText()
             + '\n' + tr("# IP address and port:")
             + "\n1.1.1.1:udp(43)"
               "\n(1.1.1.1-8.8.8.8):(43,80-8080)"
-              "\n\n!!! UNDER CONSTRUCTION !!!";
+            // Local Port
+            + "\n\n" + tr("# Local port:") + "\nlocal:tcp(80, 443)"
+            // Alternatives
+            + "\n\n" + tr("# Lines or 'or' separate alternatives, {} groups them:")
+            + "\n{ 10.0.0.0/8 or 192.168.0.0/16 } *:tcp";
 
     m_editRuleText->setPlaceholderText(placeholderText);
 }
@@ -180,9 +186,6 @@ QLayout *RuleEditDialog::setupMainLayout()
     // Rule Text
     m_editRuleText = new PlainTextEdit();
 
-    // TODO: Implement Rules
-    m_editRuleText->setEnabled(false);
-
     // RuleSet Header
     auto ruleSetHeaderLayout = setupRuleSetHeaderLayout();
 
@@ -412,6 +415,15 @@ bool RuleEditDialog::validateFields() const
         }
     }
 
+    // Rule Text
+    RuleExpr ruleExpr;
+    if (!ruleExpr.parse(m_editRuleText->toPlainText())) {
+        windowManager()->showErrorBox(ruleExpr.errorLineAndMessageDetails());
+        TextAreaUtil::moveCursor(m_editRuleText, ruleExpr.errorPos());
+        m_editRuleText->setFocus();
+        return false;
+    }
+
     return true;
 }
 
@@ -0,0 +1,258 @@
+#include "diagnosticspage.h"
+
+#include <QGridLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+#include <qcustomplot.h>
+
+#include <driver/drivermanager.h>
+#include <driver/tracedecoder.h>
+#include <form/controls/controlutil.h>
+#include <form/dialog/dialogutil.h>
+#include <manager/windowmanager.h>
+#include <util/fileutil.h>
+#include <util/ioc/ioccontainer.h>
+
+namespace {
+
+QString formatNs(quint64 ns)
+{
+    if (ns < 1000)
+        return QString("%1 ns").arg(ns);
+
+    if (ns < 1000 * 1000)
+        return QString("%1 us").arg(double(ns) / 1000, 0, 'f', 1);
+
+    return QString("%1 ms").arg(double(ns) / (1000 * 1000), 0, 'f', 1);
+}
+
+}
+
+DiagnosticsPage::DiagnosticsPage(StatisticsController *ctrl, QWidget *parent) :
+    StatBasePage(ctrl, parent)
+{
+    setupUi();
+}
+
+DriverManager *DiagnosticsPage::driverManager() const
+{
+    return IoC<DriverManager>();
+}
+
+void DiagnosticsPage::onRetranslateUi()
+{
+    m_btExportTrace->setText(tr("Export Trace..."));
+
+    m_labelCounterNames[DriverMetrics::CounterClassify]->setText(tr("Classified connections:"));
+    m_labelCounterNames[DriverMetrics::CounterPermit]->setText(tr("Permitted:"));
+    m_labelCounterNames[DriverMetrics::CounterBlock]->setText(tr("Blocked:"));
+    m_labelCounterNames[DriverMetrics::CounterLogOverflow]->setText(tr("Log overflows:"));
+    m_labelCounterNames[DriverMetrics::CounterPendingDrop]->setText(tr("Dropped pending packets:"));
+    m_labelCounterNames[DriverMetrics::CounterShaperDrop]->setText(tr("Dropped shaped packets:"));
+    m_labelCounterNames[DriverMetrics::CounterFlowClassify]->setText(tr("Classified flows:"));
+    m_labelFlowsName->setText(tr("Active flows:"));
+
+    updateMetrics(m_prevMetrics);
+}
+
+void DiagnosticsPage::showEvent(QShowEvent *event)
+{
+    StatBasePage::showEvent(event);
+
+    if (!m_isPolling) {
+        m_isPolling = true;
+        driverManager()->startMetricsPolling();
+    }
+}
+
+void DiagnosticsPage::hideEvent(QHideEvent *event)
+{
+    StatBasePage::hideEvent(event);
+
+    if (m_isPolling) {
+        m_isPolling = false;
+        driverManager()->stopMetricsPolling();
+    }
+}
+
+void DiagnosticsPage::setupUi()
+{
+    // Header
+    auto header = setupHeader();
+
+    // Counters
+    auto countersLayout = setupCountersLayout();
+
+    // Latency Histograms
+    m_labelAleLatency = ControlUtil::createLabel();
+    m_plotAleLatency = setupLatencyPlot(m_barsAleLatency);
+
+    m_labelFlowLatency = ControlUtil::createLabel();
+    m_plotFlowLatency = setupLatencyPlot(m_barsFlowLatency);
+
+    auto layout = new QVBoxLayout();
+    layout->addLayout(header);
+    layout->addLayout(countersLayout);
+    layout->addWidget(ControlUtil::createHSeparator());
+    layout->addWidget(m_labelAleLatency);
+    layout->addWidget(m_plotAleLatency, 1);
+    layout->addWidget(m_labelFlowLatency);
+    layout->addWidget(m_plotFlowLatency, 1);
+
+    this->setLayout(layout);
+
+    connect(driverManager(), &DriverManager::metricsUpdated, this,
+            &DiagnosticsPage::updateMetrics);
+}
+
+QLayout *DiagnosticsPage::setupHeader()
+{
+    m_btExportTrace = ControlUtil::createButton(":/icons/save_as.png", [&] { exportTrace(); });
+
+    // The driver is used by the service
+    m_btExportTrace->setEnabled(driverManager()->device() != nullptr);
+
+    auto layout = ControlUtil::createHLayoutByWidgets({ m_btExportTrace, /*stretch*/ nullptr });
+
+    return layout;
+}
+
+QLayout *DiagnosticsPage::setupCountersLayout()
+{
+    auto layout = new QGridLayout();
+    layout->setColumnStretch(2, 1);
+
+    for (int i = 0; i < DriverMetrics::CounterCount; ++i) {
+        m_labelCounterNames[i] = ControlUtil::createLabel();
+        m_labelCounters[i] = ControlUtil::createLabel();
+
+        layout->addWidget(m_labelCounterNames[i], i, 0);
+        layout->addWidget(m_labelCounters[i], i, 1);
+    }
+
+    m_labelFlowsName = ControlUtil::createLabel();
+    m_labelFlows = ControlUtil::createLabel();
+
+    layout->addWidget(m_labelFlowsName, DriverMetrics::CounterCount, 0);
+    layout->addWidget(m_labelFlows, DriverMetrics::CounterCount, 1);
+
+    return layout;
+}
+
+QCustomPlot *DiagnosticsPage::setupLatencyPlot(QCPBars *&bars)
+{
+    auto plot = new QCustomPlot();
+    plot->setMinimumHeight(100);
+
+    // Axis: bucket indexes with the upper bounds as labels
+    QSharedPointer<QCPAxisTickerText> ticker(new QCPAxisTickerText());
+    for (int i = 0; i < DriverMetrics::bucketsCount(); i += 4) {
+        ticker->addTick(i, formatNs(DriverMetrics::bucketMaxNs(i)));
+    }
+
+    auto xAxis = plot->xAxis;
+    xAxis->setTicker(ticker);
+    xAxis->setRange(-1, DriverMetrics::bucketsCount());
+
+    // Bars
+    bars = new QCPBars(plot->xAxis, plot->yAxis);
+    bars->setAntialiased(false);
+    bars->setWidth(0.8);
+
+    return plot;
+}
+
+void DiagnosticsPage::updateMetrics(const DriverMetrics &metrics)
+{
+    updateCounters(metrics);
+
+    updateLatency(metrics, DriverMetrics::HistAleClassify, m_plotAleLatency, m_barsAleLatency,
+            m_labelAleLatency);
+    updateLatency(metrics, DriverMetrics::HistFlowClassify, m_plotFlowLatency, m_barsFlowLatency,
+            m_labelFlowLatency);
+
+    m_prevMetrics = metrics;
+}
+
+void DiagnosticsPage::updateCounters(const DriverMetrics &metrics)
+{
+    for (int i = 0; i < DriverMetrics::CounterCount; ++i) {
+        m_labelCounters[i]->setText(counterText(metrics, DriverMetrics::Counter(i)));
+    }
+
+    m_labelFlows->setText(tr("%1 (%2 buckets)")
+                    .arg(QString::number(metrics.flowsCount()),
+                            QString::number(metrics.flowBucketsCount())));
+}
+
+void DiagnosticsPage::updateLatency(const DriverMetrics &metrics, DriverMetrics::Histogram hist,
+        QCustomPlot *plot, QCPBars *bars, QLabel *label)
+{
+    const QString title = (hist == DriverMetrics::HistAleClassify)
+            ? tr("Connection classify latency")
+            : tr("Flow classify latency");
+
+    label->setText(QString("%1: %2, p50: %3, p99: %4")
+                           .arg(title, formatNs(metrics.latencyAverageNs(hist)),
+                                   formatNs(metrics.latencyPercentileNs(hist, 50)),
+                                   formatNs(metrics.latencyPercentileNs(hist, 99))));
+
+    const QVector<quint32> buckets = metrics.latencyBuckets(hist);
+
+    QVector<double> keys;
+    QVector<double> values;
+    double maxValue = 1;
+
+    for (int i = 0; i < buckets.size(); ++i) {
+        const double value = buckets[i];
+
+        keys.append(i);
+        values.append(value);
+
+        maxValue = qMax(maxValue, value);
+    }
+
+    bars->setData(keys, values, /*alreadySorted=*/true);
+
+    plot->yAxis->setRange(0, maxValue);
+    plot->replot();
+}
+
+QString DiagnosticsPage::counterText(
+        const DriverMetrics &metrics, DriverMetrics::Counter counter) const
+{
+    const quint64 value = metrics.counter(counter);
+
+    if (!m_prevMetrics.isValid() || !metrics.isValid())
+        return QString::number(value);
+
+    const quint64 prevValue = m_prevMetrics.counter(counter);
+    const quint64 rate = (value >= prevValue)
+            ? (value - prevValue) * 1000 / DriverManager::metricsPollingInterval
+            : 0;
+
+    return tr("%1 (%2/s)").arg(QString::number(value), QString::number(rate));
+}
+
+void DiagnosticsPage::exportTrace()
+{
+    TraceDecoder decoder;
+    if (!driverManager()->readTrace(decoder)) {
+        windowManager()->showErrorBox(tr("Cannot read the driver trace"));
+        return;
+    }
+
+    const auto filePath = DialogUtil::getSaveFileName(
+            m_btExportTrace->text(), tr("CSV files (*.csv);;Text files (*.txt)"));
+    if (filePath.isEmpty())
+        return;
+
+    const bool isCsv = filePath.endsWith(".csv", Qt::CaseInsensitive);
+    const QString text = isCsv ? decoder.toCsv() : decoder.toText();
+
+    if (!FileUtil::writeFile(filePath, text)) {
+        windowManager()->showErrorBox(tr("Cannot save the driver trace"));
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef DIAGNOSTICSPAGE_H
+#define DIAGNOSTICSPAGE_H
+
+#include <driver/drivermetrics.h>
+
+#include "statbasepage.h"
+
+class DriverManager;
+class QCPBars;
+class QCustomPlot;
+
+class DiagnosticsPage : public StatBasePage
+{
+    Q_OBJECT
+
+public:
+    explicit DiagnosticsPage(StatisticsController *ctrl = nullptr, QWidget *parent = nullptr);
+
+    DriverManager *driverManager() const;
+
+protected slots:
+    void onRetranslateUi() override;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private:
+    void setupUi();
+    QLayout *setupHeader();
+    QLayout *setupCountersLayout();
+    QCustomPlot *setupLatencyPlot(QCPBars *&bars);
+
+    void updateMetrics(const DriverMetrics &metrics);
+    void updateCounters(const DriverMetrics &metrics);
+    void updateLatency(const DriverMetrics &metrics, DriverMetrics::Histogram hist,
+            QCustomPlot *plot, QCPBars *bars, QLabel *label);
+
+    QString counterText(const DriverMetrics &metrics, DriverMetrics::Counter counter) const;
+
+    void exportTrace();
+
+private:
+    bool m_isPolling = false;
+
+    DriverMetrics m_prevMetrics;
+
+    QPushButton *m_btExportTrace = nullptr;
+
+    QLabel *m_labelCounterNames[DriverMetrics::CounterCount] = {};
+    QLabel *m_labelCounters[DriverMetrics::CounterCount] = {};
+    QLabel *m_labelFlowsName = nullptr;
+    QLabel *m_labelFlows = nullptr;
+
+    QLabel *m_labelAleLatency = nullptr;
+    QCustomPlot *m_plotAleLatency = nullptr;
+    QCPBars *m_barsAleLatency = nullptr;
+
+    QLabel *m_labelFlowLatency = nullptr;
+    QCustomPlot *m_plotFlowLatency = nullptr;
+    QCPBars *m_barsFlowLatency = nullptr;
+};
+
+#endif // DIAGNOSTICSPAGE_H
@@ -14,6 +14,7 @@
 #include <util/iconcache.h>
 
 #include "connectionspage.h"
+#include "diagnosticspage.h"
 #include "trafficpage.h"
 
 StatMainPage::StatMainPage(StatisticsController *ctrl, QWidget *parent) : StatBasePage(ctrl, parent)
@@ -25,6 +26,7 @@ void StatMainPage::onRetranslateUi()
 {
     m_tabWidget->setTabText(0, tr("Traffic"));
     m_tabWidget->setTabText(1, tr("Blocked Connections"));
+    m_tabWidget->setTabText(2, tr("Diagnostics"));
 
     m_btOptions->setText(tr("Options"));
 }
@@ -45,10 +47,12 @@ void StatMainPage::setupTabBar()
 {
     auto statisticsPage = new TrafficPage(ctrl());
     auto connectionsPage = new ConnectionsPage(ctrl());
+    auto diagnosticsPage = new DiagnosticsPage(ctrl());
 
     m_tabWidget = new QTabWidget();
     m_tabWidget->addTab(statisticsPage, IconCache::icon(":/icons/chart_bar.png"), QString());
     m_tabWidget->addTab(connectionsPage, IconCache::icon(":/icons/connect.png"), QString());
+    m_tabWidget->addTab(diagnosticsPage, IconCache::icon(":/icons/information.png"), QString());
 
     setupCornerWidget();
 }
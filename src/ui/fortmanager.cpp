@@ -56,19 +56,23 @@ void showErrorMessage(const QString &errorMessage)
     IoC<WindowManager>()->showErrorBox(errorMessage);
 }
 
+// The databases are opened and migrated in a thread pool
+constexpr quint8 parallelServiceFlags =
+        IocContainer::AutoDelete | IocContainer::IsService | IocContainer::ParallelSetUp;
+
 inline void setupMasterServices(IocContainer *ioc, const FortSettings *settings)
 {
-    ioc->setService(new ConfManager(settings->confFilePath()));
+    ioc->setService(new ConfManager(settings->confFilePath()), parallelServiceFlags);
     ioc->setService(new ConfAppManager());
     ioc->setService(new ConfRuleManager());
     ioc->setService(new ConfZoneManager());
     ioc->setService(new QuotaManager());
-    ioc->setService(new StatManager(settings->statFilePath()));
+    ioc->setService(new StatManager(settings->statFilePath()), parallelServiceFlags);
     ioc->setService(new StatBlockManager(settings->statBlockFilePath()));
     ioc->setService(new AskPendingManager());
     ioc->setService(new AutoUpdateManager(settings->cachePath()));
     ioc->setService(new DriverManager());
-    ioc->setService(new AppInfoManager(settings->cacheFilePath()));
+    ioc->setService(new AppInfoManager(settings->cacheFilePath()), parallelServiceFlags);
     ioc->setService(new LogManager());
     ioc->setService(new ServiceInfoManager());
     ioc->setService(new TaskManager());
@@ -95,6 +99,25 @@ inline void setupClientServices(IocContainer *ioc, const FortSettings *settings)
     ioc->setService<TaskManager>(new TaskManagerRpc());
 }
 
+inline void setupServiceDependencies(IocContainer *ioc)
+{
+    ioc->setDependencies<ConfAppManager, ConfManager>();
+    ioc->setDependencies<ConfRuleManager, ConfManager>();
+    ioc->setDependencies<ConfZoneManager, ConfManager>();
+    ioc->setDependencies<QuotaManager, ConfManager, ConfAppManager, StatManager>();
+    ioc->setDependencies<StatBlockManager, ConfManager>();
+    ioc->setDependencies<AutoUpdateManager, TaskManager, RpcManager>();
+    ioc->setDependencies<LogManager, DriverManager>();
+    ioc->setDependencies<TaskManager, ConfManager>();
+    ioc->setDependencies<RpcManager, ControlManager>();
+    ioc->setDependencies<WindowManager, NativeEventFilter, ConfManager>();
+    ioc->setDependencies<ServiceManager, ControlManager, ConfManager>();
+    ioc->setDependencies<HotKeyManager, NativeEventFilter>();
+    ioc->setDependencies<TranslationManager, ConfManager>();
+    ioc->setDependencies<AppInfoCache, AppInfoManager>();
+    ioc->setDependencies<ZoneListModel, ConfZoneManager>();
+}
+
 inline void setupServices(IocContainer *ioc, const FortSettings *settings)
 {
     if (settings->isMaster()) {
@@ -124,8 +147,10 @@ inline void setupServices(IocContainer *ioc, const FortSettings *settings)
     ioc->setService(new NativeEventFilter());
     ioc->setService(new AppInfoCache());
     ioc->setService(new DbErrorManager());
-    ioc->setService(new HostInfoCache());
+    ioc->setService(new HostInfoCache(settings->hostInfoFilePath()), parallelServiceFlags);
     ioc->setService(new ZoneListModel());
+
+    setupServiceDependencies(ioc);
 }
 
 }
@@ -229,6 +254,8 @@ void FortManager::createManagers()
     }
 
     ioc->setUpAll();
+
+    qCDebug(LC).noquote() << "Services set up:\n" << ioc->setUpReport();
 }
 
 void FortManager::deleteManagers()
@@ -419,9 +446,9 @@ void FortManager::setupConfManager()
 
 void FortManager::setupQuotaManager()
 {
-    connect(IoC<QuotaManager>(), &QuotaManager::alert, this, [&](qint8 alertType) {
+    connect(IoC<QuotaManager>(), &QuotaManager::alert, this, [&](qint8 alertType, int percent) {
         IoC<WindowManager>()->showInfoBox(
-                QuotaManager::alertTypeText(alertType), tr("Quota Alert"));
+                QuotaManager::alertTypeText(alertType, percent), tr("Quota Alert"));
     });
 }
 
@@ -464,8 +491,8 @@ void FortManager::setupServiceInfoManager()
 {
     auto serviceInfoManager = IoC<ServiceInfoManager>();
 
-    connect(serviceInfoManager, &ServiceInfoManager::servicesStarted, IoC<ConfManager>(),
-            &ConfManager::updateDriverServices);
+    connect(serviceInfoManager, &ServiceInfoManager::servicesChanged, IoC<ConfManager>(),
+            &ConfManager::updateDriverServicesDelta);
 }
 
 void FortManager::processRestartRequired(const QString &info)
@@ -538,6 +565,7 @@ void FortManager::setupResources()
     Q_INIT_RESOURCE(appinfo_migrations);
     Q_INIT_RESOURCE(conf_migrations);
     Q_INIT_RESOURCE(conf_zone);
+    Q_INIT_RESOURCE(hostinfo_migrations);
     Q_INIT_RESOURCE(stat_migrations);
 
     Q_INIT_RESOURCE(fort_icons);
@@ -53,6 +53,11 @@ QString FortSettings::cacheFilePath() const
     return noCache() && !hasService() ? ":memory:" : cachePath() + "appinfo.db";
 }
 
+QString FortSettings::hostInfoFilePath() const
+{
+    return noCache() && !hasService() ? ":memory:" : cachePath() + "hostinfo.db";
+}
+
 QString FortSettings::passwordUnlockedTillText() const
 {
     if (passwordUnlockType() == UnlockDisabled)
@@ -128,6 +133,9 @@ void FortSettings::setupGlobal()
     m_cachePath = settings.value("global/cacheDir").toString();
     m_userPath = settings.value("global/userDir").toString();
     m_logsPath = settings.value("global/logsDir").toString();
+
+    // Record raw driver log buffers for offline replay
+    m_logTraceFilePath = settings.value("global/logTraceFile").toString();
 }
 
 void FortSettings::initialize(const QStringList &args, EnvManager *envManager)
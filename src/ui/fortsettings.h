@@ -58,11 +58,14 @@ public:
 
     QString cachePath() const { return m_cachePath; }
     QString cacheFilePath() const;
+    QString hostInfoFilePath() const;
 
     QString userPath() const { return m_userPath; }
 
     QString logsPath() const { return m_logsPath; }
 
+    QString logTraceFilePath() const { return m_logTraceFilePath; }
+
     QString controlCommand() const { return m_controlCommand; }
 
     const QStringList &args() const { return m_args; }
@@ -151,6 +154,7 @@ private:
     QString m_cachePath;
     QString m_userPath;
     QString m_logsPath;
+    QString m_logTraceFilePath;
     QString m_controlCommand;
     QStringList m_args;
 };
@@ -6,7 +6,11 @@
 class HostInfo
 {
 public:
-    QString hostName;
+    bool isExpired(qint64 unixTime) const { return expireTime <= unixTime; }
+
+public:
+    qint64 expireTime = 0; // unix time
+    QString hostName; // empty, if not resolved
 };
 
 #endif // HOSTINFO_H
@@ -1,64 +1,236 @@
 #include "hostinfocache.h"
 
+#include <QLoggingCategory>
+
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/dateutil.h>
+
 #include "hostinfomanager.h"
 
-HostInfoCache::HostInfoCache(QObject *parent) :
-    QObject(parent), m_manager(new HostInfoManager(this)), m_cache(1000)
+namespace {
+
+const QLoggingCategory LC("hostInfo");
+
+constexpr int DATABASE_USER_VERSION = 1;
+
+constexpr int HOST_CACHE_MAX_COUNT = 1000;
+
+const char *const sqlSelectHost = "SELECT host_name, expire_time FROM host WHERE address = ?1;";
+
+const char *const sqlUpsertHost = "INSERT OR REPLACE INTO host(address, host_name, expire_time)"
+                                  "  VALUES(?1, ?2, ?3);";
+
+const char *const sqlDeleteExpiredHosts = "DELETE FROM host WHERE expire_time <= ?1;";
+
+const char *const sqlDeleteAllHosts = "DELETE FROM host;";
+
+}
+
+HostInfoCache::HostInfoCache(const QString &filePath, QObject *parent) :
+    QObject(parent),
+    m_manager(new HostInfoManager(this)),
+    m_sqliteDb(new SqliteDb(filePath)),
+    m_cache(HOST_CACHE_MAX_COUNT),
+    m_saveTimer(1000)
 {
     connect(m_manager, &HostInfoManager::lookupFinished, this,
             &HostInfoCache::handleFinishedLookup);
 
     connect(&m_triggerTimer, &QTimer::timeout, this, &HostInfoCache::cacheChanged);
+    connect(&m_saveTimer, &QTimer::timeout, this, &HostInfoCache::saveHostInfos);
 }
 
 HostInfoCache::~HostInfoCache()
 {
-    clear();
     close();
 }
 
-QString HostInfoCache::hostName(const QString &address)
+int HostInfoCache::lookupConcurrency() const
 {
-    HostInfo *hostInfo = m_cache.object(address);
+    return m_manager->maxWorkersCount();
+}
 
-    if (hostInfo) {
-        return hostInfo->hostName;
-    }
+void HostInfoCache::setLookupConcurrency(int v)
+{
+    m_manager->setMaxWorkersCount(qMax(v, 1));
+}
+
+void HostInfoCache::setResolver(const HostResolverPtr &resolver)
+{
+    m_manager->setResolver(resolver);
+}
 
-    hostInfo = new HostInfo();
+int HostInfoCache::pendingCount() const
+{
+    return m_manager->pendingCount();
+}
 
-    m_cache.insert(address, hostInfo, 1);
-    /* hostInfo may be deleted */
+void HostInfoCache::setUp()
+{
+    m_isDbOpened = setupDb();
 
-    m_manager->lookupHost(address);
+    deleteExpiredHostInfos();
+}
 
-    return {};
+QString HostInfoCache::hostName(const QString &address)
+{
+    HostInfo hostInfo;
+
+    const HostInfo *cachedHostInfo = m_cache.object(address);
+    if (cachedHostInfo) {
+        hostInfo = *cachedHostInfo;
+    } else {
+        loadHostInfo(address, hostInfo);
+
+        m_cache.insert(address, new HostInfo(hostInfo), 1);
+    }
+
+    // The expired host name is used till the lookup is finished
+    if (hostInfo.isExpired(currentUnixTime())) {
+        m_manager->lookupHost(address);
+    }
+
+    return hostInfo.hostName;
 }
 
 void HostInfoCache::clear()
 {
-    m_manager->clear();
+    m_manager->clearLookups();
     m_cache.clear();
 
+    m_saveTimer.stop();
+    m_unsavedHostInfos.clear();
+
+    if (m_isDbOpened) {
+        sqliteDb()->execute(sqlDeleteAllHosts);
+    }
+
     emitCacheChanged();
 }
 
+qint64 HostInfoCache::currentUnixTime() const
+{
+    return DateUtil::getUnixTime();
+}
+
 void HostInfoCache::close()
 {
     m_manager->abortWorkers();
+
+    m_saveTimer.stop();
+    saveHostInfos();
 }
 
-void HostInfoCache::handleFinishedLookup(const QString &address, const QString &hostName)
+void HostInfoCache::handleFinishedLookup(const QString &address, const HostLookup &lookup)
 {
-    HostInfo *hostInfo = m_cache.object(address);
-    if (!hostInfo)
-        return;
+    const qint32 ttlSecs = (lookup.ttlSecs > 0)
+            ? lookup.ttlSecs
+            : (lookup.ok ? m_positiveTtlSecs : m_negativeTtlSecs);
+
+    HostInfo hostInfo;
+    hostInfo.expireTime = currentUnixTime() + ttlSecs;
+    hostInfo.hostName = lookup.hostName;
 
-    hostInfo->hostName = hostName;
+    m_cache.insert(address, new HostInfo(hostInfo), 1);
+
+    saveHostInfo(address, hostInfo);
 
     emitCacheChanged();
 }
 
+bool HostInfoCache::setupDb()
+{
+    if (!sqliteDb()->open()) {
+        qCCritical(LC) << "File open error:" << sqliteDb()->filePath()
+                       << sqliteDb()->errorMessage();
+        return false;
+    }
+
+    SqliteDb::MigrateOptions opt = {
+        .sqlDir = ":/hostinfo/migrations",
+        .version = DATABASE_USER_VERSION,
+        .recreate = true,
+        .importOldData = false,
+    };
+
+    if (!sqliteDb()->migrate(opt)) {
+        qCCritical(LC) << "Migration error" << sqliteDb()->filePath();
+        return false;
+    }
+
+    return true;
+}
+
+bool HostInfoCache::loadHostInfo(const QString &address, HostInfo &hostInfo)
+{
+    // The unsaved host info is newer
+    const auto it = m_unsavedHostInfos.constFind(address);
+    if (it != m_unsavedHostInfos.constEnd()) {
+        hostInfo = it.value();
+        return true;
+    }
+
+    if (!m_isDbOpened)
+        return false;
+
+    SqliteStmt stmt;
+    if (!DbQuery(sqliteDb()).sql(sqlSelectHost).vars({ address }).prepareRow(stmt))
+        return false;
+
+    hostInfo.hostName = stmt.columnText(0);
+    hostInfo.expireTime = stmt.columnInt64(1);
+
+    return true;
+}
+
+void HostInfoCache::saveHostInfo(const QString &address, const HostInfo &hostInfo)
+{
+    if (!m_isDbOpened)
+        return;
+
+    // Save the lookups by one transaction
+    m_unsavedHostInfos.insert(address, hostInfo);
+
+    m_saveTimer.startTrigger();
+}
+
+void HostInfoCache::saveHostInfos()
+{
+    if (m_unsavedHostInfos.isEmpty())
+        return;
+
+    sqliteDb()->beginWriteTransaction();
+
+    SqliteStmt stmt;
+    bool ok = DbQuery(sqliteDb()).sql(sqlUpsertHost).prepare(stmt);
+
+    for (auto it = m_unsavedHostInfos.constBegin(); ok && it != m_unsavedHostInfos.constEnd();
+            ++it) {
+        const HostInfo &hostInfo = it.value();
+
+        stmt.bindVars({ it.key(), hostInfo.hostName, hostInfo.expireTime });
+
+        ok = sqliteDb()->done(&stmt);
+    }
+
+    if (!sqliteDb()->endTransaction(ok)) {
+        qCWarning(LC) << "Save error:" << sqliteDb()->errorMessage();
+    }
+
+    m_unsavedHostInfos.clear();
+}
+
+void HostInfoCache::deleteExpiredHostInfos()
+{
+    if (!m_isDbOpened)
+        return;
+
+    DbQuery(sqliteDb()).sql(sqlDeleteExpiredHosts).vars({ currentUnixTime() }).executeOk();
+}
+
 void HostInfoCache::emitCacheChanged()
 {
     m_triggerTimer.startTrigger();
@@ -2,12 +2,17 @@
 #define HOSTINFOCACHE_H
 
 #include <QCache>
+#include <QHash>
 #include <QObject>
 
+#include <sqlite/sqlitetypes.h>
+
+#include <util/classhelpers.h>
 #include <util/ioc/iocservice.h>
 #include <util/triggertimer.h>
 
 #include "hostinfo.h"
+#include "hostresolver.h"
 
 class HostInfoManager;
 
@@ -16,8 +21,31 @@ class HostInfoCache : public QObject, public IocService
     Q_OBJECT
 
 public:
-    explicit HostInfoCache(QObject *parent = nullptr);
+    explicit HostInfoCache(const QString &filePath = ":memory:", QObject *parent = nullptr);
     ~HostInfoCache() override;
+    CLASS_DELETE_COPY_MOVE(HostInfoCache)
+
+    constexpr static qint32 DefaultPositiveTtlSecs = 24 * 60 * 60;
+    constexpr static qint32 DefaultNegativeTtlSecs = 60 * 60;
+
+    SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
+
+    HostInfoManager *manager() const { return m_manager; }
+
+    qint32 positiveTtlSecs() const { return m_positiveTtlSecs; }
+    void setPositiveTtlSecs(qint32 v) { m_positiveTtlSecs = v; }
+
+    qint32 negativeTtlSecs() const { return m_negativeTtlSecs; }
+    void setNegativeTtlSecs(qint32 v) { m_negativeTtlSecs = v; }
+
+    int lookupConcurrency() const;
+    void setLookupConcurrency(int v);
+
+    void setResolver(const HostResolverPtr &resolver);
+
+    int pendingCount() const;
+
+    void setUp() override;
 
 signals:
     void cacheChanged();
@@ -27,20 +55,42 @@ public slots:
 
     void clear();
 
+protected:
+    virtual qint64 currentUnixTime() const;
+
 private slots:
     void close();
 
-    void handleFinishedLookup(const QString &address, const QString &hostName);
+    void handleFinishedLookup(const QString &address, const HostLookup &lookup);
+
+    void saveHostInfos();
 
 private:
+    bool setupDb();
+
+    bool loadHostInfo(const QString &address, HostInfo &hostInfo);
+    void saveHostInfo(const QString &address, const HostInfo &hostInfo);
+
+    void deleteExpiredHostInfos();
+
     void emitCacheChanged();
 
 private:
+    bool m_isDbOpened = false;
+
+    qint32 m_positiveTtlSecs = DefaultPositiveTtlSecs;
+    qint32 m_negativeTtlSecs = DefaultNegativeTtlSecs;
+
     HostInfoManager *m_manager = nullptr;
 
+    SqliteDbPtr m_sqliteDb;
+
     QCache<QString, HostInfo> m_cache;
 
+    QHash<QString, HostInfo> m_unsavedHostInfos;
+
     TriggerTimer m_triggerTimer;
+    TriggerTimer m_saveTimer;
 };
 
 #endif // HOSTINFOCACHE_H
@@ -1,15 +1,17 @@
 #include "hostinfojob.h"
 
-#include <util/net/netutil.h>
 #include <util/worker/workerobject.h>
 
 #include "hostinfomanager.h"
 
-HostInfoJob::HostInfoJob(const QString &address) : WorkerJob(address) { }
+HostInfoJob::HostInfoJob(const QString &address, const HostResolverPtr &resolver) :
+    WorkerJob(address), m_resolver(resolver)
+{
+}
 
 void HostInfoJob::doJob(WorkerObject & /*worker*/)
 {
-    m_hostName = NetUtil::getHostName(address());
+    m_lookup = m_resolver->lookupHost(address());
 }
 
 void HostInfoJob::reportResult(WorkerObject &worker)
@@ -19,5 +21,5 @@ void HostInfoJob::reportResult(WorkerObject &worker)
 
 void HostInfoJob::emitFinished(HostInfoManager *manager)
 {
-    emit manager->lookupFinished(address(), m_hostName);
+    emit manager->lookupFinished(address(), m_lookup);
 }
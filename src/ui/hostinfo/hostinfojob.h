@@ -3,12 +3,14 @@
 
 #include <util/worker/workerjob.h>
 
+#include "hostresolver.h"
+
 class HostInfoManager;
 
 class HostInfoJob : public WorkerJob
 {
 public:
-    explicit HostInfoJob(const QString &address);
+    explicit HostInfoJob(const QString &address, const HostResolverPtr &resolver);
 
     QString address() const { return text(); }
 
@@ -19,7 +21,9 @@ private:
     void emitFinished(HostInfoManager *manager);
 
 private:
-    QString m_hostName;
+    HostResolverPtr m_resolver;
+
+    HostLookup m_lookup;
 };
 
 #endif // HOSTINFOJOB_H
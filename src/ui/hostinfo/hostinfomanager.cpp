@@ -2,14 +2,35 @@
 
 #include "hostinfojob.h"
 
-HostInfoManager::HostInfoManager(QObject *parent) : WorkerManager(parent)
+HostInfoManager::HostInfoManager(QObject *parent) :
+    WorkerManager(parent), m_resolver(new HostResolverSystem())
 {
-    setMaxWorkersCount(2);
+    setMaxWorkersCount(DefaultMaxWorkersCount);
 
     QSysInfo::machineHostName(); // Initialize ws2_32.dll
+
+    connect(this, &HostInfoManager::lookupFinished, this, &HostInfoManager::onLookupFinished);
 }
 
 void HostInfoManager::lookupHost(const QString &address)
 {
-    enqueueJob(WorkerJobPtr(new HostInfoJob(address)));
+    // Deduplicate the lookups of the same address
+    if (isPending(address))
+        return;
+
+    m_pendingAddresses.insert(address);
+
+    enqueueJob(WorkerJobPtr(new HostInfoJob(address, m_resolver)));
+}
+
+void HostInfoManager::clearLookups()
+{
+    clear();
+
+    m_pendingAddresses.clear();
+}
+
+void HostInfoManager::onLookupFinished(const QString &address)
+{
+    m_pendingAddresses.remove(address);
 }
@@ -1,8 +1,12 @@
 #ifndef HOSTINFOMANAGER_H
 #define HOSTINFOMANAGER_H
 
+#include <QSet>
+
 #include <util/worker/workermanager.h>
 
+#include "hostresolver.h"
+
 class HostInfoManager : public WorkerManager
 {
     Q_OBJECT
@@ -10,13 +14,32 @@ class HostInfoManager : public WorkerManager
 public:
     explicit HostInfoManager(QObject *parent = nullptr);
 
+    constexpr static int DefaultMaxWorkersCount = 2;
+
+    const HostResolverPtr &resolver() const { return m_resolver; }
+    void setResolver(const HostResolverPtr &resolver) { m_resolver = resolver; }
+
+    // Queued and in-flight lookups
+    int pendingCount() const { return int(m_pendingAddresses.size()); }
+    bool isPending(const QString &address) const { return m_pendingAddresses.contains(address); }
+
     QString workerName() const override { return "HostInfoWorker"; }
 
 signals:
-    void lookupFinished(const QString &address, const QString &hostName);
+    void lookupFinished(const QString &address, const HostLookup &lookup);
 
 public slots:
     void lookupHost(const QString &address);
+
+    void clearLookups();
+
+private:
+    void onLookupFinished(const QString &address);
+
+private:
+    HostResolverPtr m_resolver;
+
+    QSet<QString> m_pendingAddresses;
 };
 
 #endif // HOSTINFOMANAGER_H
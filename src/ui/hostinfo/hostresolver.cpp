@@ -0,0 +1,18 @@
+#include "hostresolver.h"
+
+#include <util/net/netutil.h>
+
+HostLookup HostResolverSystem::lookupHost(const QString &address)
+{
+    HostLookup lookup;
+    lookup.hostName = NetUtil::getHostName(address);
+
+    // The numeric address is returned, when the name is not found
+    lookup.ok = !(lookup.hostName.isEmpty() || lookup.hostName == address);
+
+    if (!lookup.ok) {
+        lookup.hostName.clear();
+    }
+
+    return lookup;
+}
@@ -0,0 +1,35 @@
+#ifndef HOSTRESOLVER_H
+#define HOSTRESOLVER_H
+
+#include <QMetaType>
+#include <QSharedPointer>
+#include <QString>
+
+struct HostLookup
+{
+    bool ok = false; // the host name is resolved
+    qint32 ttlSecs = 0; // default TTL, if zero
+    QString hostName;
+};
+
+Q_DECLARE_METATYPE(HostLookup)
+
+// Backend of the host name lookups, called from the worker threads
+class HostResolver
+{
+public:
+    virtual ~HostResolver() = default;
+
+    virtual HostLookup lookupHost(const QString &address) = 0;
+};
+
+using HostResolverPtr = QSharedPointer<HostResolver>;
+
+// Reverse DNS lookup by the system resolver
+class HostResolverSystem : public HostResolver
+{
+public:
+    HostLookup lookupHost(const QString &address) override;
+};
+
+#endif // HOSTRESOLVER_H
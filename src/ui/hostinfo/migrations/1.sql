@@ -0,0 +1,7 @@
+CREATE TABLE host(
+  address TEXT PRIMARY KEY,
+  host_name TEXT,
+  expire_time INTEGER NOT NULL
+) WITHOUT ROWID;
+
+CREATE INDEX host_expire_time_idx ON host(expire_time);
@@ -159,6 +159,39 @@ void LogBuffer::readEntryBlockedIp(LogEntryBlockedIp *logEntry)
     m_offset += entrySize;
 }
 
+void LogBuffer::writeEntryBlockedIpSum(const LogEntryBlockedIp *logEntry)
+{
+    const int headerSize = int(DriverCommon::logBlockedIpSumHeaderSize());
+    prepareFor(headerSize);
+
+    char *output = this->output();
+
+    DriverCommon::logBlockedIpSumHeaderWrite(
+            output, logEntry->connCount(), logEntry->connTime(), logEntry->connTime());
+
+    m_top += headerSize;
+
+    writeEntryBlockedIp(logEntry);
+}
+
+void LogBuffer::readEntryBlockedIpSum(LogEntryBlockedIp *logEntry)
+{
+    Q_ASSERT(m_offset < m_top);
+
+    const char *input = this->input();
+
+    quint32 hitCount;
+    qint64 firstTime, lastTime;
+    DriverCommon::logBlockedIpSumHeaderRead(input, &hitCount, &firstTime, &lastTime);
+
+    m_offset += int(DriverCommon::logBlockedIpSumHeaderSize());
+
+    readEntryBlockedIp(logEntry);
+
+    logEntry->setConnCount(hitCount);
+    logEntry->setConnTime(lastTime);
+}
+
 void LogBuffer::writeEntryProcNew(const LogEntryProcNew *logEntry)
 {
     const QString path = logEntry->kernelPath();
@@ -201,6 +234,25 @@ void LogBuffer::readEntryProcNew(LogEntryProcNew *logEntry)
     m_offset += entrySize;
 }
 
+void LogBuffer::writeEntryStatTraf(const LogEntryStatTraf *logEntry)
+{
+    const quint16 procCount = logEntry->procCount();
+
+    const int entrySize = int(DriverCommon::logStatSize(procCount));
+    prepareFor(entrySize);
+
+    char *output = this->output();
+
+    DriverCommon::logStatTrafHeaderWrite(output, procCount);
+
+    if (procCount != 0) {
+        output += DriverCommon::logStatHeaderSize();
+        memcpy(output, logEntry->procTrafBytes(), DriverCommon::logStatTrafSize(procCount));
+    }
+
+    m_top += entrySize;
+}
+
 void LogBuffer::readEntryStatTraf(LogEntryStatTraf *logEntry)
 {
     Q_ASSERT(m_offset < m_top);
@@ -32,9 +32,13 @@ public:
     void writeEntryBlockedIp(const LogEntryBlockedIp *logEntry);
     void readEntryBlockedIp(LogEntryBlockedIp *logEntry);
 
+    void writeEntryBlockedIpSum(const LogEntryBlockedIp *logEntry);
+    void readEntryBlockedIpSum(LogEntryBlockedIp *logEntry);
+
     void writeEntryProcNew(const LogEntryProcNew *logEntry);
     void readEntryProcNew(LogEntryProcNew *logEntry);
 
+    void writeEntryStatTraf(const LogEntryStatTraf *logEntry);
     void readEntryStatTraf(LogEntryStatTraf *logEntry);
 
     void writeEntryTime(const LogEntryTime *logEntry);
@@ -42,6 +42,11 @@ void LogEntryBlockedIp::setConnTime(qint64 connTime)
     m_connTime = connTime;
 }
 
+void LogEntryBlockedIp::setConnCount(quint32 connCount)
+{
+    m_connCount = connCount;
+}
+
 void LogEntryBlockedIp::setLocalIp(ip_addr_t &ip)
 {
     m_localIp = ip;
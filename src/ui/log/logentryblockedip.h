@@ -34,6 +34,9 @@ public:
     qint64 connTime() const { return m_connTime; }
     void setConnTime(qint64 connTime);
 
+    quint32 connCount() const { return m_connCount; }
+    void setConnCount(quint32 connCount);
+
     const ip_addr_t &localIp() const { return m_localIp; }
     ip_addr_t &localIp() { return m_localIp; }
     void setLocalIp(ip_addr_t &ip);
@@ -64,6 +67,7 @@ private:
     quint8 m_ipProto = 0;
     quint16 m_localPort = 0;
     quint16 m_remotePort = 0;
+    quint32 m_connCount = 1;
     qint64 m_connTime = 0;
     ip_addr_t m_localIp;
     ip_addr_t m_remoteIp;
@@ -123,18 +123,24 @@ void LogManager::processLogBuffer(LogBuffer *logBuffer, bool success, quint32 er
     addFreeBuffer(logBuffer);
 }
 
-void LogManager::processLogEntries(LogBuffer *logBuffer)
+int LogManager::processLogEntries(LogBuffer *logBuffer)
 {
     // XXX: OsUtil::setThreadIsBusy(true);
 
+    int count = 0;
+
     for (;;) {
         const FortLogType logType = logBuffer->peekEntryType();
 
         if (!processLogEntry(logBuffer, logType))
             break;
+
+        ++count;
     }
 
     // XXX: OsUtil::setThreadIsBusy(false);
+
+    return count;
 }
 
 bool LogManager::processLogEntry(LogBuffer *logBuffer, FortLogType logType)
@@ -145,6 +151,8 @@ bool LogManager::processLogEntry(LogBuffer *logBuffer, FortLogType logType)
         return processLogEntryBlocked(logBuffer);
     case FORT_LOG_TYPE_BLOCKED_IP:
         return processLogEntryBlockedIp(logBuffer);
+    case FORT_LOG_TYPE_BLOCKED_IP_SUM:
+        return processLogEntryBlockedIpSum(logBuffer);
     case FORT_LOG_TYPE_PROC_NEW:
         return processLogEntryProcNew(logBuffer);
     case FORT_LOG_TYPE_STAT_TRAF:
@@ -173,13 +181,28 @@ bool LogManager::processLogEntryBlockedIp(LogBuffer *logBuffer)
 
     blockedIpEntry.setConnTime(currentUnixTime());
 
+    logBlockedIp(blockedIpEntry);
+
+    return true;
+}
+
+bool LogManager::processLogEntryBlockedIpSum(LogBuffer *logBuffer)
+{
+    LogEntryBlockedIp blockedIpEntry;
+    logBuffer->readEntryBlockedIpSum(&blockedIpEntry);
+
+    logBlockedIp(blockedIpEntry);
+
+    return true;
+}
+
+void LogManager::logBlockedIp(const LogEntryBlockedIp &blockedIpEntry)
+{
     if (blockedIpEntry.isAskPending()) {
         IoC<AskPendingManager>()->logBlockedIp(blockedIpEntry);
     } else {
         IoC<StatBlockManager>()->logBlockedIp(blockedIpEntry);
     }
-
-    return true;
 }
 
 bool LogManager::processLogEntryProcNew(LogBuffer *logBuffer)
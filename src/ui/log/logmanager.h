@@ -8,6 +8,7 @@
 
 class LogBuffer;
 class LogEntry;
+class LogEntryBlockedIp;
 
 class LogManager : public QObject, public IocService
 {
@@ -23,6 +24,9 @@ public:
     void setUp() override;
     void tearDown() override;
 
+    // Returns the count of processed entries
+    int processLogEntries(LogBuffer *logBuffer);
+
 signals:
     void activeChanged();
     void errorMessageChanged();
@@ -43,10 +47,11 @@ private:
     LogBuffer *getFreeBuffer();
     void addFreeBuffer(LogBuffer *logBuffer);
 
-    void processLogEntries(LogBuffer *logBuffer);
     bool processLogEntry(LogBuffer *logBuffer, FortLogType logType);
     bool processLogEntryBlocked(LogBuffer *logBuffer);
     bool processLogEntryBlockedIp(LogBuffer *logBuffer);
+    bool processLogEntryBlockedIpSum(LogBuffer *logBuffer);
+    void logBlockedIp(const LogEntryBlockedIp &blockedIpEntry);
     bool processLogEntryProcNew(LogBuffer *logBuffer);
     bool processLogEntryStatTraf(LogBuffer *logBuffer);
     bool processLogEntryTime(LogBuffer *logBuffer);
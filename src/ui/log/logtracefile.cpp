@@ -0,0 +1,109 @@
+#include "logtracefile.h"
+
+#include <QLoggingCategory>
+
+#include "logbuffer.h"
+
+namespace {
+
+const QLoggingCategory LC("log.traceFile");
+
+constexpr quint32 traceMagic = 0x52544C46; // "FLTR"
+constexpr quint32 traceVersion = 1;
+
+struct TraceHeader
+{
+    quint32 magic;
+    quint32 version;
+};
+
+struct TraceRecordHeader
+{
+    qint64 elapsedNsecs;
+    quint32 size;
+};
+
+}
+
+LogTraceFile::LogTraceFile(const QString &filePath) : m_file(filePath) { }
+
+bool LogTraceFile::openWrite()
+{
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qCWarning(LC) << "File open error:" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    const TraceHeader header = { traceMagic, traceVersion };
+
+    if (m_file.write((const char *) &header, sizeof(header)) != sizeof(header)) {
+        close();
+        return false;
+    }
+
+    m_timer.start();
+
+    return true;
+}
+
+bool LogTraceFile::openRead()
+{
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        qCWarning(LC) << "File open error:" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    TraceHeader header;
+
+    if (m_file.read((char *) &header, sizeof(header)) != sizeof(header)
+            || header.magic != traceMagic || header.version != traceVersion) {
+        qCWarning(LC) << "Bad trace file:" << m_file.fileName();
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void LogTraceFile::close()
+{
+    m_file.close();
+}
+
+bool LogTraceFile::writeBuffer(const char *data, int size)
+{
+    const TraceRecordHeader header = { m_timer.nsecsElapsed(), quint32(size) };
+
+    if (m_file.write((const char *) &header, sizeof(header)) != sizeof(header)
+            || m_file.write(data, size) != size) {
+        qCWarning(LC) << "File write error:" << m_file.fileName() << m_file.errorString();
+        return false;
+    }
+
+    return true;
+}
+
+bool LogTraceFile::readBuffer(LogBuffer *logBuffer, qint64 &elapsedNsecs)
+{
+    TraceRecordHeader header;
+
+    if (m_file.read((char *) &header, sizeof(header)) != sizeof(header))
+        return false;
+
+    const int size = int(header.size);
+
+    QByteArray &array = logBuffer->array();
+    if (array.size() < size) {
+        array.resize(size);
+    }
+
+    if (m_file.read(array.data(), size) != size) {
+        qCWarning(LC) << "Truncated trace record:" << m_file.fileName();
+        return false;
+    }
+
+    logBuffer->reset(size);
+    elapsedNsecs = header.elapsedNsecs;
+
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef LOGTRACEFILE_H
+#define LOGTRACEFILE_H
+
+#include <QElapsedTimer>
+#include <QFile>
+
+#include <util/classhelpers.h>
+
+class LogBuffer;
+
+// Raw driver log buffers with their read times, recorded for offline replay
+class LogTraceFile
+{
+public:
+    explicit LogTraceFile(const QString &filePath);
+    CLASS_DELETE_COPY_MOVE(LogTraceFile)
+
+    QString filePath() const { return m_file.fileName(); }
+
+    bool isOpen() const { return m_file.isOpen(); }
+
+    bool openWrite();
+    bool openRead();
+    void close();
+
+    // Elapsed nanoseconds from the trace start are saved with each buffer
+    bool writeBuffer(const char *data, int size);
+    bool readBuffer(LogBuffer *logBuffer, qint64 &elapsedNsecs);
+
+private:
+    QFile m_file;
+    QElapsedTimer m_timer;
+};
+
+#endif // LOGTRACEFILE_H
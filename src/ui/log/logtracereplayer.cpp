@@ -0,0 +1,112 @@
+#include "logtracereplayer.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <driver/drivercommon.h>
+
+#include "logbuffer.h"
+#include "logmanager.h"
+#include "logtracefile.h"
+
+namespace {
+
+QString stageStatText(const QString &name, const LogTraceReplayer::StageStat &stat)
+{
+    return QString("%1: count=%2 avg=%3us max=%4us\n")
+            .arg(name)
+            .arg(stat.count)
+            .arg(double(stat.averageNsecs()) / 1000.0, 0, 'f', 2)
+            .arg(double(stat.maxNsecs) / 1000.0, 0, 'f', 2);
+}
+
+}
+
+LogTraceReplayer::LogTraceReplayer(LogManager *logManager) : m_logManager(logManager) { }
+
+double LogTraceReplayer::entriesPerSecond() const
+{
+    return m_busyNsecs > 0 ? double(m_entryCount) * 1e9 / double(m_busyNsecs) : 0.0;
+}
+
+bool LogTraceReplayer::replay(const QString &filePath, Speed speed)
+{
+    reset();
+
+    LogTraceFile traceFile(filePath);
+    if (!traceFile.openRead())
+        return false;
+
+    LogBuffer logBuffer(DriverCommon::bufferSize());
+
+    QElapsedTimer replayTimer;
+    replayTimer.start();
+
+    qint64 waitNsecs = 0;
+
+    for (;;) {
+        QElapsedTimer stageTimer;
+        stageTimer.start();
+
+        qint64 elapsedNsecs = 0;
+        if (!traceFile.readBuffer(&logBuffer, elapsedNsecs))
+            break;
+
+        addStageTime(m_readStat, stageTimer.nsecsElapsed());
+
+        if (speed == SpeedRealTime) {
+            const qint64 aheadNsecs = elapsedNsecs - replayTimer.nsecsElapsed();
+            if (aheadNsecs > 0) {
+                QThread::usleep(quint64(aheadNsecs / 1000));
+                waitNsecs += aheadNsecs;
+            }
+        }
+
+        stageTimer.restart();
+
+        m_entryCount += m_logManager->processLogEntries(&logBuffer);
+
+        addStageTime(m_processStat, stageTimer.nsecsElapsed());
+
+        // Let the managers handle their queued signals
+        QCoreApplication::processEvents();
+
+        ++m_bufferCount;
+    }
+
+    m_busyNsecs = qMax(replayTimer.nsecsElapsed() - waitNsecs, qint64(0));
+
+    return true;
+}
+
+QString LogTraceReplayer::report() const
+{
+    QString text = QString("buffers=%1 entries=%2 busy=%3ms rate=%4 entries/s\n")
+                           .arg(m_bufferCount)
+                           .arg(m_entryCount)
+                           .arg(double(m_busyNsecs) / 1e6, 0, 'f', 2)
+                           .arg(entriesPerSecond(), 0, 'f', 0);
+
+    text += stageStatText("read", m_readStat);
+    text += stageStatText("process", m_processStat);
+
+    return text;
+}
+
+void LogTraceReplayer::reset()
+{
+    m_bufferCount = 0;
+    m_entryCount = 0;
+    m_busyNsecs = 0;
+
+    m_readStat = {};
+    m_processStat = {};
+}
+
+void LogTraceReplayer::addStageTime(StageStat &stat, qint64 nsecs)
+{
+    ++stat.count;
+    stat.totalNsecs += nsecs;
+    stat.maxNsecs = qMax(stat.maxNsecs, nsecs);
+}
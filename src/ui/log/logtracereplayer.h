@@ -0,0 +1,66 @@
+#ifndef LOGTRACEREPLAYER_H
+#define LOGTRACEREPLAYER_H
+
+#include <QString>
+
+#include <util/classhelpers.h>
+
+class LogBuffer;
+class LogManager;
+
+// Feeds a recorded driver log trace through LogManager into the IoC managers
+class LogTraceReplayer
+{
+public:
+    enum Speed : qint8 {
+        SpeedRealTime = 0, // 1x: keep the recorded intervals between buffers
+        SpeedMax,
+    };
+
+    struct StageStat
+    {
+        qint64 averageNsecs() const { return count > 0 ? totalNsecs / count : 0; }
+
+        int count = 0;
+        qint64 totalNsecs = 0;
+        qint64 maxNsecs = 0;
+    };
+
+    explicit LogTraceReplayer(LogManager *logManager);
+    CLASS_DELETE_COPY_MOVE(LogTraceReplayer)
+
+    int bufferCount() const { return m_bufferCount; }
+    int entryCount() const { return m_entryCount; }
+
+    // Busy time, i.e. without the waiting for 1x speed
+    qint64 busyNsecs() const { return m_busyNsecs; }
+
+    double entriesPerSecond() const;
+
+    const StageStat &readStat() const { return m_readStat; }
+
+    // Buffers processed by LogManager
+    const StageStat &processStat() const { return m_processStat; }
+
+    bool replay(const QString &filePath, Speed speed = SpeedMax);
+
+    QString report() const;
+
+private:
+    void reset();
+
+    static void addStageTime(StageStat &stat, qint64 nsecs);
+
+private:
+    int m_bufferCount = 0;
+    int m_entryCount = 0;
+
+    qint64 m_busyNsecs = 0;
+
+    LogManager *m_logManager = nullptr;
+
+    StageStat m_readStat;
+    StageStat m_processStat;
+};
+
+#endif // LOGTRACEREPLAYER_H
@@ -281,21 +281,31 @@ void ServiceInfoManager::onServiceStateChanged(ServiceMonitor *serviceMonitor)
         onServiceStarted(serviceMonitor);
     } break;
     case ServiceMonitor::ServiceDeleting: {
-        stopServiceMonitor(serviceMonitor);
+        onServiceDeleting(serviceMonitor);
     } break;
     }
 }
 
 void ServiceInfoManager::onServiceStarted(ServiceMonitor *serviceMonitor)
 {
-    constexpr int servicesCount = 1;
+    emitServiceChanged(serviceMonitor, /*isRunning=*/true);
+}
+
+void ServiceInfoManager::onServiceDeleting(ServiceMonitor *serviceMonitor)
+{
+    emitServiceChanged(serviceMonitor, /*isRunning=*/false);
 
-    QVector<ServiceInfo> services(servicesCount);
+    stopServiceMonitor(serviceMonitor);
+}
+
+void ServiceInfoManager::emitServiceChanged(ServiceMonitor *serviceMonitor, bool isRunning)
+{
+    QVector<ServiceInfo> services(1);
 
     ServiceInfo &info = services[0];
-    info.isRunning = true;
-    info.processId = serviceMonitor->processId();
+    info.isRunning = isRunning;
+    info.processId = isRunning ? serviceMonitor->processId() : 0;
     info.serviceName = serviceMonitor->serviceName();
 
-    emit servicesStarted(services, servicesCount);
+    emit servicesChanged(services);
 }
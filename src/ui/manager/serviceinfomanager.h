@@ -26,7 +26,7 @@ public:
     static QString getSvcHostServiceDll(const QString &serviceName);
 
 signals:
-    void servicesStarted(const QVector<ServiceInfo> &services, int runningServicesCount);
+    void servicesChanged(const QVector<ServiceInfo> &services);
 
 public slots:
     virtual void trackService(const QString &serviceName);
@@ -46,6 +46,9 @@ private:
     void onServicesCreated(const QStringList &serviceNames);
     void onServiceStateChanged(ServiceMonitor *serviceMonitor);
     void onServiceStarted(ServiceMonitor *serviceMonitor);
+    void onServiceDeleting(ServiceMonitor *serviceMonitor);
+
+    void emitServiceChanged(ServiceMonitor *serviceMonitor, bool isRunning);
 
 private:
     ServiceListMonitor *m_serviceListMonitor = nullptr;
@@ -85,6 +85,8 @@ void AppStatModel::updateList()
 
     statManager()->getStatAppList(list, m_appIds);
 
+    appInfoCache()->prefetchAppInfos(list);
+
     setList(list);
 }
 
@@ -153,7 +153,7 @@ QVariant ConnBlockListModel::dataDisplay(const QModelIndex &index, int role) con
     case 5:
         return dataDisplayDirection(connRow, role);
     case 6:
-        return connRow.connTime;
+        return dataDisplayTime(connRow, role);
     }
 
     return QVariant();
@@ -170,6 +170,17 @@ QVariant ConnBlockListModel::dataDisplayDirection(const ConnRow &connRow, int ro
     return connRow.inbound ? tr("In") : tr("Out");
 }
 
+QVariant ConnBlockListModel::dataDisplayTime(const ConnRow &connRow, int role) const
+{
+    if (role == Qt::ToolTipRole && connRow.connCount > 1) {
+        // Show count of the aggregated connections in a tool-tip
+        return connRow.connTime.toString() + " (" + tr("%n times", nullptr, connRow.connCount)
+                + ")";
+    }
+
+    return connRow.connTime;
+}
+
 QVariant ConnBlockListModel::dataDecoration(const QModelIndex &index) const
 {
     const int column = index.column();
@@ -297,6 +308,8 @@ bool ConnBlockListModel::updateTableRow(const QVariantHash & /*vars*/, int row)
 
     m_connRow.appPath = stmt.columnText(14);
 
+    m_connRow.connCount = stmt.columnInt64(15);
+
     return true;
 }
 
@@ -322,7 +335,8 @@ QString ConnBlockListModel::sqlBase() const
            "    t.local_ip6,"
            "    t.remote_ip6,"
            "    t.block_reason,"
-           "    a.path"
+           "    a.path,"
+           "    t.conn_count"
            "  FROM conn_block t"
            "    JOIN app a ON a.app_id = t.app_id";
 }
@@ -26,6 +26,7 @@ struct ConnRow : TableRow
     ip_addr_t remoteIp;
 
     quint32 pid = 0;
+    quint32 connCount = 1;
 
     qint64 connId = 0;
     qint64 appId = 0;
@@ -85,6 +86,7 @@ private:
 
     QVariant dataDisplay(const QModelIndex &index, int role) const;
     QVariant dataDisplayDirection(const ConnRow &connRow, int role) const;
+    QVariant dataDisplayTime(const ConnRow &connRow, int role) const;
     QVariant dataDecoration(const QModelIndex &index) const;
 
     static QString blockReasonText(const ConnRow &connRow);
@@ -24,6 +24,7 @@ public slots:
 
 protected:
     void updateAppAccessTime(const QString & /*appPath*/) override { }
+    void updateAppsAccessTime(const QStringList & /*appPaths*/) override { }
 };
 
 #endif // APPINFOMANAGERRPC_H
@@ -1,3 +1,164 @@
 #include "askpendingmanagerrpc.h"
 
+#include <algorithm>
+
+#include <control/controlworker.h>
+#include <rpc/rpcmanager.h>
+#include <util/ioc/ioccontainer.h>
+#include <util/net/netutil.h>
+#include <util/variantutil.h>
+
+namespace {
+
+inline bool processAskPendingManagerRpcResult(
+        AskPendingManager *askPendingManager, const ProcessCommandArgs &p)
+{
+    switch (p.command) {
+    case Control::Rpc_AskPendingManager_decideApps:
+        return askPendingManager->decideApps(
+                p.args.value(0).toStringList(), p.args.value(1).toBool());
+    default:
+        return false;
+    }
+}
+
+}
+
 AskPendingManagerRpc::AskPendingManagerRpc(QObject *parent) : AskPendingManager(parent) { }
+
+bool AskPendingManagerRpc::decideApps(const QStringList &appPaths, bool blocked)
+{
+    return IoC<RpcManager>()->doOnServer(
+            Control::Rpc_AskPendingManager_decideApps, { appPaths, blocked });
+}
+
+void AskPendingManagerRpc::updateConns(const AskPendingChanges &changes, bool isReset)
+{
+    if (isReset) {
+        queue().clear();
+    }
+
+    // Keep the order of recently seen connections
+    QVector<AskPendingConn> updatedConns = changes.updatedConns;
+    std::sort(updatedConns.begin(), updatedConns.end(),
+            [](const AskPendingConn &a, const AskPendingConn &b) {
+                return a.lastTime < b.lastTime;
+            });
+
+    for (const AskPendingConn &conn : std::as_const(updatedConns)) {
+        queue().updateConn(conn);
+    }
+
+    for (const quint32 connId : changes.removedConnIds) {
+        queue().removeConn(connId);
+    }
+
+    emitConnsChanged();
+}
+
+QVariantList AskPendingManagerRpc::connToVarList(const AskPendingConn &conn)
+{
+    const QVariant remoteIp = conn.isIPv6 ? QVariant(NetUtil::ip6ToRawArray(conn.remoteIp))
+                                          : QVariant(conn.remoteIp.v4);
+
+    return { conn.isIPv6, conn.inbound, conn.ipProto, conn.remotePort, conn.connId, conn.hitCount,
+        conn.firstTime, conn.lastTime, remoteIp, conn.appPath };
+}
+
+AskPendingConn AskPendingManagerRpc::varListToConn(const QVariantList &v)
+{
+    AskPendingConn conn;
+    conn.isIPv6 = v.value(0).toBool();
+    conn.inbound = v.value(1).toBool();
+    conn.ipProto = v.value(2).toUInt();
+    conn.remotePort = v.value(3).toUInt();
+    conn.connId = v.value(4).toUInt();
+    conn.hitCount = v.value(5).toUInt();
+    conn.firstTime = v.value(6).toLongLong();
+    conn.lastTime = v.value(7).toLongLong();
+
+    if (conn.isIPv6) {
+        conn.remoteIp.v6 = NetUtil::rawArrayToIp6(v.value(8).toByteArray());
+    } else {
+        conn.remoteIp.v4 = v.value(8).toUInt();
+    }
+
+    conn.appPath = v.value(9).toString();
+    return conn;
+}
+
+QVariantList AskPendingManagerRpc::changesToVarList(
+        const AskPendingChanges &changes, bool isReset)
+{
+    QVariantList connsList;
+    connsList.reserve(changes.updatedConns.size());
+
+    for (const AskPendingConn &conn : changes.updatedConns) {
+        connsList.append(QVariant(connToVarList(conn)));
+    }
+
+    QVariantList removedList;
+    VariantUtil::vectorToList(changes.removedConnIds, removedList);
+
+    QVariantList args = { isReset };
+    VariantUtil::addToList(args, QVariant(connsList));
+    VariantUtil::addToList(args, QVariant(removedList));
+
+    return args;
+}
+
+AskPendingChanges AskPendingManagerRpc::varListToChanges(const QVariantList &v)
+{
+    AskPendingChanges changes;
+
+    const QVariantList connsList = v.value(1).toList();
+    changes.updatedConns.reserve(connsList.size());
+
+    for (const QVariant &connVar : connsList) {
+        changes.updatedConns.append(varListToConn(connVar.toList()));
+    }
+
+    VariantUtil::listToVector(v.value(2).toList(), changes.removedConnIds);
+
+    return changes;
+}
+
+bool AskPendingManagerRpc::processInitClient(ControlWorker *w)
+{
+    AskPendingChanges changes;
+    changes.updatedConns = IoC<AskPendingManager>()->queue().conns();
+
+    return w->sendCommand(Control::Rpc_AskPendingManager_connsChanged,
+            changesToVarList(changes, /*isReset=*/true));
+}
+
+bool AskPendingManagerRpc::processServerCommand(
+        const ProcessCommandArgs &p, QVariantList & /*resArgs*/, bool &ok, bool &isSendResult)
+{
+    auto askPendingManager = IoC<AskPendingManager>();
+
+    switch (p.command) {
+    case Control::Rpc_AskPendingManager_connsChanged: {
+        if (auto apm = qobject_cast<AskPendingManagerRpc *>(askPendingManager)) {
+            apm->updateConns(varListToChanges(p.args), /*isReset=*/p.args.value(0).toBool());
+        }
+        return true;
+    }
+    default: {
+        ok = processAskPendingManagerRpcResult(askPendingManager, p);
+        isSendResult = true;
+        return true;
+    }
+    }
+}
+
+void AskPendingManagerRpc::setupServerSignals(RpcManager *rpcManager)
+{
+    auto askPendingManager = IoC<AskPendingManager>();
+
+    connect(askPendingManager, &AskPendingManager::connsChanged, rpcManager,
+            [=](const AskPendingChanges &changes) {
+                rpcManager->invokeOnClients(Control::Rpc_AskPendingManager_connsChanged,
+                        changesToVarList(changes));
+            });
+}
@@ -3,12 +3,34 @@
 
 #include <stat/askpendingmanager.h>
 
+class ControlWorker;
+class RpcManager;
+
+struct ProcessCommandArgs;
+
 class AskPendingManagerRpc : public AskPendingManager
 {
     Q_OBJECT
 
 public:
     explicit AskPendingManagerRpc(QObject *parent = nullptr);
+
+    bool decideApps(const QStringList &appPaths, bool blocked) override;
+
+    void updateConns(const AskPendingChanges &changes, bool isReset);
+
+    static QVariantList connToVarList(const AskPendingConn &conn);
+    static AskPendingConn varListToConn(const QVariantList &v);
+
+    static QVariantList changesToVarList(const AskPendingChanges &changes, bool isReset = false);
+    static AskPendingChanges varListToChanges(const QVariantList &v);
+
+    static bool processInitClient(ControlWorker *w);
+
+    static bool processServerCommand(
+            const ProcessCommandArgs &p, QVariantList &resArgs, bool &ok, bool &isSendResult);
+
+    static void setupServerSignals(RpcManager *rpcManager);
 };
 
 #endif // ASKPENDINGMANAGERRPC_H
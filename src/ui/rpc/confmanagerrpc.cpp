@@ -123,13 +123,10 @@ void ConfManagerRpc::onConfChanged(const QVariant &confVar)
 
     const uint editedFlags = FirewallConf::editedFlagsFromVariant(confVar);
 
-    if ((editedFlags & FirewallConf::OptEdited) != 0) {
-        // Reload from storage
+    // Apply the changes or reload from storage
+    if (!applyPatchVariant(confVar)) {
         setConf(createConf());
         loadConf(*conf());
-    } else {
-        // Apply only flags
-        conf()->fromVariant(confVar, /*onlyEdited=*/true);
     }
 
     if ((editedFlags & FirewallConf::TaskEdited) != 0) {
@@ -59,7 +59,13 @@ inline bool processConfRuleManagerRpcResult(
 
 }
 
-ConfRuleManagerRpc::ConfRuleManagerRpc(QObject *parent) : ConfRuleManager(parent) { }
+ConfRuleManagerRpc::ConfRuleManagerRpc(QObject *parent) : ConfRuleManager(parent)
+{
+    // Rule Sets are changed by the service
+    connect(this, &ConfRuleManager::ruleAdded, this, &ConfRuleManager::resetRuleSetGraph);
+    connect(this, &ConfRuleManager::ruleRemoved, this, &ConfRuleManager::resetRuleSetGraph);
+    connect(this, &ConfRuleManager::ruleUpdated, this, &ConfRuleManager::resetRuleSetGraph);
+}
 
 bool ConfRuleManagerRpc::addOrUpdateRule(Rule &rule)
 {
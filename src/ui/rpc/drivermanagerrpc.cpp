@@ -1,9 +1,45 @@
 #include "drivermanagerrpc.h"
 
 #include <control/controlworker.h>
+#include <driver/drivercommon.h>
+#include <driver/drivermetrics.h>
+#include <driver/tracedecoder.h>
 #include <rpc/rpcmanager.h>
 #include <util/ioc/ioccontainer.h>
 
+namespace {
+
+int statsDataMaxSize(quint32 code)
+{
+    if (code == DriverCommon::ioctlGetStats())
+        return DriverMetrics::bufferSize();
+
+    if (code == DriverCommon::ioctlGetTrace())
+        return TraceDecoder::bufferSize(TraceDecoder::ringRecordsCount());
+
+    return 0;
+}
+
+bool processReadStatsData(const ProcessCommandArgs &p, QVariantList &resArgs)
+{
+    const quint32 code = p.args.value(0).toUInt();
+    const int size = p.args.value(1).toInt();
+
+    if (size <= 0 || size > statsDataMaxSize(code))
+        return false;
+
+    QByteArray buf(size, '\0');
+
+    if (!IoC<DriverManager>()->readStatsData(code, buf))
+        return false;
+
+    resArgs = { buf };
+
+    return true;
+}
+
+}
+
 DriverManagerRpc::DriverManagerRpc(QObject *parent) : DriverManager(parent, /*useDevice=*/false) { }
 
 void DriverManagerRpc::setIsDeviceOpened(bool v)
@@ -32,6 +68,19 @@ bool DriverManagerRpc::closeDevice()
     return false;
 }
 
+bool DriverManagerRpc::readStatsData(quint32 code, QByteArray &buf)
+{
+    QVariantList resArgs;
+
+    if (!IoC<RpcManager>()->doOnServer(
+                Control::Rpc_DriverManager_readStatsData, { code, buf.size() }, &resArgs))
+        return false;
+
+    buf = resArgs.value(0).toByteArray();
+
+    return true;
+}
+
 QVariantList DriverManagerRpc::updateState_args()
 {
     auto driverManager = IoC<DriverManager>();
@@ -44,12 +93,17 @@ bool DriverManagerRpc::processInitClient(ControlWorker *w)
     return w->sendCommand(Control::Rpc_DriverManager_updateState, updateState_args());
 }
 
-bool DriverManagerRpc::processServerCommand(const ProcessCommandArgs &p, QVariantList & /*resArgs*/,
-        bool & /*ok*/, bool & /*isSendResult*/)
+bool DriverManagerRpc::processServerCommand(
+        const ProcessCommandArgs &p, QVariantList &resArgs, bool &ok, bool &isSendResult)
 {
     auto driverManager = IoC<DriverManager>();
 
     switch (p.command) {
+    case Control::Rpc_DriverManager_readStatsData: {
+        ok = processReadStatsData(p, resArgs);
+        isSendResult = true;
+        return true;
+    }
     case Control::Rpc_DriverManager_updateState: {
         if (auto dm = qobject_cast<DriverManagerRpc *>(driverManager)) {
             dm->updateState(p.args.value(0).toUInt(), p.args.value(1).toBool());
@@ -20,6 +20,8 @@ public:
 
     void setUp() override { }
 
+    bool readStatsData(quint32 code, QByteArray &buf) override;
+
     void updateState(quint32 errorCode, bool isDeviceOpened);
 
     static QVariantList updateState_args();
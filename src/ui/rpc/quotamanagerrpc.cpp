@@ -12,7 +12,7 @@ bool QuotaManagerRpc::processServerCommand(const ProcessCommandArgs &p, QVariant
 
     switch (p.command) {
     case Control::Rpc_QuotaManager_alert: {
-        emit quotaManager->alert(p.args.value(0).toInt());
+        emit quotaManager->alert(p.args.value(0).toInt(), p.args.value(1).toInt());
         return true;
     }
     default:
@@ -24,7 +24,7 @@ void QuotaManagerRpc::setupServerSignals(RpcManager *rpcManager)
 {
     auto quotaManager = IoC<QuotaManager>();
 
-    connect(quotaManager, &QuotaManager::alert, rpcManager, [=](qint8 alertType) {
-        rpcManager->invokeOnClients(Control::Rpc_QuotaManager_alert, { alertType });
+    connect(quotaManager, &QuotaManager::alert, rpcManager, [=](qint8 alertType, int percent) {
+        rpcManager->invokeOnClients(Control::Rpc_QuotaManager_alert, { alertType, percent });
     });
 }
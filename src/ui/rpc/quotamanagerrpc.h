@@ -17,10 +17,10 @@ public:
     static bool processServerCommand(
             const ProcessCommandArgs &p, QVariantList &resArgs, bool &ok, bool &isSendResult);
 
-    static void setupServerSignals(RpcManager *rpcManager);
+    void setUp() override { }
+    void tearDown() override { }
 
-protected:
-    void setupConfManager() override { }
+    static void setupServerSignals(RpcManager *rpcManager);
 };
 
 #endif // QUOTAMANAGERRPC_H
@@ -10,6 +10,7 @@
 #include <fortsettings.h>
 #include <manager/windowmanager.h>
 #include <rpc/appinfomanagerrpc.h>
+#include <rpc/askpendingmanagerrpc.h>
 #include <rpc/autoupdatemanagerrpc.h>
 #include <rpc/confappmanagerrpc.h>
 #include <rpc/confmanagerrpc.h>
@@ -80,6 +81,7 @@ void RpcManager::tearDown()
 void RpcManager::setupServerSignals()
 {
     AppInfoManagerRpc::setupServerSignals(this);
+    AskPendingManagerRpc::setupServerSignals(this);
     AutoUpdateManagerRpc::setupServerSignals(this);
     ConfManagerRpc::setupServerSignals(this);
     ConfAppManagerRpc::setupServerSignals(this);
@@ -194,6 +196,7 @@ void RpcManager::initClientOnServer(ControlWorker *w) const
 {
     w->setIsServiceClient(true);
 
+    AskPendingManagerRpc::processInitClient(w);
     AutoUpdateManagerRpc::processInitClient(w);
     DriverManagerRpc::processInitClient(w);
 }
@@ -218,6 +221,7 @@ bool RpcManager::processCommandRpc(const ProcessCommandArgs &p)
 
 static processManager_func processManager_funcList[] = {
     &AppInfoManagerRpc::processServerCommand, // Control::Rpc_AppInfoManager,
+    &AskPendingManagerRpc::processServerCommand, // Control::Rpc_AskPendingManager,
     &AutoUpdateManagerRpc::processServerCommand, // Control::Rpc_AutoUpdateManager,
     &ConfManagerRpc::processServerCommand, // Control::Rpc_ConfManager,
     &ConfAppManagerRpc::processServerCommand, // Control::Rpc_ConfAppManager,
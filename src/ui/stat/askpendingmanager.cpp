@@ -2,53 +2,91 @@
 
 #include <QLoggingCategory>
 
-#include <sqlite/sqlitedb.h>
-#include <sqlite/sqlitestmt.h>
-
+#include <conf/confappmanager.h>
+#include <log/logentryblockedip.h>
 #include <util/ioc/ioccontainer.h>
 
-#include "logblockedipjob.h"
-#include "statsql.h"
-
 namespace {
 
 const QLoggingCategory LC("pendingManager");
 
 }
 
-AskPendingManager::AskPendingManager(QObject *parent) :
-    QObject(parent), m_sqliteDb(new SqliteDb(":memory:"))
+AskPendingManager::AskPendingManager(QObject *parent) : QObject(parent)
 {
+    connect(&m_connsChangedTimer, &QTimer::timeout, this,
+            &AskPendingManager::onConnsChangedTriggered);
+    connect(&m_decisionsTimer, &QTimer::timeout, this, &AskPendingManager::applyDecisions);
 }
 
-void AskPendingManager::setUp()
+void AskPendingManager::logBlockedIp(const LogEntryBlockedIp &entry)
 {
-    setupDb();
+    m_queue.addEntry(entry);
+
+    emitConnsChanged();
 }
 
-bool AskPendingManager::setupDb()
+bool AskPendingManager::decideApps(const QStringList &appPaths, bool blocked)
 {
-    if (!sqliteDb()->open()) {
-        qCCritical(LC) << "File open error:" << sqliteDb()->filePath()
-                       << sqliteDb()->errorMessage();
-        return false;
+    for (const QString &appPath : appPaths) {
+        m_queue.removeAppPath(appPath);
+
+        m_decisions.insert(appPath, blocked);
     }
 
-    SqliteDb::MigrateOptions opt = {
-        .sqlDir = ":/stat/migrations/block",
-        .recreate = true,
-    };
+    emitConnsChanged();
 
-    if (!sqliteDb()->migrate(opt)) {
-        qCCritical(LC) << "Migration error" << sqliteDb()->filePath();
-        return false;
-    }
+    m_decisionsTimer.startTrigger();
 
     return true;
 }
 
-void AskPendingManager::logBlockedIp(const LogEntryBlockedIp &entry)
+void AskPendingManager::emitConnsChanged()
+{
+    m_connsChangedTimer.startTrigger();
+}
+
+void AskPendingManager::applyDecisions()
+{
+    if (m_decisions.isEmpty())
+        return;
+
+    auto confAppManager = IoC<ConfAppManager>();
+
+    QVector<qint64> allowedAppIds;
+    QVector<qint64> blockedAppIds;
+
+    for (auto it = m_decisions.constBegin(); it != m_decisions.constEnd(); ++it) {
+        const QString &appPath = it.key();
+        const bool blocked = it.value();
+
+        QString normPath;
+        const qint64 appId = confAppManager->appIdByPath(appPath, normPath);
+
+        if (appId > 0) {
+            (blocked ? blockedAppIds : allowedAppIds).append(appId);
+        } else if (!confAppManager->addOrUpdateAppPath(appPath, blocked, /*killProcess=*/false)) {
+            qCWarning(LC) << "Add app error:" << appPath;
+        }
+    }
+
+    m_decisions.clear();
+
+    // Update the existing apps by batches
+    if (!allowedAppIds.isEmpty()) {
+        confAppManager->updateAppsBlocked(allowedAppIds, /*blocked=*/false, /*killProcess=*/false);
+    }
+
+    if (!blockedAppIds.isEmpty()) {
+        confAppManager->updateAppsBlocked(blockedAppIds, /*blocked=*/true, /*killProcess=*/false);
+    }
+}
+
+void AskPendingManager::onConnsChangedTriggered()
 {
-    // TODO
-    Q_UNUSED(entry);
+    const AskPendingChanges changes = m_queue.takeChanges();
+
+    if (!changes.isEmpty()) {
+        emit connsChanged(changes);
+    }
 }
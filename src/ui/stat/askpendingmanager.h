@@ -1,12 +1,14 @@
 #ifndef ASKPENDINGMANAGER_H
 #define ASKPENDINGMANAGER_H
 
+#include <QHash>
 #include <QObject>
 
-#include <sqlite/sqlitetypes.h>
-
 #include <util/classhelpers.h>
 #include <util/ioc/iocservice.h>
+#include <util/triggertimer.h>
+
+#include "askpendingqueue.h"
 
 class LogEntryBlockedIp;
 
@@ -18,17 +20,33 @@ public:
     explicit AskPendingManager(QObject *parent = nullptr);
     CLASS_DELETE_COPY_MOVE(AskPendingManager)
 
-    SqliteDb *sqliteDb() const { return m_sqliteDb.data(); }
-
-    void setUp() override;
+    const AskPendingQueue &queue() const { return m_queue; }
 
     void logBlockedIp(const LogEntryBlockedIp &entry);
 
+    // Allow or block the apps and drop their pending connections
+    virtual bool decideApps(const QStringList &appPaths, bool blocked);
+
+signals:
+    void connsChanged(const AskPendingChanges &changes);
+
+protected:
+    AskPendingQueue &queue() { return m_queue; }
+
+    void emitConnsChanged();
+
 private:
-    bool setupDb();
+    void applyDecisions();
+
+    void onConnsChangedTriggered();
 
 private:
-    SqliteDbPtr m_sqliteDb;
+    AskPendingQueue m_queue;
+
+    QHash<QString, bool> m_decisions; // app path -> blocked
+
+    TriggerTimer m_connsChangedTimer;
+    TriggerTimer m_decisionsTimer;
 };
 
 #endif // ASKPENDINGMANAGER_H
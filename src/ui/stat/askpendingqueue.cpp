@@ -0,0 +1,286 @@
+#include "askpendingqueue.h"
+
+#include <log/logentryblockedip.h>
+
+bool AskPendingKey::operator==(const AskPendingKey &o) const
+{
+    return isIPv6 == o.isIPv6 && ipProto == o.ipProto && remotePort == o.remotePort
+            && remoteIp.lo64 == o.remoteIp.lo64 && remoteIp.hi64 == o.remoteIp.hi64
+            && appPath == o.appPath;
+}
+
+size_t qHash(const AskPendingKey &key, size_t seed)
+{
+    return qHashMulti(seed, key.appPath, key.remoteIp.lo64, key.remoteIp.hi64, key.remotePort,
+            key.ipProto, key.isIPv6);
+}
+
+AskPendingKey AskPendingConn::key() const
+{
+    AskPendingKey key;
+    key.isIPv6 = isIPv6;
+    key.ipProto = ipProto;
+    key.remotePort = remotePort;
+    key.appPath = appPath;
+
+    if (isIPv6) {
+        key.remoteIp = remoteIp.v6;
+    } else {
+        key.remoteIp.addr32[0] = remoteIp.v4;
+    }
+
+    return key;
+}
+
+AskPendingQueue::AskPendingQueue(int maxCount) : m_maxCount(qMax(maxCount, 1)) { }
+
+const AskPendingConn *AskPendingQueue::connById(quint32 connId) const
+{
+    const int index = m_idIndexes.value(connId, -1);
+
+    return (index >= 0) ? &m_slots[index].conn : nullptr;
+}
+
+QVector<AskPendingConn> AskPendingQueue::conns() const
+{
+    QVector<AskPendingConn> list;
+    list.reserve(count());
+
+    for (int index = m_head; index >= 0; index = m_slots[index].next) {
+        list.append(m_slots[index].conn);
+    }
+
+    return list;
+}
+
+const AskPendingConn &AskPendingQueue::addEntry(const LogEntryBlockedIp &entry)
+{
+    AskPendingConn conn;
+    conn.isIPv6 = entry.isIPv6();
+    conn.inbound = entry.inbound();
+    conn.ipProto = entry.ipProto();
+    conn.remotePort = entry.remotePort();
+    conn.hitCount = entry.connCount();
+    conn.firstTime = entry.connTime();
+    conn.lastTime = entry.connTime();
+    conn.appPath = entry.path();
+
+    if (conn.isIPv6) {
+        conn.remoteIp.v6 = entry.remoteIp().v6;
+    } else {
+        conn.remoteIp.v4 = entry.remoteIp4();
+    }
+
+    const int index = m_connIndexes.value(conn.key(), -1);
+    if (index < 0) {
+        conn.connId = ++m_lastConnId;
+
+        return m_slots[addSlot(conn)].conn;
+    }
+
+    // Duplicate
+    AskPendingConn &pendingConn = m_slots[index].conn;
+
+    pendingConn.hitCount += conn.hitCount;
+    pendingConn.firstTime = qMin(pendingConn.firstTime, conn.firstTime);
+    pendingConn.lastTime = qMax(pendingConn.lastTime, conn.lastTime);
+
+    touchSlot(index);
+
+    return pendingConn;
+}
+
+void AskPendingQueue::updateConn(const AskPendingConn &conn)
+{
+    const AskPendingKey key = conn.key();
+
+    // Replace another connection with the same key
+    const int keyIndex = m_connIndexes.value(key, -1);
+    if (keyIndex >= 0 && m_slots[keyIndex].conn.connId != conn.connId) {
+        removeSlot(keyIndex);
+    }
+
+    const int index = m_idIndexes.value(conn.connId, -1);
+    if (index < 0) {
+        addSlot(conn);
+        return;
+    }
+
+    // Update in place to report the connection as updated, not as removed and added
+    ConnSlot &slot = m_slots[index];
+
+    m_connIndexes.remove(slot.conn.key());
+    m_connIndexes.insert(key, index);
+
+    slot.conn = conn;
+
+    touchSlot(index);
+}
+
+bool AskPendingQueue::removeConn(quint32 connId)
+{
+    const int index = m_idIndexes.value(connId, -1);
+    if (index < 0)
+        return false;
+
+    removeSlot(index);
+
+    return true;
+}
+
+int AskPendingQueue::removeAppPath(const QString &appPath)
+{
+    int removedCount = 0;
+
+    int index = m_head;
+    while (index >= 0) {
+        const int nextIndex = m_slots[index].next;
+
+        if (m_slots[index].conn.appPath == appPath) {
+            removeSlot(index);
+            ++removedCount;
+        }
+
+        index = nextIndex;
+    }
+
+    return removedCount;
+}
+
+void AskPendingQueue::clear()
+{
+    for (int index = m_head; index >= 0; index = m_slots[index].next) {
+        const ConnSlot &slot = m_slots[index];
+
+        if (!slot.isNew) {
+            m_removedConnIds.insert(slot.conn.connId);
+        }
+    }
+
+    m_head = m_tail = -1;
+
+    m_slots.clear();
+    m_freeIndexes.clear();
+
+    m_connIndexes.clear();
+    m_idIndexes.clear();
+
+    m_updatedConnIds.clear();
+}
+
+AskPendingChanges AskPendingQueue::takeChanges()
+{
+    AskPendingChanges changes;
+
+    changes.updatedConns.reserve(m_updatedConnIds.size());
+
+    for (const quint32 connId : std::as_const(m_updatedConnIds)) {
+        ConnSlot &slot = m_slots[m_idIndexes.value(connId)];
+
+        slot.isNew = false;
+        changes.updatedConns.append(slot.conn);
+    }
+
+    changes.removedConnIds = QVector<quint32>(m_removedConnIds.begin(), m_removedConnIds.end());
+
+    m_updatedConnIds.clear();
+    m_removedConnIds.clear();
+
+    return changes;
+}
+
+int AskPendingQueue::addSlot(const AskPendingConn &conn)
+{
+    if (count() >= m_maxCount) {
+        removeSlot(m_tail);
+    }
+
+    int index;
+    if (m_freeIndexes.isEmpty()) {
+        index = int(m_slots.size());
+        m_slots.append({});
+    } else {
+        index = m_freeIndexes.takeLast();
+    }
+
+    ConnSlot &slot = m_slots[index];
+    slot.isNew = true;
+    slot.conn = conn;
+
+    m_lastConnId = qMax(m_lastConnId, conn.connId);
+
+    m_connIndexes.insert(conn.key(), index);
+    m_idIndexes.insert(conn.connId, index);
+
+    m_updatedConnIds.insert(conn.connId);
+
+    linkFront(index);
+
+    return index;
+}
+
+void AskPendingQueue::removeSlot(int index)
+{
+    ConnSlot &slot = m_slots[index];
+    const quint32 connId = slot.conn.connId;
+
+    unlink(index);
+
+    m_connIndexes.remove(slot.conn.key());
+    m_idIndexes.remove(connId);
+
+    // Skip the connections, which were not reported yet
+    m_updatedConnIds.remove(connId);
+    if (!slot.isNew) {
+        m_removedConnIds.insert(connId);
+    }
+
+    slot = {};
+    m_freeIndexes.append(index);
+}
+
+void AskPendingQueue::linkFront(int index)
+{
+    ConnSlot &slot = m_slots[index];
+
+    slot.prev = -1;
+    slot.next = m_head;
+
+    if (m_head >= 0) {
+        m_slots[m_head].prev = index;
+    } else {
+        m_tail = index;
+    }
+
+    m_head = index;
+}
+
+void AskPendingQueue::unlink(int index)
+{
+    ConnSlot &slot = m_slots[index];
+
+    if (slot.prev >= 0) {
+        m_slots[slot.prev].next = slot.next;
+    } else {
+        m_head = slot.next;
+    }
+
+    if (slot.next >= 0) {
+        m_slots[slot.next].prev = slot.prev;
+    } else {
+        m_tail = slot.prev;
+    }
+
+    slot.prev = slot.next = -1;
+}
+
+void AskPendingQueue::touchSlot(int index)
+{
+    m_updatedConnIds.insert(m_slots[index].conn.connId);
+
+    if (index == m_head)
+        return;
+
+    unlink(index);
+    linkFront(index);
+}
@@ -0,0 +1,115 @@
+#ifndef ASKPENDINGQUEUE_H
+#define ASKPENDINGQUEUE_H
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include <common/common_types.h>
+
+class LogEntryBlockedIp;
+
+struct AskPendingKey
+{
+    bool operator==(const AskPendingKey &o) const;
+
+    bool isIPv6 = false;
+    quint8 ipProto = 0;
+    quint16 remotePort = 0;
+    ip6_addr_t remoteIp = {}; // IPv4 address is zero-padded
+    QString appPath;
+};
+
+size_t qHash(const AskPendingKey &key, size_t seed = 0);
+
+struct AskPendingConn
+{
+    AskPendingKey key() const;
+
+    bool isIPv6 : 1 = false;
+    bool inbound : 1 = false;
+    quint8 ipProto = 0;
+    quint16 remotePort = 0;
+    quint32 connId = 0;
+    quint32 hitCount = 0;
+    qint64 firstTime = 0; // unix time
+    qint64 lastTime = 0;
+    ip_addr_t remoteIp = {};
+    QString appPath;
+};
+
+struct AskPendingChanges
+{
+    bool isEmpty() const { return updatedConns.isEmpty() && removedConnIds.isEmpty(); }
+
+    QVector<AskPendingConn> updatedConns;
+    QVector<quint32> removedConnIds;
+};
+
+// Blocked connections deduplicated by app path, remote address, port and protocol.
+// The least recently seen connection is evicted, when the queue is full.
+class AskPendingQueue
+{
+public:
+    explicit AskPendingQueue(int maxCount = DefaultMaxCount);
+
+    constexpr static int DefaultMaxCount = 1000;
+
+    int maxCount() const { return m_maxCount; }
+    int count() const { return int(m_connIndexes.size()); }
+    bool isEmpty() const { return count() == 0; }
+
+    const AskPendingConn *connById(quint32 connId) const;
+
+    // Most recently seen first
+    QVector<AskPendingConn> conns() const;
+
+    const AskPendingConn &addEntry(const LogEntryBlockedIp &entry);
+
+    // Add or replace the connection with the same id, e.g. from the service
+    void updateConn(const AskPendingConn &conn);
+
+    bool removeConn(quint32 connId);
+    int removeAppPath(const QString &appPath);
+
+    void clear();
+
+    // Changes since the previous call
+    AskPendingChanges takeChanges();
+
+private:
+    struct ConnSlot
+    {
+        bool isNew = false; // since the previous changes
+        int prev = -1; // more recently seen
+        int next = -1;
+        AskPendingConn conn;
+    };
+
+    int addSlot(const AskPendingConn &conn);
+    void removeSlot(int index);
+
+    void linkFront(int index);
+    void unlink(int index);
+
+    void touchSlot(int index);
+
+private:
+    int m_maxCount = 0;
+
+    quint32 m_lastConnId = 0;
+
+    int m_head = -1; // most recently seen
+    int m_tail = -1;
+
+    QVector<ConnSlot> m_slots;
+    QVector<int> m_freeIndexes;
+
+    QHash<AskPendingKey, int> m_connIndexes;
+    QHash<quint32, int> m_idIndexes;
+
+    QSet<quint32> m_updatedConnIds;
+    QSet<quint32> m_removedConnIds;
+};
+
+#endif // ASKPENDINGQUEUE_H
@@ -140,6 +140,7 @@ qint64 LogBlockedIpJob::insertConn(const LogEntryBlockedIp &entry, qint64 appId)
     }
 
     stmt->bindInt(13, entry.blockReason());
+    stmt->bindInt64(14, entry.connCount());
 
     if (sqliteDb()->done(stmt)) {
         return sqliteDb()->lastInsertRowid();
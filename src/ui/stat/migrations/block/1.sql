@@ -21,7 +21,8 @@ CREATE TABLE conn_block(
   local_ip6 BLOB,
   remote_ip6 BLOB,
   --
-  block_reason INTEGER NOT NULL
+  block_reason INTEGER NOT NULL,
+  conn_count INTEGER NOT NULL DEFAULT 1
 );
 
 CREATE INDEX conn_block_app_id_idx ON conn_block(app_id);
@@ -54,3 +54,17 @@ CREATE TABLE traffic_month(
   in_bytes INTEGER NOT NULL,
   out_bytes INTEGER NOT NULL
 ) WITHOUT ROWID;
+
+CREATE TABLE quota_ledger(
+  scope INTEGER NOT NULL,
+  scope_id INTEGER NOT NULL,
+  day_time INTEGER NOT NULL,
+  day_bytes INTEGER NOT NULL,
+  day_quota INTEGER NOT NULL,
+  day_alerted INTEGER NOT NULL,
+  month_time INTEGER NOT NULL,
+  month_bytes INTEGER NOT NULL,
+  month_quota INTEGER NOT NULL,
+  month_alerted INTEGER NOT NULL,
+  PRIMARY KEY (scope, scope_id)
+) WITHOUT ROWID;
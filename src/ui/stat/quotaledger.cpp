@@ -0,0 +1,315 @@
+#include "quotaledger.h"
+
+#include <algorithm>
+
+#include <sqlite/dbquery.h>
+#include <sqlite/sqlitedb.h>
+#include <sqlite/sqlitestmt.h>
+
+#include <util/dateutil.h>
+
+#include "statsql.h"
+
+namespace {
+
+constexpr qint16 ALERT_PERCENT_MIN = 1;
+constexpr qint16 ALERT_PERCENT_MAX = 1000;
+
+void resetCounter(QuotaCounter &counter, qint32 trafTime)
+{
+    counter.alertedPercent = 0;
+    counter.trafTime = trafTime;
+    counter.bytes = 0;
+}
+
+void fillCounter(QuotaCounter &counter, const SqliteStmt &stmt, int column)
+{
+    counter.trafTime = stmt.columnInt(column);
+    counter.bytes = stmt.columnInt64(column + 1);
+    counter.quotaBytes = stmt.columnInt64(column + 2);
+    counter.alertedPercent = qint16(stmt.columnInt(column + 3));
+}
+
+void bindCounter(SqliteStmt &stmt, const QuotaCounter &counter, int index)
+{
+    stmt.bindInt(index, counter.trafTime);
+    stmt.bindInt64(index + 1, counter.bytes);
+    stmt.bindInt64(index + 2, counter.quotaBytes);
+    stmt.bindInt(index + 3, counter.alertedPercent);
+}
+
+}
+
+size_t qHash(const QuotaKey &key, size_t seed)
+{
+    return qHashMulti(seed, key.scope, key.id);
+}
+
+QuotaLedger::QuotaLedger(int monthStart) : m_monthStart(monthStart), m_alertPercents({ 100 })
+{
+    const QuotaKey key = QuotaKey::global();
+
+    m_entries.insert(key, { .key = key });
+}
+
+void QuotaLedger::setMonthStart(int v)
+{
+    if (m_monthStart == v)
+        return;
+
+    m_monthStart = v;
+
+    // Re-calculate the periods
+    m_trafHour = 0;
+}
+
+void QuotaLedger::setAlertPercents(const QVector<qint16> &percents)
+{
+    m_alertPercents.clear();
+
+    for (const qint16 percent : percents) {
+        const qint16 v = qBound(ALERT_PERCENT_MIN, percent, ALERT_PERCENT_MAX);
+
+        if (!m_alertPercents.contains(v)) {
+            m_alertPercents.append(v);
+        }
+    }
+
+    std::sort(m_alertPercents.begin(), m_alertPercents.end());
+}
+
+const QuotaEntry *QuotaLedger::entry(const QuotaKey &key) const
+{
+    const auto it = m_entries.constFind(key);
+
+    return (it != m_entries.constEnd()) ? &it.value() : nullptr;
+}
+
+void QuotaLedger::setQuota(const QuotaKey &key, qint64 dayBytes, qint64 monthBytes)
+{
+    if (!key.isGlobal() && dayBytes == 0 && monthBytes == 0) {
+        if (m_entries.remove(key)) {
+            m_removedKeys.insert(key);
+        }
+        return;
+    }
+
+    m_removedKeys.remove(key);
+
+    QuotaEntry &entry = m_entries[key];
+    entry.key = key;
+
+    const auto setQuotaBytes = [&](QuotaCounter &counter, qint64 bytes) {
+        if (counter.quotaBytes != bytes) {
+            counter.quotaBytes = bytes;
+            counter.alertedPercent = 0;
+
+            entry.dirty = true;
+        }
+    };
+
+    setQuotaBytes(entry.day, dayBytes);
+    setQuotaBytes(entry.month, monthBytes);
+}
+
+void QuotaLedger::setTraf(qint64 unixTime, const QuotaKey &key, qint64 dayBytes, qint64 monthBytes)
+{
+    QuotaEntry *entry = prepareEntry(unixTime, key);
+    if (!entry)
+        return;
+
+    entry->day.bytes = dayBytes;
+    entry->month.bytes = monthBytes;
+    entry->dirty = true;
+}
+
+QVector<QuotaAlert> QuotaLedger::addTraf(qint64 unixTime, const QuotaKey &key, qint64 bytes)
+{
+    QVector<QuotaAlert> alerts;
+
+    QuotaEntry *entry = prepareEntry(unixTime, key);
+    if (!entry)
+        return alerts;
+
+    entry->day.bytes += bytes;
+    entry->month.bytes += bytes;
+    entry->dirty = true;
+
+    checkAlert(*entry, entry->day, QuotaAlert::PeriodDay, alerts);
+    checkAlert(*entry, entry->month, QuotaAlert::PeriodMonth, alerts);
+
+    return alerts;
+}
+
+void QuotaLedger::clear(bool clearDay, bool clearMonth)
+{
+    for (QuotaEntry &entry : m_entries) {
+        if (clearDay) {
+            resetCounter(entry.day, entry.day.trafTime);
+        }
+        if (clearMonth) {
+            resetCounter(entry.month, entry.month.trafTime);
+        }
+
+        entry.dirty = true;
+    }
+}
+
+bool QuotaLedger::isDirty() const
+{
+    if (!m_removedKeys.isEmpty())
+        return true;
+
+    for (const QuotaEntry &entry : m_entries) {
+        if (entry.dirty)
+            return true;
+    }
+
+    return false;
+}
+
+bool QuotaLedger::saveCheckpoint(SqliteDb *sqliteDb)
+{
+    if (!isDirty())
+        return true;
+
+    if (!sqliteDb)
+        return false;
+
+    sqliteDb->beginWriteTransaction();
+
+    bool ok = true;
+
+    SqliteStmt upsertStmt;
+    SqliteStmt deleteStmt;
+
+    if (!DbQuery(sqliteDb).sql(StatSql::sqlUpsertQuotaLedger).prepare(upsertStmt)
+            || !DbQuery(sqliteDb).sql(StatSql::sqlDeleteQuotaLedger).prepare(deleteStmt)) {
+        ok = false;
+    }
+
+    for (auto it = m_entries.constBegin(); ok && it != m_entries.constEnd(); ++it) {
+        const QuotaEntry &entry = it.value();
+        if (!entry.dirty)
+            continue;
+
+        upsertStmt.bindInt(1, entry.key.scope);
+        upsertStmt.bindInt64(2, entry.key.id);
+        bindCounter(upsertStmt, entry.day, 3);
+        bindCounter(upsertStmt, entry.month, 7);
+
+        ok = sqliteDb->done(&upsertStmt);
+    }
+
+    for (auto it = m_removedKeys.constBegin(); ok && it != m_removedKeys.constEnd(); ++it) {
+        deleteStmt.bindInt(1, it->scope);
+        deleteStmt.bindInt64(2, it->id);
+
+        // The key may be not saved yet
+        ok = (deleteStmt.step() == SqliteStmt::StepDone);
+        deleteStmt.reset();
+    }
+
+    ok = sqliteDb->endTransaction(ok);
+
+    if (ok) {
+        for (QuotaEntry &entry : m_entries) {
+            entry.dirty = false;
+        }
+        m_removedKeys.clear();
+    }
+
+    return ok;
+}
+
+bool QuotaLedger::loadCheckpoint(SqliteDb *sqliteDb)
+{
+    if (!sqliteDb)
+        return false;
+
+    SqliteStmt stmt;
+    if (!DbQuery(sqliteDb).sql(StatSql::sqlSelectQuotaLedger).prepare(stmt))
+        return false;
+
+    while (stmt.step() == SqliteStmt::StepRow) {
+        QuotaEntry entry;
+        entry.key.scope = qint8(stmt.columnInt(0));
+        entry.key.id = stmt.columnInt64(1);
+
+        fillCounter(entry.day, stmt, 2);
+        fillCounter(entry.month, stmt, 6);
+
+        m_entries.insert(entry.key, entry);
+        m_removedKeys.remove(entry.key);
+    }
+
+    return true;
+}
+
+void QuotaLedger::updateTrafTime(qint64 unixTime)
+{
+    const qint32 trafHour = DateUtil::getUnixHour(unixTime);
+    if (trafHour == m_trafHour)
+        return;
+
+    m_trafHour = trafHour;
+    m_trafDay = DateUtil::getUnixDay(unixTime);
+    m_trafMonth = DateUtil::getUnixMonth(unixTime, m_monthStart);
+}
+
+QuotaEntry *QuotaLedger::prepareEntry(qint64 unixTime, const QuotaKey &key)
+{
+    const auto it = m_entries.find(key);
+    if (it == m_entries.end())
+        return nullptr;
+
+    updateTrafTime(unixTime);
+
+    QuotaEntry &entry = it.value();
+    rolloverEntry(entry);
+
+    return &entry;
+}
+
+void QuotaLedger::rolloverEntry(QuotaEntry &entry)
+{
+    if (entry.day.trafTime != m_trafDay) {
+        resetCounter(entry.day, m_trafDay);
+        entry.dirty = true;
+    }
+
+    if (entry.month.trafTime != m_trafMonth) {
+        resetCounter(entry.month, m_trafMonth);
+        entry.dirty = true;
+    }
+}
+
+void QuotaLedger::checkAlert(QuotaEntry &entry, QuotaCounter &counter, QuotaAlert::Period period,
+        QVector<QuotaAlert> &alerts) const
+{
+    if (counter.quotaBytes <= 0)
+        return;
+
+    // The highest exceeded threshold
+    qint16 percent = 0;
+    for (auto it = m_alertPercents.crbegin(); it != m_alertPercents.crend(); ++it) {
+        if (counter.bytes * 100 > counter.quotaBytes * *it) {
+            percent = *it;
+            break;
+        }
+    }
+
+    if (percent <= counter.alertedPercent)
+        return;
+
+    counter.alertedPercent = percent;
+    entry.dirty = true;
+
+    alerts.append({
+            .period = period,
+            .percent = percent,
+            .key = entry.key,
+            .bytes = counter.bytes,
+            .quotaBytes = counter.quotaBytes,
+    });
+}
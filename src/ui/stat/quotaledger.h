@@ -0,0 +1,118 @@
+#ifndef QUOTALEDGER_H
+#define QUOTALEDGER_H
+
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+class SqliteDb;
+
+struct QuotaKey
+{
+    enum Scope : qint8 { ScopeGlobal = 0, ScopeApp, ScopeAppGroup };
+
+    bool operator==(const QuotaKey &o) const { return scope == o.scope && id == o.id; }
+
+    bool isGlobal() const { return scope == ScopeGlobal; }
+
+    static QuotaKey global() { return {}; }
+    static QuotaKey app(qint64 appId) { return { ScopeApp, appId }; }
+    static QuotaKey appGroup(qint64 appGroupId) { return { ScopeAppGroup, appGroupId }; }
+
+    qint8 scope = ScopeGlobal;
+    qint64 id = 0;
+};
+
+size_t qHash(const QuotaKey &key, size_t seed = 0);
+
+struct QuotaCounter
+{
+    qint16 alertedPercent = 0; // the highest alerted threshold
+    qint32 trafTime = 0; // unix hour of the period start
+    qint64 bytes = 0;
+    qint64 quotaBytes = 0;
+};
+
+struct QuotaEntry
+{
+    bool dirty = false; // since the previous checkpoint
+
+    QuotaKey key;
+
+    QuotaCounter day;
+    QuotaCounter month;
+};
+
+struct QuotaAlert
+{
+    enum Period : qint8 { PeriodDay = 1, PeriodMonth };
+
+    qint8 period = PeriodDay;
+    qint16 percent = 0;
+
+    QuotaKey key;
+
+    qint64 bytes = 0;
+    qint64 quotaBytes = 0;
+};
+
+// Rolling day and month traffic counters of the global, app and app group quotas.
+// The counters are kept in memory and saved to the "quota_ledger" table by checkpoints.
+class QuotaLedger
+{
+public:
+    explicit QuotaLedger(int monthStart = 1);
+
+    int monthStart() const { return m_monthStart; }
+    void setMonthStart(int v);
+
+    // Sorted thresholds in percents of quotas
+    const QVector<qint16> &alertPercents() const { return m_alertPercents; }
+    void setAlertPercents(const QVector<qint16> &percents);
+
+    int count() const { return int(m_entries.size()); }
+
+    bool hasScopedQuotas() const { return count() > 1; }
+
+    const QuotaEntry *entry(const QuotaKey &key) const;
+
+    // Zero quotas remove the app and app group entries
+    void setQuota(const QuotaKey &key, qint64 dayBytes, qint64 monthBytes);
+
+    // Set the counters of the current periods, e.g. from the traffic statistics
+    void setTraf(qint64 unixTime, const QuotaKey &key, qint64 dayBytes, qint64 monthBytes);
+
+    // Returns the new alerts of the key
+    QVector<QuotaAlert> addTraf(qint64 unixTime, const QuotaKey &key, qint64 bytes);
+
+    void clear(bool clearDay = true, bool clearMonth = true);
+
+    bool isDirty() const;
+
+    bool saveCheckpoint(SqliteDb *sqliteDb);
+    bool loadCheckpoint(SqliteDb *sqliteDb);
+
+private:
+    void updateTrafTime(qint64 unixTime);
+
+    QuotaEntry *prepareEntry(qint64 unixTime, const QuotaKey &key);
+
+    void rolloverEntry(QuotaEntry &entry);
+
+    void checkAlert(QuotaEntry &entry, QuotaCounter &counter, QuotaAlert::Period period,
+            QVector<QuotaAlert> &alerts) const;
+
+private:
+    int m_monthStart = 1;
+
+    qint32 m_trafHour = 0;
+    qint32 m_trafDay = 0;
+    qint32 m_trafMonth = 0;
+
+    QVector<qint16> m_alertPercents;
+
+    QHash<QuotaKey, QuotaEntry> m_entries;
+    QSet<QuotaKey> m_removedKeys;
+};
+
+#endif // QUOTALEDGER_H
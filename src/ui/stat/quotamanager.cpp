@@ -1,5 +1,8 @@
 #include "quotamanager.h"
 
+#include <QLoggingCategory>
+
+#include <conf/confappmanager.h>
 #include <conf/confmanager.h>
 #include <conf/firewallconf.h>
 #include <stat/statmanager.h>
@@ -8,115 +11,130 @@
 
 #include "statsql.h"
 
-QuotaManager::QuotaManager(QObject *parent) : QObject(parent) { }
+namespace {
 
-void QuotaManager::setQuotaDayBytes(qint64 bytes)
-{
-    if (m_quotaDayBytes != bytes) {
-        if (m_quotaDayBytes != 0) {
-            setQuotaDayAlerted(0);
-        }
+const QLoggingCategory LC("stat.quota");
 
-        m_quotaDayBytes = bytes;
-    }
-}
+constexpr int QUOTA_CHECKPOINT_INTERVAL_MSEC = 5 * 60 * 1000;
 
-void QuotaManager::setQuotaMonthBytes(qint64 bytes)
+QVector<qint16> parseAlertPercents(const QString &text)
 {
-    if (m_quotaMonthBytes != bytes) {
-        if (m_quotaMonthBytes != 0) {
-            setQuotaMonthAlerted(0);
-        }
+    QVector<qint16> percents;
 
-        m_quotaMonthBytes = bytes;
+    for (const auto &v : QStringView(text).split(',', Qt::SkipEmptyParts)) {
+        bool ok;
+        const int percent = v.trimmed().toInt(&ok);
+        if (ok && percent > 0) {
+            percents.append(qint16(qMin(percent, 1000)));
+        }
     }
+
+    return percents;
+}
+
 }
 
-void QuotaManager::setTrafDayBytes(qint64 bytes)
+QuotaManager::QuotaManager(QObject *parent) : QObject(parent) { }
+
+void QuotaManager::setAppQuota(qint64 appId, qint64 dayBytes, qint64 monthBytes)
 {
-    m_trafDayBytes = bytes;
+    m_ledger.setQuota(QuotaKey::app(appId), dayBytes, monthBytes);
+
+    clearAppQuotaIds();
+    saveCheckpoint();
 }
 
-void QuotaManager::setTrafMonthBytes(qint64 bytes)
+void QuotaManager::setAppGroupQuota(qint64 appGroupId, qint64 dayBytes, qint64 monthBytes)
 {
-    m_trafMonthBytes = bytes;
+    m_ledger.setQuota(QuotaKey::appGroup(appGroupId), dayBytes, monthBytes);
+
+    clearAppQuotaIds();
+    saveCheckpoint();
 }
 
 void QuotaManager::setUp()
 {
+    loadCheckpoint();
+
     setupConfManager();
+    setupConfAppManager();
+
+    setupCheckpointTimer();
 }
 
-void QuotaManager::clear(bool clearDay, bool clearMonth)
+void QuotaManager::tearDown()
 {
-    if (clearDay) {
-        m_trafDayBytes = 0;
-
-        setQuotaDayAlerted(0);
-    }
+    m_checkpointTimer.stop();
 
-    if (clearMonth) {
-        m_trafMonthBytes = 0;
-
-        setQuotaMonthAlerted(0);
-    }
+    saveCheckpoint();
 }
 
-void QuotaManager::addTraf(qint64 bytes)
+void QuotaManager::clear(bool clearDay, bool clearMonth)
 {
-    m_trafDayBytes += bytes;
-    m_trafMonthBytes += bytes;
+    m_ledger.clear(clearDay, clearMonth);
 }
 
-void QuotaManager::checkQuotaDay(qint32 trafDay)
+void QuotaManager::addTraf(qint64 unixTime, qint64 bytes)
 {
-    if (m_quotaDayBytes == 0)
-        return;
-
-    if (m_quotaDayAlerted == 0) {
-        m_quotaDayAlerted = quotaDayAlerted();
-    }
-
-    if (m_quotaDayAlerted == trafDay)
-        return;
-
-    if (m_trafDayBytes > m_quotaDayBytes) {
-        setQuotaDayAlerted(trafDay);
-
-        processQuotaExceed(AlertDay);
-    }
+    processAlerts(m_ledger.addTraf(unixTime, QuotaKey::global(), bytes));
 }
 
-void QuotaManager::checkQuotaMonth(qint32 trafMonth)
+void QuotaManager::addAppTraf(qint64 unixTime, const QString &appPath, qint64 bytes)
 {
-    if (m_quotaMonthBytes == 0)
+    if (!m_ledger.hasScopedQuotas())
         return;
 
-    if (m_quotaMonthAlerted == 0) {
-        m_quotaMonthAlerted = quotaMonthAlerted();
-    }
+    const AppQuotaIds ids = appQuotaIds(appPath);
 
-    if (m_quotaMonthAlerted == trafMonth)
-        return;
-
-    if (m_trafMonthBytes > m_quotaMonthBytes) {
-        setQuotaMonthAlerted(trafMonth);
+    if (ids.appId != 0) {
+        processAlerts(m_ledger.addTraf(unixTime, QuotaKey::app(ids.appId), bytes));
+    }
 
-        processQuotaExceed(AlertMonth);
+    if (ids.appGroupId != 0) {
+        processAlerts(m_ledger.addTraf(unixTime, QuotaKey::appGroup(ids.appGroupId), bytes));
     }
 }
 
-QString QuotaManager::alertTypeText(qint8 alertType)
+QString QuotaManager::alertTypeText(qint8 alertType, int percent)
 {
+    QString quotaName;
+
     switch (alertType) {
     case AlertDay:
-        return tr("Day traffic quota exceeded!");
+        quotaName = tr("Day traffic quota");
+        break;
     case AlertMonth:
-        return tr("Month traffic quota exceeded!");
+        quotaName = tr("Month traffic quota");
+        break;
+    case AlertAppDay:
+        quotaName = tr("Application's day traffic quota");
+        break;
+    case AlertAppMonth:
+        quotaName = tr("Application's month traffic quota");
+        break;
+    case AlertAppGroupDay:
+        quotaName = tr("Application group's day traffic quota");
+        break;
+    case AlertAppGroupMonth:
+        quotaName = tr("Application group's month traffic quota");
+        break;
     default:
         Q_UNREACHABLE();
         return QString();
     };
+
+    return (percent < 100) ? tr("%1 reached %2%!").arg(quotaName, QString::number(percent))
+                           : tr("%1 exceeded!").arg(quotaName);
+}
+
+bool QuotaManager::saveCheckpoint()
+{
+    if (m_ledger.saveCheckpoint(sqliteDb()))
+        return true;
+
+    qCWarning(LC) << "Checkpoint save error";
+
+    return false;
 }
 
 void QuotaManager::setupConfManager()
@@ -126,49 +144,101 @@ void QuotaManager::setupConfManager()
     connect(confManager, &ConfManager::iniChanged, this, &QuotaManager::setupByConf);
 }
 
-int QuotaManager::quotaDayAlerted() const
+void QuotaManager::setupConfAppManager()
 {
-    auto confManager = IoC<ConfManager>();
-    const IniOptions &ini = confManager->conf()->ini();
+    auto confAppManager = IoCDependency<ConfAppManager>();
 
-    return ini.quotaDayAlerted();
+    connect(confAppManager, &ConfAppManager::appsChanged, this, &QuotaManager::clearAppQuotaIds);
+    connect(confAppManager, &ConfAppManager::appUpdated, this, &QuotaManager::clearAppQuotaIds);
 }
 
-void QuotaManager::setQuotaDayAlerted(int v)
+SqliteDb *QuotaManager::sqliteDb() const
 {
-    auto confManager = IoC<ConfManager>();
-    IniOptions &ini = confManager->conf()->ini();
+    return IoC<StatManager>()->sqliteDb();
+}
+
+bool QuotaManager::getAppQuotaIds(const QString &appPath, qint64 &appId, qint64 &appGroupId)
+{
+    return IoC<ConfAppManager>()->appIdsByPath(appPath, appId, appGroupId);
+}
+
+void QuotaManager::setupCheckpointTimer()
+{
+    m_checkpointTimer.setInterval(QUOTA_CHECKPOINT_INTERVAL_MSEC);
+
+    connect(&m_checkpointTimer, &QTimer::timeout, this, &QuotaManager::saveCheckpoint);
+
+    m_checkpointTimer.start();
+}
+
+void QuotaManager::loadCheckpoint()
+{
+    auto statManager = IoCDependency<StatManager>();
+
+    if (!m_ledger.loadCheckpoint(statManager->sqliteDb())) {
+        qCWarning(LC) << "Checkpoint load error";
+        return;
+    }
 
-    m_quotaDayAlerted = v;
+    // COMPAT: Initialize the global counters from the traffic statistics
+    if (m_ledger.entry(QuotaKey::global())->day.trafTime == 0) {
+        auto confManager = IoC<ConfManager>();
+        const IniOptions &ini = confManager->conf()->ini();
 
-    if (ini.quotaDayAlerted() != v) {
-        ini.setQuotaDayAlerted(v);
-        confManager->saveIni();
+        const qint64 unixTime = DateUtil::getUnixTime();
+        const qint32 trafDay = DateUtil::getUnixDay(unixTime);
+        const qint32 trafMonth = DateUtil::getUnixMonth(unixTime, ini.monthStart());
+
+        qint64 dayBytes, monthBytes, outBytes;
+
+        statManager->getTraffic(StatSql::sqlSelectTrafDay, trafDay, dayBytes, outBytes);
+        statManager->getTraffic(StatSql::sqlSelectTrafMonth, trafMonth, monthBytes, outBytes);
+
+        m_ledger.setMonthStart(ini.monthStart());
+        m_ledger.setTraf(unixTime, QuotaKey::global(), dayBytes, monthBytes);
     }
 }
 
-int QuotaManager::quotaMonthAlerted() const
+QuotaManager::AppQuotaIds QuotaManager::appQuotaIds(const QString &appPath)
 {
-    auto confManager = IoC<ConfManager>();
-    const IniOptions &ini = confManager->conf()->ini();
+    const auto it = m_appQuotaIdsCache.constFind(appPath);
+    if (it != m_appQuotaIdsCache.constEnd())
+        return it.value();
+
+    AppQuotaIds ids;
+    getAppQuotaIds(appPath, ids.appId, ids.appGroupId);
 
-    return ini.quotaMonthAlerted();
+    // Skip the apps and groups without quotas
+    if (!m_ledger.entry(QuotaKey::app(ids.appId))) {
+        ids.appId = 0;
+    }
+    if (!m_ledger.entry(QuotaKey::appGroup(ids.appGroupId))) {
+        ids.appGroupId = 0;
+    }
+
+    m_appQuotaIdsCache.insert(appPath, ids);
+
+    return ids;
 }
 
-void QuotaManager::setQuotaMonthAlerted(int v)
+void QuotaManager::clearAppQuotaIds()
 {
-    auto confManager = IoC<ConfManager>();
-    IniOptions &ini = confManager->conf()->ini();
+    m_appQuotaIdsCache.clear();
+}
 
-    m_quotaMonthAlerted = v;
+void QuotaManager::processAlerts(const QVector<QuotaAlert> &alerts)
+{
+    for (const QuotaAlert &quotaAlert : alerts) {
+        // Block the Internet by the global quotas only
+        if (quotaAlert.key.isGlobal() && quotaAlert.percent >= 100) {
+            processQuotaExceed();
+        }
 
-    if (ini.quotaMonthAlerted() != v) {
-        ini.setQuotaMonthAlerted(v);
-        confManager->saveIni();
+        emit alert(alertTypeByAlert(quotaAlert), quotaAlert.percent);
     }
 }
 
-void QuotaManager::processQuotaExceed(AlertType alertType)
+void QuotaManager::processQuotaExceed()
 {
     auto confManager = IoC<ConfManager>();
     FirewallConf *conf = confManager->conf();
@@ -177,25 +247,27 @@ void QuotaManager::processQuotaExceed(AlertType alertType)
         conf->setBlockInetTraffic(true);
         confManager->saveFlags();
     }
-
-    emit alert(alertType);
 }
 
 void QuotaManager::setupByConf(const IniOptions &ini)
 {
-    setQuotaDayBytes(qint64(ini.quotaDayMb()) * 1024 * 1024);
-    setQuotaMonthBytes(qint64(ini.quotaMonthMb()) * 1024 * 1024);
-
-    const qint64 unixTime = DateUtil::getUnixTime();
-    const qint32 trafDay = DateUtil::getUnixDay(unixTime);
-    const qint32 trafMonth = DateUtil::getUnixMonth(unixTime, ini.monthStart());
+    m_ledger.setMonthStart(ini.monthStart());
+    m_ledger.setAlertPercents(parseAlertPercents(ini.quotaAlertPercents()));
 
-    auto statManager = IoC<StatManager>();
-    qint64 inBytes, outBytes;
+    m_ledger.setQuota(QuotaKey::global(), qint64(ini.quotaDayMb()) * 1024 * 1024,
+            qint64(ini.quotaMonthMb()) * 1024 * 1024);
+}
 
-    statManager->getTraffic(StatSql::sqlSelectTrafDay, trafDay, inBytes, outBytes);
-    setTrafDayBytes(inBytes);
+qint8 QuotaManager::alertTypeByAlert(const QuotaAlert &alert)
+{
+    const bool isDay = (alert.period == QuotaAlert::PeriodDay);
 
-    statManager->getTraffic(StatSql::sqlSelectTrafMonth, trafMonth, inBytes, outBytes);
-    setTrafMonthBytes(inBytes);
+    switch (alert.key.scope) {
+    case QuotaKey::ScopeApp:
+        return isDay ? AlertAppDay : AlertAppMonth;
+    case QuotaKey::ScopeAppGroup:
+        return isDay ? AlertAppGroupDay : AlertAppGroupMonth;
+    default:
+        return isDay ? AlertDay : AlertMonth;
+    }
 }
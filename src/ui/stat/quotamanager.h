@@ -1,63 +1,89 @@
 #ifndef QUOTAMANAGER_H
 #define QUOTAMANAGER_H
 
+#include <QHash>
 #include <QObject>
+#include <QTimer>
 
 #include <util/ioc/iocservice.h>
 
+#include "quotaledger.h"
+
 class IniOptions;
+class SqliteDb;
 
 class QuotaManager : public QObject, public IocService
 {
     Q_OBJECT
 
 public:
-    enum AlertType : qint8 { AlertDay = 1, AlertMonth };
+    enum AlertType : qint8 {
+        AlertDay = 1,
+        AlertMonth,
+        AlertAppDay,
+        AlertAppMonth,
+        AlertAppGroupDay,
+        AlertAppGroupMonth,
+    };
 
     explicit QuotaManager(QObject *parent = nullptr);
 
-    void setQuotaDayBytes(qint64 bytes);
-    void setQuotaMonthBytes(qint64 bytes);
+    const QuotaLedger &ledger() const { return m_ledger; }
 
-    void setTrafDayBytes(qint64 bytes);
-    void setTrafMonthBytes(qint64 bytes);
+    void setAppQuota(qint64 appId, qint64 dayBytes, qint64 monthBytes);
+    void setAppGroupQuota(qint64 appGroupId, qint64 dayBytes, qint64 monthBytes);
 
     void setUp() override;
+    void tearDown() override;
 
     void clear(bool clearDay = true, bool clearMonth = true);
-    void addTraf(qint64 bytes);
 
-    void checkQuotaDay(qint32 trafDay);
-    void checkQuotaMonth(qint32 trafMonth);
+    void addTraf(qint64 unixTime, qint64 bytes);
+    void addAppTraf(qint64 unixTime, const QString &appPath, qint64 bytes);
 
-    static QString alertTypeText(qint8 alertType);
+    static QString alertTypeText(qint8 alertType, int percent = 100);
 
 signals:
-    void alert(qint8 alertType);
+    void alert(qint8 alertType, int percent);
+
+public slots:
+    bool saveCheckpoint();
 
 protected:
     virtual void setupConfManager();
+    virtual void setupConfAppManager();
 
-    virtual int quotaDayAlerted() const;
-    virtual void setQuotaDayAlerted(qint32 v);
+    virtual SqliteDb *sqliteDb() const;
 
-    virtual int quotaMonthAlerted() const;
-    virtual void setQuotaMonthAlerted(qint32 v);
+    virtual bool getAppQuotaIds(const QString &appPath, qint64 &appId, qint64 &appGroupId);
 
 private:
-    void processQuotaExceed(AlertType alertType);
+    struct AppQuotaIds
+    {
+        qint64 appId = 0;
+        qint64 appGroupId = 0;
+    };
+
+    void setupCheckpointTimer();
+
+    void loadCheckpoint();
+
+    AppQuotaIds appQuotaIds(const QString &appPath);
+    void clearAppQuotaIds();
+
+    void processAlerts(const QVector<QuotaAlert> &alerts);
+    void processQuotaExceed();
 
     void setupByConf(const IniOptions &ini);
 
+    static qint8 alertTypeByAlert(const QuotaAlert &alert);
+
 private:
-    int m_quotaDayAlerted = 0;
-    int m_quotaMonthAlerted = 0;
+    QuotaLedger m_ledger;
 
-    qint64 m_quotaDayBytes = 0;
-    qint64 m_quotaMonthBytes = 0;
+    QTimer m_checkpointTimer;
 
-    qint64 m_trafDayBytes = 0;
-    qint64 m_trafMonthBytes = 0;
+    QHash<QString, AppQuotaIds> m_appQuotaIdsCache; // appPath -> ids
 };
 
 #endif // QUOTAMANAGER_H
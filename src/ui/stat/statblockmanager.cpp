@@ -19,7 +19,7 @@ namespace {
 
 const QLoggingCategory LC("statBlock");
 
-constexpr int DATABASE_USER_VERSION = 7;
+constexpr int DATABASE_USER_VERSION = 8;
 
 bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
 {
@@ -49,6 +49,23 @@ bool migrateFunc(SqliteDb *db, int version, bool isNewDb, void *ctx)
                                        " inherited, ip_proto, local_port, remote_port,"
                                        " local_ip, remote_ip, local_ip6, remote_ip6,"
                                        " block_reason"));
+    } else if (version < 8) {
+        const QString srcSchema = SqliteDb::migrationOldSchemaName();
+        const QString dstSchema = SqliteDb::migrationNewSchemaName();
+
+        db->executeStr(QString("INSERT INTO %1 (%3) SELECT %3 FROM %2;")
+                               .arg(SqliteDb::entityName(dstSchema, "app"),
+                                       SqliteDb::entityName(srcSchema, "app"),
+                                       "app_id, path, creat_time"));
+
+        // Add the "conn_count" column
+        db->executeStr(QString("INSERT INTO %1 (%3) SELECT %3 FROM %2;")
+                               .arg(SqliteDb::entityName(dstSchema, "conn_block"),
+                                       SqliteDb::entityName(srcSchema, "conn_block"),
+                                       "conn_id, app_id, conn_time, process_id, inbound,"
+                                       " inherited, ip_proto, local_port, remote_port,"
+                                       " local_ip, remote_ip, local_ip6, remote_ip6,"
+                                       " block_reason"));
     }
 
     return true;
@@ -87,7 +104,8 @@ void StatBlockManager::tearDown()
 
 void StatBlockManager::logBlockedIp(const LogEntryBlockedIp &entry)
 {
-    constexpr int maxJobCount = 16;
+    // The entries are merged to the last job by batches of 1000
+    constexpr int maxJobCount = 64;
     if (jobCount() >= maxJobCount)
         return; // drop excessive data
 
@@ -174,8 +192,8 @@ bool StatBlockManager::setupDb()
         .sqlDir = ":/stat/migrations/block",
         .version = DATABASE_USER_VERSION,
         .recreate = true,
-        // COMPAT: Union the "conn" & "conn_block" tables
-        .autoCopyTables = (DATABASE_USER_VERSION != 7),
+        // COMPAT: Union the "conn" & "conn_block" tables; Add the "conn_count" column
+        .autoCopyTables = false,
         .migrateFunc = &migrateFunc,
     };
 
@@ -28,7 +28,7 @@ public:
     void setUp() override;
     void tearDown() override;
 
-    void logBlockedIp(const LogEntryBlockedIp &entry);
+    virtual void logBlockedIp(const LogEntryBlockedIp &entry);
 
     virtual void deleteConn(qint64 connIdTo = 0);
 
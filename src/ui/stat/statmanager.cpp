@@ -22,7 +22,7 @@ namespace {
 
 const QLoggingCategory LC("stat");
 
-constexpr int DATABASE_USER_VERSION = 7;
+constexpr int DATABASE_USER_VERSION = 8;
 
 constexpr qint32 ACTIVE_PERIOD_CHECK_SECS = 60 * OS_TICKS_PER_SECOND;
 
@@ -123,23 +123,18 @@ void StatManager::updateActivePeriod()
     }
 }
 
-void StatManager::clearQuotas(bool isNewDay, bool isNewMonth)
-{
-    auto quotaManager = IoC<QuotaManager>();
-
-    quotaManager->clear(isNewDay && m_trafDay != 0, isNewMonth && m_trafMonth != 0);
-}
-
-void StatManager::checkQuotas(quint32 inBytes)
+void StatManager::checkQuotas(qint64 unixTime, quint32 inBytes)
 {
     if (m_isActivePeriod) {
-        auto quotaManager = IoC<QuotaManager>();
-
         // Update quota traffic bytes
-        quotaManager->addTraf(inBytes);
+        IoC<QuotaManager>()->addTraf(unixTime, inBytes);
+    }
+}
 
-        quotaManager->checkQuotaDay(m_trafDay);
-        quotaManager->checkQuotaMonth(m_trafMonth);
+void StatManager::checkAppQuotas(qint64 unixTime, const QString &appPath, quint32 inBytes)
+{
+    if (m_isActivePeriod && inBytes != 0) {
+        IoC<QuotaManager>()->addAppTraf(unixTime, appPath, inBytes);
     }
 }
 
@@ -153,10 +148,6 @@ bool StatManager::updateTrafDay(qint64 unixTime)
 
     const qint32 trafMonth =
             isNewDay ? DateUtil::getUnixMonth(unixTime, ini()->monthStart()) : m_trafMonth;
-    const bool isNewMonth = (trafMonth != m_trafMonth);
-
-    // Initialize quotas traffic bytes
-    clearQuotas(isNewDay, isNewMonth);
 
     m_trafHour = trafHour;
     m_trafDay = trafDay;
@@ -324,7 +315,7 @@ bool StatManager::logStatTraf(const LogEntryStatTraf &entry, qint64 unixTime)
     sqliteDb()->commitTransaction();
 
     // Check quotas
-    checkQuotas(sumInBytes);
+    checkQuotas(unixTime, sumInBytes);
 
     // Notify about sum traffic bytes
     emit trafficAdded(unixTime, sumInBytes, sumOutBytes);
@@ -510,6 +501,9 @@ void StatManager::logTrafBytes(const SqliteStmtList &insertStmtList,
         updateTrafficList(insertStmtList, updateStmtList, inBytes, outBytes, appId);
     }
 
+    // Check app quotas
+    checkAppQuotas(unixTime, appPath, inBytes);
+
     // Update sum traffic bytes
     sumInBytes += inBytes;
     sumOutBytes += outBytes;
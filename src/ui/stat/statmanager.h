@@ -72,8 +72,8 @@ private:
     void setupActivePeriod();
     void updateActivePeriod();
 
-    void clearQuotas(bool isNewDay, bool isNewMonth);
-    void checkQuotas(quint32 inBytes);
+    void checkQuotas(qint64 unixTime, quint32 inBytes);
+    void checkAppQuotas(qint64 unixTime, const QString &appPath, quint32 inBytes);
 
     bool updateTrafDay(qint64 unixTime);
 
@@ -163,11 +163,26 @@ const char *const StatSql::sqlDeleteAllTraffic = "DELETE FROM traffic_app;"
                                                  "DELETE FROM traffic_month;"
                                                  "DELETE FROM app;";
 
+const char *const StatSql::sqlSelectQuotaLedger =
+        "SELECT scope, scope_id,"
+        "    day_time, day_bytes, day_quota, day_alerted,"
+        "    month_time, month_bytes, month_quota, month_alerted"
+        "  FROM quota_ledger;";
+
+const char *const StatSql::sqlUpsertQuotaLedger =
+        "INSERT OR REPLACE INTO quota_ledger(scope, scope_id,"
+        "    day_time, day_bytes, day_quota, day_alerted,"
+        "    month_time, month_bytes, month_quota, month_alerted)"
+        "  VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10);";
+
+const char *const StatSql::sqlDeleteQuotaLedger =
+        "DELETE FROM quota_ledger WHERE scope = ?1 AND scope_id = ?2;";
+
 const char *const StatSql::sqlInsertConnBlock =
         "INSERT INTO conn_block(app_id, conn_time, process_id, inbound, inherited,"
         "    ip_proto, local_port, remote_port, local_ip, remote_ip,"
-        "    local_ip6, remote_ip6, block_reason)"
-        "  VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13);";
+        "    local_ip6, remote_ip6, block_reason, conn_count)"
+        "  VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13, ?14);";
 
 const char *const StatSql::sqlSelectMinMaxConnBlockId =
         "SELECT MIN(conn_id), MAX(conn_id) FROM conn_block;";
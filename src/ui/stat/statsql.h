@@ -66,6 +66,10 @@ public:
     static const char *const sqlResetAppTrafTotals;
     static const char *const sqlDeleteAllTraffic;
 
+    static const char *const sqlSelectQuotaLedger;
+    static const char *const sqlUpsertQuotaLedger;
+    static const char *const sqlDeleteQuotaLedger;
+
     static const char *const sqlInsertConnBlock;
 
     static const char *const sqlSelectMinMaxConnBlockId;
@@ -0,0 +1,96 @@
+#include "taskapppurger.h"
+
+#include <QLoggingCategory>
+#include <QTimer>
+
+#include <appinfo/apppurgemanager.h>
+#include <conf/confappmanager.h>
+#include <util/ioc/ioccontainer.h>
+
+namespace {
+
+const QLoggingCategory LC("task.appPurger");
+
+}
+
+TaskAppPurger::TaskAppPurger(QObject *parent) : TaskWorker(parent) { }
+
+void TaskAppPurger::run()
+{
+    createPurgeManager();
+
+    // Snapshot the apps to not hold the DB while checking the files
+    const QVector<AppPurgeEntry> apps = IoC<ConfAppManager>()->collectPurgeApps();
+
+    m_purgeManager->checkApps(apps);
+}
+
+void TaskAppPurger::finish(bool success)
+{
+    if (!m_purgeManager)
+        return;
+
+    deletePurgeManager();
+
+    emit finished(success);
+}
+
+void TaskAppPurger::createPurgeManager()
+{
+    if (m_purgeManager)
+        return;
+
+    m_purgeManager = new AppPurgeManager(this);
+
+    connect(m_purgeManager, &AppPurgeManager::progressChanged, this,
+            &TaskAppPurger::progressChanged);
+    connect(m_purgeManager, &AppPurgeManager::checkFinished, this,
+            &TaskAppPurger::onCheckFinished);
+}
+
+void TaskAppPurger::deletePurgeManager()
+{
+    if (!m_purgeManager)
+        return;
+
+    m_purgeManager->disconnect(this); // to avoid recursive call on abort()
+
+    m_purgeManager->abortWorkers();
+
+    m_purgeManager->deleteLater();
+    m_purgeManager = nullptr;
+}
+
+void TaskAppPurger::onCheckFinished(const QVector<qint64> &obsoleteAppIds)
+{
+    qCDebug(LC) << "Obsolete apps:" << obsoleteAppIds.size();
+
+    m_obsoleteAppIds = obsoleteAppIds;
+    m_deleteIndex = 0;
+
+    deleteNextApps();
+}
+
+void TaskAppPurger::deleteNextApps()
+{
+    if (!m_purgeManager)
+        return; // aborted
+
+    if (m_deleteIndex >= m_obsoleteAppIds.size()) {
+        finish(/*success=*/true);
+        return;
+    }
+
+    const auto appIdList =
+            m_obsoleteAppIds.mid(m_deleteIndex, ConfAppManager::DeleteAppsChunkSize);
+
+    m_deleteIndex += appIdList.size();
+
+    if (!IoC<ConfAppManager>()->deleteApps(appIdList)) {
+        finish(/*success=*/false);
+        return;
+    }
+
+    // Let the event loop run between the transactions
+    QTimer::singleShot(0, this, &TaskAppPurger::deleteNextApps);
+}
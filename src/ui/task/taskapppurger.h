@@ -0,0 +1,42 @@
+#ifndef TASKAPPPURGER_H
+#define TASKAPPPURGER_H
+
+#include <QVector>
+
+#include "taskworker.h"
+
+class AppPurgeManager;
+
+class TaskAppPurger : public TaskWorker
+{
+    Q_OBJECT
+
+public:
+    explicit TaskAppPurger(QObject *parent = nullptr);
+
+    AppPurgeManager *purgeManager() const { return m_purgeManager; }
+
+signals:
+    void progressChanged(int checkedCount, int totalCount);
+
+public slots:
+    void run() override;
+    void finish(bool success = false) override;
+
+private:
+    void createPurgeManager();
+    void deletePurgeManager();
+
+    void onCheckFinished(const QVector<qint64> &obsoleteAppIds);
+
+    void deleteNextApps();
+
+private:
+    int m_deleteIndex = 0;
+
+    QVector<qint64> m_obsoleteAppIds;
+
+    AppPurgeManager *m_purgeManager = nullptr;
+};
+
+#endif // TASKAPPPURGER_H
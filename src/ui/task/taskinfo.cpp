@@ -4,6 +4,7 @@
 
 #include <util/dateutil.h>
 
+#include "taskapppurger.h"
 #include "taskeditinfo.h"
 #include "taskmanager.h"
 #include "taskupdatechecker.h"
@@ -201,6 +202,8 @@ TaskWorker *TaskInfo::createWorker()
         return new TaskUpdateChecker(this);
     case ZoneDownloader:
         return new TaskZoneDownloader(this);
+    case AppPurger:
+        return new TaskAppPurger(this);
     default:
         Q_UNREACHABLE();
         return nullptr;
@@ -2,9 +2,7 @@
 
 #include <QLoggingCategory>
 
-#include <conf/confappmanager.h>
-#include <util/ioc/ioccontainer.h>
-
+#include "taskapppurger.h"
 #include "taskmanager.h"
 
 namespace {
@@ -16,12 +14,24 @@ const QLoggingCategory LC("task.appPurger");
 TaskInfoAppPurger::TaskInfoAppPurger(TaskManager &taskManager) :
     TaskInfo(AppPurger, taskManager) { }
 
-void TaskInfoAppPurger::runTaskWorker()
+TaskAppPurger *TaskInfoAppPurger::appPurger() const
+{
+    return static_cast<TaskAppPurger *>(taskWorker());
+}
+
+bool TaskInfoAppPurger::processResult(bool success)
 {
-    // TODO: Use worker to run in a separate thread to not block the UI
-    const bool ok = IoC<ConfAppManager>()->purgeApps();
+    qCDebug(LC) << "Purged:" << success;
 
-    qCDebug(LC) << "Purged:" << ok;
+    return success;
+}
+
+void TaskInfoAppPurger::setupTaskWorker()
+{
+    TaskInfo::setupTaskWorker();
 
-    handleFinished(ok);
+    connect(appPurger(), &TaskAppPurger::progressChanged, this,
+            [](int checkedCount, int totalCount) {
+                qCDebug(LC) << "Checked:" << checkedCount << "of" << totalCount;
+            });
 }
@@ -12,12 +12,13 @@ class TaskInfoAppPurger : public TaskInfo
 public:
     explicit TaskInfoAppPurger(TaskManager &taskManager);
 
+    TaskAppPurger *appPurger() const;
+
 public slots:
-    bool processResult(bool success) override { return success; }
+    bool processResult(bool success) override;
 
 protected slots:
-    void setupTaskWorker() override { }
-    void runTaskWorker() override;
+    void setupTaskWorker() override;
 };
 
 #endif // TASKINFOAPPPURGER_H
@@ -1,5 +1,7 @@
 #include "confutil.h"
 
+#include <QLoggingCategory>
+
 #include <common/fortconf.h>
 #include <fort_version.h>
 
@@ -12,28 +14,34 @@
 #include <util/bitutil.h>
 #include <util/dateutil.h>
 #include <util/fileutil.h>
+#include <util/net/portrange.h>
 #include <util/stringutil.h>
 
 #include "confappswalker.h"
 #include "confruleswalker.h"
+#include "ruleexpr.h"
 
 #define APP_GROUP_MAX      FORT_CONF_GROUP_MAX
 #define APP_GROUP_NAME_MAX 128
 #define APP_PATH_MAX       FORT_CONF_APP_PATH_MAX
+#define APP_ENTRIES_MAX    0xFFFF /* apps_n of FORT_APP_ENTRIES */
 
 namespace {
 
+const QLoggingCategory LC("util.conf.confUtil");
+
 inline bool checkIpRangeSize(const IpRange &range)
 {
     return (range.ip4Size() + range.pair4Size()) < FORT_CONF_IP_MAX
             && (range.ip6Size() + range.pair6Size()) < FORT_CONF_IP_MAX;
 }
 
-int writeServicesHeader(char *data, int servicesCount)
+int writeServicesHeader(char *data, int servicesCount, quint16 flags = 0)
 {
     PFORT_SERVICE_INFO_LIST infoList = (PFORT_SERVICE_INFO_LIST) data;
 
     infoList->services_n = servicesCount;
+    infoList->flags = flags;
 
     return FORT_SERVICE_INFO_LIST_DATA_OFF;
 }
@@ -42,7 +50,8 @@ int writeServiceInfo(char *data, const ServiceInfo &serviceInfo)
 {
     PFORT_SERVICE_INFO info = (PFORT_SERVICE_INFO) data;
 
-    info->process_id = serviceInfo.processId;
+    // Zero process id removes the service on delta update
+    info->process_id = serviceInfo.isRunning ? serviceInfo.processId : 0;
 
     const quint16 nameLen = quint16(serviceInfo.serviceName.size() * sizeof(char16_t));
     info->name_len = nameLen;
@@ -225,6 +234,25 @@ void ConfUtil::writeServices(const QVector<ServiceInfo> &services, int runningSe
     buffer().resize(outSize);
 }
 
+void ConfUtil::writeServicesDelta(const QVector<ServiceInfo> &services)
+{
+    const int servicesCount = services.size();
+    const int servicesSize =
+            FORT_SERVICE_INFO_LIST_MIN_SIZE + servicesCount * FORT_SERVICE_INFO_MAX_SIZE;
+
+    buffer().resize(servicesSize);
+
+    char *data = buffer().data();
+
+    int outSize = writeServicesHeader(data, servicesCount, FORT_SERVICE_INFO_LIST_DELTA);
+
+    for (const ServiceInfo &info : services) {
+        outSize += writeServiceInfo(data + outSize, info);
+    }
+
+    buffer().resize(outSize);
+}
+
 bool ConfUtil::write(
         const FirewallConf &conf, const ConfAppsWalker *confAppsWalker, EnvManager &envManager)
 {
@@ -295,50 +323,136 @@ bool ConfUtil::writeAppEntry(const App &app, bool isNew)
     return true;
 }
 
+bool ConfUtil::writeAppEntries(const QList<App> &apps)
+{
+    appdata_map_t appsMap;
+    quint32 appsSize = 0;
+
+    for (const App &app : apps) {
+        if (!addApp(app, /*isNew=*/false, appsMap, appsSize))
+            return false;
+    }
+
+    if (appsMap.size() > APP_ENTRIES_MAX || appsSize > FORT_CONF_APPS_LEN_MAX) {
+        setErrorMessage(tr("Too many application paths"));
+        return false;
+    }
+
+    buffer().resize(FORT_APP_ENTRIES_DATA_OFF + appsSize);
+
+    // Fill the buffer
+    PFORT_APP_ENTRIES appEntries = (PFORT_APP_ENTRIES) buffer().data();
+    appEntries->apps_n = quint16(appsMap.size());
+
+    char *data = appEntries->data;
+
+    writeApps(&data, appsMap);
+
+    return true;
+}
+
 bool ConfUtil::writeRules(const ConfRulesWalker &confRulesWalker)
 {
     ruleset_map_t ruleSetMap;
     ruleid_arr_t ruleIds;
-    int maxRuleId;
+    int maxRuleId = 0;
 
-    int outSize = 0;
-    int ruleOffset = 0;
+    longs_arr_t ruleOffsets;
+    QByteArray rulesData;
 
-    return confRulesWalker.walkRules(ruleSetMap, ruleIds, maxRuleId, [&](Rule &rule) -> bool {
-        if (outSize == 0) {
-            outSize = FORT_CONF_RULES_DATA_OFF + FORT_CONF_RULES_OFFSETS_SIZE(maxRuleId);
+    RuleExpr ruleExpr;
 
-            buffer().resize(outSize);
-            buffer().fill('\0');
-
-            PFORT_CONF_RULES rules = (PFORT_CONF_RULES) buffer().data();
-            rules->max_rule_id = maxRuleId;
+    const auto fillMissingOffsets = [&] {
+        if (ruleOffsets.isEmpty()) {
+            ruleOffsets.fill(FORT_CONF_RULE_OFF_NONE, maxRuleId + 1);
         }
+    };
 
-        const int ruleId = rule.ruleId;
-        const auto ruleSetIndex = ruleSetMap[ruleId];
+    const bool ok = confRulesWalker.walkRules(
+            ruleSetMap, ruleIds, maxRuleId, [&](Rule &rule) -> bool {
+                const int ruleId = rule.ruleId;
 
-        // Store the rule's offset
-        {
-            int *ruleOffsets = (int *) (buffer().data() + FORT_CONF_RULES_DATA_OFF);
-            ruleOffsets[ruleId] = ruleOffset;
-        }
+                // The deleted and skipped rules' ids stay missing
+                fillMissingOffsets();
 
-        // Store the rule
-        PFORT_CONF_RULE confRule = (PFORT_CONF_RULE) (buffer().data() + outSize);
-        confRule->enabled = rule.enabled;
-        confRule->blocked = rule.blocked;
-        confRule->exclusive = rule.exclusive;
+                if (!ruleExpr.parse(rule.ruleText)) {
+                    qCWarning(LC) << "Rule skipped:" << ruleId
+                                  << ruleExpr.errorLineAndMessageDetails();
+                    return true;
+                }
 
-        const bool hasZones = (rule.acceptZones != 0 || rule.rejectZones != 0);
-        confRule->has_zones = hasZones;
+                const auto ruleSetIndex = ruleSetMap.value(ruleId);
+                const auto ruleSet = ruleIds.mid(ruleSetIndex.index, ruleSetIndex.count);
 
-        confRule->has_expr = !rule.ruleText.isEmpty();
+                // Store the rule's offset
+                ruleOffsets[ruleId] = rulesData.size();
 
-        confRule->set_count = ruleSetIndex.count;
+                writeRule(rulesData, rule, ruleSet, ruleExpr);
 
-        return true;
-    });
+                return true;
+            });
+
+    if (!ok)
+        return false;
+
+    fillMissingOffsets();
+
+    buffer().resize(FORT_CONF_RULES_DATA_OFF + FORT_CONF_RULES_OFFSETS_SIZE(maxRuleId)
+            + rulesData.size());
+
+    // Fill the buffer
+    PFORT_CONF_RULES rules = (PFORT_CONF_RULES) buffer().data();
+    char *data = rules->data;
+
+    rules->max_rule_id = maxRuleId;
+
+    writeLongs(&data, ruleOffsets);
+    writeArray(&data, rulesData);
+
+    return true;
+}
+
+void ConfUtil::writeRuleExpr(const RuleExpr &ruleExpr)
+{
+    buffer().clear();
+
+    writeRuleExprData(buffer(), ruleExpr);
+}
+
+int ConfUtil::writePorts(const PortRange &portRange, int portEncoding)
+{
+    const QByteArray portBitmap = portRange.toBitmap();
+
+    int listSize;
+    if (portEncoding < 0) {
+        portEncoding = selectPortEncoding(portRange, portBitmap, listSize);
+    } else {
+        listSize = portListSize(portRange, portBitmap, portEncoding);
+        if (listSize < 0)
+            return -1;
+    }
+
+    buffer().resize(listSize);
+
+    // Fill the buffer
+    char *data = buffer().data();
+
+    writePortListData(&data, portRange, portBitmap, portEncoding);
+
+    return portEncoding;
+}
+
+void ConfUtil::writeRuleFlag(int ruleId, bool enabled)
+{
+    const int flagSize = sizeof(FORT_CONF_RULE_FLAG);
+
+    buffer().resize(flagSize);
+
+    // Fill the buffer
+    PFORT_CONF_RULE_FLAG confRuleFlag = (PFORT_CONF_RULE_FLAG) buffer().data();
+
+    confRuleFlag->rule_id = ruleId;
+    confRuleFlag->enabled = enabled;
 }
 
 void ConfUtil::writeZone(const IpRange &ipRange)
@@ -699,6 +813,8 @@ void ConfUtil::writeConf(char *output, const WriteConfArgs &wca, AppParseOptions
 
     writeLimits(&drvConfIo->conf_group, wca.conf.appGroups());
 
+    drvConfIo->flows_capacity = quint32(qMax(wca.conf.ini().flowsCapacity(), 0));
+
     writeConfFlags(wca.conf, &drvConf->flags);
 
     DriverCommon::confAppPermsMaskInit(drvConf);
@@ -880,6 +996,256 @@ void ConfUtil::writeApps(char **data, const appdata_map_t &appsMap, bool useHead
     *data += offTableSize + FORT_CONF_STR_DATA_SIZE(off);
 }
 
+void ConfUtil::writeRule(
+        QByteArray &out, const Rule &rule, const shorts_arr_t &ruleSet, const RuleExpr &ruleExpr)
+{
+    const bool hasZones = (rule.acceptZones != 0 || rule.rejectZones != 0);
+    const bool hasExpr = !ruleExpr.isEmpty();
+
+    const int ruleSize = sizeof(FORT_CONF_RULE) + (hasZones ? sizeof(FORT_CONF_RULE_ZONES) : 0)
+            + ruleSet.size() * sizeof(quint16);
+
+    char *data = appendData(out, ruleSize);
+
+    PFORT_CONF_RULE confRule = (PFORT_CONF_RULE) data;
+    confRule->enabled = rule.enabled;
+    confRule->blocked = rule.blocked;
+    confRule->exclusive = rule.exclusive;
+    confRule->has_zones = hasZones;
+    confRule->has_expr = hasExpr;
+    confRule->set_count = ruleSet.size();
+
+    data += sizeof(FORT_CONF_RULE);
+
+    if (hasZones) {
+        PFORT_CONF_RULE_ZONES ruleZones = (PFORT_CONF_RULE_ZONES) data;
+        ruleZones->accept_zones = rule.acceptZones;
+        ruleZones->reject_zones = rule.rejectZones;
+
+        data += sizeof(FORT_CONF_RULE_ZONES);
+    }
+
+    writeShorts(&data, ruleSet);
+
+    if (hasExpr) {
+        writeRuleExprData(out, ruleExpr);
+    }
+}
+
+void ConfUtil::writeRuleExprData(QByteArray &out, const RuleExpr &ruleExpr)
+{
+    writeRuleExprList(out, ruleExpr, ruleExpr.filterAt(0));
+
+    // Close the top group
+    writeRuleExprHeader(out, /*isOr=*/false, /*isBegin=*/false, /*isEnd=*/true);
+}
+
+void ConfUtil::writeRuleExprList(
+        QByteArray &out, const RuleExpr &ruleExpr, const RuleFilter &listFilter)
+{
+    for (const int filterIndex : listFilter.children) {
+        const RuleFilter &filter = ruleExpr.filterAt(filterIndex);
+
+        if (filter.isList()) {
+            writeRuleExprHeader(out, filter.isOr, /*isBegin=*/true);
+            writeRuleExprList(out, ruleExpr, filter);
+            writeRuleExprHeader(out, /*isOr=*/false, /*isBegin=*/false, /*isEnd=*/true);
+        } else {
+            writeRuleExprFilter(out, filter);
+        }
+    }
+}
+
+void ConfUtil::writeRuleExprFilter(QByteArray &out, const RuleFilter &filter)
+{
+    // The lists are checked by the parser
+    IpRange ipRange;
+    ipRange.fromList(filter.addressList);
+
+    PortRange portRange;
+    portRange.fromList(filter.portList);
+
+    const bool hasAddress = !filter.addressList.isEmpty();
+    const bool hasIp6List = (ipRange.ip6Size() != 0 || ipRange.pair6Size() != 0);
+    const bool hasPort = !filter.portList.isEmpty();
+
+    const QByteArray portBitmap = hasPort ? portRange.toBitmap() : QByteArray();
+
+    int portListSize = 0;
+    const int portEncoding = hasPort ? selectPortEncoding(portRange, portBitmap, portListSize) : 0;
+
+    int filterSize = sizeof(FORT_CONF_RULE_EXPR);
+    if (hasAddress) {
+        filterSize += FORT_CONF_ADDR4_LIST_SIZE(ipRange.ip4Size(), ipRange.pair4Size());
+        if (hasIp6List) {
+            filterSize += FORT_CONF_ADDR6_LIST_SIZE(ipRange.ip6Size(), ipRange.pair6Size());
+        }
+    }
+    filterSize += portListSize;
+
+    char *data = appendData(out, filterSize);
+
+    PFORT_CONF_RULE_EXPR expr = (PFORT_CONF_RULE_EXPR) data;
+    expr->expr_or = filter.isOr;
+    expr->expr_local = filter.isLocal;
+    expr->has_ip6_list = hasIp6List;
+    expr->port_encoding = portEncoding;
+    expr->flags = (hasAddress ? FORT_RULE_FLAG_ADDRESS : 0) | (hasPort ? FORT_RULE_FLAG_PORT : 0)
+            | ((filter.protoFlags & RuleFilter::ProtoTcp) != 0 ? FORT_RULE_FLAG_PROTO_TCP : 0)
+            | ((filter.protoFlags & RuleFilter::ProtoUdp) != 0 ? FORT_RULE_FLAG_PROTO_UDP : 0);
+
+    data += sizeof(FORT_CONF_RULE_EXPR);
+
+    if (hasAddress) {
+        writeAddress4List(&data, ipRange);
+        if (hasIp6List) {
+            writeAddress6List(&data, ipRange);
+        }
+    }
+
+    if (hasPort) {
+        writePortListData(&data, portRange, portBitmap, portEncoding);
+    }
+}
+
+void ConfUtil::writeRuleExprHeader(QByteArray &out, bool isOr, bool isBegin, bool isEnd)
+{
+    PFORT_CONF_RULE_EXPR expr =
+            (PFORT_CONF_RULE_EXPR) appendData(out, sizeof(FORT_CONF_RULE_EXPR));
+
+    expr->expr_begin = isBegin;
+    expr->expr_end = isEnd;
+    expr->expr_or = isOr;
+}
+
+int ConfUtil::selectPortEncoding(
+        const PortRange &portRange, const QByteArray &portBitmap, int &listSize)
+{
+    int portEncoding = FORT_CONF_PORT_ENCODING_BITMAP;
+    listSize = FORT_CONF_PORT_BITMAP_SIZE;
+
+    // Prefer the list, then the two-level bitmap on the same size
+    for (const int encoding : { FORT_CONF_PORT_ENCODING_BLOCKS, FORT_CONF_PORT_ENCODING_LIST }) {
+        const int size = portListSize(portRange, portBitmap, encoding);
+
+        if (size >= 0 && size <= listSize) {
+            portEncoding = encoding;
+            listSize = size;
+        }
+    }
+
+    return portEncoding;
+}
+
+int ConfUtil::portListSize(const PortRange &portRange, const QByteArray &portBitmap, int portEncoding)
+{
+    switch (portEncoding) {
+    case FORT_CONF_PORT_ENCODING_LIST: {
+        // The list's counts are UINT8
+        if (portRange.portSize() > 0xFF || portRange.pairSize() > 0xFF)
+            return -1;
+
+        return FORT_CONF_PORT_LIST_SIZE(portRange.portSize(), portRange.pairSize());
+    }
+    case FORT_CONF_PORT_ENCODING_BLOCKS: {
+        const int leafCount = portBlocksLeafCount(portBitmap);
+        if (leafCount > FORT_CONF_PORT_LEAF_MAX)
+            return -1;
+
+        return FORT_CONF_PORT_BLOCKS_SIZE(leafCount);
+    }
+    default:
+        return FORT_CONF_PORT_BITMAP_SIZE;
+    }
+}
+
+int ConfUtil::portBlocksLeafCount(const QByteArray &portBitmap)
+{
+    int leafCount = 0;
+
+    for (int i = 0; i < FORT_CONF_PORT_BLOCK_COUNT; ++i) {
+        if (portBlockCode(portBitmap, i) == FORT_CONF_PORT_BLOCK_LEAF) {
+            ++leafCount;
+        }
+    }
+
+    return leafCount;
+}
+
+quint8 ConfUtil::portBlockCode(const QByteArray &portBitmap, int blockIndex)
+{
+    const uchar *leafBits =
+            (const uchar *) portBitmap.constData() + blockIndex * FORT_CONF_PORT_LEAF_SIZE;
+
+    bool isNone = true;
+    bool isAll = true;
+
+    for (int i = 0; i < FORT_CONF_PORT_LEAF_SIZE; ++i) {
+        isNone = isNone && (leafBits[i] == 0);
+        isAll = isAll && (leafBits[i] == 0xFF);
+    }
+
+    return isNone ? FORT_CONF_PORT_BLOCK_NONE
+                  : (isAll ? FORT_CONF_PORT_BLOCK_ALL : FORT_CONF_PORT_BLOCK_LEAF);
+}
+
+void ConfUtil::writePortListData(char **data, const PortRange &portRange,
+        const QByteArray &portBitmap, int portEncoding)
+{
+    switch (portEncoding) {
+    case FORT_CONF_PORT_ENCODING_LIST: {
+        writePortList(data, portRange);
+    } break;
+    case FORT_CONF_PORT_ENCODING_BITMAP: {
+        writeArray(data, portBitmap);
+    } break;
+    case FORT_CONF_PORT_ENCODING_BLOCKS: {
+        writePortBlocks(data, portBitmap);
+    } break;
+    }
+}
+
+void ConfUtil::writePortBlocks(char **data, const QByteArray &portBitmap)
+{
+    PFORT_CONF_PORT_BLOCKS portBlocks = PFORT_CONF_PORT_BLOCKS(*data);
+
+    quint8 leafCount = 0;
+
+    for (int i = 0; i < FORT_CONF_PORT_BLOCK_COUNT; ++i) {
+        quint8 blockCode = portBlockCode(portBitmap, i);
+
+        if (blockCode == FORT_CONF_PORT_BLOCK_LEAF) {
+            blockCode += leafCount;
+
+            memcpy(&portBlocks->leaf_bits[leafCount * FORT_CONF_PORT_LEAF_SIZE],
+                    portBitmap.constData() + i * FORT_CONF_PORT_LEAF_SIZE,
+                    FORT_CONF_PORT_LEAF_SIZE);
+
+            ++leafCount;
+        }
+
+        portBlocks->block[i] = blockCode;
+    }
+
+    portBlocks->leaf_n = leafCount;
+
+    *data += FORT_CONF_PORT_BLOCKS_SIZE(leafCount);
+}
+
+void ConfUtil::writePortList(char **data, const PortRange &portRange)
+{
+    PFORT_CONF_PORT_LIST portList = PFORT_CONF_PORT_LIST(*data);
+
+    portList->port_n = quint8(portRange.portSize());
+    portList->pair_n = quint8(portRange.pairSize());
+
+    *data += FORT_CONF_PORT_LIST_OFF;
+
+    writeShorts(data, portRange.portArray());
+    writeShorts(data, portRange.pairFromArray());
+    writeShorts(data, portRange.pairToArray());
+}
+
 void ConfUtil::writeShorts(char **data, const shorts_arr_t &array)
 {
     writeData(data, array.constData(), array.size(), sizeof(quint16));
@@ -904,6 +1270,15 @@ void ConfUtil::writeData(char **data, void const *src, int elemCount, uint elemS
     *data += arraySize;
 }
 
+char *ConfUtil::appendData(QByteArray &out, int size)
+{
+    const int oldSize = out.size();
+
+    out.append(size, '\0');
+
+    return out.data() + oldSize;
+}
+
 void ConfUtil::writeChars(char **data, const chars_arr_t &array)
 {
     const size_t arraySize = size_t(array.size());
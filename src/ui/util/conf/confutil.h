@@ -18,6 +18,10 @@ class ConfAppsWalker;
 class ConfRulesWalker;
 class EnvManager;
 class FirewallConf;
+class PortRange;
+class Rule;
+class RuleExpr;
+struct RuleFilter;
 
 using longs_arr_t = QVector<quint32>;
 using shorts_arr_t = QVector<quint16>;
@@ -54,13 +58,20 @@ public:
 public slots:
     void writeVersion();
     void writeServices(const QVector<ServiceInfo> &services, int runningServicesCount);
+    void writeServicesDelta(const QVector<ServiceInfo> &services);
 
     bool write(
             const FirewallConf &conf, const ConfAppsWalker *confAppsWalker, EnvManager &envManager);
     void writeFlags(const FirewallConf &conf);
     bool writeAppEntry(const App &app, bool isNew = false);
+    bool writeAppEntries(const QList<App> &apps);
 
     bool writeRules(const ConfRulesWalker &confRulesWalker);
+    void writeRuleExpr(const RuleExpr &ruleExpr);
+    void writeRuleFlag(int ruleId, bool enabled);
+
+    // Write the port list of the given or the smallest encoding, return the encoding or -1
+    int writePorts(const PortRange &portRange, int portEncoding = -1);
 
     void writeZone(const IpRange &ipRange);
     void writeZones(quint32 zonesMask, quint32 enabledMask, quint32 dataSize,
@@ -127,12 +138,34 @@ private:
 
     static void writeApps(char **data, const appdata_map_t &appsMap, bool useHeader = false);
 
+    static void writeRule(QByteArray &out, const Rule &rule, const shorts_arr_t &ruleSet,
+            const RuleExpr &ruleExpr);
+    static void writeRuleExprData(QByteArray &out, const RuleExpr &ruleExpr);
+    static void writeRuleExprList(
+            QByteArray &out, const RuleExpr &ruleExpr, const RuleFilter &listFilter);
+    static void writeRuleExprFilter(QByteArray &out, const RuleFilter &filter);
+    static void writeRuleExprHeader(
+            QByteArray &out, bool isOr, bool isBegin = false, bool isEnd = false);
+
+    static int selectPortEncoding(
+            const PortRange &portRange, const QByteArray &portBitmap, int &listSize);
+    static int portListSize(
+            const PortRange &portRange, const QByteArray &portBitmap, int portEncoding);
+    static int portBlocksLeafCount(const QByteArray &portBitmap);
+    static quint8 portBlockCode(const QByteArray &portBitmap, int blockIndex);
+
+    static void writePortListData(char **data, const PortRange &portRange,
+            const QByteArray &portBitmap, int portEncoding);
+    static void writePortList(char **data, const PortRange &portRange);
+    static void writePortBlocks(char **data, const QByteArray &portBitmap);
+
     static void migrateZoneData(char **data, const QByteArray &zoneData);
 
     static void writeShorts(char **data, const shorts_arr_t &array);
     static void writeLongs(char **data, const longs_arr_t &array);
     static void writeIp6Array(char **data, const ip6_arr_t &array);
     static void writeData(char **data, void const *src, int elemCount, uint elemSize);
+    static char *appendData(QByteArray &out, int size);
     static void writeChars(char **data, const chars_arr_t &array);
     static void writeArray(char **data, const QByteArray &array);
 
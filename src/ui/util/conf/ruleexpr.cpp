@@ -1,3 +1,378 @@
 #include "ruleexpr.h"
 
+#include <util/net/iprange.h>
+#include <util/net/portrange.h>
+
+#include "confutil.h"
+
+/*
+ * Rule text:
+ *   Lines and the "or" keyword separate alternatives,
+ *   filters of an alternative must match all.
+ *
+ * Filter:
+ *   address[:ports]     remote address: 1.1.1.1, (1.1.1.1-8.8.8.8, ::1)
+ *   *:ports             any remote address
+ *   local[(addresses)]:ports
+ *   { alternatives }    nested group
+ *
+ * Ports:
+ *   80, (80, 443-450), tcp, udp(53), tcp(80, 443)
+ *
+ * "#" comments out the rest of line.
+ */
+
+namespace {
+
+bool isWordDelimiter(const QChar c, bool isValue)
+{
+    switch (c.unicode()) {
+    case ' ':
+    case '\t':
+    case '\r':
+    case '\n':
+    case '#':
+    case '(':
+    case ')':
+    case '{':
+    case '}':
+    case ',':
+        return true;
+    case ':':
+        return !isValue; // part of IPv6 address
+    default:
+        return false;
+    }
+}
+
+}
+
 RuleExpr::RuleExpr(QObject *parent) : QObject(parent) { }
+
+QString RuleExpr::errorLineAndMessageDetails() const
+{
+    const QString details = errorDetails().isEmpty() ? QString() : " (" + errorDetails() + ')';
+
+    return tr("Error at line %1, column %2: %3")
+                   .arg(QString::number(errorLineNo()), QString::number(errorColumnNo()),
+                           errorMessage())
+            + details;
+}
+
+void RuleExpr::clear()
+{
+    m_pos = 0;
+
+    m_errorPos = 0;
+    m_errorLineNo = 0;
+    m_errorColumnNo = 0;
+    m_errorMessage.clear();
+    m_errorDetails.clear();
+
+    m_text.clear();
+
+    m_filters.clear();
+}
+
+bool RuleExpr::parse(const QString &text)
+{
+    clear();
+
+    m_text = text;
+
+    RuleFilter rootFilter;
+    rootFilter.type = RuleFilter::TypeList;
+
+    m_filters.append(rootFilter);
+
+    return parseList(/*listIndex=*/0, /*depth=*/0, /*endChar=*/QChar());
+}
+
+bool RuleExpr::setError(int pos, const QString &errorMessage, const QString &errorDetails)
+{
+    const QStringView textBefore = QStringView(m_text).left(pos);
+    const int lineStartPos = int(textBefore.lastIndexOf('\n')) + 1;
+
+    m_errorPos = pos;
+    m_errorLineNo = int(textBefore.count('\n')) + 1;
+    m_errorColumnNo = pos - lineStartPos + 1;
+    m_errorMessage = errorMessage;
+    m_errorDetails = errorDetails;
+
+    return false;
+}
+
+bool RuleExpr::parseList(int listIndex, int depth, QChar endChar)
+{
+    int filtersCount = 0; // of the current alternative
+    bool isOr = false;
+    int orKeywordPos = -1;
+
+    for (;;) {
+        skipSpaces();
+
+        if (atEnd()) {
+            if (!endChar.isNull())
+                return setError(m_pos, tr("Missing '%1'").arg(endChar));
+            break;
+        }
+
+        const int pos = m_pos;
+        const QChar c = currentChar();
+
+        if (c == '\n') {
+            ++m_pos;
+
+            if (filtersCount != 0) {
+                filtersCount = 0;
+                isOr = true;
+            }
+            continue;
+        }
+
+        if (c == endChar) {
+            ++m_pos;
+            break;
+        }
+
+        if (c == '{') {
+            if (!parseGroup(listIndex, depth, isOr))
+                return false;
+        } else {
+            const QStringView word = readWord();
+
+            if (isKeyword(word, "or")) {
+                if (filtersCount == 0)
+                    return setError(pos, tr("Unexpected 'or'"));
+
+                filtersCount = 0;
+                isOr = true;
+                orKeywordPos = pos;
+                continue;
+            }
+
+            m_pos = pos;
+
+            RuleFilter filter;
+            filter.type = RuleFilter::TypeEndpoint;
+            filter.isOr = isOr;
+            filter.pos = pos;
+
+            if (!parseEndpoint(filter))
+                return false;
+
+            m_filters[listIndex].children.append(m_filters.size());
+            m_filters.append(filter);
+        }
+
+        ++filtersCount;
+        isOr = false;
+        orKeywordPos = -1;
+    }
+
+    if (orKeywordPos >= 0)
+        return setError(orKeywordPos, tr("Missing filter after 'or'"));
+
+    return true;
+}
+
+bool RuleExpr::parseGroup(int listIndex, int depth, bool isOr)
+{
+    const int pos = m_pos++; // skip '{'
+
+    if (depth >= ConfUtil::ruleDepthMaxCount())
+        return setError(pos, tr("Too deep nesting of groups"));
+
+    RuleFilter filter;
+    filter.type = RuleFilter::TypeList;
+    filter.isOr = isOr;
+    filter.pos = pos;
+
+    const int groupIndex = m_filters.size();
+
+    m_filters[listIndex].children.append(groupIndex);
+    m_filters.append(filter);
+
+    if (!parseList(groupIndex, depth + 1, /*endChar=*/'}'))
+        return false;
+
+    if (m_filters[groupIndex].children.isEmpty())
+        return setError(pos, tr("Empty group"));
+
+    return true;
+}
+
+bool RuleExpr::parseEndpoint(RuleFilter &filter)
+{
+    bool hasAddress = true;
+
+    if (currentChar() == '(') {
+        if (!parseValues(filter.addressList))
+            return false;
+    } else {
+        const QStringView word = readWord();
+
+        if (word.isEmpty())
+            return setError(m_pos, tr("Unexpected character '%1'").arg(currentChar()));
+
+        if (isKeyword(word, "local")) {
+            filter.isLocal = true;
+
+            hasAddress = (currentChar() == '(');
+            if (hasAddress && !parseValues(filter.addressList))
+                return false;
+        } else if (word == QLatin1Char('*')) {
+            hasAddress = false;
+        } else {
+            filter.addressList.append(word);
+        }
+    }
+
+    if (hasAddress && !checkAddressList(filter.addressList))
+        return false;
+
+    if (currentChar() == ':') {
+        ++m_pos;
+
+        if (!parsePorts(filter))
+            return false;
+    } else if (!hasAddress) {
+        return setError(m_pos, tr("Missing ports"));
+    }
+
+    if (!(atEnd() || isWordDelimiter(currentChar(), /*isValue=*/false)))
+        return setError(m_pos, tr("Unexpected character '%1'").arg(currentChar()));
+
+    return true;
+}
+
+bool RuleExpr::parsePorts(RuleFilter &filter)
+{
+    if (currentChar() != '(') {
+        const QStringView word = readWord();
+
+        if (word.isEmpty())
+            return setError(m_pos, tr("Missing ports"));
+
+        if (isKeyword(word, "tcp")) {
+            filter.protoFlags = RuleFilter::ProtoTcp;
+        } else if (isKeyword(word, "udp")) {
+            filter.protoFlags = RuleFilter::ProtoUdp;
+        } else {
+            filter.portList.append(word);
+
+            return checkPortList(filter.portList);
+        }
+
+        // Any port of the protocol
+        if (currentChar() != '(')
+            return true;
+    }
+
+    return parseValues(filter.portList) && checkPortList(filter.portList);
+}
+
+bool RuleExpr::parseValues(StringViewList &list)
+{
+    const int pos = m_pos++; // skip '('
+
+    int commaPos = -1;
+
+    for (;;) {
+        skipSpaces(/*skipNewLines=*/true);
+
+        if (atEnd())
+            return setError(m_pos, tr("Missing ')'"));
+
+        const QChar c = currentChar();
+
+        if (c == ')') {
+            if (commaPos >= 0)
+                return setError(commaPos, tr("Missing value after ','"));
+
+            ++m_pos;
+            break;
+        }
+
+        if (c == ',') {
+            if (list.isEmpty() || commaPos >= 0)
+                return setError(m_pos, tr("Unexpected ','"));
+
+            commaPos = m_pos++;
+            continue;
+        }
+
+        const QStringView word = readWord(/*isValue=*/true);
+        if (word.isEmpty())
+            return setError(m_pos, tr("Unexpected character '%1'").arg(c));
+
+        list.append(word);
+        commaPos = -1;
+    }
+
+    if (list.isEmpty())
+        return setError(pos, tr("Empty list"));
+
+    return true;
+}
+
+bool RuleExpr::checkAddressList(const StringViewList &list)
+{
+    IpRange ipRange;
+
+    if (!ipRange.fromList(list, /*sort=*/false)) {
+        const QStringView &word = list.at(ipRange.errorLineNo() - 1);
+
+        return setError(textPos(word), ipRange.errorMessage(), ipRange.errorDetails());
+    }
+
+    return true;
+}
+
+bool RuleExpr::checkPortList(const StringViewList &list)
+{
+    PortRange portRange;
+
+    if (!portRange.fromList(list)) {
+        const QStringView &word = list.at(portRange.errorLineNo() - 1);
+
+        return setError(textPos(word), portRange.errorMessage(), portRange.errorDetails());
+    }
+
+    return true;
+}
+
+void RuleExpr::skipSpaces(bool skipNewLines)
+{
+    while (!atEnd()) {
+        const QChar c = currentChar();
+
+        if (c == '#') {
+            // Skip the comment till the end of line
+            const int lineEndPos = int(m_text.indexOf('\n', m_pos));
+            m_pos = (lineEndPos < 0) ? int(m_text.size()) : lineEndPos;
+            continue;
+        }
+
+        if (!(c == ' ' || c == '\t' || c == '\r' || (skipNewLines && c == '\n')))
+            break;
+
+        ++m_pos;
+    }
+}
+
+QStringView RuleExpr::readWord(bool isValue)
+{
+    const int startPos = m_pos;
+
+    while (!atEnd() && !isWordDelimiter(currentChar(), isValue)) {
+        ++m_pos;
+    }
+
+    return QStringView(m_text).mid(startPos, m_pos - startPos);
+}
+
+bool RuleExpr::isKeyword(const QStringView &word, const char *keyword) const
+{
+    return word.compare(QLatin1String(keyword), Qt::CaseInsensitive) == 0;
+}
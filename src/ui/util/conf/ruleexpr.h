@@ -2,9 +2,40 @@
 #define RULEEXPR_H
 
 #include <QObject>
+#include <QVector>
 
 #include <util/util_types.h>
 
+struct RuleFilter
+{
+    enum Type : qint8 {
+        TypeNone = -1,
+        TypeList = 0,
+        TypeEndpoint,
+    };
+
+    enum ProtoFlag : quint8 {
+        ProtoTcp = 0x01,
+        ProtoUdp = 0x02,
+    };
+
+    bool isList() const { return type == TypeList; }
+
+    Type type = TypeNone;
+
+    bool isOr : 1 = false; // starts an alternative in the parent list
+    bool isLocal : 1 = false;
+
+    quint8 protoFlags = 0;
+
+    int pos = 0; // in the rule text
+
+    StringViewList addressList;
+    StringViewList portList;
+
+    QVector<int> children; // of the list
+};
+
 class RuleExpr : public QObject
 {
     Q_OBJECT
@@ -12,10 +43,63 @@ class RuleExpr : public QObject
 public:
     explicit RuleExpr(QObject *parent = nullptr);
 
-    const StringViewList &viewList() const { return m_viewList; }
+    int errorPos() const { return m_errorPos; }
+    int errorLineNo() const { return m_errorLineNo; }
+    int errorColumnNo() const { return m_errorColumnNo; }
+
+    QString errorMessage() const { return m_errorMessage; }
+    QString errorDetails() const { return m_errorDetails; }
+    QString errorLineAndMessageDetails() const;
+
+    const QString &text() const { return m_text; }
+
+    // The root list is the first one
+    const QVector<RuleFilter> &filters() const { return m_filters; }
+    const RuleFilter &filterAt(int index) const { return m_filters.at(index); }
+
+    bool isEmpty() const { return m_filters.size() <= 1; }
+
+    // Parse the rule text
+    bool parse(const QString &text);
+
+public slots:
+    void clear();
+
+private:
+    bool setError(int pos, const QString &errorMessage, const QString &errorDetails = {});
+
+    bool parseList(int listIndex, int depth, QChar endChar);
+    bool parseGroup(int listIndex, int depth, bool isOr);
+
+    bool parseEndpoint(RuleFilter &filter);
+    bool parsePorts(RuleFilter &filter);
+    bool parseValues(StringViewList &list);
+
+    bool checkAddressList(const StringViewList &list);
+    bool checkPortList(const StringViewList &list);
+
+    void skipSpaces(bool skipNewLines = false);
+    QStringView readWord(bool isValue = false);
+
+    bool isKeyword(const QStringView &word, const char *keyword) const;
+
+    bool atEnd() const { return m_pos >= m_text.size(); }
+    QChar currentChar() const { return atEnd() ? QChar() : m_text.at(m_pos); }
+
+    int textPos(const QStringView &word) const { return int(word.data() - m_text.constData()); }
 
 private:
-    StringViewList m_viewList;
+    int m_pos = 0;
+
+    int m_errorPos = 0;
+    int m_errorLineNo = 0;
+    int m_errorColumnNo = 0;
+    QString m_errorMessage;
+    QString m_errorDetails;
+
+    QString m_text;
+
+    QVector<RuleFilter> m_filters;
 };
 
 #endif // RULEEXPR_H
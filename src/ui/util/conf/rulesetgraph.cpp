@@ -0,0 +1,309 @@
+#include "rulesetgraph.h"
+
+#include <QMap>
+
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+const RuleSetNode g_emptyNode;
+
+}
+
+const RuleSetNode &RuleSetGraph::nodeAt(int ruleId) const
+{
+    return (ruleId >= 0 && ruleId < m_nodes.size()) ? m_nodes[ruleId] : g_emptyNode;
+}
+
+RuleSetNode &RuleSetGraph::node(int ruleId)
+{
+    if (ruleId >= m_nodes.size()) {
+        m_nodes.resize(ruleId + 1);
+        m_visitMarks.resize(ruleId + 1);
+    }
+
+    RuleSetNode &node = m_nodes[ruleId];
+
+    if (!node.hasEdges()) {
+        // New nodes are appended to the topological order
+        node.order = m_nextOrder++;
+    }
+
+    return node;
+}
+
+bool RuleSetGraph::isLoop(int ruleId, int subRuleId) const
+{
+    if (ruleId == subRuleId)
+        return true;
+
+    const RuleSetNode &ruleNode = nodeAt(ruleId);
+    const RuleSetNode &subRuleNode = nodeAt(subRuleId);
+
+    if (!ruleNode.hasEdges() || !subRuleNode.hasEdges())
+        return false;
+
+    // The rule can't be reached from the sub-rule, which is after it in the order
+    if (subRuleNode.order > ruleNode.order)
+        return false;
+
+    QVector<int> ruleIds;
+    return !collectForward(subRuleId, ruleNode.order, ruleIds);
+}
+
+void RuleSetGraph::clear()
+{
+    m_nextOrder = 0;
+
+    m_nodes.clear();
+
+    m_visitMarks.clear();
+    m_visitMark = 0;
+}
+
+bool RuleSetGraph::addSubRule(int ruleId, int subRuleId)
+{
+    if (ruleId == subRuleId)
+        return false;
+
+    node(ruleId);
+    node(subRuleId);
+
+    if (m_nodes[subRuleId].order < m_nodes[ruleId].order && !reorder(ruleId, subRuleId))
+        return false;
+
+    m_nodes[ruleId].subRuleIds.append(subRuleId);
+    m_nodes[subRuleId].parentRuleIds.append(ruleId);
+
+    updateParentDepths(subRuleId);
+    updateSubDepths(ruleId);
+
+    return true;
+}
+
+void RuleSetGraph::removeSubRule(int ruleId, int subRuleId)
+{
+    if (ruleId >= m_nodes.size() || subRuleId >= m_nodes.size())
+        return;
+
+    if (!m_nodes[ruleId].subRuleIds.removeOne(subRuleId))
+        return;
+
+    m_nodes[subRuleId].parentRuleIds.removeOne(ruleId);
+
+    updateParentDepths(subRuleId);
+    updateSubDepths(ruleId);
+}
+
+bool RuleSetGraph::setRuleSet(int ruleId, const RuleSetList &subRuleIds)
+{
+    const RuleSetList oldSubRuleIds = nodeAt(ruleId).subRuleIds;
+
+    for (const int subRuleId : oldSubRuleIds) {
+        removeSubRule(ruleId, subRuleId);
+    }
+
+    bool ok = true;
+
+    for (const int subRuleId : subRuleIds) {
+        if (!addSubRule(ruleId, subRuleId)) {
+            ok = false;
+        }
+    }
+
+    return ok;
+}
+
+void RuleSetGraph::removeRule(int ruleId)
+{
+    const RuleSetNode &ruleNode = nodeAt(ruleId);
+
+    const RuleSetList subRuleIds = ruleNode.subRuleIds;
+    const RuleSetList parentRuleIds = ruleNode.parentRuleIds;
+
+    for (const int subRuleId : subRuleIds) {
+        removeSubRule(ruleId, subRuleId);
+    }
+
+    for (const int parentRuleId : parentRuleIds) {
+        removeSubRule(parentRuleId, ruleId);
+    }
+}
+
+void RuleSetGraph::fillRuleSetMap(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds) const
+{
+    const int nodesCount = int(m_nodes.size());
+
+    for (int ruleId = 0; ruleId < nodesCount; ++ruleId) {
+        const RuleSetList &subRuleIds = m_nodes[ruleId].subRuleIds;
+        if (subRuleIds.isEmpty())
+            continue;
+
+        const RuleSetIndex ruleSetIndex = {
+            .index = quint32(ruleIds.size()),
+            .count = quint8(subRuleIds.size()),
+        };
+
+        ruleSetMap.insert(ruleId, ruleSetIndex);
+
+        ruleIds.append(subRuleIds);
+    }
+}
+
+bool RuleSetGraph::reorder(int ruleId, int subRuleId)
+{
+    const int lowerOrder = m_nodes[subRuleId].order;
+    const int upperOrder = m_nodes[ruleId].order;
+
+    // Sub-rules of the sub-rule, which are before the rule in the order
+    QVector<int> forwardIds;
+    if (!collectForward(subRuleId, upperOrder, forwardIds))
+        return false;
+
+    // Parents of the rule, which are after the sub-rule in the order
+    QVector<int> backwardIds;
+    collectBackward(ruleId, lowerOrder, backwardIds);
+
+    const auto orderLess = [&](int lhs, int rhs) {
+        return m_nodes[lhs].order < m_nodes[rhs].order;
+    };
+
+    std::sort(forwardIds.begin(), forwardIds.end(), orderLess);
+    std::sort(backwardIds.begin(), backwardIds.end(), orderLess);
+
+    // Move the parents before the sub-rules, reusing their order positions
+    const QVector<int> ruleIds = backwardIds + forwardIds;
+
+    QVector<int> orders;
+    orders.reserve(ruleIds.size());
+
+    for (const int id : ruleIds) {
+        orders.append(m_nodes[id].order);
+    }
+
+    std::sort(orders.begin(), orders.end());
+
+    const int ruleIdsCount = int(ruleIds.size());
+    for (int i = 0; i < ruleIdsCount; ++i) {
+        m_nodes[ruleIds[i]].order = orders[i];
+    }
+
+    return true;
+}
+
+bool RuleSetGraph::collectForward(int ruleId, int upperOrder, QVector<int> &ruleIds) const
+{
+    const int visitMark = newVisitMark();
+
+    QVector<int> stack = { ruleId };
+    m_visitMarks[ruleId] = visitMark;
+
+    while (!stack.isEmpty()) {
+        const int id = stack.takeLast();
+
+        ruleIds.append(id);
+
+        for (const int subRuleId : m_nodes[id].subRuleIds) {
+            const int order = m_nodes[subRuleId].order;
+
+            if (order == upperOrder)
+                return false; // loop
+
+            if (order > upperOrder || m_visitMarks[subRuleId] == visitMark)
+                continue;
+
+            m_visitMarks[subRuleId] = visitMark;
+            stack.append(subRuleId);
+        }
+    }
+
+    return true;
+}
+
+void RuleSetGraph::collectBackward(int ruleId, int lowerOrder, QVector<int> &ruleIds) const
+{
+    const int visitMark = newVisitMark();
+
+    QVector<int> stack = { ruleId };
+    m_visitMarks[ruleId] = visitMark;
+
+    while (!stack.isEmpty()) {
+        const int id = stack.takeLast();
+
+        ruleIds.append(id);
+
+        for (const int parentRuleId : m_nodes[id].parentRuleIds) {
+            if (m_nodes[parentRuleId].order < lowerOrder
+                    || m_visitMarks[parentRuleId] == visitMark)
+                continue;
+
+            m_visitMarks[parentRuleId] = visitMark;
+            stack.append(parentRuleId);
+        }
+    }
+}
+
+int RuleSetGraph::newVisitMark() const
+{
+    if (m_visitMark == std::numeric_limits<int>::max()) {
+        m_visitMarks.fill(0);
+        m_visitMark = 0;
+    }
+
+    return ++m_visitMark;
+}
+
+void RuleSetGraph::updateParentDepths(int ruleId)
+{
+    // Walk the changed sub-rules in the topological order
+    QMap<int, int> queue;
+    queue.insert(m_nodes[ruleId].order, ruleId);
+
+    while (!queue.isEmpty()) {
+        const int id = queue.take(queue.firstKey());
+
+        RuleSetNode &ruleNode = m_nodes[id];
+
+        int depth = 0;
+        for (const int parentRuleId : ruleNode.parentRuleIds) {
+            depth = qMax(depth, m_nodes[parentRuleId].parentDepth + 1);
+        }
+
+        if (ruleNode.parentDepth == depth)
+            continue;
+
+        ruleNode.parentDepth = depth;
+
+        for (const int subRuleId : ruleNode.subRuleIds) {
+            queue.insert(m_nodes[subRuleId].order, subRuleId);
+        }
+    }
+}
+
+void RuleSetGraph::updateSubDepths(int ruleId)
+{
+    // Walk the changed parents in the reverse topological order
+    QMap<int, int> queue;
+    queue.insert(m_nodes[ruleId].order, ruleId);
+
+    while (!queue.isEmpty()) {
+        const int id = queue.take(queue.lastKey());
+
+        RuleSetNode &ruleNode = m_nodes[id];
+
+        int depth = 0;
+        for (const int subRuleId : ruleNode.subRuleIds) {
+            depth = qMax(depth, m_nodes[subRuleId].subDepth + 1);
+        }
+
+        if (ruleNode.subDepth == depth)
+            continue;
+
+        ruleNode.subDepth = depth;
+
+        for (const int parentRuleId : ruleNode.parentRuleIds) {
+            queue.insert(m_nodes[parentRuleId].order, parentRuleId);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef RULESETGRAPH_H
+#define RULESETGRAPH_H
+
+#include <QVector>
+
+#include "confruleswalker.h"
+
+struct RuleSetNode
+{
+    bool hasEdges() const { return order >= 0; }
+
+    int order = -1; // in the topological order
+
+    int parentDepth = 0; // longest path from the top parent
+    int subDepth = 0; // longest path to the bottom sub-rule
+
+    RuleSetList subRuleIds; // ordered
+    RuleSetList parentRuleIds;
+};
+
+// Rule Sets DAG with the incremental topological order (Pearce-Kelly)
+class RuleSetGraph
+{
+public:
+    const RuleSetNode &nodeAt(int ruleId) const;
+
+    const RuleSetList &subRuleIds(int ruleId) const { return nodeAt(ruleId).subRuleIds; }
+
+    int parentDepth(int ruleId) const { return nodeAt(ruleId).parentDepth; }
+    int subDepth(int ruleId) const { return nodeAt(ruleId).subDepth; }
+
+    // Is the rule reachable from the sub-rule, i.e. would the edge make a loop?
+    bool isLoop(int ruleId, int subRuleId) const;
+
+    // Depth of the chain through the edge, not counting the edge itself
+    int depth(int ruleId, int subRuleId) const
+    {
+        return parentDepth(ruleId) + subDepth(subRuleId);
+    }
+
+    void clear();
+
+    // Returns false on loop
+    bool addSubRule(int ruleId, int subRuleId);
+    void removeSubRule(int ruleId, int subRuleId);
+
+    // Returns false when some sub-rules are skipped on loop
+    bool setRuleSet(int ruleId, const RuleSetList &subRuleIds);
+
+    void removeRule(int ruleId);
+
+    void fillRuleSetMap(ruleset_map_t &ruleSetMap, ruleid_arr_t &ruleIds) const;
+
+private:
+    RuleSetNode &node(int ruleId);
+
+    bool reorder(int ruleId, int subRuleId);
+
+    bool collectForward(int ruleId, int upperOrder, QVector<int> &ruleIds) const;
+    void collectBackward(int ruleId, int lowerOrder, QVector<int> &ruleIds) const;
+
+    int newVisitMark() const;
+
+    void updateParentDepths(int ruleId);
+    void updateSubDepths(int ruleId);
+
+private:
+    int m_nextOrder = 0;
+
+    QVector<RuleSetNode> m_nodes; // indexed by rule id
+
+    mutable QVector<int> m_visitMarks; // of the depth-first searches
+    mutable int m_visitMark = 0;
+};
+
+#endif // RULESETGRAPH_H
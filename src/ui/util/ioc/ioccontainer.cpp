@@ -1,6 +1,12 @@
 #include "ioccontainer.h"
 
 #include <QLoggingCategory>
+#include <QMetaObject>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+
+#include <algorithm>
 
 #include "iocservice.h"
 
@@ -10,7 +16,10 @@ const QLoggingCategory LC("util.ioc.iocContainer");
 
 ThreadStorage IocContainer::g_threadStorage;
 
-IocContainer::IocContainer() = default;
+IocContainer::IocContainer()
+{
+    m_setupTimer.start();
+}
 
 IocContainer::~IocContainer()
 {
@@ -34,11 +43,76 @@ void IocContainer::setObject(int typeId, IocObject *obj, quint8 flags)
     m_objectFlags[typeId] = flags;
 }
 
-void IocContainer::setUpAll()
+void IocContainer::setObjectDependencies(int typeId, IocTypeIds deps)
 {
-    for (int i = 0; i < m_size; ++i) {
-        setUp(i);
+    m_objectDependencies[typeId] = deps;
+}
+
+bool IocContainer::setUpAll()
+{
+    m_setupTimer.restart();
+
+    const QVector<int> cyclicIds = cyclicTypeIds();
+    if (!cyclicIds.isEmpty()) {
+        qCCritical(LC) << "Cyclic dependencies of services:" << cyclicIds;
+
+        for (int i = 0; i < m_size; ++i) {
+            setUp(i);
+        }
+        return false;
+    }
+
+    const IocTypeIds serviceIds = typeIdsByFlags(IsService);
+
+    QMutexLocker locker(&m_setupMutex);
+
+    for (;;) {
+        const IocTypeIds pendingIds = serviceIds & ~typeIdsByFlags(WasSetUp);
+        if (pendingIds == 0)
+            break;
+
+        const IocTypeIds finishedIds = typeIdsByFlags(SetUpFinished);
+
+        int inlineTypeId = -1;
+
+        // Start the ready parallel services first
+        for (int i = 0; i < m_size; ++i) {
+            if ((pendingIds & (IocTypeIds(1) << i)) == 0)
+                continue;
+
+            if ((m_objectDependencies[i] & serviceIds & ~finishedIds) != 0)
+                continue;
+
+            if ((m_objectFlags[i] & ParallelSetUp) == 0) {
+                if (inlineTypeId < 0) {
+                    inlineTypeId = i;
+                }
+                continue;
+            }
+
+            m_objectFlags[i] |= WasSetUp;
+            m_objectSetupIds[m_setupIndex++] = i;
+            ++m_poolSetupCount;
+
+            QThreadPool::globalInstance()->start([this, i] { setUpInPool(i); });
+        }
+
+        if (inlineTypeId >= 0) {
+            // Thread-affine services are set up in the current thread
+            locker.unlock();
+            setUp(inlineTypeId);
+            locker.relock();
+        } else {
+            m_setupCondition.wait(&m_setupMutex);
+        }
     }
+
+    // Wait for the parallel services
+    while (m_poolSetupCount > 0) {
+        m_setupCondition.wait(&m_setupMutex);
+    }
+
+    return true;
 }
 
 void IocContainer::tearDownAll()
@@ -60,17 +134,78 @@ IocService *IocContainer::setUp(int typeId)
 {
     IocService *obj = resolveService(typeId);
 
+    QMutexLocker locker(&m_setupMutex);
+
     const quint8 flags = m_objectFlags[typeId];
-    if ((flags & (IsService | WasSetUp)) == IsService) {
+    if ((flags & IsService) == 0)
+        return obj;
+
+    if ((flags & WasSetUp) == 0) {
         m_objectFlags[typeId] = (flags | WasSetUp);
         m_objectSetupIds[m_setupIndex++] = typeId;
 
-        obj->setUp();
+        locker.unlock();
+        setUpService(typeId, /*isParallel=*/false);
+        return obj;
+    }
+
+    // Wait for the service set up by another thread
+    const Qt::HANDLE threadId = QThread::currentThreadId();
+
+    while ((m_objectFlags[typeId] & SetUpFinished) == 0
+            && m_setupThreadIds[typeId] != threadId) {
+        m_setupCondition.wait(&m_setupMutex);
     }
 
     return obj;
 }
 
+void IocContainer::setUpService(int typeId, bool isParallel)
+{
+    IocService *obj = resolveService(typeId);
+
+    m_setupMutex.lock();
+    m_setupThreadIds[typeId] = QThread::currentThreadId();
+    m_setupMutex.unlock();
+
+    const qint64 startMsecs = m_setupTimer.elapsed();
+
+    obj->setUp();
+
+    const qint64 endMsecs = m_setupTimer.elapsed();
+
+    QMutexLocker locker(&m_setupMutex);
+
+    m_setupTimes[typeId] = {
+        .typeId = typeId,
+        .isParallel = isParallel,
+        .startMsecs = startMsecs,
+        .msecs = endMsecs - startMsecs,
+    };
+
+    m_setupThreadIds[typeId] = nullptr;
+    m_objectFlags[typeId] |= SetUpFinished;
+
+    m_setupCondition.wakeAll();
+}
+
+void IocContainer::setUpInPool(int typeId)
+{
+    // Resolve the dependencies by IoC() in the pool thread
+    void *pinned = g_threadStorage.value();
+    pinToThread();
+
+    setUpService(typeId, /*isParallel=*/true);
+
+    g_threadStorage.setValue(pinned);
+
+    QMutexLocker locker(&m_setupMutex);
+
+    --m_poolSetupCount;
+
+    m_setupCondition.wakeAll();
+}
+
 void IocContainer::tearDown(int typeId)
 {
     const quint8 flags = m_objectFlags[typeId];
@@ -98,6 +233,96 @@ bool IocContainer::pinToThread()
     return g_threadStorage.setValue(this);
 }
 
+QVector<int> IocContainer::cyclicTypeIds() const
+{
+    const IocTypeIds serviceIds = typeIdsByFlags(IsService);
+
+    // Kahn's algorithm: remove the services with ordered dependencies
+    IocTypeIds orderedIds = 0;
+    bool changed;
+    do {
+        changed = false;
+
+        for (int i = 0; i < m_size; ++i) {
+            const IocTypeIds bit = IocTypeIds(1) << i;
+            if ((serviceIds & ~orderedIds & bit) == 0)
+                continue;
+
+            if ((m_objectDependencies[i] & serviceIds & ~orderedIds) != 0)
+                continue;
+
+            orderedIds |= bit;
+            changed = true;
+        }
+    } while (changed);
+
+    QVector<int> typeIds;
+
+    for (int i = 0; i < m_size; ++i) {
+        if ((serviceIds & ~orderedIds & (IocTypeIds(1) << i)) != 0) {
+            typeIds.append(i);
+        }
+    }
+
+    return typeIds;
+}
+
+QVector<IocSetUpTime> IocContainer::setUpTimes() const
+{
+    QVector<IocSetUpTime> setupTimes;
+
+    QMutexLocker locker(&m_setupMutex);
+
+    for (int i = 0; i < m_size; ++i) {
+        if ((m_objectFlags[i] & SetUpFinished) != 0) {
+            setupTimes.append(m_setupTimes[i]);
+        }
+    }
+
+    std::sort(setupTimes.begin(), setupTimes.end(),
+            [](const IocSetUpTime &a, const IocSetUpTime &b) {
+                return a.startMsecs < b.startMsecs;
+            });
+
+    return setupTimes;
+}
+
+QString IocContainer::setUpReport() const
+{
+    QStringList lines;
+
+    for (const IocSetUpTime &t : setUpTimes()) {
+        // The RTTI names are mangled by some compilers
+        const auto qobj = dynamic_cast<const QObject *>(resolveService(t.typeId));
+        const QString name = qobj ? QLatin1String(qobj->metaObject()->className())
+                                  : QString("#%1").arg(t.typeId);
+
+        QString line = QString("%1: start=%2ms took=%3ms")
+                               .arg(name, QString::number(t.startMsecs),
+                                       QString::number(t.msecs));
+        if (t.isParallel) {
+            line += " parallel";
+        }
+
+        lines.append(line);
+    }
+
+    return lines.join('\n');
+}
+
+IocTypeIds IocContainer::typeIdsByFlags(quint8 flags) const
+{
+    IocTypeIds typeIds = 0;
+
+    for (int i = 0; i < m_size; ++i) {
+        if ((m_objectFlags[i] & flags) == flags) {
+            typeIds |= IocTypeIds(1) << i;
+        }
+    }
+
+    return typeIds;
+}
+
 int IocContainer::getNextTypeId()
 {
     static int g_nextTypeId = 0;
@@ -1,7 +1,11 @@
 #ifndef IOCCONTAINER_H
 #define IOCCONTAINER_H
 
+#include <QElapsedTimer>
+#include <QMutex>
 #include <QObject>
+#include <QVector>
+#include <QWaitCondition>
 
 #include <util/threadstorage.h>
 
@@ -11,10 +15,28 @@ using IocObject = void;
 
 constexpr int IOC_MAX_SIZE = 32;
 
+using IocTypeIds = quint32; // bit mask of type ids
+
+static_assert(IOC_MAX_SIZE <= sizeof(IocTypeIds) * 8, "IoC type ids mask is too small");
+
+struct IocSetUpTime
+{
+    int typeId = 0;
+    bool isParallel = false;
+    qint64 startMsecs = 0; // since setUpAll() start
+    qint64 msecs = 0;
+};
+
 class IocContainer final
 {
 public:
-    enum IocFlag : quint8 { AutoDelete = 0x01, IsService = 0x02, WasSetUp = 0x04 };
+    enum IocFlag : quint8 {
+        AutoDelete = 0x01,
+        IsService = 0x02,
+        WasSetUp = 0x04,
+        ParallelSetUp = 0x08, // setUp() may run in a thread pool
+        SetUpFinished = 0x10,
+    };
 
     explicit IocContainer();
     ~IocContainer();
@@ -53,6 +75,13 @@ public:
         setService(&obj, IsService);
     }
 
+    // Services are set up after their dependencies
+    template<class T, class... Deps>
+    void setDependencies()
+    {
+        setObjectDependencies(getTypeId<T>(), (IocTypeIds(0) | ... | getTypeIdBit<Deps>()));
+    }
+
     template<class T>
     inline constexpr std::enable_if_t<!std::is_base_of_v<IocService, T>, T *> resolve() const
     {
@@ -71,12 +100,20 @@ public:
         return static_cast<T *>(setUp(getTypeId<T>()));
     }
 
-    void setUpAll();
+    // Returns false on cyclic dependencies and sets up the services sequentially
+    bool setUpAll();
     void tearDownAll();
     void autoDeleteAll();
 
     bool pinToThread();
 
+    // Services not ordered by the dependencies
+    QVector<int> cyclicTypeIds() const;
+
+    // Sorted by the start time
+    QVector<IocSetUpTime> setUpTimes() const;
+    QString setUpReport() const;
+
     inline static IocContainer *getPinned()
     {
         return static_cast<IocContainer *>(g_threadStorage.value());
@@ -90,8 +127,15 @@ public:
         return typeId;
     }
 
+    template<class T>
+    static IocTypeIds getTypeIdBit()
+    {
+        return IocTypeIds(1) << getTypeId<T>();
+    }
+
 private:
     void setObject(int typeId, IocObject *obj, quint8 flags = 0);
+    void setObjectDependencies(int typeId, IocTypeIds deps);
 
     inline IocObject *resolveObject(int typeId) const { return m_objects[typeId]; }
     inline IocService *resolveService(int typeId) const
@@ -100,9 +144,13 @@ private:
     }
 
     IocService *setUp(int typeId);
+    void setUpService(int typeId, bool isParallel);
+    void setUpInPool(int typeId);
     void tearDown(int typeId);
     void autoDelete(int typeId);
 
+    IocTypeIds typeIdsByFlags(quint8 flags) const;
+
     static int getNextTypeId();
 
 private:
@@ -110,10 +158,20 @@ private:
 
     int m_size = 0;
     int m_setupIndex = 0;
+    int m_poolSetupCount = 0;
 
     quint8 m_objectFlags[IOC_MAX_SIZE] = {};
     quint16 m_objectSetupIds[IOC_MAX_SIZE] = {};
+    IocTypeIds m_objectDependencies[IOC_MAX_SIZE] = {};
     IocObject *m_objects[IOC_MAX_SIZE] = {};
+
+    Qt::HANDLE m_setupThreadIds[IOC_MAX_SIZE] = {};
+    IocSetUpTime m_setupTimes[IOC_MAX_SIZE];
+
+    QElapsedTimer m_setupTimer;
+
+    mutable QMutex m_setupMutex;
+    QWaitCondition m_setupCondition;
 };
 
 constexpr auto IoCPinned = IocContainer::getPinned;
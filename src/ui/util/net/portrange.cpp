@@ -50,6 +50,28 @@ QString PortRange::toText() const
     return text;
 }
 
+QByteArray PortRange::toBitmap() const
+{
+    QByteArray bitmap(65536 / 8, '\0');
+    uchar *bits = (uchar *) bitmap.data();
+
+    const auto setBit = [&](quint16 port) { bits[port / 8] |= uchar(1 << (port % 8)); };
+
+    for (const quint16 port : portArray()) {
+        setBit(port);
+    }
+
+    for (int i = 0, n = pairSize(); i < n; ++i) {
+        const PortPair pair = pairAt(i);
+
+        for (int port = pair.from; port <= pair.to; ++port) {
+            setBit(quint16(port));
+        }
+    }
+
+    return bitmap;
+}
+
 bool PortRange::fromText(const QString &text)
 {
     const auto list = StringUtil::splitView(text, QLatin1Char('\n'));
@@ -110,11 +132,34 @@ PortRange::ParseError PortRange::parsePortLine(
 PortRange::ParseError PortRange::parsePortRange(const QStringView &port, const QStringView &port2,
         portrange_map_t &portRangeMap, int &pairSize)
 {
-    quint16 from, to = 0;
+    quint16 from, to;
 
-    if (!(parsePortNumber(port, from) || parsePortNumber(port2, to)))
+    if (!parsePortNumber(port, from))
         return ErrorBadPort;
 
+    if (port2.isEmpty()) {
+        to = from;
+    } else if (!parsePortNumber(port2, to)) {
+        return ErrorBadPort;
+    }
+
+    if (from > to) {
+        setErrorMessage(tr("Bad range"));
+        setErrorDetails(QString("from=%1 to=%2").arg(QString::number(from), QString::number(to)));
+        return ErrorBadRangeFormat;
+    }
+
+    // Keep the widest range of the same start
+    const auto it = portRangeMap.constFind(from);
+    if (it != portRangeMap.constEnd()) {
+        if (it.value() >= to)
+            return ErrorOk;
+
+        if (it.value() != from) {
+            --pairSize;
+        }
+    }
+
     portRangeMap.insert(from, to);
 
     if (from != to) {
@@ -134,3 +179,42 @@ bool PortRange::parsePortNumber(const QStringView &port, quint16 &v)
     }
     return ok;
 }
+
+void PortRange::fillPortRange(const portrange_map_t &portRangeMap, int pairSize)
+{
+    if (portRangeMap.isEmpty())
+        return;
+
+    const int mapSize = portRangeMap.size();
+    m_portArray.reserve(mapSize - pairSize);
+    m_pairFromArray.reserve(pairSize);
+    m_pairToArray.reserve(pairSize);
+
+    PortPair prevPort;
+    int prevIndex = -1;
+
+    auto it = portRangeMap.constBegin();
+    auto end = portRangeMap.constEnd();
+
+    for (; it != end; ++it) {
+        const PortPair port { it.key(), it.value() };
+
+        // try to merge colliding ports
+        if (prevIndex >= 0 && port.from <= prevPort.to + 1) {
+            if (port.to > prevPort.to) {
+                m_pairToArray.replace(prevIndex, port.to);
+
+                prevPort.to = port.to;
+            }
+            // else skip it
+        } else if (port.from == port.to) {
+            m_portArray.append(port.from);
+        } else {
+            m_pairFromArray.append(port.from);
+            m_pairToArray.append(port.to);
+
+            prevPort = port;
+            ++prevIndex;
+        }
+    }
+}
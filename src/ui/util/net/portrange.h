@@ -1,6 +1,7 @@
 #ifndef PORTRANGE_H
 #define PORTRANGE_H
 
+#include <QByteArray>
 #include <QMap>
 #include <QObject>
 #include <QVector>
@@ -43,7 +44,7 @@ public:
     const port_arr_t &pairFromArray() const { return m_pairFromArray; }
     port_arr_t &pairFromArray() { return m_pairFromArray; }
 
-    const port_arr_t &pair4oArray() const { return m_pairToArray; }
+    const port_arr_t &pairToArray() const { return m_pairToArray; }
     port_arr_t &pairToArray() { return m_pairToArray; }
 
     int portSize() const { return m_portArray.size(); }
@@ -56,6 +57,9 @@ public:
 
     QString toText() const;
 
+    // 65536-bit bitmap of the ports
+    QByteArray toBitmap() const;
+
     // Parse Port ranges
     bool fromText(const QString &text);
     bool fromList(const StringViewList &list);